@@ -34,8 +34,6 @@ static bool						is_sensor_sampling_complete = false;
 /** @Func Function for handling Peer Manager events */
 void pm_evt_handler(pm_evt_t const * p_evt)
 {
-    ret_code_t err_code;
-
     switch (p_evt->evt_id)
     {
         case PM_EVT_BONDED_PEER_CONNECTED:
@@ -70,16 +68,8 @@ void pm_evt_handler(pm_evt_t const * p_evt)
 
         case PM_EVT_STORAGE_FULL:
         {
-            // Run garbage collection on the flash.
-            err_code = fds_gc();
-            if (err_code == FDS_ERR_BUSY || err_code == FDS_ERR_NO_SPACE_IN_QUEUES)
-            {
-                // Retry.
-            }
-            else
-            {
-                APP_ERROR_CHECK(err_code);
-            }
+            // Run garbage collection on the flash (From the scheduler context, retried at the next poll if FDS is busy).
+            storageHealthRequestGC();
         } break;
 
         case PM_EVT_PEERS_DELETE_SUCCEEDED:
@@ -158,6 +148,8 @@ void on_adv_evt(ble_adv_evt_t ble_adv_evt)
 						NRF_LOG_INFO("Fast Advertising!!\r\n");
 						NRF_LOG_FLUSH();
 					}
+					// Nothing time-critical while advertising (Garbage collection can run)
+					storageHealthSetIdle(true);
 //            err_code = bsp_indication_set(BSP_INDICATE_ADVERTISING);
 //            APP_ERROR_CHECK(err_code);
           break;
@@ -190,6 +182,7 @@ void on_ble_evt(ble_evt_t * p_ble_evt)
 //            err_code = bsp_indication_set(BSP_INDICATE_CONNECTED);
 //            APP_ERROR_CHECK(err_code);
             m_conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            storageHealthSetIdle(false);
             break; // BLE_GAP_EVT_CONNECTED
 
         case BLE_GATTC_EVT_TIMEOUT:
@@ -267,6 +260,7 @@ void ble_evt_dispatch(ble_evt_t * p_ble_evt)
     btnBleEventHandler(p_ble_evt);
     on_ble_evt(p_ble_evt);
     ble_advertising_on_ble_evt(p_ble_evt);
+    batteryOnBleEvt(p_ble_evt);
     /*YOUR_JOB add calls to _on_ble_evt functions from each service your application is using
        ble_xxs_on_ble_evt(&m_xxs, p_ble_evt);
        ble_yys_on_ble_evt(&m_yys, p_ble_evt);
@@ -287,13 +281,26 @@ void sys_evt_dispatch(uint32_t sys_evt)
 }
 
 
+/** @Func Scheduler Event Handler for the Color Sensor Sample Ready Event */
+void sensor_sample_ready_event_handler(void *p_event_data, uint16_t event_size)
+{
+	sensor_sample_evt_t const * p_evt = (sensor_sample_evt_t const *)p_event_data;
+	APP_TRACE(APP_TRACE_SENSOR_DISPATCH);
+	if(p_evt->err_code == NRF_SUCCESS){
+		is_sensor_sampling_complete = true;
+		sensorSettingsSave(); // Persist the exposure settings once the auto-exposure controller has settled
+	}
+	else{
+		NRF_LOG_INFO("SENSOR_EVENT: SAMPLING FAILED (0x%x)!\r\n", p_evt->err_code);
+	}
+}
+
 /** @Func Scheduler Event Handler for Color Sensor */
 void sensor_scheduler_event_handler(void *p_event_data, uint16_t event_size)
 {
-	is_sensor_sampling_complete = false;
-	uint8_t err_code = sensorSampleColor(sensor_data_array,array_length);
-	if(err_code == NRF_SUCCESS){
-		is_sensor_sampling_complete = true;
+	// Start the non-blocking sampling (Ignored if a sample is already in flight)
+	if(sensorSampleColorStart(sensor_data_array,array_length,sensor_sample_ready_event_handler) == NRF_SUCCESS){
+		is_sensor_sampling_complete = false;
 	}
 }
 
@@ -329,6 +336,7 @@ void board_event_handler(board_event_t event)
 		case BOARD_TEST_EVENT_5:
 		{
 			boardLedEffect(LED_EFFECT_SECOND);
+			APP_TRACE(APP_TRACE_SENSOR_REQUEST);
 			app_sched_event_put(NULL,0,sensor_scheduler_event_handler);
 			NRF_LOG_INFO("BOARD_TEST_EVENT_5!\r\n");
 			NRF_LOG_FLUSH();
@@ -362,6 +370,26 @@ void board_event_handler(board_event_t event)
 //	}
 }
 
+/** @Func Function for handling the battery state of charge estimates */
+void battery_soc_event_handler(battery_soc_t const * p_soc)
+{
+	switch (p_soc->state){
+		case BATTERY_STATE_LOW:
+			sensorLedLevelLimit(SENSOR_AE_LED_LEVEL_MAX/2);
+			break;
+		case BATTERY_STATE_CRITICAL:
+			sensorLedLevelLimit(SENSOR_AE_LED_LEVEL_MIN);
+			if(sensorStreamIsRunning()){
+				sensorStreamStop();
+			}
+			NRF_LOG_INFO("BATTERY_EVENT: CRITICAL (%d mV)!\r\n", p_soc->ocv_mv);
+			break;
+		default:
+			sensorLedLevelLimit(SENSOR_AE_LED_LEVEL_MAX);
+			break;
+	}
+}
+
 /* Initialization of the FDS event handler(This can be defined in the "module_scheduler.c" file that aims to manage all the modules */
 void fds_event_handler(fds_evt_t const * const p_fds_evt){
 	switch (p_fds_evt->id){
@@ -410,6 +438,7 @@ void fds_event_handler(fds_evt_t const * const p_fds_evt){
 		}
 		break;
 		case FDS_EVT_GC:         //!< Event for @ref fds_gc.
+		storageHealthOnGC(p_fds_evt->result);
 		if (p_fds_evt->result == FDS_SUCCESS){
 			fdsSetGcFlag(1);
 			if(fdsGetFlags().fds_log_flag) {
@@ -430,6 +459,7 @@ uint8_t * sensorDataAddress(uint8_t * array_length_ptr)
 {
 	if(is_sensor_sampling_complete){
 		is_sensor_sampling_complete = false;
+		APP_TRACE(APP_TRACE_SENSOR_CONSUMED);
 		*array_length_ptr = array_length;
 		return sensor_data_array;
 	}
@@ -112,6 +112,15 @@ void sys_evt_dispatch(uint32_t sys_evt);
 */
 void board_event_handler(board_event_t event);
 
+/**	@Func 	Function for handling the battery state of charge estimates.
+	*
+	* @Brief	The LED current is limited on a low battery, and the streaming is stopped on a critical one,
+	*					so an LED pulse does not pull the battery below the brown-out voltage.
+	*
+	* @Para   p_soc   The new estimate (from the scheduler).
+*/
+void battery_soc_event_handler(battery_soc_t const * p_soc);
+
 void fds_event_handler(fds_evt_t const * const p_fds_evt);
 
 /** @Func Return the Color Sensor Data Array */
@@ -185,10 +185,6 @@ static void boardInit(bool * p_erase_bonds)
     *p_erase_bonds = (startup_event == BOARD_EVENT_CLEAR_BONDING_DATA);
 	*/
 	
-	// Fill in Each LED Effect Data Sequence
-	ledEffectFillSeq(LED_EFFECT_FIRST);
-	ledEffectFillSeq(LED_EFFECT_SECOND);
-	
 	/* Assign Some Events Here */
 	boardButtonEventAssign(BOARD_BUTTON_0, BOARD_BUTTON_ACTION_PUSH, BOARD_TEST_EVENT_2);
 	boardButtonEventAssign(BOARD_BUTTON_0, BOARD_BUTTON_ACTION_RELEASE, BOARD_TEST_EVENT_5);
@@ -211,7 +207,7 @@ static void pinInit(void)
 	nrf_gpio_cfg_input(BOARD_BUTTON_0, NRF_GPIO_PIN_PULLUP);
 	
 	nrf_gpio_cfg_output(VBAT_ADC_EN);
-	nrf_gpio_cfg_input(VBAT_ADC, NRF_GPIO_PIN_PULLUP);
+	nrf_gpio_input_disconnect(VBAT_ADC);		// Analog input of the SAADC (AIN6): no pull-up biasing the divider, no digital input buffer
 	
 	nrf_gpio_cfg_input(USB_PRESENT_INT, NRF_GPIO_PIN_PULLUP);
 	nrf_gpio_cfg_input(CHARGE_FULL_INT, NRF_GPIO_PIN_PULLUP);
@@ -234,7 +230,8 @@ static void pinInit(void)
 /** @Func Function for initializing services that will be used by the application */
 static void serviceInit(void)
 {
-	/*Your Code Here*/
+	// Battery Service (The Level is Updated by the Battery Monitor)
+	batteryServiceInit();
 }
 
 /*===========================================================================================================================*/
@@ -243,7 +240,26 @@ static void serviceInit(void)
 static void storageInit(void)
 {
 	fdsInit(fds_event_handler);
-	initAllRecords();
+	
+	// Serve the Records from RAM (The Changes are Written Back by the Scheduler)
+	loadRecordCache();
+	
+	// Complete or Drop A Transaction Interrupted by A Reset (Retried once after Collecting the Garbage, as A Full Flash Fails the Writes)
+	flash_status_t flash_ret_code = recoverRecordTransaction();
+	if(flash_ret_code != FLASH_STATUS_SUCCESS){
+		fdsGC();
+		flash_ret_code = recoverRecordTransaction();
+	}
+	if(flash_ret_code != FLASH_STATUS_SUCCESS && isLoggerEnabled()){
+		NRF_LOG_INFO("STORAGE: TRANSACTION RECOVERY FAILED (%d)!\r\n", flash_ret_code);
+		NRF_LOG_FLUSH();
+	}
+	
+	// Create the Missing Records and Migrate the Changed Ones (Nothing is Written if the Schema is Unchanged)
+	syncAllRecords();
+	
+	// Poll the FDS Pages and Collect the Garbage while Idle
+	storageHealthInit();
 }
 
 /** @Func Initialize the Scheduler */
@@ -271,6 +287,16 @@ static void sensorInit(void)
 	sensorLedCurrentConfig(RED_CURRENT,RED);
 	sensorLedCurrentConfig(GREEN_CURRENT,GREEN);
 	sensorLedCurrentConfig(BLUE_CURRENT,BLUE);
+	
+	//Restore the Exposure Settings Saved by the Auto-exposure Controller (The Defaults are Kept if the Storage is Unavailable)
+	sensorSettingsLoad();
+	sensorAutoExposureEnable(true);
+	
+	//Initialize the Streaming Mode (Requires the Non-blocking Mode)
+	sensorStreamInit();
+	
+	//Build the Fixed-point Colour Calibration Table (The Default Records are Used if the Storage is Unavailable)
+	colorCalibLoad();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -293,6 +319,9 @@ void moduleInit(void)
 	// Initialize the Timer
 	timerInit();
 	
+	// Initialize the Latency Trace (Removed if APP_TRACE_ENABLED is 0)
+	APP_TRACE_INIT();
+	
 	// Initialize the Board Resources
   boardInit(&erase_bonds);
 	
@@ -314,12 +343,16 @@ void moduleInit(void)
 	// Initialize Connection Parameters
 	connParamsInit();
 	
-	// Initialize Storage Module
-	// storageInit();
-	
 	// Initialize the Scheduler
 	schedulerInit();
 	
+	// Initialize Storage Module (The Write-back and the Health Polling Post Scheduler Events)
+	storageInit();
+	
+	// Initialize the Battery Monitor (Measured in the Background, Published from the Scheduler)
+	batteryMonitorInit();
+	batterySocHandlerConfig(battery_soc_event_handler);
+	
 	// Initialize Sensor Module
 	sensorInit();
 	
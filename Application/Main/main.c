@@ -88,6 +88,8 @@ int main(void)
 						NRF_LOG_INFO("Data[%d] : 0x%2x\r\n",i,sensor_data[i]);
 						NRF_LOG_FLUSH();
 					}
+					APP_TRACE_DUMP();
+					NRF_LOG_FLUSH();
 				}
 			}
 			__WFI();
@@ -1,6 +1,8 @@
 /** Library Name: app_adc.h
  * @Brief 	This library declares functions for ADC (sampling from the battery)
- * @Brief   This library only supports sampling triggered by Timer0 connected using PPI (non-blocking mode)
+ * @Brief   One measurement is one SAMPLE task, averaged by the SAADC hardware (OVERSAMPLE with BURST), after a settling time kept by an app timer (non-blocking mode)
+ * @Brief   Several channels can be converted by the same SAMPLE task (scan mode), each one with its own filter
+ * @Brief   The results are filtered and converted into millivolts with integer arithmetic only (No FPU usage in the SAADC interrupt)
  *
  * @Auther 	Feng Yuan
  * @Time 		12/09/2017
@@ -12,16 +14,20 @@
 
 /** System Modules */
 
+#include <string.h>
 #include "app_adc.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Variable Definitions */
 
-/** @Variable ADC Default Buffers */
-// Use the double buffer function in the ADC peripheral
-static uint16_t adc_default_buffer1[ADC_BUFFER_SIZE];
-static uint16_t adc_default_buffer2[ADC_BUFFER_SIZE];
+/** @Variable ADC Default Buffer */
+// One SAMPLE task fills the whole buffer (The hardware averages the conversions)
+static uint16_t adc_default_buffer[ADC_BUFFER_SIZE];
+
+/** @Variable ADC Scan Buffer */
+// One result per channel, in the scan order
+static nrf_saadc_value_t adc_scan_buffer[ADC_SCAN_CHANNEL_NUM];
 
 /** @Variable The Variable to Store the Final ADC Result */
 // Result after data post-processing
@@ -33,42 +39,107 @@ static adc_config_t adc_config;
 /** @Variable ADC Enable Pin Number */
 static uint8_t adc_en_pin_no;
 
-/** @Variable Sampling Timer Instance Definition */
-// Use Timer0 as the sampling timer to control the sampling rate
-static const nrf_drv_timer_t adc_sa_timer = NRF_DRV_TIMER_INSTANCE(0);
-
-/** @Variable PPI Channel */
-// This PPI channel is used to connect the sampling timer(Timer0) to the ADC peripheral
-static nrf_ppi_channel_t adc_ppi_channel;
+/** @Variable Settling Timer */
+// Started with the ADC enable pin, so the CPU sleeps until the battery voltage is stable
+APP_TIMER_DEF(adc_settle_timer_id);
+static bool is_adc_settle_timer_created = false;
 
 /** @Variable ADC Final Result Ready Flag */
 static bool adc_result_ready;
 
+/** @Variable ADC Measurement in Progress Flag */
+static bool is_adc_busy = false;
+
+/** @Variable Scale Factors of the Gains (Indexed by nrf_saadc_gain_t, Computed at Compile Time) */
+static const uint32_t adc_gain_scale[NRF_SAADC_GAIN4 + 1] = {
+	ADC_SCALE(1, 6),			// NRF_SAADC_GAIN1_6
+	ADC_SCALE(1, 5),			// NRF_SAADC_GAIN1_5
+	ADC_SCALE(1, 4),			// NRF_SAADC_GAIN1_4
+	ADC_SCALE(1, 3),			// NRF_SAADC_GAIN1_3
+	ADC_SCALE(1, 2),			// NRF_SAADC_GAIN1_2
+	ADC_SCALE(1, 1),			// NRF_SAADC_GAIN1
+	ADC_SCALE(2, 1),			// NRF_SAADC_GAIN2
+	ADC_SCALE(4, 1),			// NRF_SAADC_GAIN4
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /* Function Implementation for ADC Operations */
 
-/** @Func Convert the ADC Value into the Real Voltage in Milivolt */
-static uint16_t adc_val_to_voltage(uint32_t adc_val)
+/** @Func Divide and Round to the Nearest (Signed) */
+static int32_t adc_div_round(int32_t num, int32_t den)
+{
+	return (num >= 0)?((num + den/2) / den):((num - den/2) / den);
+}
+
+/** @Func Filter the Samples of One Channel (Average, Kernel, Conversion into Millivolts) */
+static uint16_t adc_filter_samples(nrf_saadc_value_t const * p_samples, uint16_t sample_num, adc_kernel_t * p_kernel, uint32_t scale)
 {
-	uint16_t tmp_voltage;
-	float tmp 	= adc_val/((adc_config.adc_gain_factor / adc_config.adc_ref_voltage_v) * adc_config.adc_res_val);
-  tmp_voltage = (uint16_t) (tmp* 1000); 	// Change the value into milivolts
-	return ((tmp_voltage + 5) / 10) * 10;  	// Round the value.
+	int32_t 					sum 	= 0;
+	nrf_saadc_value_t value = 0;
+	
+	for(uint16_t i = 0; i < sample_num; i++){
+		sum += p_samples[i];
+	}
+	if(sample_num != 0){
+		value = (nrf_saadc_value_t)adc_div_round(sum, sample_num);
+	}
+	if((p_kernel != NULL) && (p_kernel->adc_kernel_func != NULL)){
+		value = p_kernel->adc_kernel_func(p_kernel, value);
+	}
+	return adcValueToMillivolts(value, scale);
+}
+
+/** @Func Push One Value into the Window of A Kernel (Returns the Value Dropped Out, 0 While the Window Fills) */
+static nrf_saadc_value_t adc_kernel_push(adc_kernel_t * p_kernel, nrf_saadc_value_t value)
+{
+	nrf_saadc_value_t dropped = 0;
+	
+	if(p_kernel->adc_kernel_count < p_kernel->adc_kernel_len){
+		p_kernel->adc_kernel_count++;
+	}
+	else{
+		dropped = p_kernel->adc_kernel_window[p_kernel->adc_kernel_head];
+	}
+	p_kernel->adc_kernel_window[p_kernel->adc_kernel_head] = value;
+	p_kernel->adc_kernel_head = (p_kernel->adc_kernel_head + 1) % p_kernel->adc_kernel_len;
+	return dropped;
+}
+
+/** @Func Settling Timer Time-out Handler (Trigger the Averaged Conversion) */
+static void adc_settle_timer_handler(void * p_context)
+{
+	uint8_t err_code;
+	
+	APP_TRACE(APP_TRACE_ADC_START);
+	
+	// Queue the buffer, then one SAMPLE task (The burst takes all the averaged conversions, the scan takes all the channels)
+	if(adc_config.adc_scan_count != 0){
+		err_code = nrf_drv_saadc_buffer_convert(adc_scan_buffer, adc_config.adc_scan_count);
+	}
+	else{
+		err_code = nrf_drv_saadc_buffer_convert((nrf_saadc_value_t *)(adc_config.adc_buffer_addr), adc_config.adc_buffer_size);
+	}
+	APP_ERROR_CHECK(err_code);
+	err_code = nrf_drv_saadc_sample();
+	APP_ERROR_CHECK(err_code);
 }
 
-/** @Func Default ADC Filter (Averaging) */
-static uint16_t adc_filter_default(uint16_t * buffer_addr, uint16_t buffer_size)
+/** @Func Filter the Interleaved Results of A Scan (One Result per Channel) */
+static void adc_scan_filter(nrf_saadc_value_t * buffer_addr)
 {
-	uint32_t sum = 0;
-	for(int16_t i = 0; i < buffer_size; i++){
-		sum += buffer_addr[i];
+	for(uint8_t i = 0; i < adc_config.adc_scan_count; i++){
+		adc_scan_channel_t * p_channel = &adc_config.adc_scan_channels[i];
+		p_channel->adc_result = adc_filter_samples(&buffer_addr[i], 1, p_channel->adc_kernel_ptr, p_channel->adc_scale);
 	}
-	return (uint16_t)(adc_val_to_voltage(sum)/buffer_size);
 }
 
-/** @Func Default Timer Handler */
-static void adc_sa_timer_handler(nrf_timer_event_t event_type, void * p_context)
+/** @Func Create the Settling Timer (Once) */
+static void adc_settle_timer_create(void)
 {
+	if(!is_adc_settle_timer_created){
+		APP_ERROR_CHECK(app_timer_create(&adc_settle_timer_id, APP_TIMER_MODE_SINGLE_SHOT, adc_settle_timer_handler));
+		is_adc_settle_timer_created = true;
+	}
 }
 
 /** @Func Default Event Handler for ADC EventDone */
@@ -78,303 +149,308 @@ static void adc_evt_handler(nrf_drv_saadc_evt_t const * event)
 	switch (event->type){
 		case NRF_DRV_SAADC_EVT_DONE:
 		{
-			// Post-process the ADC data
-			adc_final_result = adc_config.adc_filter_ptr((uint16_t *)(event->data.done.p_buffer),adc_config.adc_buffer_size);
+			// Post-process the ADC data (Each channel of a scan with its own filter)
+			if(adc_config.adc_scan_count != 0){
+				adc_scan_filter(event->data.done.p_buffer);
+				adc_final_result = adc_config.adc_scan_channels[0].adc_result;
+			}
+			else{
+				adc_final_result = adc_filter_samples(event->data.done.p_buffer, adc_config.adc_buffer_size, adc_config.adc_kernel_ptr, adc_config.adc_scale);
+			}
+			APP_TRACE(APP_TRACE_ADC_DONE);
 			
-			// Do nothing about the final result
 			adc_result_ready = true;
 			
 			// Stop the ADC sampling
 			adcSampleStop();
+			
+			// Pass the final result on
+			if(adc_config.adc_scan_count != 0 && adc_config.adc_scan_handler_ptr != NULL){
+				adc_config.adc_scan_handler_ptr(adc_config.adc_scan_channels, adc_config.adc_scan_count);
+			}
+			if(adc_config.adc_done_handler_ptr != NULL){
+				adc_config.adc_done_handler_ptr(adc_final_result);
+			}
 		}
+		break;
 		default:
 			break;
 	}
 }
 
 /** @Func Configuration of ADC Buffer Information */
-void adcBufferConfig(uint16_t * adc_buffer_1, uint16_t * adc_buffer_2, uint16_t buffer_size)
+void adcBufferConfig(uint16_t * adc_buffer, uint16_t buffer_size)
 {
-	// Set the buffer information to default
-	adc_config.adc_buffer_1_addr 		= NULL;
-	adc_config.adc_buffer_2_addr 		= NULL;
-	adc_config.adc_buffer_size 			= 0;
-	
 	// Configure the ADC buffer settings
-	if(((adc_buffer_1 == NULL) && (adc_buffer_2 == NULL)) || (buffer_size == 0)){
-		// Two ADC buffers are set to default
-		adc_config.adc_buffer_1_addr 	= adc_default_buffer1;
-		adc_config.adc_buffer_2_addr 	= adc_default_buffer2;
-		adc_config.adc_buffer_size 		= ADC_BUFFER_SIZE;
+	if((adc_buffer == NULL) || (buffer_size == 0)){
+		// The ADC buffer is set to default
+		adc_config.adc_buffer_addr 	= adc_default_buffer;
+		adc_config.adc_buffer_size 	= ADC_BUFFER_SIZE;
 		return;
 	}
-	if(adc_buffer_1 != NULL && buffer_size != 0){
-		adc_config.adc_buffer_1_addr 	= adc_buffer_1;
-		adc_config.adc_buffer_size 		= buffer_size;
-	}
-	if(adc_buffer_2 != NULL && buffer_size != 0){
-		adc_config.adc_buffer_2_addr 	= adc_buffer_2;
-		adc_config.adc_buffer_size 		= buffer_size;
-	}
+	// One SAMPLE task gives one averaged result per channel (BURST), so a larger buffer would never be filled
+	adc_config.adc_buffer_addr 		= adc_buffer;
+	adc_config.adc_buffer_size 		= ADC_BUFFER_SIZE;
 }
 
-/** @Func Configuration of ADC Sampling Rate and Post Processing Function */
-void adcSamplingConfig(nrf_saadc_gain_t adc_gain_factor, uint32_t adc_sampling_rate, adc_filter_t adc_filter)
+/** @Func Configuration of ADC Averaging and Post Processing Function */
+void adcSamplingConfig(nrf_saadc_gain_t adc_gain_factor, nrf_saadc_oversample_t adc_oversample, adc_kernel_t * p_kernel)
 {
 	// Set the data resolution information
-	switch (SAADC_CONFIG_RESOLUTION){
-		case 0:
-			adc_config.adc_res_val = 256;
-			break;
-		case 1:
-			adc_config.adc_res_val = 1024;
-			break;
-		case 2:
-			adc_config.adc_res_val = 4096;
-			break;
-		case 3:
-			adc_config.adc_res_val = 16384;
-			break;
-	}
+	adc_config.adc_res_val = ADC_RESOLUTION_VAL;
 	
-	// Configure the channel gain factor
+	// Configure the channel gain factor, and its scale factor (Precomputed, so the conversion is integer only)
 	adc_config.adc_channel_config.gain = adc_gain_factor;
+	adc_config.adc_scale							 = adcGainScale(adc_gain_factor);
 	
-	switch (adc_gain_factor){//convert the enumerate gain factor into the real gain value (float type)
-		case NRF_SAADC_GAIN1_6:
-			adc_config.adc_gain_factor = 1/6;
-			break;
-		case NRF_SAADC_GAIN1_5:
-			adc_config.adc_gain_factor = 0.2;
-			break;
-		case NRF_SAADC_GAIN1_4:
-			adc_config.adc_gain_factor = 0.25;
-			break;
-		case NRF_SAADC_GAIN1_3:
-			adc_config.adc_gain_factor = 1/3;
-			break;
-		case NRF_SAADC_GAIN1_2:
-			adc_config.adc_gain_factor = 0.5;
-			break;
-		case NRF_SAADC_GAIN1:
-			adc_config.adc_gain_factor = 1.0;
-			break;
-		case NRF_SAADC_GAIN2:
-			adc_config.adc_gain_factor = 2.0;
-			break;
-		case NRF_SAADC_GAIN4:
-			adc_config.adc_gain_factor = 4.0;
-			break;
-	}
-	
-	// Configure the ADC acquire time
-	// Calculate the sampling period of the ADC peripheral
-	adc_config.adc_sa_period_us = (uint32_t)(1.0e+6/adc_sampling_rate); //Convert the float value into the integer
-	
-	if(adc_config.adc_sa_period_us >= 50){
-		adc_config.adc_channel_config.acq_time = NRF_SAADC_ACQTIME_40US;
-	}
-	else if(adc_config.adc_sa_period_us >= 30){
-		adc_config.adc_channel_config.acq_time = NRF_SAADC_ACQTIME_20US;
-	}
-	else if(adc_config.adc_sa_period_us >= 20){
-		adc_config.adc_channel_config.acq_time = NRF_SAADC_ACQTIME_10US;
-	}
-	else if(adc_config.adc_sa_period_us >= 3){
-		adc_config.adc_channel_config.acq_time = NRF_SAADC_ACQTIME_3US;
-	}
-	else{
-		adc_config.adc_sa_period_us = 0;
-	}
+	// Configure the ADC acquire time and the hardware averaging
+	adc_config.adc_channel_config.acq_time = ADC_ACQ_TIME;
+	adc_config.adc_oversample							 = adc_oversample;
 	
-	// Assign the post filter of the ADC acquired data
-	if(adc_filter != NULL){// filter provided outside the module
-		adc_config.adc_filter_ptr = adc_filter;
-	}
-	else{ // use the default adc post filter
-		adc_config.adc_filter_ptr = adc_filter_default;
-	}
+	// Assign the post filter kernel of the ADC acquired data (NULL keeps the average)
+	adc_config.adc_kernel_ptr = p_kernel;
 }
 
 /** @Func Configuration of the ADC Analog Channel */
 void adcChannelConfig(uint8_t adc_channel_no, adc_evt_handler_t adc_evt_handler_ptr)
 {
 	uint8_t err_code;
+	nrf_drv_saadc_config_t	adc_saadc_config	= NRF_DRV_SAADC_DEFAULT_CONFIG;
 	
 	// Configure the common ADC channel peripheral settings
 	adc_config.adc_channel_config.resistor_p 	=	NRF_SAADC_RESISTOR_DISABLED;
 	adc_config.adc_channel_config.resistor_n 	=	NRF_SAADC_RESISTOR_DISABLED;
 	adc_config.adc_channel_config.reference		=	NRF_SAADC_REFERENCE_INTERNAL;//Internal 0.6v reference
-	adc_config.adc_channel_config.burst				= NRF_SAADC_BURST_DISABLED;
+	adc_config.adc_channel_config.burst				= (adc_config.adc_oversample != NRF_SAADC_OVERSAMPLE_DISABLED)?NRF_SAADC_BURST_ENABLED:NRF_SAADC_BURST_DISABLED;
 	adc_config.adc_channel_config.mode				= NRF_SAADC_MODE_SINGLE_ENDED;
 	adc_config.adc_channel_config.pin_n				= NRF_SAADC_INPUT_DISABLED;
 	
 	// Set the ADC channel number
 	adc_config.adc_channel_no									= adc_channel_no;
 	
-	// Set the reference voltage in the adc configuration structure
-	// Internal voltage is 0.6 V
-	adc_config.adc_ref_voltage_v							= 0.6;
-	
 	// Configure the ADC peripheral to the designated channel number
-	switch (adc_channel_no){
-		case 0:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN0;
-			break;
-		}
-		case 1:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN1;
-			break;
-		}
-		case 2:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN2;
-			break;
-		}
-		case 3:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN3;
-			break;
-		}
-		case 4:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN4;
-			break;
-		}
-		case 5:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN5;
-			break;
-		}
-		case 6:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN6;
-			break;
-		}
-		case 7:
-		{
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN7;
-			break;
-		}
-		default:
-		{// Use AIN6 as default due to the PCB design
-			adc_config.adc_channel_config.pin_p		= NRF_SAADC_INPUT_AIN6;
-			break;
-		}
-	}
+	adc_config.adc_channel_config.pin_p				= ADC_AIN_INPUT(adc_channel_no);
+	
+	// A single channel (Not a scan)
+	adc_config.adc_scan_count									= 0;
 	
 	// Initialize the ADC peripheral
+	adc_saadc_config.oversample								= adc_config.adc_oversample;
 	if(adc_evt_handler_ptr != NULL){
-		err_code = nrf_drv_saadc_init(NULL, adc_evt_handler_ptr);
+		err_code = nrf_drv_saadc_init(&adc_saadc_config, adc_evt_handler_ptr);
 	}
 	else{
-		err_code = nrf_drv_saadc_init(NULL, adc_evt_handler);
+		err_code = nrf_drv_saadc_init(&adc_saadc_config, adc_evt_handler);
 	}
 	APP_ERROR_CHECK(err_code);
 	
 	// Initialize the ADC channel
   err_code = nrf_drv_saadc_channel_init(adc_channel_no, &adc_config.adc_channel_config);
   APP_ERROR_CHECK(err_code);
+	
+	// Create the settling timer (Once)
+	adc_settle_timer_create();
 }
 
-/** @Func Configure the ADC enable pin as output */
-void adcEnPinConfig(uint8_t pin_no)
+/** @Func Add One Channel to the Scan */
+uint8_t adcScanChannelAdd(uint8_t adc_ain_no, nrf_saadc_gain_t adc_gain, adc_kernel_t * p_kernel)
 {
-	// Set the internal variable
-	adc_en_pin_no = pin_no;
+	uint8_t position = adc_config.adc_scan_count;
 	
-	// Set the adc enable pin as output
-	nrf_gpio_cfg_output(adc_en_pin_no);
-	
-	// Set the adc enable pin number to 0 (disable ADC)
-	nrf_gpio_pin_write(adc_en_pin_no, (ADC_ENABLE_PIN_ACTIVE_STATE?false:true));
+	if(position >= ADC_SCAN_CHANNEL_NUM){
+		return ADC_SCAN_CHANNEL_NUM;
+	}
+	adc_config.adc_scan_channels[position].adc_ain_no 		= adc_ain_no;
+	adc_config.adc_scan_channels[position].adc_gain 			= adc_gain;
+	adc_config.adc_scan_channels[position].adc_kernel_ptr = p_kernel;
+	adc_config.adc_scan_channels[position].adc_scale 			= adcGainScale(adc_gain);
+	adc_config.adc_scan_channels[position].adc_result 		= 0;
+	adc_config.adc_scan_count++;
+	return position;
 }
 
-/** @Func Configure the ADC sampling timer */
-void adcTimerConfig(void)
+/** @Func Configuration of the ADC Peripheral for the Scan */
+void adcScanConfig(nrf_saadc_oversample_t adc_oversample, adc_scan_handler_t adc_scan_handler)
 {
 	uint8_t err_code;
+	nrf_drv_saadc_config_t			adc_saadc_config	= NRF_DRV_SAADC_DEFAULT_CONFIG;
+	nrf_saadc_channel_config_t	adc_channel_config;
 	
-	// Set up the timer peripheral
-	nrf_drv_timer_config_t	adc_sa_timer_cfg	=	NRF_DRV_TIMER_DEFAULT_CONFIG;
-	adc_sa_timer_cfg.bit_width 								= NRF_TIMER_BIT_WIDTH_32;
+	// The SAADC averages every channel of a scan in hardware, as long as all the channels run in burst mode
+	adc_config.adc_oversample				= adc_oversample;
+	adc_config.adc_scan_handler_ptr	= adc_scan_handler;
+	adc_config.adc_res_val					= ADC_RESOLUTION_VAL;
 	
-	err_code = nrf_drv_timer_init(&adc_sa_timer, &adc_sa_timer_cfg, adc_sa_timer_handler);
+	// Initialize the ADC peripheral (The driver asserts a single channel with oversampling, so OVERSAMPLE is set after the channels)
+	adc_saadc_config.oversample			= NRF_SAADC_OVERSAMPLE_DISABLED;
+	err_code = nrf_drv_saadc_init(&adc_saadc_config, adc_evt_handler);
 	APP_ERROR_CHECK(err_code);
 	
-	// Setup adc_sa_timer for compare event
-	uint32_t adc_sa_ticks = nrf_drv_timer_us_to_ticks(&adc_sa_timer, adc_config.adc_sa_period_us);
-	nrf_drv_timer_extended_compare(&adc_sa_timer, NRF_TIMER_CC_CHANNEL0, adc_sa_ticks, NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK, false);
+	// Initialize the channels (SAADC channel N converts the N-th channel of the scan)
+	adc_channel_config.resistor_p 	=	NRF_SAADC_RESISTOR_DISABLED;
+	adc_channel_config.resistor_n 	=	NRF_SAADC_RESISTOR_DISABLED;
+	adc_channel_config.reference		=	NRF_SAADC_REFERENCE_INTERNAL;//Internal 0.6v reference
+	adc_channel_config.acq_time			=	ADC_ACQ_TIME;
+	adc_channel_config.burst				= (adc_config.adc_oversample != NRF_SAADC_OVERSAMPLE_DISABLED)?NRF_SAADC_BURST_ENABLED:NRF_SAADC_BURST_DISABLED;
+	adc_channel_config.mode					= NRF_SAADC_MODE_SINGLE_ENDED;
+	adc_channel_config.pin_n				= NRF_SAADC_INPUT_DISABLED;
+	for(uint8_t i = 0; i < adc_config.adc_scan_count; i++){
+		adc_channel_config.gain				= adc_config.adc_scan_channels[i].adc_gain;
+		adc_channel_config.pin_p			= ADC_AIN_INPUT(adc_config.adc_scan_channels[i].adc_ain_no);
+		err_code = nrf_drv_saadc_channel_init(i, &adc_channel_config);
+		APP_ERROR_CHECK(err_code);
+	}
+	nrf_saadc_oversample_set(adc_config.adc_oversample);
+	
+	// Create the settling timer (Once)
+	adc_settle_timer_create();
 }
 
-/** @Func Configuration of the PPI Peripheral (Including the PPI Between GPIO and Timer, the PPI Between Timer and ADC) */
-void adcPPIConfig(void)
+/** @Func Read the Filtered Result of One Channel of the Scan */
+uint16_t adcScanResultRead(uint8_t position)
 {
-	uint8_t err_code;
-	// Initialize the PPI peripheral
-	nrf_drv_ppi_init();
+	return (position < adc_config.adc_scan_count)?adc_config.adc_scan_channels[position].adc_result:0;
+}
+
+/** @Func Initialization of A Filter Kernel */
+void adcKernelInit(adc_kernel_t * p_kernel, adc_kernel_func_t func, uint8_t len)
+{
+	memset(p_kernel, 0, sizeof(adc_kernel_t));
+	p_kernel->adc_kernel_func = func;
 	
-	// Allocate a free PPI channel
-	err_code = nrf_drv_ppi_channel_alloc(&adc_ppi_channel);
-	APP_ERROR_CHECK(err_code);
+	// The IIR kernel takes a shift, the others a window length
+	if(func == adcKernelIIR){
+		p_kernel->adc_kernel_len = (len > 15)?15:len;
+	}
+	else{
+		p_kernel->adc_kernel_len = (len == 0)?1:((len > ADC_KERNEL_WINDOW_SIZE)?ADC_KERNEL_WINDOW_SIZE:len);
+	}
+}
+
+/** @Func Moving Average Kernel */
+nrf_saadc_value_t adcKernelMovingAverage(adc_kernel_t * p_kernel, nrf_saadc_value_t value)
+{
+	// Running sum: add the new value, remove the one dropped out of the window
+	p_kernel->adc_kernel_acc -= adc_kernel_push(p_kernel, value);
+	p_kernel->adc_kernel_acc += value;
+	return (nrf_saadc_value_t)adc_div_round(p_kernel->adc_kernel_acc, p_kernel->adc_kernel_count);
+}
+
+/** @Func Median-of-N Kernel */
+nrf_saadc_value_t adcKernelMedian(adc_kernel_t * p_kernel, nrf_saadc_value_t value)
+{
+	nrf_saadc_value_t sorted[ADC_KERNEL_WINDOW_SIZE];
+	uint8_t						count;
 	
-	// Get the trigger event (timer time-out) and the task (adc conversion) for PPI channel
-	uint32_t adc_sa_event_addr 	= nrf_drv_timer_compare_event_address_get(&adc_sa_timer, NRF_TIMER_CC_CHANNEL0);
-	uint32_t adc_sa_task_addr   = nrf_drv_saadc_sample_task_get();
+	adc_kernel_push(p_kernel, value);
+	count = p_kernel->adc_kernel_count;
+	
+	// Insertion sort of a copy of the window (N is small)
+	for(uint8_t i = 0; i < count; i++){
+		nrf_saadc_value_t tmp = p_kernel->adc_kernel_window[i];
+		uint8_t 					j 	= i;
+		while((j > 0) && (sorted[j-1] > tmp)){
+			sorted[j] = sorted[j-1];
+			j--;
+		}
+		sorted[j] = tmp;
+	}
+	
+	// The mean of the two middle values for an even count
+	if((count & 0x01) == 0){
+		return (nrf_saadc_value_t)adc_div_round((int32_t)sorted[count/2 - 1] + sorted[count/2], 2);
+	}
+	return sorted[count/2];
+}
 
-	// Setup ppi channel so that timer compare event is triggering sample task in SAADC
-	err_code = nrf_drv_ppi_channel_assign(adc_ppi_channel, adc_sa_event_addr, adc_sa_task_addr);
-	APP_ERROR_CHECK(err_code);
+/** @Func First Order IIR Kernel */
+nrf_saadc_value_t adcKernelIIR(adc_kernel_t * p_kernel, nrf_saadc_value_t value)
+{
+	uint8_t shift = p_kernel->adc_kernel_len;
+	
+	// The state is kept in Q(K), so the small steps are not lost
+	if(p_kernel->adc_kernel_count == 0){
+		p_kernel->adc_kernel_count = 1;
+		p_kernel->adc_kernel_acc 	 = (int32_t)value * (1L << shift);
+	}
+	else{
+		p_kernel->adc_kernel_acc 	+= value - adc_div_round(p_kernel->adc_kernel_acc, 1L << shift);
+	}
+	return (nrf_saadc_value_t)adc_div_round(p_kernel->adc_kernel_acc, 1L << shift);
+}
+
+/** @Func Get the Scale Factor of A Gain */
+uint32_t adcGainScale(nrf_saadc_gain_t adc_gain)
+{
+	return (adc_gain <= NRF_SAADC_GAIN4)?adc_gain_scale[adc_gain]:adc_gain_scale[NRF_SAADC_GAIN1_6];
+}
+
+/** @Func Convert An ADC Value into Millivolts */
+uint16_t adcValueToMillivolts(nrf_saadc_value_t value, uint32_t scale)
+{
+	// A negative value is noise around zero
+	if(value <= 0){
+		return 0;
+	}
+	return (uint16_t)(((uint32_t)value * scale + (1UL << (ADC_SCALE_SHIFT - 1))) >> ADC_SCALE_SHIFT);
+}
+
+/** @Func Configuration of the ADC Result Handler */
+void adcDoneHandlerConfig(adc_done_handler_t adc_done_handler)
+{
+	adc_config.adc_done_handler_ptr = adc_done_handler;
+}
+
+/** @Func Configure the ADC enable pin as output */
+void adcEnPinConfig(uint8_t pin_no)
+{
+	// Set the internal variable
+	adc_en_pin_no = pin_no;
+	
+	// Set the adc enable pin as output
+	nrf_gpio_cfg_output(adc_en_pin_no);
+	
+	// Set the adc enable pin number to 0 (disable ADC)
+	nrf_gpio_pin_write(adc_en_pin_no, (ADC_ENABLE_PIN_ACTIVE_STATE?false:true));
 }
 
 /** @Func Start Taking a Sample (Single Shot) */
 void adcSampleStart(void)
 {
 	uint8_t err_code;
+	bool		is_start	=	false;
 	
-	// Pull up the ADC enable GPIO pin
-	nrf_gpio_pin_write(adc_en_pin_no,(ADC_ENABLE_PIN_ACTIVE_STATE?true:false));
-	
-	// Wait till the battery voltage is stable
-	nrf_delay_ms(ADC_FIRST_CONVERSION_DELAY_MS);
+	CRITICAL_REGION_ENTER();
+	if(!is_adc_busy){
+		is_adc_busy	=	true;
+		is_start		=	true;
+	}
+	CRITICAL_REGION_EXIT();
+	if(!is_start){
+		return;
+	}
 	
 	// Set the ADC result notification flag
 	adc_result_ready = false;
 	
-	// Start the timer
-	nrf_drv_timer_enable(&adc_sa_timer);
-	nrf_drv_timer_clear(&adc_sa_timer);
+	// Pull up the ADC enable GPIO pin
+	nrf_gpio_pin_write(adc_en_pin_no,(ADC_ENABLE_PIN_ACTIVE_STATE?true:false));
 	
-	// Enable the PPI channel
-	err_code = nrf_drv_ppi_channel_enable(adc_ppi_channel);
+	// Convert when the battery voltage is stable (The CPU is free in the meantime)
+	err_code = app_timer_start(adc_settle_timer_id, APP_TIMER_TICKS(ADC_FIRST_CONVERSION_DELAY_MS, ADC_TIMER_PRESCALER), NULL);
 	APP_ERROR_CHECK(err_code);
-	
-	// First ADC conversion
-	if(adc_config.adc_buffer_1_addr != NULL){
-		err_code = nrf_drv_saadc_buffer_convert((nrf_saadc_value_t *)(adc_config.adc_buffer_1_addr), adc_config.adc_buffer_size);
-		APP_ERROR_CHECK(err_code);
-	}
-	if(adc_config.adc_buffer_2_addr != NULL){
-		err_code = nrf_drv_saadc_buffer_convert((nrf_saadc_value_t *)(adc_config.adc_buffer_2_addr), adc_config.adc_buffer_size);
-		APP_ERROR_CHECK(err_code);
-	}
 }
 
 /** @Func Stop Taking a Sample */
 void adcSampleStop(void)
 {
-	uint8_t err_code;
-	// Disable the PPI channel
-	err_code = nrf_drv_ppi_channel_disable(adc_ppi_channel);
-	APP_ERROR_CHECK(err_code);
-	
-	// Stop the timer
-	nrf_drv_timer_disable(&adc_sa_timer);
+	// Stop the settling timer (If the conversion has not been triggered yet)
+	app_timer_stop(adc_settle_timer_id);
 	
 	// Pull down the ADC enable GPIO pin
 	nrf_gpio_pin_write(adc_en_pin_no,(ADC_ENABLE_PIN_ACTIVE_STATE?false:true));
+	
+	is_adc_busy = false;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -384,28 +460,23 @@ void adcChannelDestruct(void)
 {
 	uint8_t err_code;
 	
-	// Destruct the ADC channel
-	err_code = nrf_drv_saadc_channel_uninit(adc_config.adc_channel_no);
-	APP_ERROR_CHECK(err_code);
+	// Destruct the ADC channel (All the channels of a scan)
+	if(adc_config.adc_scan_count != 0){
+		for(uint8_t i = 0; i < adc_config.adc_scan_count; i++){
+			err_code = nrf_drv_saadc_channel_uninit(i);
+			APP_ERROR_CHECK(err_code);
+		}
+		adc_config.adc_scan_count = 0;
+	}
+	else{
+		err_code = nrf_drv_saadc_channel_uninit(adc_config.adc_channel_no);
+		APP_ERROR_CHECK(err_code);
+	}
 	
 	// Destruct the ADC peripheral
 	nrf_drv_saadc_uninit();
 }
 
-/** @Func Destruct the PPI Channel */
-void adcPPIDestruct(void)
-{
-	uint8_t err_code;
-	// Destruct the PPI channel
-	err_code = nrf_drv_ppi_channel_free(adc_ppi_channel);
-	APP_ERROR_CHECK(err_code);
-	err_code = nrf_drv_ppi_uninit();
-	APP_ERROR_CHECK(err_code);
-	
-	// Destruct the Timer
-	nrf_drv_timer_uninit(&adc_sa_timer);
-}
-
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /** @Func Read the ADC Final Result From the Internal Variable */
@@ -438,4 +509,10 @@ bool adcIsResultReady(void)
 	return adc_result_ready;
 }
 
+/** @Func Check whether a measurement is in progress */
+bool adcIsBusy(void)
+{
+	return is_adc_busy;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1,6 +1,8 @@
 /** Library Name: app_adc.h
  * @Brief 	This library declares functions for ADC (sampling from the battery)
- * @Brief   This library only supports sampling triggered by Timer0 connected using PPI (non-blocking mode)
+ * @Brief   One measurement is one SAMPLE task, averaged by the SAADC hardware (OVERSAMPLE with BURST), after a settling time kept by an app timer (non-blocking mode)
+ * @Brief   Several channels can be converted by the same SAMPLE task (scan mode), each one with its own filter
+ * @Brief   The results are filtered and converted into millivolts with integer arithmetic only (No FPU usage in the SAADC interrupt)
  *
  * @Auther 	Feng Yuan
  * @Time 		12/09/2017
@@ -8,33 +10,52 @@
  *
  * @Req			This library requires the following modules to function
  * @Req			- SAADC Module for nRF52 Series						(Include the header file "nrf_drv_saadc.h" and configure in "sdk_config.h")
- * @Req			- PPI Module															(Include the header file "nrf_drv_ppi.h" and configure in "sdk_config.h")
- * @Req			- Timer Module														(Include the header file "nrf_drv_timer.h" and configure in "sdk_config.h".The module uses timer 0.)
+ * @Req			- App Timer																(Settling time before the conversion. Configured in "sdk_config.h")
  * @Req			- GPIO Module															(Used to control the ADC enable pin. Do not need to configure in "sdk_config.h")
  *
  * @Macro		ADC_BUFFER_SIZE														(The default buffer size for the ADC module)
  * @Macro 	ADC_FIRST_CONVERSION_DELAY_MS							(The delay time before the first ADC conversion, waiting for the circuit to become stable)
  * @Macro		ADC_ENABLE_PIN_ACTIVE_STATE								(The ADC enable pin active state)
+ * @Macro		ADC_OVERSAMPLE														(The default number of conversions averaged by the SAADC into one result)
+ * @Macro		ADC_ACQ_TIME															(The acquisition time of each conversion)
+ * @Macro		ADC_SCAN_CHANNEL_NUM											(The maximum number of channels in one scan)
+ * @Macro		ADC_AIN_INPUT															(Procedure for Mapping An Analog Input Number into the SAADC Input)
+ * @Macro		ADC_RESOLUTION_VAL												(The resolution of the ADC in its real value)
+ * @Macro		ADC_REF_MV																(The internal reference voltage in millivolts)
+ * @Macro		ADC_SCALE_SHIFT														(The fraction bits of the integer scale factor)
+ * @Macro		ADC_SCALE																	(Procedure for Computing the Scale Factor of A Gain)
+ * @Macro		ADC_KERNEL_WINDOW_SIZE										(The maximum window length of a filter kernel)
  *
  * @Type		adc_evt_handler_t													(Function Pointer Type for the ADC Completion Event Handler)
- * @Type		adc_filter_t															(Function Pointer Type for the ADC Sample Filter)
+ * @Type		adc_kernel_func_t													(Function Pointer Type for the ADC Filter Kernel)
+ * @Type		adc_kernel_t															(Data Type for the State of One Filter Kernel)
+ * @Type		adc_done_handler_t												(Function Pointer Type for the ADC Result Handler)
+ * @Type		adc_scan_channel_t												(Data Type for One Channel of the Scan)
+ * @Type		adc_scan_handler_t												(Function Pointer Type for the ADC Scan Result Handler)
  * @Type		adc_config_t															(Data Type for the ADC Configuration Structure)
  *
  * @Func		adcBufferConfig														(Configuration of ADC Buffer Information)
- * @Func		adcSamplingConfig													(Configuration of ADC Sampling Rate and Post Processing Function)
+ * @Func		adcSamplingConfig													(Configuration of ADC Averaging and Post Processing Function)
  * @Func		adcChannelConfig													(Configuration of the ADC Peripheral)
+ * @Func		adcDoneHandlerConfig											(Configuration of the ADC Result Handler)
+ * @Func		adcScanChannelAdd													(Add One Channel to the Scan)
+ * @Func		adcScanConfig															(Configuration of the ADC Peripheral for the Scan)
+ * @Func		adcScanResultRead													(Read the Filtered Result of One Channel of the Scan)
+ * @Func		adcKernelInit															(Initialization of A Filter Kernel)
+ * @Func		adcKernelMovingAverage										(Moving Average Kernel)
+ * @Func		adcKernelMedian														(Median-of-N Kernel)
+ * @Func		adcKernelIIR															(First Order IIR Kernel)
+ * @Func		adcGainScale															(Get the Scale Factor of A Gain)
+ * @Func		adcValueToMillivolts											(Convert An ADC Value into Millivolts)
  * @Func		adcEnPinConfig														(Configure the ADC enable pin as output)
- * @Func		adcPPIConfig															(Configuration of the PPI Peripheral)
- * @Func		adcPPIEnable															(Enable the PPI Channel)
- * @Func		adcPPIDisable															(Disable the PPI Channel)
  * @Func		adcSampleStart														(Start Taking a Sample [Single Shot])
  * @Func		adcSampleStop															(Stop Sampling [Single Shot])
  * @Func		adcSampleRead															(Read a Sample Data Out)
  * @Func		adcResultWrite														(Write the ADC Final Result into the Internal Variable)
  * @Func		adcGetConfig															(Get the Address of the ADC Configuration Variable)
  * @Func		adcIsResultReady													(Check whether the ADC processing is finished)
+ * @Func		adcIsBusy																	(Check whether a measurement is in progress)
  * @Func		adcChannelDestruct												(Destruct the ADC Channel)
- * @Func		adcPPIDestruct														(Destruct the PPI Channel)
  *
 */
 
@@ -48,23 +69,52 @@
 /** System Modules */
 
 #include "nrf_drv_saadc.h"
-#include "nrf_drv_timer.h"
 #include "nrf_gpio.h"
-#include "nrf_drv_ppi.h"
-#include "nrf_delay.h"
+#include "app_timer.h"
+#include "app_trace.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Macro Definitions */
 
-/** @Macro The Size of the Default ADC Buffer */
-#define ADC_BUFFER_SIZE									10
+/** @Macro The Size of the Default ADC Buffer (One Averaged Result per SAMPLE Task) */
+#define ADC_BUFFER_SIZE									1
 
 /** @Macro The Delay Before the First ADC Conversion */
 #define ADC_FIRST_CONVERSION_DELAY_MS 	5
 
 /** @Macro The ADC Enable Pin Active State */
 #define ADC_ENABLE_PIN_ACTIVE_STATE			true
+
+/** @Macro The Hardware Averaging (2^N Conversions per Result, Taken in One Burst) */
+#define ADC_OVERSAMPLE									NRF_SAADC_OVERSAMPLE_16X
+
+/** @Macro The Acquisition Time of Each Conversion (Long Enough for the High-impedance Battery Divider) */
+#define ADC_ACQ_TIME										NRF_SAADC_ACQTIME_40US
+
+/** @Macro The Prescaler of the Settling Timer */
+#define ADC_TIMER_PRESCALER							0				// Must be the same as APP_TIMER_PRESCALER
+
+/** @Macro The Maximum Number of Channels in One Scan (One per SAADC Channel) */
+#define ADC_SCAN_CHANNEL_NUM						NRF_SAADC_CHANNEL_COUNT
+
+/** @Macro Map An Analog Input Number (0 - 7) into the SAADC Input (AIN6 as Default due to the PCB Design) */
+#define ADC_AIN_INPUT(A)								((nrf_saadc_input_t)(((A) <= 7)?(NRF_SAADC_INPUT_AIN0 + (A)):NRF_SAADC_INPUT_AIN6))
+
+/** @Macro The Resolution of the ADC in Its Real Value (8, 10, 12 or 14 Bits) */
+#define ADC_RESOLUTION_VAL							(1UL << (8 + 2*SAADC_CONFIG_RESOLUTION))
+
+/** @Macro The Internal Reference Voltage in Millivolts */
+#define ADC_REF_MV											600
+
+/** @Macro The Fraction Bits of the Scale Factor (Millivolts per LSB in Q16) */
+#define ADC_SCALE_SHIFT									16
+
+/** @Macro The Scale Factor of the Gain NUM/DEN (Full Scale = ADC_REF_MV * DEN / NUM, Fits 32 Bits for Every Gain and Resolution) */
+#define ADC_SCALE(NUM, DEN)							((((uint32_t)ADC_REF_MV * (DEN)) << ADC_SCALE_SHIFT) / ((NUM) * ADC_RESOLUTION_VAL))
+
+/** @Macro The Maximum Window Length of A Filter Kernel (Moving Average, Median) */
+#define ADC_KERNEL_WINDOW_SIZE					8
 	
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -79,8 +129,22 @@ extern "C" {
 /** @Type Function Pointer Type for the ADC Completion Event Handler */
 typedef void (* adc_evt_handler_t)(nrf_drv_saadc_evt_t const *);
 
-/** @Type Function Pointer Type for the ADC Sample Filter */
-typedef uint16_t (* adc_filter_t)(uint16_t *, uint16_t);
+/** @Type Function Pointer Type for the ADC Filter Kernel (One Averaged Value In, One Filtered Value Out, Integer Only) */
+typedef struct adc_kernel_s adc_kernel_t;
+typedef nrf_saadc_value_t (* adc_kernel_func_t)(adc_kernel_t *, nrf_saadc_value_t);
+
+/** @Type Data Type for the State of One Filter Kernel (Kept by the Owner of the Channel) */
+struct adc_kernel_s{
+	adc_kernel_func_t						adc_kernel_func;				// The kernel (adcKernelMovingAverage, adcKernelMedian, adcKernelIIR or an external one)
+	uint8_t											adc_kernel_len;					// Window length N (moving average, median) or shift K (IIR, alpha = 1/2^K)
+	uint8_t											adc_kernel_count;				// The number of values taken so far (up to the window length)
+	uint8_t											adc_kernel_head;				// The next position in the window
+	int32_t											adc_kernel_acc;					// Running sum (moving average) or state in Q(K) (IIR)
+	nrf_saadc_value_t						adc_kernel_window[ADC_KERNEL_WINDOW_SIZE];	// The last values
+};
+
+/** @Type Function Pointer Type for the ADC Result Handler (Called with the Filtered Result in the SAADC Interrupt Context) */
+typedef void (* adc_done_handler_t)(uint16_t);
 
 /** @Type Data Type for the ADC Sampling Mode */
 typedef enum{
@@ -88,24 +152,38 @@ typedef enum{
 	ADC_CPU_TRIGGERED
 }adc_sa_mode_t;
 
+/** @Type Data Type for One Channel of the Scan */
+typedef struct{
+	uint8_t											adc_ain_no;							// Analog input number (AIN0 - AIN7)
+	nrf_saadc_gain_t						adc_gain;								// Gain of the channel
+	adc_kernel_t *							adc_kernel_ptr;					// The filter kernel of the channel (NULL keeps the averaged value)
+	uint32_t										adc_scale;							// Millivolts per LSB of the gain (ADC_SCALE)
+	uint16_t										adc_result;							// The last filtered result in millivolts
+}adc_scan_channel_t;
+
+/** @Type Function Pointer Type for the ADC Scan Result Handler (Called with All the Channels in the SAADC Interrupt Context) */
+typedef void (* adc_scan_handler_t)(adc_scan_channel_t const *, uint8_t);
+
 /** @Type Data Type for the ADC Configuration Structure */
 typedef struct{
 	/* ADC channel settings */
   uint8_t										 	adc_channel_no;			 		// ADC channel number in use
 	nrf_saadc_channel_config_t 	adc_channel_config;	 		// ADC channel configuration
 	/* ADC buffer settings */
-	uint16_t * 									adc_buffer_1_addr;			// Address of ADC buffer one
-	uint16_t * 									adc_buffer_2_addr;			// Address of ADC buffer two
+	uint16_t * 									adc_buffer_addr;				// Address of ADC buffer
 	uint16_t										adc_buffer_size;				// Buffer size
-	/* ADC resolution and reference settings */
+	/* ADC resolution and gain settings */
 	uint16_t										adc_res_val;				 		// The resolution of the ADC in its real value
-	float												adc_ref_voltage_v;			// The reference voltage used in ADC conversion
-	/* ADC gain settings */
-	float												adc_gain_factor;				// ADC gain factor
-	/* ADC sampling rate settings */
-	uint32_t										adc_sa_period_us;			  // Sampling period in us
+	uint32_t										adc_scale;							// Millivolts per LSB of the gain (ADC_SCALE, precomputed)
+	/* ADC hardware averaging settings */
+	nrf_saadc_oversample_t			adc_oversample;					// Conversions averaged into one result
 	/* ADC post processing function (DSP) */
-	adc_filter_t								adc_filter_ptr;					// The function pointer to the post-processing filter
+	adc_kernel_t *							adc_kernel_ptr;					// The post-processing filter kernel (or NULL)
+	adc_done_handler_t					adc_done_handler_ptr;		// The function pointer to the result handler (or NULL)
+	/* ADC scan settings */
+	adc_scan_channel_t					adc_scan_channels[ADC_SCAN_CHANNEL_NUM];	// The channels converted by one SAMPLE task
+	uint8_t											adc_scan_count;					// The number of channels in the scan (0 in the single channel mode)
+	adc_scan_handler_t					adc_scan_handler_ptr;		// The function pointer to the scan result handler (or NULL)
 }adc_config_t;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -114,31 +192,29 @@ typedef struct{
 
 /** @Func Configuration of ADC Buffer Information
 	*	
-	*	@Brief This function allocates the buffers for ADC sampling
+	*	@Brief This function allocates the buffer for ADC sampling
+	* @Brief One SAMPLE task gives one averaged result (BURST) and the measurement issues one SAMPLE task, so only one result is converted
 	* 
-	* @Para adc_buffer_1 [uint16_t*] : the first adc buffer address
-	* @Para adc_buffer_2 [uint16_t*] : the second adc buffer address
-	* @Para buffer_size  [uint16_t]  : the size of the buffer
+	* @Para adc_buffer  [uint16_t*] : the adc buffer address
+	* @Para buffer_size [uint16_t]  : the size of the buffer (Clamped to ADC_BUFFER_SIZE, a larger buffer would never complete the conversion)
 	* 
-	* @Note The addresses of the two ADC buffers can be set to NULL, so that the internal ADC buffers are used.
-	* @Note If only one buffer address is set to non-NULL value, then only one buffer is used for ADC. (double buffer function is automatically closed)
+	* @Note The address of the ADC buffer can be set to NULL, so that the internal ADC buffer is used.
 	*
 */
-void adcBufferConfig(uint16_t * adc_buffer_1, uint16_t * adc_buffer_2, uint16_t buffer_size);
+void adcBufferConfig(uint16_t * adc_buffer, uint16_t buffer_size);
 
-/** @Func Configuration of ADC Sampling Rate and Post Processing Function
+/** @Func Configuration of ADC Averaging and Post Processing Function
   *
-	* @Brief This function sets the gain factor and sampling rate of the ADC peripheral
-	* @Brief This function also sets the post-processing filter for the acquired data
-	* @Brief The ADC filter can be set to NULL so that the internal filter is employed
-	* @Brief The internal filter automatically converts the ADC data into the real voltage value in milivolt. If external filter is used, then the acquired adc data is untouched.
+	* @Brief This function sets the gain factor and the hardware averaging of the ADC peripheral
+	* @Brief This function also sets the post-processing filter kernel for the acquired data
+	* @Brief The buffer is averaged, passed through the kernel (if any) and converted into millivolts with the scale factor of the gain
 	*
-	* @Para adc_gain_factor 	[nrf_saadc_gain_t] 	: the ADC gain factor choice, which must be of the enumerate type defined in "nrf_drv_saadc.h" file
-	* @Para adc_sampling_rate [uint32_t] 					: the sampling rate of ADC in Hz
-	* @Para adc_filter 				[adc_filter_t] 			: the ADC post-processing
+	* @Para adc_gain_factor 	[nrf_saadc_gain_t] 				: the ADC gain factor choice, which must be of the enumerate type defined in "nrf_drv_saadc.h" file
+	* @Para adc_oversample 		[nrf_saadc_oversample_t] 	: the number of conversions averaged by the SAADC into one result (NRF_SAADC_OVERSAMPLE_DISABLED for one)
+	* @Para p_kernel 					[adc_kernel_t*] 					: the filter kernel initialized by adcKernelInit (NULL for none)
 	*
 */
-void adcSamplingConfig(nrf_saadc_gain_t adc_gain_factor, uint32_t adc_sampling_rate, adc_filter_t adc_filter);
+void adcSamplingConfig(nrf_saadc_gain_t adc_gain_factor, nrf_saadc_oversample_t adc_oversample, adc_kernel_t * p_kernel);
 
 /** @Func Configuration of the ADC Channel and Event Handler
 	*
@@ -148,40 +224,111 @@ void adcSamplingConfig(nrf_saadc_gain_t adc_gain_factor, uint32_t adc_sampling_r
 	* @Para adc_evt_handler_ptr [adc_evt_handler_t]	: the event handler of the ADC done event
 	*
 	* @Note The ADC event handler can be set to NULL so that the ADC is only performed once
+	* @Note The channel runs in burst mode when the hardware averaging is enabled, so one SAMPLE task gives one averaged result
 	*
 */
 void adcChannelConfig(uint8_t adc_channel_no, adc_evt_handler_t adc_evt_handler_ptr);
 
-/** @Func Configure the ADC enable pin as output
+/** @Func Add One Channel to the Scan
 	*
-	* @Brief This function configures the ADC enabling pin as output and initializes its value as 0 (ADC disabled)
+	* @Brief This function adds one analog input to the channels converted together by one SAMPLE task
+	* @Brief The channels must all be added before adcScanConfig. The results are interleaved in the scan order.
 	*
-	* @Para pin_no [uint8_t] : the pin number of the ADC enabling pin
+	* @Para adc_ain_no 	[uint8_t] 					: the analog input number (AIN0 - AIN7)
+	* @Para adc_gain 		[nrf_saadc_gain_t] 	: the gain of the channel
+	* @Para p_kernel 		[adc_kernel_t*] 		: the filter kernel of the channel, fed with the results of this channel only (NULL for none)
+	*
+	* @Return [uint8_t] : the position of the channel in the scan (ADC_SCAN_CHANNEL_NUM if the scan is full)
+	*
+	* @Note The result of the channel is in millivolts at the pin, converted with the scale factor of its own gain
 	*
 */
-void adcEnPinConfig(uint8_t pin_no);
+uint8_t adcScanChannelAdd(uint8_t adc_ain_no, nrf_saadc_gain_t adc_gain, adc_kernel_t * p_kernel);
 
-/** @Func Configure the ADC sampling timer
+/** @Func Configuration of the ADC Peripheral for the Scan
+	*
+	* @Brief This function initializes the SAADC and all the added channels once, so each measurement (adcSampleStart) is one SAMPLE task
+	* @Brief Every channel of the scan runs in burst mode with the hardware averaging, so one SAMPLE task gives one averaged result per channel
 	*
-	* @Brief This function configures the sampling rate control timer for the ADC
-	* @Brief This function uses the Timer0
+	* @Para adc_oversample 		[nrf_saadc_oversample_t] 	: the hardware averaging of each channel of the scan
+	* @Para adc_scan_handler 	[adc_scan_handler_t] 			: the handler called with all the channels after each scan (or NULL)
 	*
 */
-void adcTimerConfig(void);
-	
-/** @Func Configuration of the PPI Peripheral
+void adcScanConfig(nrf_saadc_oversample_t adc_oversample, adc_scan_handler_t adc_scan_handler);
+
+/** @Func Read the Filtered Result of One Channel of the Scan
 	*
-	* @Brief This function configures the PPI channel that connects the sampling rate control timer and the ADC
+	* @Para position [uint8_t] : the position returned by adcScanChannelAdd
+	*
+	* @Return [uint16_t] : the last filtered result of the channel
 	*
 */
-void adcPPIConfig(void);
+uint16_t adcScanResultRead(uint8_t position);
+
+/** @Func Initialization of A Filter Kernel
+	*
+	* @Brief This function clears the state of the kernel and sets its function and its length
+	*
+	* @Para p_kernel 	[adc_kernel_t*] 			: the kernel state (static, owned by the caller)
+	* @Para func 			[adc_kernel_func_t] 	: adcKernelMovingAverage, adcKernelMedian, adcKernelIIR or an external kernel
+	* @Para len 			[uint8_t] 						: the window length N (1 - ADC_KERNEL_WINDOW_SIZE), or the shift K of the IIR kernel (0 - 15)
+	*
+*/
+void adcKernelInit(adc_kernel_t * p_kernel, adc_kernel_func_t func, uint8_t len);
+
+/** @Func Moving Average Kernel (Mean of the Last N Values) */
+nrf_saadc_value_t adcKernelMovingAverage(adc_kernel_t * p_kernel, nrf_saadc_value_t value);
+
+/** @Func Median-of-N Kernel (Median of the Last N Values, Rejects Single Spikes) */
+nrf_saadc_value_t adcKernelMedian(adc_kernel_t * p_kernel, nrf_saadc_value_t value);
+
+/** @Func First Order IIR Kernel (y += (x - y) / 2^K, Starts from the First Value) */
+nrf_saadc_value_t adcKernelIIR(adc_kernel_t * p_kernel, nrf_saadc_value_t value);
+
+/** @Func Get the Scale Factor of A Gain
+	*
+	* @Para adc_gain [nrf_saadc_gain_t] : the gain of the channel
+	*
+	* @Return [uint32_t] : millivolts per LSB in Q(ADC_SCALE_SHIFT) at the configured resolution
+	*
+*/
+uint32_t adcGainScale(nrf_saadc_gain_t adc_gain);
+
+/** @Func Convert An ADC Value into Millivolts
+	*
+	* @Para value [nrf_saadc_value_t] 	: the ADC value (a negative value is noise around zero)
+	* @Para scale [uint32_t] 						: the scale factor of the gain (adcGainScale)
+	*
+	* @Return [uint16_t] : the voltage at the pin in millivolts (rounded)
+	*
+*/
+uint16_t adcValueToMillivolts(nrf_saadc_value_t value, uint32_t scale);
+
+/** @Func Configuration of the ADC Result Handler
+	*
+	* @Brief This function sets the handler called by the internal ADC event handler with the filtered result of each measurement
+	*
+	* @Para adc_done_handler [adc_done_handler_t] : the result handler (SAADC interrupt context), or NULL
+	*
+*/
+void adcDoneHandlerConfig(adc_done_handler_t adc_done_handler);
+
+/** @Func Configure the ADC enable pin as output
+	*
+	* @Brief This function configures the ADC enabling pin as output and initializes its value as 0 (ADC disabled)
+	*
+	* @Para pin_no [uint8_t] : the pin number of the ADC enabling pin
+	*
+*/
+void adcEnPinConfig(uint8_t pin_no);
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /** @Func Start Taking a Sample (Single Shot)
 	*
-	* @Brief This function starts ADC sampling
-	* @Brief This function sets the ADC enabling pin, starts the sampling timer, enables the ppi channel and starts the first time ADC conversion
+	* @Brief This function starts ADC sampling and returns at once
+	* @Brief This function sets the ADC enabling pin and starts the settling timer. The SAMPLE task is triggered when the timer expires.
+	* @Brief A call while a measurement is in progress is ignored
 	*
 */
 void adcSampleStart(void);
@@ -189,7 +336,7 @@ void adcSampleStart(void);
 /** @Func Stop Taking a Sample
 	*
 	* @Brief This function stops the entire ADC sampling
-	* @Brief This function clears the ADC enabling pin, stops the sampling timer, disables the ppi channel
+	* @Brief This function clears the ADC enabling pin and stops the settling timer
 	*
 */
 void adcSampleStop(void);
@@ -224,18 +371,17 @@ void adcSetResultReady(bool flag);
 /** @Func Destruct the ADC Channel
 	*
 	* @Brief This function destroys the ADC analog channel
-	* @Brief This function uninitializes the channel and the ADC peripheral
+	* @Brief This function uninitializes the channel (or all the channels of the scan) and the ADC peripheral
 	*
 */
 void adcChannelDestruct(void);
 
-/** @Func Destruct the PPI Channel
+/** @Func Check whether a measurement is in progress
 	*
-	* @Brief This function destroys the PPI channel
-	* @Brief This function uninitializes the ppi channel and the ADC sampling timer
+	* @Return [bool] : true from adcSampleStart until the result is filtered (or adcSampleStop)
 	*
 */
-void adcPPIDestruct(void);
+bool adcIsBusy(void);
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,376 @@
+/** Library Name : app_battery.c
+	*
+	* @Brief 		Implementation of the background battery measurement and the Battery Service
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include "app_battery.h"
+#include "app_sensor.h"
+#include "board_select.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Battery Service */
+static ble_bas_t battery_bas;
+
+/** @Variable The Last Measurement */
+static battery_power_t	battery_power;
+static uint8_t 					battery_level = 100;
+
+/** @Variable The Position of the Battery Channel in the Scan */
+static uint8_t battery_adc_position;
+
+/** @Variable The Filter Kernel of the Battery Channel */
+static adc_kernel_t battery_adc_kernel;
+
+/** @Variable The Battery Level Update Scheduler Event */
+static bool is_battery_update_posted = false;
+
+/** @Variable The Measurement Timer and the Retry Timer */
+APP_TIMER_DEF(battery_timer_id);
+APP_TIMER_DEF(battery_retry_timer_id);
+static uint8_t battery_retry_count = 0;
+
+/** @Variable The Last Reading was Taken with the LEDs Off */
+static bool			is_battery_reading_valid = false;
+static uint32_t battery_led_charge_start;
+
+/** @Variable Discharge Curve of the Cell (Open-circuit Voltage in Millivolts, State of Charge in 0.01% Steps, Decreasing Voltages) */
+static const struct{
+	uint16_t	mv;
+	uint16_t	soc;
+}battery_discharge_curve[] =
+{
+	{4200,	10000},
+	{4100,	 9000},
+	{4000,	 7800},
+	{3900,	 6500},
+	{3800,	 5000},
+	{3750,	 4000},
+	{3700,	 2800},
+	{3650,	 1800},
+	{3600,	 1100},
+	{3500,	  500},
+	{3400,	  200},
+	{3300,	    0}
+};
+
+/** @Variable The State of Charge Estimate */
+static battery_soc_t					battery_soc;
+static bool										is_battery_soc_valid 		= false;
+static bool										is_battery_usb_present 	= false;
+static uint32_t								battery_led_charge_last = 0;		// LED charge counter at the last estimate
+static uint32_t								battery_idle_charge_uc 	= 0;		// Idle load charge since the last estimate
+static uint32_t								battery_charge_rem_uc 	= 0;		// The charge below one step
+static battery_soc_handler_t	battery_soc_handler 		= NULL;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Test Whether the Sensor LEDs Load the Battery (On, or A Sample in Flight Turning Them On) */
+static bool battery_is_led_load(void)
+{
+	return sensorIsRedOn() || sensorIsGreenOn() || sensorIsBlueOn() || sensorIsSampling();
+}
+
+/** @Func Take the Reading Again Later (Up to BATTERY_RETRY_MAX Times, Then the Next Interval) */
+static void battery_retry(void)
+{
+	if(battery_retry_count < BATTERY_RETRY_MAX){
+		battery_retry_count++;
+		APP_ERROR_CHECK(app_timer_start(battery_retry_timer_id, APP_TIMER_TICKS(BATTERY_RETRY_MS, BATTERY_TIMER_PRESCALER), NULL));
+	}
+}
+
+/** @Func Start One Reading with the LEDs Off */
+static void battery_measure_start(void)
+{
+	// A reading under an LED pulse would look like an empty battery
+	if(battery_is_led_load()){
+		battery_retry();
+		return;
+	}
+	battery_led_charge_start = sensorGetLedCharge();
+	adcSampleStart();
+}
+
+/** @Func Convert the Open-circuit Voltage into the State of Charge (Piecewise-linear Discharge Curve) */
+static uint16_t battery_curve_lookup(const uint16_t mv)
+{
+	const uint8_t point_num = sizeof(battery_discharge_curve)/sizeof(battery_discharge_curve[0]);
+	
+	if(mv >= battery_discharge_curve[0].mv){
+		return battery_discharge_curve[0].soc;
+	}
+	for(uint8_t i = 1; i < point_num; i++){
+		if(mv >= battery_discharge_curve[i].mv){
+			uint32_t span_mv 	= battery_discharge_curve[i-1].mv - battery_discharge_curve[i].mv;
+			uint32_t span_soc = battery_discharge_curve[i-1].soc - battery_discharge_curve[i].soc;
+			return (uint16_t)(battery_discharge_curve[i].soc + ((uint32_t)(mv - battery_discharge_curve[i].mv) * span_soc) / span_mv);
+		}
+	}
+	return 0;
+}
+
+/** @Func Add One to A Counter Record */
+static void battery_counter_increment(const uint16_t index)
+{
+	union data_set_t value;
+	
+	if(getOneRecord(index, value.byte) == FLASH_STATUS_SUCCESS){
+		value.word++;
+		setOneRecord(index, value.byte);
+	}
+}
+
+/** @Func Update the State of Charge Estimate from A Reading Taken with the LEDs Off */
+static void battery_soc_update(battery_power_t const * p_power)
+{
+	int32_t		soc 				= battery_soc.soc;
+	int32_t		soc_curve;
+	uint32_t	led_charge 	= sensorGetLedCharge();
+	uint32_t	charge_uc;
+	uint32_t	drop_mv;
+	
+	// Open-circuit voltage: the reading plus the drop of the idle load over the internal resistance (uA x mOhm = nV)
+	battery_soc.ocv_mv 		= p_power->battery_mv + (uint16_t)(((uint32_t)BATTERY_IDLE_LOAD_UA * BATTERY_RINT_MOHM) / 1000000);
+	drop_mv 							= (sensorGetLedPeakCurrent() * BATTERY_RINT_MOHM) / 1000000;
+	battery_soc.pulse_mv 	= (battery_soc.ocv_mv > drop_mv) ? (uint16_t)(battery_soc.ocv_mv - drop_mv) : 0;
+	soc_curve 						= battery_curve_lookup(battery_soc.ocv_mv);
+	
+	// The charge drawn since the last estimate (The LED counter wraps around like the subtraction)
+	CRITICAL_REGION_ENTER();
+	charge_uc 							= (led_charge - battery_led_charge_last) + battery_idle_charge_uc + battery_charge_rem_uc;
+	battery_idle_charge_uc 	= 0;
+	CRITICAL_REGION_EXIT();
+	battery_led_charge_last = led_charge;
+	battery_charge_rem_uc 	= charge_uc % BATTERY_SOC_STEP_UC;
+	
+	if(!is_battery_soc_valid){
+		// The first reading: only the curve is known
+		soc 									= soc_curve;
+		is_battery_soc_valid 	= true;
+	}
+	else if(p_power->is_usb_present){
+		// The charge current is not measured, and the voltage reads high while charging: only move up towards the curve
+		battery_charge_rem_uc = 0;
+		if(p_power->is_charge_full){
+			soc = BATTERY_SOC_FULL;
+		}
+		else if(soc_curve > soc){
+			soc += (soc_curve - soc) / (1 << BATTERY_SOC_FUSION_SHIFT);
+		}
+	}
+	else{
+		// Count the charge down, then pull the estimate towards the curve, so the coulomb drift is corrected slowly
+		soc -= (int32_t)(charge_uc / BATTERY_SOC_STEP_UC);
+		if(soc < 0){
+			soc = 0;
+		}
+		soc += (soc_curve - soc) / (1 << BATTERY_SOC_FUSION_SHIFT);
+	}
+	battery_soc.soc = (uint16_t)((soc > BATTERY_SOC_FULL) ? BATTERY_SOC_FULL : soc);
+	
+	// The state for the throttling of the application
+	if(p_power->is_usb_present){
+		battery_soc.state = BATTERY_STATE_CHARGING;
+	}
+	else if(battery_soc.soc <= BATTERY_SOC_CRITICAL * 100 || battery_soc.pulse_mv < BATTERY_BROWNOUT_MV){
+		battery_soc.state = BATTERY_STATE_CRITICAL;
+	}
+	else if(battery_soc.soc <= BATTERY_SOC_LOW * 100){
+		battery_soc.state = BATTERY_STATE_LOW;
+	}
+	else{
+		battery_soc.state = BATTERY_STATE_NORMAL;
+	}
+}
+
+/** @Func Scheduler Event Handler Updating the Estimate and the Battery Service */
+static void battery_update_handler(void *p_event_data, uint16_t event_size)
+{
+	uint32_t 				err_code;
+	battery_power_t power;
+	bool						is_valid;
+
+	CRITICAL_REGION_ENTER();
+	is_battery_update_posted = false;
+	power 		= battery_power;
+	is_valid 	= is_battery_reading_valid;
+	CRITICAL_REGION_EXIT();
+	
+	// An LED was turned on during the reading
+	if(!is_valid){
+		battery_retry();
+		return;
+	}
+	battery_retry_count = 0;
+	
+	// One charge per connection of the USB supply
+	if(power.is_usb_present && !is_battery_usb_present){
+		battery_counter_increment(SET_DATA_SYS_CHRNUM_INDEX);
+	}
+	is_battery_usb_present = power.is_usb_present;
+	
+	battery_soc_update(&power);
+	
+	// The estimate is only published once the divider ratio gives a real one
+	if(!BATTERY_DIVIDER_IS_SET){
+		return;
+	}
+	battery_level = (uint8_t)((battery_soc.soc + 50) / 100);
+
+	// Not connected, or the notifications are not enabled: the value is still written for a read
+	err_code = ble_bas_battery_level_update(&battery_bas, battery_level);
+	if((err_code != NRF_SUCCESS) && (err_code != NRF_ERROR_INVALID_STATE) && (err_code != BLE_ERROR_NO_TX_PACKETS) && (err_code != BLE_ERROR_GATTS_SYS_ATTR_MISSING)){
+		APP_ERROR_HANDLER(err_code);
+	}
+	
+	// Let the application throttle the sampling and the LED current
+	if(battery_soc_handler != NULL){
+		battery_soc_handler(&battery_soc);
+	}
+}
+
+/** @Func ADC Scan Result Handler (SAADC Interrupt Context) */
+static void battery_adc_scan_handler(adc_scan_channel_t const * p_channels, uint8_t channel_count)
+{
+	bool is_post	=	false;
+
+	CRITICAL_REGION_ENTER();
+	// The reading is only kept if no LED was on since the start
+	is_battery_reading_valid 			= !battery_is_led_load() && (sensorGetLedCharge() == battery_led_charge_start);
+	if(is_battery_reading_valid){
+		battery_power.battery_mv 			= (uint16_t)(((uint32_t)p_channels[battery_adc_position].adc_result * BATTERY_DIVIDER_MUL) / BATTERY_DIVIDER_DIV);
+		battery_power.is_usb_present 	= (nrf_gpio_pin_read(USB_PRESENT_INT) == (BATTERY_STATUS_ACTIVE_STATE?1:0));
+		battery_power.is_charge_full 	= (nrf_gpio_pin_read(CHARGE_FULL_INT) == (BATTERY_STATUS_ACTIVE_STATE?1:0));
+	}
+	if(!is_battery_update_posted){
+		is_battery_update_posted	=	true;
+		is_post										=	true;
+	}
+	CRITICAL_REGION_EXIT();
+
+	if(is_post){
+		APP_ERROR_CHECK(app_sched_event_put(NULL,0,battery_update_handler));
+	}
+}
+
+/** @Func Measurement Timer Time-out Handler */
+static void battery_timer_handler(void * p_context)
+{
+	// The idle load over one interval
+	CRITICAL_REGION_ENTER();
+	battery_idle_charge_uc += ((uint32_t)BATTERY_IDLE_LOAD_UA * BATTERY_MEAS_INTERVAL_MS) / 1000;
+	CRITICAL_REGION_EXIT();
+	
+	battery_retry_count = 0;
+	battery_measure_start();
+}
+
+/** @Func Retry Timer Time-out Handler */
+static void battery_retry_timer_handler(void * p_context)
+{
+	battery_measure_start();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Add the Battery Service */
+void batteryServiceInit(void)
+{
+	ble_bas_init_t bas_init;
+
+	memset(&bas_init, 0, sizeof(bas_init));
+
+	// Readable and notifiable without security
+	BLE_GAP_CONN_SEC_MODE_SET_OPEN(&bas_init.battery_level_char_attr_md.cccd_write_perm);
+	BLE_GAP_CONN_SEC_MODE_SET_OPEN(&bas_init.battery_level_char_attr_md.read_perm);
+	BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&bas_init.battery_level_char_attr_md.write_perm);
+	BLE_GAP_CONN_SEC_MODE_SET_OPEN(&bas_init.battery_level_report_read_perm);
+
+	bas_init.evt_handler          = NULL;
+	bas_init.support_notification = true;
+	bas_init.p_report_ref         = NULL;
+	bas_init.initial_batt_level   = battery_level;
+
+	APP_ERROR_CHECK(ble_bas_init(&battery_bas, &bas_init));
+}
+
+/** @Func Initialization of the Background Measurement */
+void batteryMonitorInit(void)
+{
+	// One scan of the power channels per measurement (The battery channel alone is averaged by the hardware)
+	adcEnPinConfig(VBAT_ADC_EN);
+	adcKernelInit(&battery_adc_kernel, adcKernelMedian, BATTERY_ADC_MEDIAN_LEN);
+	battery_adc_position = adcScanChannelAdd(BATTERY_ADC_CHANNEL, BATTERY_ADC_GAIN, &battery_adc_kernel);
+	adcScanConfig(ADC_OVERSAMPLE, battery_adc_scan_handler);
+
+	APP_ERROR_CHECK(app_timer_create(&battery_timer_id, APP_TIMER_MODE_REPEATED, battery_timer_handler));
+	APP_ERROR_CHECK(app_timer_create(&battery_retry_timer_id, APP_TIMER_MODE_SINGLE_SHOT, battery_retry_timer_handler));
+	APP_ERROR_CHECK(app_timer_start(battery_timer_id, APP_TIMER_TICKS(BATTERY_MEAS_INTERVAL_MS, BATTERY_TIMER_PRESCALER), NULL));
+	
+	// Count the power-on (The records are synchronized by the storage initialization)
+	battery_counter_increment(SET_DATA_SYS_POWNUM_INDEX);
+	
+	// The first level is published at once
+	battery_led_charge_last = sensorGetLedCharge();
+	battery_measure_start();
+}
+
+/** @Func Pass the BLE Events to the Battery Service */
+void batteryOnBleEvt(ble_evt_t * p_ble_evt)
+{
+	ble_bas_on_ble_evt(&battery_bas, p_ble_evt);
+}
+
+/** @Func Start One Measurement at Once */
+void batteryMeasureStart(void)
+{
+	battery_measure_start();
+}
+
+/** @Func Get the Last Battery Voltage */
+uint16_t batteryGetMillivolts(void)
+{
+	return battery_power.battery_mv;
+}
+
+/** @Func Get the Last Battery Level */
+uint8_t batteryGetLevel(void)
+{
+	return battery_level;
+}
+
+/** @Func Get the Last Power State */
+void batteryGetPower(battery_power_t * p_power)
+{
+	CRITICAL_REGION_ENTER();
+	*p_power = battery_power;
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Get the Last State of Charge Estimate */
+void batteryGetSoc(battery_soc_t * p_soc)
+{
+	*p_soc = battery_soc;
+}
+
+/** @Func Configuration of the State of Charge Handler */
+void batterySocHandlerConfig(battery_soc_handler_t handler)
+{
+	battery_soc_handler = handler;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,280 @@
+/** Library Name : app_battery.h
+	*
+	* @Brief 		This module measures the battery voltage in the background and publishes it through the Battery Service (ble_bas)
+	* @Brief		An app timer starts one measurement every BATTERY_MEAS_INTERVAL_MS. The ADC module enables the VBAT divider, waits for
+	* @Brief		the settling time with its own app timer, and takes one SAADC result averaged by the hardware (no TIMER0, no PPI, no spin)
+	* @Brief		The result is converted into millivolts with integer arithmetic, and the battery level is updated from the scheduler
+	* @Brief		The power state (battery voltage, USB present, charge full) is taken in one pass: the analog channels are one SAADC scan
+	* @Brief		and the status lines of the charger are read when the scan completes
+	* @Brief		The state of charge is estimated without a fuel gauge:
+	* @Brief		- The voltage is only taken with the sensor LEDs off (A reading disturbed by an LED pulse is taken again), and is compensated
+	* @Brief		  for the idle load with the internal resistance of the cell
+	* @Brief		- The compensated voltage gives a state of charge through a piecewise-linear discharge curve (const table in flash)
+	* @Brief		- Between two readings, the charge drawn by the LEDs (timed by app_sensor) and the idle load is counted down from the estimate,
+	* @Brief		  and the estimate is pulled slowly towards the discharge curve, so neither the LED peaks nor the coulomb drift dominate
+	* @Brief		The power-on and the charge counters are kept in the SET_DATA_SYS_POWNUM/CHRNUM records, and a handler lets the application
+	* @Brief		throttle the sampling rate and the LED current before an LED pulse could pull the battery below the brown-out voltage
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Req			This module requires the following modules to be enabled
+	* @Req			- ADC Module														(Included in "app_adc.h")
+	* @Req			- Battery Service												(BLE_BAS_ENABLED in "sdk_config.h")
+	* @Req			- App Timer															(Configured in "sdk_config.h")
+	* @Req			- App Scheduler													(Configured in "sdk_config.h")
+	* @Req			- Sensor Module													(LED status and LED charge, included in "app_sensor.h")
+	* @Req			- Storage Module												(Counters, included in "app_storage.h")
+	*
+	* @Note			The Battery Service only carries a level in percent, so the millivolts are kept here (batteryGetMillivolts)
+	* @Note			and the level is the estimated state of charge.
+	* @Note			USB_PRESENT_INT and CHARGE_FULL_INT are digital pins (not analog inputs), so they are not channels of the scan.
+	*
+	* @Macro		BATTERY_MEAS_INTERVAL_MS						(Interval between Two Measurements)
+	* @Macro		BATTERY_ADC_CHANNEL									(Analog Input of the Battery Divider)
+	* @Macro		BATTERY_ADC_GAIN										(SAADC Gain of the Battery Channel)
+	* @Macro		BATTERY_ADC_MEDIAN_LEN							(Length of the Median Kernel of the Battery Channel)
+	* @Macro		BATTERY_DIVIDER_MUL/DIV							(Ratio of the Battery Voltage to the Pin Voltage)
+	* @Macro		BATTERY_DIVIDER_IS_SET							(The Ratio is the Measured Ratio of the Board)
+	* @Macro		BATTERY_STATUS_ACTIVE_STATE					(Active State of the Charger Status Lines)
+	* @Macro		BATTERY_RETRY_MS/RETRY_MAX					(Retry of A Reading Disturbed by the LEDs)
+	* @Macro		BATTERY_CAPACITY_MAH								(Capacity of the Cell)
+	* @Macro		BATTERY_RINT_MOHM										(Internal Resistance of the Cell)
+	* @Macro		BATTERY_IDLE_LOAD_UA								(Average Load with the LEDs Off)
+	* @Macro		BATTERY_BROWNOUT_MV									(Lowest Voltage under An LED Pulse)
+	* @Macro		BATTERY_SOC_LOW/CRITICAL						(State of Charge Thresholds)
+	* @Macro		BATTERY_SOC_FUSION_SHIFT						(Weight of the Discharge Curve in the Estimate)
+	*
+	* @Type			battery_power_t											(Data Type of the Power State)
+	* @Type			battery_state_t											(Battery States)
+	* @Type			battery_soc_t												(Data Type of the State of Charge Estimate)
+	* @Type			battery_soc_handler_t								(Function Pointer Type of the State of Charge Handler)
+	*
+	* @Func			batteryServiceInit									(Add the Battery Service)
+	* @Func			batteryMonitorInit									(Initialization of the Background Measurement)
+	* @Func			batteryOnBleEvt											(Pass the BLE Events to the Battery Service)
+	* @Func			batteryMeasureStart									(Start One Measurement at Once)
+	* @Func			batteryGetMillivolts								(Get the Last Battery Voltage)
+	* @Func			batteryGetLevel											(Get the Last Battery Level)
+	* @Func			batteryGetPower											(Get the Last Power State)
+	* @Func			batteryGetSoc												(Get the Last State of Charge Estimate)
+	* @Func			batterySocHandlerConfig							(Configuration of the State of Charge Handler)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __APP_BATTERY_H__
+#define __APP_BATTERY_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include "app_adc.h"
+#include "board_select.h"
+#include "app_scheduler.h"
+#include "app_storage.h"
+#include "ble_bas.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Header */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Measurement Interval */
+#define BATTERY_MEAS_INTERVAL_MS														60000
+#define BATTERY_TIMER_PRESCALER															0				// Must be the same as APP_TIMER_PRESCALER
+
+/** @Macro Battery Channel (VBAT_ADC is AIN6, Full Scale 3.6 V with the Internal 0.6 V Reference and Gain 1/6) */
+#define BATTERY_ADC_CHANNEL																	6
+#define BATTERY_ADC_GAIN																		NRF_SAADC_GAIN1_6
+
+/** @Macro Median of the Last Measurements (Rejects A Single Reading Taken During A Load Peak) */
+#define BATTERY_ADC_MEDIAN_LEN															3
+
+/** @Macro Battery Divider (Battery Voltage = Pin Voltage * MUL / DIV, Defined with VBAT_ADC in the IO Mapping of the Board)
+	*
+	* @Note		BATTERY_DIVIDER_IS_SET is 1 once BATTERY_DIVIDER_MUL/DIV hold the ratio measured on the board.
+	* @Note		The pin cannot go above VDD (nor the 3.6 V full scale), so with the placeholder 1:1 ratio a full cell reads at most ~11% on the
+	* @Note		discharge curve. Until the ratio is set, the Battery Service keeps its initial level and the state of charge handler is
+	* @Note		not called, so neither the central nor the application acts on a wrong estimate (The millivolts are still measured).
+	*
+*/
+#ifndef BATTERY_DIVIDER_IS_SET
+#define BATTERY_DIVIDER_MUL																	1
+#define BATTERY_DIVIDER_DIV																	1
+#define BATTERY_DIVIDER_IS_SET															0
+#endif
+
+#if BATTERY_DIVIDER_IS_SET && ((3600UL * BATTERY_DIVIDER_MUL) / BATTERY_DIVIDER_DIV < 4200)
+#error "The battery divider ratio cannot measure a full cell (4200 mV) within the 3.6 V full scale"
+#endif
+
+/** @Macro Charger Status Lines (Open-drain, Pulled Up by the Board Initialization) */
+#define BATTERY_STATUS_ACTIVE_STATE													false
+
+/** @Macro Retry of A Reading Taken While An LED was On (Then the Reading Waits for the Next Interval) */
+#define BATTERY_RETRY_MS																		250
+#define BATTERY_RETRY_MAX																		8
+
+/** @Macro The Cell (Single Li-Po Cell) */
+#define BATTERY_CAPACITY_MAH																110
+#define BATTERY_RINT_MOHM																		300
+#define BATTERY_IDLE_LOAD_UA																400
+
+/** @Macro The Lowest Cell Voltage Allowed under the Strongest LED Pulse */
+#define BATTERY_BROWNOUT_MV																	3200
+
+/** @Macro State of Charge Thresholds (in Percent) */
+#define BATTERY_SOC_LOW																			20
+#define BATTERY_SOC_CRITICAL																5
+
+/** @Macro The Estimate Moves by 1/2^N of Its Distance to the Discharge Curve at Each Reading */
+#define BATTERY_SOC_FUSION_SHIFT														3
+
+/** @Macro Full Scale of the State of Charge (0.01% Steps) and the Charge of One Step in Microcoulomb */
+#define BATTERY_SOC_FULL																		10000
+#define BATTERY_SOC_STEP_UC																	((uint32_t)BATTERY_CAPACITY_MAH * 360)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Type Declarations */
+
+/** @Type 	Data Type of the Power State
+	*
+	* @Brief 	battery_mv 			: the battery voltage in millivolts
+	* @Brief 	is_usb_present 	: the USB supply is connected
+	* @Brief 	is_charge_full 	: the charger reports the end of the charge
+	*
+*/
+typedef struct{
+	uint16_t				battery_mv;
+	bool						is_usb_present;
+	bool						is_charge_full;
+}battery_power_t;
+
+/** @Type 	Battery States
+	*
+	* @Brief 	BATTERY_STATE_NORMAL 		: full sampling rate and LED current
+	* @Brief 	BATTERY_STATE_LOW 			: the state of charge is below BATTERY_SOC_LOW
+	* @Brief 	BATTERY_STATE_CRITICAL 	: below BATTERY_SOC_CRITICAL, or the strongest LED pulse would pull the cell below BATTERY_BROWNOUT_MV
+	* @Brief 	BATTERY_STATE_CHARGING 	: the USB supply is connected
+	*
+*/
+typedef enum{
+	BATTERY_STATE_NORMAL,
+	BATTERY_STATE_LOW,
+	BATTERY_STATE_CRITICAL,
+	BATTERY_STATE_CHARGING
+}battery_state_t;
+
+/** @Type 	Data Type of the State of Charge Estimate
+	*
+	* @Brief 	ocv_mv 					: the load-compensated battery voltage in millivolts
+	* @Brief 	pulse_mv 				: the battery voltage expected under the strongest LED pulse
+	* @Brief 	soc 						: the state of charge in 0.01% steps (0 ~ BATTERY_SOC_FULL)
+	* @Brief 	state 					: the battery state
+	*
+*/
+typedef struct{
+	uint16_t				ocv_mv;
+	uint16_t				pulse_mv;
+	uint16_t				soc;
+	battery_state_t	state;
+}battery_soc_t;
+
+/** @Type Function Pointer Type of the State of Charge Handler (Called from the Scheduler after Each Reading) */
+typedef void (* battery_soc_handler_t)(battery_soc_t const *);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func 	Add the Battery Service
+	*
+	* @Brief	This function adds the Battery Service to the GATT table (with notifications). It must be called with the other services.
+	*
+*/
+void batteryServiceInit(void);
+
+/** @Func 	Initialization of the Background Measurement
+	*
+	* @Brief	This function configures the ADC module for the battery channel, starts the measurement timer and the first measurement
+	* @Brief	It must be called after the scheduler is initialized (The battery level is updated from the scheduler)
+	*
+*/
+void batteryMonitorInit(void);
+
+/** @Func 	Pass the BLE Events to the Battery Service
+	*
+	* @Para		p_ble_evt [ble_evt_t*] : the BLE event (from ble_evt_dispatch)
+	*
+*/
+void batteryOnBleEvt(ble_evt_t * p_ble_evt);
+
+/** @Func 	Start One Measurement at Once
+	*
+	* @Brief	The result is published like a periodic one. A call while a measurement is in progress is ignored.
+	*
+*/
+void batteryMeasureStart(void);
+
+/** @Func 	Get the Last Battery Voltage
+	*
+	* @Return	[uint16_t] : the battery voltage in millivolts (0 before the first measurement)
+	*
+*/
+uint16_t batteryGetMillivolts(void);
+
+/** @Func 	Get the Last Battery Level
+	*
+	* @Return	[uint8_t] : the battery level in percent (The initial level until BATTERY_DIVIDER_IS_SET is 1)
+	*
+*/
+uint8_t batteryGetLevel(void);
+
+/** @Func 	Get the Last Power State
+	*
+	* @Para		p_power [battery_power_t*] : the structure to be written into
+	*
+*/
+void batteryGetPower(battery_power_t * p_power);
+
+/** @Func 	Get the Last State of Charge Estimate
+	*
+	* @Para		p_soc [battery_soc_t*] : the structure to be written into
+	*
+*/
+void batteryGetSoc(battery_soc_t * p_soc);
+
+/** @Func 	Configuration of the State of Charge Handler
+	*
+	* @Brief	The handler is called from the scheduler with the new estimate after each valid reading
+	* @Brief	The application throttles the sampling rate and the LED current from there (e.g. sensorLedLevelLimit)
+	* @Brief	The handler is held back (never called) until BATTERY_DIVIDER_IS_SET is 1, as is the level of the Battery Service
+	*
+	* @Para		handler [battery_soc_handler_t] : the handler (or NULL)
+	*
+*/
+void batterySocHandlerConfig(battery_soc_handler_t handler);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Library Header */
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //__APP_BATTERY_H__
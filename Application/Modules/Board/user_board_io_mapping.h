@@ -5,6 +5,7 @@
  * @Macro		-	Button Pin Definitions
  * @Macro		-	UART Pin Definitions
  * @Macro		-	Low Frequency Clock Source(Softdevice)
+ * @Macro		-	Battery Divider Ratio
  *
  * 
 */
@@ -81,6 +82,13 @@ extern "C" {
 #define VBAT_ADC_EN 						PIN_01
 #define VBAT_ADC								PIN_30
 
+/** @Macro Battery Divider on VBAT_ADC (Battery Voltage = Pin Voltage * MUL / DIV)
+	* BATTERY_DIVIDER_IS_SET is set to 1 once MUL/DIV hold the ratio measured on this board (See "app_battery.h")
+*/
+#define BATTERY_DIVIDER_MUL			1
+#define BATTERY_DIVIDER_DIV			1
+#define BATTERY_DIVIDER_IS_SET	0
+
 #define USB_PRESENT_INT					PIN_14
 #define CHARGE_FULL_INT					PIN_15
 #define ENTER_SHIP_MODE					PIN_21
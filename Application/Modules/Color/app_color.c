@@ -0,0 +1,355 @@
+/** Library Name : app_color.c
+	*
+	* @Brief 		Implementation of the on-device colour calibration engine
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <stdlib.h>
+#include "app_color.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro D65 Reference White (Q15.16, 0 ~ 100 Scale) */
+#define COLOR_WHITE_X_Q16																		((int32_t)(95.047 * 65536 + 0.5))
+#define COLOR_WHITE_Y_Q16																		((int32_t)(100.000 * 65536 + 0.5))
+#define COLOR_WHITE_Z_Q16																		((int32_t)(108.883 * 65536 + 0.5))
+
+/** @Macro Minimum Temperature Span of A Drift Fit (0.25 degC Units) */
+#define COLOR_DRIFT_FIT_MIN_SPAN														8					// 2 degC
+
+/** @Macro Constants of the Lab Companding Function (Q15.16) */
+#define COLOR_LAB_EPSILON_Q16																580				// (6/29)^3
+#define COLOR_LAB_OFFSET_Q16																9039			// 4/29
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Packed Fixed-point Calibration Table */
+static color_calib_table_t color_calib_table;
+
+/** @Variable The Stored Records Loaded Flag */
+static bool is_color_calib_loaded = false;
+
+/** @Variable The Table Holds A Valid Calibration Flag (The Stored or the Default Records) */
+static bool is_color_calib_ready 	= false;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Read One Calibration Record (The Default Value is Used if is_default is Set) */
+static bool color_record_get(const uint16_t index, const bool is_default, float * p_value)
+{
+	union data_color_t record;
+
+	if(is_default){
+		*p_value = getColorInfo()[index - COLOR_DATA_START_INDEX].flt;
+		return true;
+	}
+	if(getOneRecord(index, record.byte) != FLASH_STATUS_SUCCESS){
+		return false;
+	}
+	*p_value = record.flt;
+	return true;
+}
+
+/** @Func Convert A Float Number into Fixed-point (Fails if the Value is Out of the Range or Not A Number) */
+static bool color_float_to_q(const float value, const uint8_t q, const float limit, int32_t * p_q)
+{
+	if(!(value > -limit && value < limit)){
+		return false;
+	}
+	*p_q = (int32_t)(value * (float)(1UL << q) + ((value >= 0.0f) ? 0.5f : -0.5f));
+	return true;
+}
+
+/** @Func Build the Calibration Table from the Records */
+static uint8_t color_table_build(const bool is_default, color_calib_table_t * p_table)
+{
+	float factory, gain, grey, coef, divisor;
+
+	// Feature Transfer Coefficients
+	for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+		if(!color_record_get(COLOR_DATA_FACTORY_START_INDEX + i, is_default, &factory) \
+			|| !color_record_get(COLOR_DATA_FACTORY_START_INDEX + COLOR_FEATURE_NUM + i, is_default, &gain) \
+			|| !color_record_get(COLOR_DATA_GREYSCALE_USER_START_INDEX + i, is_default, &grey)){
+			return NRF_ERROR_NOT_FOUND;
+		}
+		if(!(grey > 0.0f) || !color_float_to_q(factory * gain / grey, COLOR_Q_FEATURE_SCALE, 64.0f, &p_table->feature_scale[i])){
+			return NRF_ERROR_INVALID_DATA;
+		}
+	}
+
+	// Regression Matrix and Offsets (The Divisor and the 0 ~ 100 Scale are Folded into the Coefficients)
+	for(uint8_t k = 0; k < COLOR_XYZ_NUM; k++){
+		if(!color_record_get(COLOR_DATA_MOTHER_START_INDEX + 28 + 2 * k, is_default, &divisor)){
+			return NRF_ERROR_NOT_FOUND;
+		}
+		if(divisor == 0.0f){
+			return NRF_ERROR_INVALID_DATA;
+		}
+		for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+			if(!color_record_get(COLOR_DATA_MOTHER_START_INDEX + COLOR_FEATURE_NUM * k + i, is_default, &coef)){
+				return NRF_ERROR_NOT_FOUND;
+			}
+			if(!color_float_to_q(100.0f * coef / divisor, COLOR_Q_MATRIX, 128.0f, &p_table->matrix[k][i])){
+				return NRF_ERROR_INVALID_DATA;
+			}
+		}
+		if(!color_record_get(COLOR_DATA_MOTHER_START_INDEX + 27 + 2 * k, is_default, &coef)){
+			return NRF_ERROR_NOT_FOUND;
+		}
+		if(!color_float_to_q(100.0f * coef / divisor, COLOR_Q_XYZ, 32768.0f, &p_table->offset[k])){
+			return NRF_ERROR_INVALID_DATA;
+		}
+	}
+	
+	// Temperature Drift (The Reference is the User Calibration Temperature, or the Factory One if it Was Never Set)
+	float temp_init, drift, temp_user;
+	if(!color_record_get(COLOR_DATA_TEMP_START_INDEX, is_default, &temp_init) \
+		|| !color_record_get(COLOR_DATA_TEMP_START_INDEX + 1, is_default, &drift) \
+		|| !color_record_get(COLOR_DATA_TEMP_USER_START_INDEX, is_default, &temp_user)){
+		return NRF_ERROR_NOT_FOUND;
+	}
+	int32_t ref_temperature;
+	if(!color_float_to_q(drift, COLOR_Q_DRIFT, 0.1f, &p_table->drift) \
+		|| !color_float_to_q((temp_user != 0.0f) ? temp_user : temp_init, 2, 200.0f, &ref_temperature)){
+		return NRF_ERROR_INVALID_DATA;
+	}
+	p_table->ref_temperature = (int16_t)ref_temperature;
+
+	return NRF_SUCCESS;
+}
+
+/** @Func Sum of the Nine Feature Words of One Sample */
+static uint32_t color_sample_sum(uint8_t const * byte_array, const uint8_t channel_size)
+{
+	uint32_t sum = 0;
+	
+	for(uint8_t channel = 0; channel < 3; channel++){
+		for(uint8_t word = 0; word < 3; word++){
+			uint8_t const * p_word = &byte_array[channel * channel_size + 2 * word];
+			sum += (uint32_t)((p_word[0] << 8) | p_word[1]);
+		}
+	}
+	return sum;
+}
+
+/** @Func Write One Calibration Record */
+static uint8_t color_record_set(const uint16_t index, const float value)
+{
+	union data_color_t record;
+	
+	record.flt = value;
+	if(setOneRecord(index, record.byte) != FLASH_STATUS_SUCCESS){
+		return NRF_ERROR_INTERNAL;
+	}
+	return NRF_SUCCESS;
+}
+
+/** @Func Integer Cube Root of A 64-bit Number (Bitwise Method) */
+static uint32_t color_icbrt(uint64_t x)
+{
+	uint64_t y = 0;
+
+	for(int8_t s = 63; s >= 0; s -= 3){
+		y <<= 1;
+		uint64_t b = 3 * y * (y + 1) + 1;
+		if((x >> s) >= b){
+			x -= b << s;
+			y++;
+		}
+	}
+	return (uint32_t)y;
+}
+
+/** @Func Lab Companding Function f(t) (Q15.16 In and Out) */
+static int32_t color_lab_f(int32_t t)
+{
+	if(t <= COLOR_LAB_EPSILON_Q16){
+		// Linear segment : t / (3 x (6/29)^2) + 4/29
+		return (int32_t)((int64_t)t * 841 / 108) + COLOR_LAB_OFFSET_Q16;
+	}
+	// Cube root segment : cbrt(t x 2^16 x 2^32) = cbrt(t) x 2^16
+	return (int32_t)color_icbrt((uint64_t)t << 32);
+}
+
+/** @Func Ratio of A Tristimulus Value to the Reference White (Q15.16) */
+static int32_t color_white_ratio(const int32_t value, const int32_t white)
+{
+	return (value <= 0) ? 0 : (int32_t)(((int64_t)value << 16) / white);
+}
+
+/** @Func Scale A Q15.16 Value into Hundredths with Rounding and Saturation */
+static int16_t color_q16_to_centi(const int64_t value)
+{
+	int64_t centi = (value * 100 + ((value >= 0) ? 32768 : -32768)) / 65536;
+	return (int16_t)((centi > INT16_MAX) ? INT16_MAX : ((centi < INT16_MIN) ? INT16_MIN : centi));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Load the Calibration Records into the Fixed-point Table */
+uint8_t colorCalibLoad(void)
+{
+	color_calib_table_t table;
+	uint8_t err_code = color_table_build(false, &table);
+
+	// The storage is not available or holds out-of-range records, so fall back to the default records
+	if(err_code != NRF_SUCCESS && color_table_build(true, &table) != NRF_SUCCESS){
+		return NRF_ERROR_INVALID_DATA;
+	}
+
+	CRITICAL_REGION_ENTER();
+	color_calib_table 		= table;
+	is_color_calib_loaded = (err_code == NRF_SUCCESS);
+	is_color_calib_ready	= true;
+	CRITICAL_REGION_EXIT();
+
+	return err_code;
+}
+
+/** @Func Test Whether the Calibration Table Holds the Stored Records */
+bool colorCalibIsLoaded(void)
+{
+	return is_color_calib_loaded;
+}
+
+/** @Func Get the Address of the Calibration Table */
+color_calib_table_t const * colorCalibGetTable(void)
+{
+	return &color_calib_table;
+}
+
+/** @Func Convert One Color Sample into Calibrated XYZ Values */
+uint8_t colorCalibXYZ(uint8_t const * byte_array, const sensor_sample_mode_t mode, const int16_t temperature, color_xyz_t * p_xyz)
+{
+	if(mode == SENSOR_SAMPLE_MODE_AMBIENT){
+		return NRF_ERROR_NOT_SUPPORTED;
+	}
+	if(!is_color_calib_ready){
+		return NRF_ERROR_INVALID_STATE;
+	}
+
+	uint8_t channel_size = sensorSampleDataSize(mode) / 3;
+	int32_t feature[COLOR_FEATURE_NUM];
+	int32_t xyz[COLOR_XYZ_NUM];
+	int64_t compensation = (int64_t)1 << COLOR_Q_FEATURE_SCALE;
+	
+	// Drift Compensation Factor 1 / (1 + drift x dT) (Q15.16, One Division per Sample)
+	if(temperature != SENSOR_TEMPERATURE_INVALID && color_calib_table.drift != 0){
+		int64_t response = ((int64_t)1 << COLOR_Q_DRIFT) \
+										 + (int64_t)color_calib_table.drift * (temperature - color_calib_table.ref_temperature) / 4;
+		if(response > 0){
+			compensation = ((int64_t)1 << (COLOR_Q_DRIFT + COLOR_Q_FEATURE_SCALE)) / response;
+		}
+	}
+
+	// Feature Transfer (16 x 16 bit multiplies, the IR word of each exposure is skipped)
+	for(uint8_t channel = 0; channel < 3; channel++){
+		uint8_t const * p_data = &byte_array[channel * channel_size];
+		for(uint8_t word = 0; word < 3; word++){
+			uint8_t i 	= 3 * channel + word;
+			int32_t raw = (int32_t)((p_data[2 * word] << 8) | p_data[2 * word + 1]);
+			int64_t scale = ((int64_t)color_calib_table.feature_scale[i] * compensation) >> COLOR_Q_FEATURE_SCALE;
+			feature[i] 	= (int32_t)(((int64_t)raw * scale) >> (COLOR_Q_FEATURE_SCALE - COLOR_Q_FEATURE));
+		}
+	}
+
+	// Regression (3 x 9 multiply-accumulate with 64-bit accumulators)
+	for(uint8_t k = 0; k < COLOR_XYZ_NUM; k++){
+		int32_t const * p_row = color_calib_table.matrix[k];
+		int64_t acc = (int64_t)color_calib_table.offset[k] << (COLOR_Q_MATRIX + COLOR_Q_FEATURE - COLOR_Q_XYZ);
+
+		for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+			acc += (int64_t)p_row[i] * feature[i];
+		}
+		acc += (int64_t)1 << (COLOR_Q_MATRIX + COLOR_Q_FEATURE - COLOR_Q_XYZ - 1);
+		xyz[k] = (int32_t)(acc >> (COLOR_Q_MATRIX + COLOR_Q_FEATURE - COLOR_Q_XYZ));
+	}
+
+	p_xyz->X = xyz[0];
+	p_xyz->Y = xyz[1];
+	p_xyz->Z = xyz[2];
+	return NRF_SUCCESS;
+}
+
+/** @Func Convert the XYZ Values into Lab Values */
+void colorCalibLab(color_xyz_t const * p_xyz, color_lab_t * p_lab)
+{
+	int32_t fx = color_lab_f(color_white_ratio(p_xyz->X, COLOR_WHITE_X_Q16));
+	int32_t fy = color_lab_f(color_white_ratio(p_xyz->Y, COLOR_WHITE_Y_Q16));
+	int32_t fz = color_lab_f(color_white_ratio(p_xyz->Z, COLOR_WHITE_Z_Q16));
+
+	p_lab->L = color_q16_to_centi((int64_t)116 * fy - ((int64_t)16 << 16));
+	p_lab->a = color_q16_to_centi((int64_t)500 * (fx - fy));
+	p_lab->b = color_q16_to_centi((int64_t)200 * (fy - fz));
+}
+
+/** @Func Convert One Color Sample into Calibrated Lab Values */
+uint8_t colorCalibSample(uint8_t const * byte_array, const sensor_sample_mode_t mode, const int16_t temperature, color_lab_t * p_lab)
+{
+	color_xyz_t xyz;
+	uint8_t err_code;
+
+	if((err_code = colorCalibXYZ(byte_array, mode, temperature, &xyz)) != NRF_SUCCESS){
+		return err_code;
+	}
+	colorCalibLab(&xyz, p_lab);
+	return NRF_SUCCESS;
+}
+
+/** @Func Fit and Store the Temperature Drift Coefficient from Two White Readings */
+uint8_t colorCalibDriftFit(uint8_t const * white_init, const int16_t temp_init, uint8_t const * white_final, const int16_t temp_final, const sensor_sample_mode_t mode)
+{
+	if(mode == SENSOR_SAMPLE_MODE_AMBIENT || temp_init == SENSOR_TEMPERATURE_INVALID || temp_final == SENSOR_TEMPERATURE_INVALID \
+		|| abs(temp_final - temp_init) < COLOR_DRIFT_FIT_MIN_SPAN){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	uint8_t 	channel_size 	= sensorSampleDataSize(mode) / 3;
+	uint32_t 	sum_init 			= color_sample_sum(white_init, channel_size);
+	uint32_t 	sum_final 		= color_sample_sum(white_final, channel_size);
+	if(sum_init == 0 || sum_final == 0){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	// Relative Response Change per degC (the Temperature Tags are in 0.25 degC Units)
+	float drift = ((float)sum_final / (float)sum_init - 1.0f) * 4.0f / (float)(temp_final - temp_init);
+	if(!(drift > -0.1f && drift < 0.1f)){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	uint8_t err_code;
+	if((err_code = color_record_set(COLOR_DATA_TEMP_START_INDEX, (float)temp_init / 4.0f)) != NRF_SUCCESS \
+		|| (err_code = color_record_set(COLOR_DATA_TEMP_START_INDEX + 1, drift)) != NRF_SUCCESS){
+		return err_code;
+	}
+	return (colorCalibLoad() == NRF_SUCCESS) ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
+}
+
+/** @Func Store the Die Temperature of the Greyscale User Calibration */
+uint8_t colorCalibUserTemperatureSet(const int16_t temperature)
+{
+	if(temperature == SENSOR_TEMPERATURE_INVALID){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	uint8_t err_code;
+	if((err_code = color_record_set(COLOR_DATA_TEMP_USER_START_INDEX, (float)temperature / 4.0f)) != NRF_SUCCESS){
+		return err_code;
+	}
+	return (colorCalibLoad() == NRF_SUCCESS) ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,229 @@
+/** Library Name : app_color.h
+	*
+	* @Brief 		This module implements the on-device colour calibration engine in fixed-point arithmetic
+	* @Brief		The calibration records (FLASH_SECTION_COLORS) are loaded once into a packed RAM table of Q-format coefficients,
+	* @Brief		then every color sample is converted into calibrated CIE XYZ and CIE L*a*b* values without any floating point operation
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Req			This module requires the following modules to be enabled
+	* @Req			- Color Sensor Module								(Included in "app_sensor.h")
+	* @Req			- Storage Module										(Included in "app_storage.h")
+	*
+	* @Note			Calibration model (9 features : the R/G/B readings under the red, green and blue LED exposures in sample order)
+	* @Note			- Feature Transfer : m[i] = raw[i] x FACTORY[i] x FACTORY[9+i] / GREYSCALE_USER[i]
+	* @Note			  (the reading is referred to the white tile of this unit, then mapped onto the mother instrument)
+	* @Note			- XYZ Regression 	 : XYZ[k] = 100 x (sum(MOTHER[9k+i] x m[i]) + MOTHER[27+2k]) / MOTHER[28+2k]
+	* @Note			- Drift Correction : m[i] = m[i] / (1 + TEMP_FINAL x (T - T_ref)) with T the die temperature tag of the sample,
+	* @Note			  T_ref = TEMP_USER (the temperature of the last greyscale user calibration) or TEMP_INIT if it was never set
+	* @Note			  (TEMP_INIT holds the die temperature of the factory white reading, TEMP_FINAL the fitted relative drift per degC)
+	* @Note			- Lab Conversion	 : CIE 1976 L*a*b* under the D65 white point
+	*
+	* @Macro		COLOR_FEATURE_NUM										(Number of Calibration Features of One Sample)
+	* @Macro		COLOR_XYZ_NUM												(Number of Tristimulus Values)
+	* @Macro		COLOR_Q_FEATURE_SCALE								(Fractional Bits of the Feature Transfer Coefficients)
+	* @Macro		COLOR_Q_FEATURE											(Fractional Bits of the Transferred Features)
+	* @Macro		COLOR_Q_MATRIX											(Fractional Bits of the Regression Matrix)
+	* @Macro		COLOR_Q_XYZ													(Fractional Bits of the XYZ Values and the Regression Offsets)
+	* @Macro		COLOR_Q_DRIFT												(Fractional Bits of the Temperature Drift Coefficient)
+	*
+	* @Type			color_calib_table_t									(Data Type of the Packed Fixed-point Calibration Table)
+	* @Type			color_xyz_t													(Data Type of the Calibrated XYZ Values)
+	* @Type			color_lab_t													(Data Type of the Calibrated Lab Values)
+	*
+	* @Func			colorCalibLoad											(Load the Calibration Records into the Fixed-point Table)
+	* @Func			colorCalibIsLoaded									(Test Whether the Calibration Table Holds the Stored Records)
+	* @Func			colorCalibGetTable									(Get the Address of the Calibration Table)
+	* @Func			colorCalibXYZ												(Convert One Color Sample into Calibrated XYZ Values)
+	* @Func			colorCalibLab												(Convert the XYZ Values into Lab Values)
+	* @Func			colorCalibSample										(Convert One Color Sample into Calibrated Lab Values)
+	* @Func			colorCalibDriftFit									(Fit and Store the Temperature Drift Coefficient from Two White Readings)
+	* @Func			colorCalibUserTemperatureSet				(Store the Die Temperature of the Greyscale User Calibration)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __APP_COLOR_H__
+#define __APP_COLOR_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include "app_sensor.h"
+#include "app_storage.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Header */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Calibration Dimensions */
+#define COLOR_FEATURE_NUM																		9
+#define COLOR_XYZ_NUM																				3
+
+/** @Macro Fixed-point Formats (Number of Fractional Bits) */
+#define COLOR_Q_FEATURE_SCALE																16		// Q15.16, transfer coefficients below 64
+#define COLOR_Q_FEATURE																			8			// Q23.8, transferred features
+#define COLOR_Q_MATRIX																			24		// Q7.24, regression coefficients below 128
+#define COLOR_Q_XYZ																					16		// Q15.16, XYZ on the 0 ~ 100 scale
+#define COLOR_Q_DRIFT																				24		// Q7.24, relative drift per degC
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Type Declarations */
+
+/** @Type 	Data Type of the Packed Fixed-point Calibration Table
+	*
+	* @Brief 	feature_scale : the combined transfer coefficient of each feature (Q15.16)
+	* @Brief 	matrix 				: the regression matrix with the normalisation divisor and the 0 ~ 100 scale folded in (Q7.24)
+	* @Brief 	offset 				: the regression offsets with the divisor and the scale folded in (Q15.16)
+	* @Brief 	drift 				: the relative response drift per degC (Q7.24)
+	* @Brief 	ref_temperature : the die temperature the greyscale reference was taken at (0.25 degC units)
+	*
+*/
+typedef struct{
+	int32_t				feature_scale[COLOR_FEATURE_NUM];
+	int32_t				matrix[COLOR_XYZ_NUM][COLOR_FEATURE_NUM];
+	int32_t				offset[COLOR_XYZ_NUM];
+	int32_t				drift;
+	int16_t				ref_temperature;
+}color_calib_table_t;
+
+/** @Type 	Data Type of the Calibrated XYZ Values (Q15.16, 0 ~ 100 Scale) */
+typedef struct{
+	int32_t				X;
+	int32_t				Y;
+	int32_t				Z;
+}color_xyz_t;
+
+/** @Type 	Data Type of the Calibrated Lab Values (in Hundredths, e.g. L = 5321 means L* = 53.21) */
+typedef struct{
+	int16_t				L;
+	int16_t				a;
+	int16_t				b;
+}color_lab_t;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func 	Load the Calibration Records into the Fixed-point Table
+	*
+	* @Brief	This function reads the mother, factory and greyscale user records and converts them into the packed Q-format table
+	* @Brief	The table is built from the default values (data_colors.h) if the records cannot be read
+	* @Brief	or if the coefficients do not fit into the fixed-point formats
+	*
+	* @Return NRF_SUCCESS 							: The table holds the stored records
+	* @Return NRF_ERROR_NOT_FOUND				: The records cannot be read (The table holds the default values)
+	* @Return NRF_ERROR_INVALID_DATA		: The records are out of range (The table holds the default values)
+	*
+*/
+uint8_t colorCalibLoad(void);
+
+/** @Func 	Test Whether the Calibration Table Holds the Stored Records
+	*
+	* @Return true 	[bool] : The table is built from the stored records
+	* @Return	false [bool] : The table is built from the default values
+	*
+*/
+bool colorCalibIsLoaded(void);
+
+/** @Func 	Get the Address of the Calibration Table
+	*
+	* @Return [color_calib_table_t*] : the address of the internal calibration table
+	*
+*/
+color_calib_table_t const * colorCalibGetTable(void);
+
+/** @Func 	Convert One Color Sample into Calibrated XYZ Values
+	*
+	* @Para		byte_array 	[uint8_t*] 							: the sample data read in the specified mode
+	* @Para		mode 				[sensor_sample_mode_t] 	: the sampling mode of the sample data
+	* @Para		temperature [int16_t]								: the die temperature tag of the sample (SENSOR_TEMPERATURE_INVALID skips the drift correction)
+	* @Para		p_xyz 			[color_xyz_t*] 					: the XYZ values to be written into
+	*
+	* @Return NRF_SUCCESS 							: The operation succeeded
+	* @Return NRF_ERROR_NOT_SUPPORTED		: The sample has no LED exposures (Ambient mode)
+	* @Return NRF_ERROR_INVALID_STATE		: No calibration table is loaded yet (colorCalibLoad)
+	*
+*/
+uint8_t colorCalibXYZ(uint8_t const * byte_array, const sensor_sample_mode_t mode, const int16_t temperature, color_xyz_t * p_xyz);
+
+/** @Func 	Convert the XYZ Values into Lab Values
+	*
+	* @Para		p_xyz 			[color_xyz_t*] 	: the calibrated XYZ values
+	* @Para		p_lab 			[color_lab_t*] 	: the Lab values to be written into
+	*
+*/
+void colorCalibLab(color_xyz_t const * p_xyz, color_lab_t * p_lab);
+
+/** @Func 	Convert One Color Sample into Calibrated Lab Values
+	*
+	* @Brief	This function combines colorCalibXYZ and colorCalibLab (The Lab values are 6 bytes to be sent instead of the raw sample)
+	*
+	* @Para		byte_array 	[uint8_t*] 							: the sample data read in the specified mode
+	* @Para		mode 				[sensor_sample_mode_t] 	: the sampling mode of the sample data
+	* @Para		temperature [int16_t]								: the die temperature tag of the sample (SENSOR_TEMPERATURE_INVALID skips the drift correction)
+	* @Para		p_lab 			[color_lab_t*] 					: the Lab values to be written into
+	*
+	* @Return NRF_SUCCESS 							: The operation succeeded
+	* @Return NRF_ERROR_NOT_SUPPORTED		: The sample has no LED exposures (Ambient mode)
+	* @Return NRF_ERROR_INVALID_STATE		: No calibration table is loaded yet (colorCalibLoad)
+	*
+*/
+uint8_t colorCalibSample(uint8_t const * byte_array, const sensor_sample_mode_t mode, const int16_t temperature, color_lab_t * p_lab);
+
+/** @Func 	Fit and Store the Temperature Drift Coefficient from Two White Readings
+	*
+	* @Brief	The white tile is sampled once when the LEDs are cold and once after they have warmed up
+	* @Brief	The relative change of the summed response per degC is stored in TEMP_FINAL and the cold temperature in TEMP_INIT,
+	* @Brief	then the calibration table is reloaded
+	*
+	* @Para		white_init 	[uint8_t*] 							: the white sample taken at the initial temperature
+	* @Para		temp_init 	[int16_t] 							: the die temperature tag of the initial sample (0.25 degC units)
+	* @Para		white_final [uint8_t*] 							: the white sample taken at the final temperature
+	* @Para		temp_final 	[int16_t] 							: the die temperature tag of the final sample (0.25 degC units)
+	* @Para		mode 				[sensor_sample_mode_t] 	: the sampling mode of both samples
+	*
+	* @Return NRF_SUCCESS 							: The coefficient is stored and loaded
+	* @Return NRF_ERROR_INVALID_PARAM		: The samples are not usable (Ambient mode, invalid or too close temperatures, zero readings)
+	* @Return NRF_ERROR_INTERNAL				: The records cannot be written
+	*
+*/
+uint8_t colorCalibDriftFit(uint8_t const * white_init, const int16_t temp_init, uint8_t const * white_final, const int16_t temp_final, const sensor_sample_mode_t mode);
+
+/** @Func 	Store the Die Temperature of the Greyscale User Calibration
+	*
+	* @Brief	This function must be called with the temperature tag of the white sample whenever the greyscale user records are rewritten
+	*
+	* @Para		temperature [int16_t] : the die temperature tag of the white sample (0.25 degC units)
+	*
+	* @Return NRF_SUCCESS 							: The temperature is stored and loaded
+	* @Return NRF_ERROR_INVALID_PARAM		: The temperature is invalid
+	* @Return NRF_ERROR_INTERNAL				: The record cannot be written
+	*
+*/
+uint8_t colorCalibUserTemperatureSet(const int16_t temperature);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Library Header */
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //__APP_COLOR_H__
@@ -12,7 +12,7 @@
 #include "data_colors.h"
 
 /** @Variable Default Values in This Color Data Set */
-const static union data_color_t default_colors[COLOR_DATA_TOTAL_NUM] =
+const union data_color_t default_colors[COLOR_DATA_TOTAL_NUM] =
 {
 	// Color Mother
 	COLOR_DATA_MOTHER_0_DEFAULT,
@@ -166,6 +166,9 @@ union data_color_t{
 */
 const union data_color_t* getColorInfo(void);
 
+/** @Variable Default Values (Referenced by the Record Table of the Storage Module) */
+extern const union data_color_t default_colors[COLOR_DATA_TOTAL_NUM];
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #ifdef __cplusplus
 }
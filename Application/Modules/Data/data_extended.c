@@ -22,9 +22,9 @@ const static uint8_t default_man_size[EXT_DATA_MAN_NUM]=
 };
 
 // Default Data Values in Each Data Type
-const static uint8_t default_man_unitn[EXT_DATA_MAN_UNITN_SIZE_BYTE]={0x00};
-const static uint8_t default_man_calibt[EXT_DATA_MAN_CALIBT_SIZE_BYTE]={0x00};
-const static uint8_t default_man_unitt[EXT_DATA_MAN_UNITT_SIZE_BYTE]={0x00};
+const uint8_t default_man_unitn[EXT_DATA_MAN_UNITN_SIZE_BYTE]={0x00};
+const uint8_t default_man_calibt[EXT_DATA_MAN_CALIBT_SIZE_BYTE]={0x00};
+const uint8_t default_man_unitt[EXT_DATA_MAN_UNITT_SIZE_BYTE]={0x00};
 
 // The pointer array to store the default values of the manufacturer data set
 const static uint8_t * default_man[EXT_DATA_MAN_NUM]=
@@ -41,7 +41,7 @@ const static uint8_t default_usr_size[EXT_DATA_USER_NUM]=
 };
 
 // Default Data Values in Each Data Type
-const static uint8_t default_usr_fcdt[EXT_DATA_USER_FCDT_SIZE_BYTE]={0x00};
+const uint8_t default_usr_fcdt[EXT_DATA_USER_FCDT_SIZE_BYTE]={0x00};
 
 // The pointer array to store the default values of the user data set
 const static uint8_t * default_usr[EXT_DATA_USER_NUM]=
@@ -65,16 +65,16 @@ const static uint8_t default_reserved_size[EXT_DATA_RESERVED_NUM]=
 };
 
 // Default Data Values in Each Data Type
-const static uint8_t default_reserved_1[EXT_DATA_RESERVED_1_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_2[EXT_DATA_RESERVED_2_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_3[EXT_DATA_RESERVED_3_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_4[EXT_DATA_RESERVED_4_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_5[EXT_DATA_RESERVED_5_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_6[EXT_DATA_RESERVED_6_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_7[EXT_DATA_RESERVED_7_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_8[EXT_DATA_RESERVED_8_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_9[EXT_DATA_RESERVED_9_SIZE_BYTE]={0x00};
-const static uint8_t default_reserved_10[EXT_DATA_RESERVED_10_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_1[EXT_DATA_RESERVED_1_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_2[EXT_DATA_RESERVED_2_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_3[EXT_DATA_RESERVED_3_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_4[EXT_DATA_RESERVED_4_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_5[EXT_DATA_RESERVED_5_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_6[EXT_DATA_RESERVED_6_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_7[EXT_DATA_RESERVED_7_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_8[EXT_DATA_RESERVED_8_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_9[EXT_DATA_RESERVED_9_SIZE_BYTE]={0x00};
+const uint8_t default_reserved_10[EXT_DATA_RESERVED_10_SIZE_BYTE]={0x00};
 
 // The pointer array to store the default values of the user data set
 const static uint8_t * default_reserved[EXT_DATA_RESERVED_NUM]=
@@ -73,6 +73,22 @@ const uint8_t ** 	getUsrInfo(void);
 const uint8_t *   getReservedSizeInfo(void);
 const uint8_t **  getReservedInfo(void);
 
+/** @Variable Default Values (Referenced by the Record Table of the Storage Module) */
+extern const uint8_t default_man_unitn[EXT_DATA_MAN_UNITN_SIZE_BYTE];
+extern const uint8_t default_man_calibt[EXT_DATA_MAN_CALIBT_SIZE_BYTE];
+extern const uint8_t default_man_unitt[EXT_DATA_MAN_UNITT_SIZE_BYTE];
+extern const uint8_t default_usr_fcdt[EXT_DATA_USER_FCDT_SIZE_BYTE];
+extern const uint8_t default_reserved_1[EXT_DATA_RESERVED_1_SIZE_BYTE];
+extern const uint8_t default_reserved_2[EXT_DATA_RESERVED_2_SIZE_BYTE];
+extern const uint8_t default_reserved_3[EXT_DATA_RESERVED_3_SIZE_BYTE];
+extern const uint8_t default_reserved_4[EXT_DATA_RESERVED_4_SIZE_BYTE];
+extern const uint8_t default_reserved_5[EXT_DATA_RESERVED_5_SIZE_BYTE];
+extern const uint8_t default_reserved_6[EXT_DATA_RESERVED_6_SIZE_BYTE];
+extern const uint8_t default_reserved_7[EXT_DATA_RESERVED_7_SIZE_BYTE];
+extern const uint8_t default_reserved_8[EXT_DATA_RESERVED_8_SIZE_BYTE];
+extern const uint8_t default_reserved_9[EXT_DATA_RESERVED_9_SIZE_BYTE];
+extern const uint8_t default_reserved_10[EXT_DATA_RESERVED_10_SIZE_BYTE];
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #ifdef __cplusplus
 }
@@ -71,9 +71,14 @@
 #include "app_board.h"
 #include "app_board_btn_ble.h"
 #include "app_sensor.h"
+#include "app_sensor_stream.h"
+#include "app_color.h"
 #include "app_storage.h"
+#include "app_storage_health.h"
 #include "app_uart_comm.h"
 #include "app_adc.h"
+#include "app_battery.h"
+#include "app_trace.h"
 
 //#include "p1234701ct.h"
 
@@ -91,7 +96,7 @@
 /** @Macro Value of the RTC1 PRESCALER register */
 #define APP_TIMER_PRESCALER             														0
 /** @Macro Size of timer operation queues */
-#define APP_TIMER_OP_QUEUE_SIZE         														4
+#define APP_TIMER_OP_QUEUE_SIZE         														8
 
 /* GAP Parameters */
 /** @Macro Minimum acceptable connection interval (0.1 seconds) */
@@ -138,7 +143,7 @@
 #define APP_ADV_TIMEOUT_IN_SECONDS      														180
 
 /* Scheduler Parameters */
-#define SCHED_MAX_EVENT_DATA_SIZE																		8
+#define SCHED_MAX_EVENT_DATA_SIZE																		12				//The largest event is the sample ready event (sensor_sample_evt_t)
 #define SCHED_QUEUE_SIZE																						16
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -127,8 +127,8 @@
 
 /* Color Sensor Settings */
 
-/** @Macro Post Sample Waiting Time Margin */
-#define POST_SAMPLE_WAIT_TIME_MARGIN  											1.2		//1.05 some zero-readings
+/** @Macro Post Sample Waiting Time Margin (in percent of the integration time) */
+#define POST_SAMPLE_WAIT_TIME_MARGIN_PERCENT								105		//Zero-readings are detected and retried by the oversampling layer
 
 /* LED Current Settings */
 
@@ -173,9 +173,74 @@
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/* Auto-exposure Settings */
+
+/** @Macro Target Window of the Own Colour Reading of Each LED Exposure */
+#define SENSOR_AE_TARGET																		32768
+#define SENSOR_AE_TARGET_LOW																16384
+#define SENSOR_AE_TARGET_HIGH																49152
+
+/** @Macro Readings at or above this Level are Treated as Saturated */
+#define SENSOR_AE_SATURATION_LEVEL													65000
+
+/** @Macro Limits of the Integration Time of One Channel (in microsecond) */
+#define SENSOR_AE_MIN_EXPOSURE_US														320				//32us X 10
+#define SENSOR_AE_MAX_EXPOSURE_US														75000			//A dark target is not worth more than 4 X 75ms X 1.05 = 315ms per channel (POST_SAMPLE_WAIT_TIME_MARGIN_PERCENT)
+
+/** @Macro Ratio between the High and the Low Gain */
+#define SENSOR_AE_GAIN_RATIO																10
+
+/** @Macro Limits of the LED Current Levels (0 ~ 15, one step of the LED current bits) */
+#define SENSOR_AE_LED_LEVEL_MIN															1
+#define SENSOR_AE_LED_LEVEL_MAX															15
+
+/** @Macro Drive Current of One LED Current Level (in microampere, One Tenth in the One-Tenth Mode of LED_ON_COMMAND) */
+#define SENSOR_LED_LEVEL_CURRENT_UA													((LED_ON_COMMAND & SENSOR_LED_ONE_TENTH_MODE_ONE_TENTH)?800:8000)
+
+/** @Macro The Prescaler of the App Timer Counter Timing the LEDs */
+#define SENSOR_LED_TIMER_PRESCALER													0			// Must be the same as APP_TIMER_PRESCALER
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Macro Sensor Data Sizes (in bytes) */
+#define SENSOR_CHANNEL_DATA_SIZE														6			// R/G/B data bytes read per LED exposure
+#define SENSOR_CHANNEL_FULL_DATA_SIZE												8			// R/G/B/IR data bytes read per exposure
+#define SENSOR_COLOR_DATA_SIZE															18		// Data bytes of one color sample (three channels)
+#define SENSOR_COLOR_FULL_DATA_SIZE													24		// Data bytes of one color sample with the IR channel
+#define SENSOR_SAMPLE_MAX_DATA_SIZE													SENSOR_COLOR_FULL_DATA_SIZE
+
+/** @Macro Oversampling Settings */
+#define SENSOR_OVERSAMPLE_MAX																8			// Maximum number of exposures per channel
+#define SENSOR_OVERSAMPLE_DEFAULT														1			// Exposures per channel after reset
+#define SENSOR_EXPOSURE_MAX_RETRY														2			// Retries of a zero-reading exposure per channel
+
+/** @Macro Sample Quality Score Penalties (The Score Starts at SENSOR_QUALITY_MAX) */
+#define SENSOR_QUALITY_MAX																	100
+#define SENSOR_QUALITY_RETRY_PENALTY												10		// Per retried exposure
+#define SENSOR_QUALITY_ZERO_PENALTY													50		// A zero-reading was kept after the retries
+#define SENSOR_QUALITY_SATURATION_PENALTY										40		// A word reached SENSOR_AE_SATURATION_LEVEL
+#define SENSOR_QUALITY_SPREAD_PENALTY_MAX										30		// The spread of the exposures in percent of the result, up to this limit
+
+/** @Macro Die Temperature Tag of A Sample without Any Valid Temperature Reading (0.25 degC Units) */
+#define SENSOR_TEMPERATURE_INVALID													INT16_MIN
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Macro Streaming Mode Settings */
+#define SENSOR_STREAM_QUEUE_SIZE														16		// Number of timestamped samples held in the ring
+#define SENSOR_STREAM_MAX_RATE															10		// Maximum streaming rate (samples per second)
+#define SENSOR_STREAM_PENDING_NUM														2			// Samples in flight or waiting for the scheduler to push them (double buffer)
+#define SENSOR_STREAM_TIMER_PRESCALER												0			// Must be the same as APP_TIMER_PRESCALER
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /** @Macro TWI Transaction Manager Queue Size */
 #define MAX_TWI_QUEUE_SIZE																 5
 
+/** @Macro Chained Sensor Transaction Sizes */
+#define SENSOR_TWI_MAX_TRANSFERS													 6			// Channel start sequence needs 4 transfers, burst read + stop sequence needs 4
+#define SENSOR_TWI_BUFFER_SIZE														 16			// Register addresses and written bytes of one transaction
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #endif //__DATA_SENSOR_CONFIG_H__
@@ -25,23 +25,23 @@ extern "C" {
 /** @Variable Default Values of Device Information */
 	
 // 32 bits (4 bytes)
-const static uint8_t default_devinfo_vmi[SET_DATA_DEVINFO_VMI_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_vmi[SET_DATA_DEVINFO_VMI_SIZE_BYTE]={0x00};
 // 64 bits (8 bytes)
-const static uint8_t default_devinfo_sn[SET_DATA_DEVINFO_SN_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_sn[SET_DATA_DEVINFO_SN_SIZE_BYTE]={0x00};
 // 48 bits (6 bytes)
-const static uint8_t default_devinfo_mac[SET_DATA_DEVINFO_MAC_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_mac[SET_DATA_DEVINFO_MAC_SIZE_BYTE]={0x00};
 // 64 bits (8 bytes)
-const static uint8_t default_devinfo_name[SET_DATA_DEVINFO_NAME_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_name[SET_DATA_DEVINFO_NAME_SIZE_BYTE]={0x00};
 // 64 bits (8 bytes)
-const static uint8_t default_devinfo_modn[SET_DATA_DEVINFO_MODN_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_modn[SET_DATA_DEVINFO_MODN_SIZE_BYTE]={0x00};
 // 64 bits (8 bytes)
-const static uint8_t default_devinfo_mann[SET_DATA_DEVINFO_MANN_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_mann[SET_DATA_DEVINFO_MANN_SIZE_BYTE]={0x00};
 // 64 bits (8 bytes)
-const static uint8_t default_devinfo_hr[SET_DATA_DEVINFO_HR_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_hr[SET_DATA_DEVINFO_HR_SIZE_BYTE]={0x00};
 // 64 bits (8 bytes)
-const static uint8_t default_devinfo_fr[SET_DATA_DEVINFO_FR_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_fr[SET_DATA_DEVINFO_FR_SIZE_BYTE]={0x00};
 // 160 bits (40 bytes)
-const static uint8_t default_devinfo_fcdt[SET_DATA_DEVINFO_FCDT_SIZE_BYTE]={0x00};
+const uint8_t default_devinfo_fcdt[SET_DATA_DEVINFO_FCDT_SIZE_BYTE]={0x00};
 
 /** @Variable Organise the above arrays into a pointer array */
 const static uint8_t * default_devinfo[SET_DATA_DEVINFO_NUM]=
@@ -72,7 +72,7 @@ const static uint8_t default_devinfo_size[SET_DATA_NUM]=
 };
 
 /** @Variable Default Values of 4-byte Settings Data */
-const static union data_set_t default_oneword_settings[SET_DATA_ONE_WORD_NUM]=
+const union data_set_t default_oneword_settings[SET_DATA_ONE_WORD_NUM]=
 {
 	// DFU System Information
 	SET_DATA_DFU_APPVER_DEFAULT,
@@ -36,6 +36,21 @@
 #define SET_DATA_SENR_END_INDEX					 	29
 #define SET_DATA_SENR_NUM								 	SET_DATA_SENR_END_INDEX-SET_DATA_SENR_START_INDEX+1
 
+#define SET_DATA_SYS_MEM_INDEX				 		17
+#define SET_DATA_SYS_CALIB_INDEX				 	18
+#define SET_DATA_SYS_POWNUM_INDEX				 	19
+#define SET_DATA_SYS_CHRNUM_INDEX				 	20
+
+#define SET_DATA_SENR_GSEL_INDEX				 	21
+#define SET_DATA_SENR_INTMOD_INDEX				22
+#define SET_DATA_SENR_INTSET_INDEX				23
+#define SET_DATA_SENR_MANT_INDEX				 	24
+#define SET_DATA_SENR_DCMOD_INDEX				 	25
+#define SET_DATA_SENR_OTMOD_INDEX				 	26
+#define SET_DATA_SENR_RLEDCUR_INDEX				27
+#define SET_DATA_SENR_GLEDCUR_INDEX				28
+#define SET_DATA_SENR_BLEDCUR_INDEX				29
+
 #define SET_DATA_NUM										  SET_DATA_DEVINFO_NUM \
 																				+ SET_DATA_DFU_NUM \
 																				+ SET_DATA_DEVSET_NUM \
@@ -83,15 +98,15 @@
 #define SET_DATA_SYS_POWNUM_DEFAULT			 0x00000000
 #define SET_DATA_SYS_CHRNUM_DEFAULT			 0x00000000
 //Color Sensor Settings
-#define SET_DATA_SENR_GSEL_DEFAULT			 0x00000000
-#define SET_DATA_SENR_INTMOD_DEFAULT		 0x00000000
-#define SET_DATA_SENR_INTSET_DEFAULT		 0x00000000
-#define SET_DATA_SENR_MANT_DEFAULT			 0x00000000
-#define SET_DATA_SENR_DCMOD_DEFAULT			 0x00000000
-#define SET_DATA_SENR_OTMOD_DEFAULT			 0x00000000
-#define SET_DATA_SENR_RLEDCUR_DEFAULT		 0x00000000
-#define SET_DATA_SENR_GLEDCUR_DEFAULT		 0x00000000
-#define SET_DATA_SENR_BLEDCUR_DEFAULT	   0x00000000
+#define SET_DATA_SENR_GSEL_DEFAULT			 0x00000008		//Low gain
+#define SET_DATA_SENR_INTMOD_DEFAULT		 0x00000004		//Manual timing mode
+#define SET_DATA_SENR_INTSET_DEFAULT		 0x00000000		//32us
+#define SET_DATA_SENR_MANT_DEFAULT			 0x0000074B		//1875 X 32us = 60ms
+#define SET_DATA_SENR_DCMOD_DEFAULT			 0x00000020		//DC mode
+#define SET_DATA_SENR_OTMOD_DEFAULT			 0x00000010		//One tenth mode
+#define SET_DATA_SENR_RLEDCUR_DEFAULT		 0x0000000C
+#define SET_DATA_SENR_GLEDCUR_DEFAULT		 0x000000F0
+#define SET_DATA_SENR_BLEDCUR_DEFAULT	   0x00000003
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -124,4 +139,16 @@ const uint8_t ** getDevInfo(void);
 // Get the default value array of the 32-bit settings data
 const union data_set_t * getOwSetInfo(void);
 
+/* Default Values (Referenced by the Record Table of the Storage Module) */
+extern const uint8_t default_devinfo_vmi[SET_DATA_DEVINFO_VMI_SIZE_BYTE];
+extern const uint8_t default_devinfo_sn[SET_DATA_DEVINFO_SN_SIZE_BYTE];
+extern const uint8_t default_devinfo_mac[SET_DATA_DEVINFO_MAC_SIZE_BYTE];
+extern const uint8_t default_devinfo_name[SET_DATA_DEVINFO_NAME_SIZE_BYTE];
+extern const uint8_t default_devinfo_modn[SET_DATA_DEVINFO_MODN_SIZE_BYTE];
+extern const uint8_t default_devinfo_mann[SET_DATA_DEVINFO_MANN_SIZE_BYTE];
+extern const uint8_t default_devinfo_hr[SET_DATA_DEVINFO_HR_SIZE_BYTE];
+extern const uint8_t default_devinfo_fr[SET_DATA_DEVINFO_FR_SIZE_BYTE];
+extern const uint8_t default_devinfo_fcdt[SET_DATA_DEVINFO_FCDT_SIZE_BYTE];
+extern const union data_set_t default_oneword_settings[SET_DATA_ONE_WORD_NUM];
+
 #endif //__SET_DATATINGS_H__
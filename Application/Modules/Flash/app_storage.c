@@ -7,10 +7,12 @@
 	*******************************************************************************************************************************
 	* This file includes four layers of functions:
 	* Basic Utilities (mapIndexToRecID,calWordsSize,bytes2words,words2bytes)-Essential uitility functions used in this library.
-	* First Layer (setByteArray,getByteArray,delByteArray)-Interface of the FDS driver layer
-	* Second Layer (setOneByteArrayData,getOneByteArrayData)-Add the status tag in each record
+	* First Layer (setWordArray,setByteArray,getByteArray,delByteArray)-Interface of the FDS driver layer
+	* Second Layer (setOneByteArrayData,getOneByteArrayData,getOneRecordTag)-Add the status tag in each record
 	* Third Layer (getDataSection,getOneRecordStatus,initOneRecord,setOneRecord,getOneRecord,delOneRecord)-Basic application functions
 	* Fourth Layer (initAllRecords)- Application-oriented functions
+	* Fifth Layer (loadRecordCache,flushRecordCache,flushRecordCacheOnGC)- RAM shadow of all records with background write-back
+	* Sixth Layer (setOneRecordAsync,delOneRecordAsync)- Record changes with a request handle and a completion handler
 	********************************************************************************************************************************
 	* Note: 1.Before using this module, initialization of the FDS system is required (Using the fdsInit function in "drv_storage.h").
 	* 			 2.The FDS system needs some configuration. The configuration can be set in "sdk_config.h" file or include a separate "fds_config.h" file.
@@ -18,102 +20,338 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #include "app_storage.h"
-#include <stdlib.h>
+#include "app_storage_health.h"
+#include <string.h>
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-//Essential Bricks: Utility Functions////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Internal Variables and Functions */
 
-/** @Func Byte Array to Word Array Conversion */
-uint8_t	bytes2words(const uint8_t bytes_size, const uint8_t* const bytes_array, uint32_t* words_array)
+/** @Variable Word-aligned Scratch Words for Records that Need Padding (The Storage Functions are Called from the Main Context Only) */
+static uint32_t	flash_scratch[FLASH_SCRATCH_WORDS];
+
+
+/** @Variable The RAM Shadow (One Word-aligned Slot per Record Holding the Tag and the Payload) */
+static uint32_t	flash_cache_data[FLASH_CACHE_DATA_WORDS];
+static uint16_t	flash_cache_offset[FLASH_CACHE_RECORD_NUM];		// Slot offset in words
+static uint8_t	flash_cache_size[FLASH_CACHE_RECORD_NUM];			// Payload size in bytes (without the tag)
+static uint16_t	flash_cache_file_id[FLASH_CACHE_RECORD_NUM];
+
+/** @Variable The Changed Records Waiting to Be Written Back (One Bit per Record) */
+static uint32_t	flash_cache_dirty[CAL_WORD_ARRAY_SIZE(FLASH_CACHE_RECORD_NUM,32)];
+
+/** @Variable The Records Being Written Back (Queued into FDS, One Bit per Record) */
+static uint32_t	flash_cache_busy[CAL_WORD_ARRAY_SIZE(FLASH_CACHE_RECORD_NUM,32)];
+
+/** @Variable The Write-back Scheduler Event is Queued (At Most One in the Scheduler Queue) */
+static bool 		is_flash_cache_flush_posted					= false;
+
+/** @Variable The Write-back Waits for the Garbage Collection Requested from the Storage Health Module (Flash Full) */
+static bool 		is_flash_cache_gc_waiting						= false;
+
+/** @Variable The Requests Waiting for Their Records to Be Written Back */
+static flash_request_t	flash_requests[FLASH_REQUEST_NUM];
+static uint16_t					flash_request_next_handle		= FLASH_REQUEST_HANDLE_INVALID;
+
+/** @Variable The Write-back Timer (Started by the First Change, then Re-armed until the Records Stay Unchanged for the Flush Delay) */
+APP_TIMER_DEF(flash_cache_timer_id);
+static uint32_t	flash_cache_change_ticks						= 0;
+static bool 		is_flash_cache_timer_running				= false;
+
+/** @Variable The Packed Color Blocks (First Index and Number of Entries) */
+static const uint8_t	flash_color_block_start[FLASH_COLOR_BLOCK_NUM]	=	{	COLOR_DATA_MOTHER_START_INDEX, COLOR_DATA_FACTORY_START_INDEX, COLOR_DATA_GREYSCALE_FACTORY_START_INDEX,
+																																				COLOR_DATA_TEMP_START_INDEX, COLOR_DATA_GREYSCALE_USER_START_INDEX, COLOR_DATA_TEMP_USER_START_INDEX };
+static const uint8_t	flash_color_block_count[FLASH_COLOR_BLOCK_NUM]	=	{	COLOR_DATA_MOTHER_NUM, COLOR_DATA_FACTORY_NUM, COLOR_DATA_GREYSCALE_FACTORY_NUM,
+																																				COLOR_DATA_TEMP_NUM, COLOR_DATA_GREYSCALE_USER_NUM, COLOR_DATA_TEMP_USER_NUM };
+
+/** @Variable The Packed Color Record Images (Written by FDS in Place, so A Block is Not Packed Again while Its Write is in Flight) */
+static uint32_t	flash_color_image_data[FLASH_COLOR_IMAGE_DATA_WORDS];
+
+/** @Variable The Block Record Keys Must Stay between the Last Record and the End of the Record Index Window */
+STATIC_ASSERT(FLASH_COLOR_BLOCK_REC_INDEX(0) > FLASH_CACHE_RECORD_NUM);
+STATIC_ASSERT(MAP_INDEX_TO_REC_ID(FLASH_COLOR_BLOCK_REC_INDEX(FLASH_COLOR_BLOCK_NUM)) <= FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM);
+
+/** @Variable The Open Transaction (The Commit Marker Image Holds the Staged Indexes after Its Header Word) */
+static uint32_t	flash_transaction_marker[FLASH_TRANSACTION_MARKER_WORDS];
+static uint16_t	flash_transaction_count							= 0;
+static bool 		is_flash_transaction_open						= false;
+static bool 		is_flash_transaction_committed			= false;		// The marker is in the flash, the records are not all written yet
+
+/** @Variable The Staged Records Must Stay outside the Record Index Window, and the Marker Must Be Read in One Byte-array */
+STATIC_ASSERT(MAP_INDEX_TO_REC_ID(FLASH_TRANSACTION_MARKER_INDEX) >= FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM);
+STATIC_ASSERT(FLASH_TRANSACTION_MARKER_WORDS * sizeof(uint32_t) <= UINT8_MAX);
+
+/** @Variable The Schema Record Image (The Payload Sizes Follow the Header Word) */
+static uint32_t	flash_schema_image[FLASH_SCHEMA_REC_WORDS];
+
+/** @Variable The Schema Record Must Stay after the Packed Color Blocks, and Be Read in One Byte-array */
+STATIC_ASSERT(FLASH_SCHEMA_REC_INDEX >= FLASH_COLOR_BLOCK_REC_INDEX(FLASH_COLOR_BLOCK_NUM));
+STATIC_ASSERT(MAP_INDEX_TO_REC_ID(FLASH_SCHEMA_REC_INDEX) < FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM);
+STATIC_ASSERT(FLASH_SCHEMA_REC_WORDS * sizeof(uint32_t) <= UINT8_MAX);
+
+/** @Func Scheduler Event Handler Queueing the Changed Records (Defined in the Fifth Layer) */
+static void flash_cache_flush_handler(void *p_event_data, uint16_t event_size);
+
+/** @Macro Rows of the Record Table (Each Row is Placed at Its Index, A Missing Index is Out of Range) */
+#define FLASH_RECORD(I,FILE_ID,SECTION,SIZE,DEFAULT)		[I] = { (DEFAULT), (FILE_ID), (SIZE), (SECTION) }
+#define FLASH_RECORD_SETTINGS(I,SECTION,SIZE,DEFAULT)		FLASH_RECORD(I,FLASH_FILEID_SETTINGS,SECTION,SIZE,DEFAULT)
+#define FLASH_RECORD_ONE_WORD(I,SECTION)								FLASH_RECORD(I,FLASH_FILEID_SETTINGS,SECTION,4,default_oneword_settings[(I)-SET_DATA_ONE_WORD_START_INDEX].byte)
+#define FLASH_RECORD_COLOR(I)														FLASH_RECORD(I,FLASH_FILEID_COLOR,FLASH_SECTION_COLORS,FLASH_COLOR_VALUE_SIZE_BYTE,default_colors[(I)-COLOR_DATA_START_INDEX].byte)
+#define FLASH_RECORD_EXTENDED(I,SECTION,SIZE,DEFAULT)		FLASH_RECORD(I,FLASH_FILEID_EXTENDED,SECTION,SIZE,DEFAULT)
+
+/** @Variable The Record Table (File ID, Payload Size, Default Value and Data Section of Each Index, Built from the Data File Macros) */
+static const flash_record_desc_t	flash_records[FLASH_RECORD_NUM+1]	=	{
+	// Settings File: Device Information
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+0,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_VMI_SIZE_BYTE,	default_devinfo_vmi),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+1,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_SN_SIZE_BYTE,	default_devinfo_sn),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+2,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_MAC_SIZE_BYTE,	default_devinfo_mac),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+3,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_NAME_SIZE_BYTE,	default_devinfo_name),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+4,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_MODN_SIZE_BYTE,	default_devinfo_modn),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+5,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_MANN_SIZE_BYTE,	default_devinfo_mann),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+6,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_HR_SIZE_BYTE,	default_devinfo_hr),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+7,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_FR_SIZE_BYTE,	default_devinfo_fr),
+	FLASH_RECORD_SETTINGS(SET_DATA_DEVINFO_START_INDEX+8,	FLASH_SECTION_DEVICE_INFO,	SET_DATA_DEVINFO_FCDT_SIZE_BYTE,	default_devinfo_fcdt),
+	// Settings File: DFU Information
+	FLASH_RECORD_ONE_WORD(SET_DATA_DFU_START_INDEX+0,	FLASH_SECTION_DFU_INFO),
+	FLASH_RECORD_ONE_WORD(SET_DATA_DFU_START_INDEX+1,	FLASH_SECTION_DFU_INFO),
+	FLASH_RECORD_ONE_WORD(SET_DATA_DFU_START_INDEX+2,	FLASH_SECTION_DFU_INFO),
+	FLASH_RECORD_ONE_WORD(SET_DATA_DFU_START_INDEX+3,	FLASH_SECTION_DFU_INFO),
+	// Settings File: Device Settings
+	FLASH_RECORD_ONE_WORD(SET_DATA_DEVSET_START_INDEX+0,	FLASH_SECTION_DEVICE_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_DEVSET_START_INDEX+1,	FLASH_SECTION_DEVICE_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_DEVSET_START_INDEX+2,	FLASH_SECTION_DEVICE_SETTINGS),
+	// Settings File: System Status
+	FLASH_RECORD_ONE_WORD(SET_DATA_SYS_START_INDEX+0,	FLASH_SECTION_SYS_STATUS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SYS_START_INDEX+1,	FLASH_SECTION_SYS_STATUS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SYS_START_INDEX+2,	FLASH_SECTION_SYS_STATUS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SYS_START_INDEX+3,	FLASH_SECTION_SYS_STATUS),
+	// Settings File: Sensor Settings
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_GSEL_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_INTMOD_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_INTSET_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_MANT_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_DCMOD_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_OTMOD_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_RLEDCUR_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_GLEDCUR_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	FLASH_RECORD_ONE_WORD(SET_DATA_SENR_BLEDCUR_INDEX,	FLASH_SECTION_SENSOR_SETTINGS),
+	// Color File: Mother
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+0),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+1),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+2),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+3),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+4),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+5),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+6),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+7),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+8),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+9),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+10),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+11),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+12),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+13),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+14),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+15),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+16),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+17),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+18),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+19),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+20),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+21),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+22),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+23),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+24),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+25),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+26),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+27),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+28),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+29),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+30),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+31),
+	FLASH_RECORD_COLOR(COLOR_DATA_MOTHER_START_INDEX+32),
+	// Color File: Factory
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+0),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+1),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+2),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+3),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+4),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+5),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+6),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+7),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+8),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+9),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+10),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+11),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+12),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+13),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+14),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+15),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+16),
+	FLASH_RECORD_COLOR(COLOR_DATA_FACTORY_START_INDEX+17),
+	// Color File: Greyscale Factory
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+0),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+1),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+2),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+3),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+4),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+5),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+6),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+7),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_FACTORY_START_INDEX+8),
+	// Color File: Temperature
+	FLASH_RECORD_COLOR(COLOR_DATA_TEMP_START_INDEX+0),
+	FLASH_RECORD_COLOR(COLOR_DATA_TEMP_START_INDEX+1),
+	// Color File: Greyscale User
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+0),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+1),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+2),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+3),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+4),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+5),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+6),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+7),
+	FLASH_RECORD_COLOR(COLOR_DATA_GREYSCALE_USER_START_INDEX+8),
+	// Color File: User Temperature
+	FLASH_RECORD_COLOR(COLOR_DATA_TEMP_USER_START_INDEX+0),
+	// Extended File: Manufacturer Data
+	FLASH_RECORD_EXTENDED(EXT_DATA_MAN_START_INDEX+0,	FLASH_SECTION_MANUFACTURE,	EXT_DATA_MAN_UNITN_SIZE_BYTE,	default_man_unitn),
+	FLASH_RECORD_EXTENDED(EXT_DATA_MAN_START_INDEX+1,	FLASH_SECTION_MANUFACTURE,	EXT_DATA_MAN_CALIBT_SIZE_BYTE,	default_man_calibt),
+	FLASH_RECORD_EXTENDED(EXT_DATA_MAN_START_INDEX+2,	FLASH_SECTION_MANUFACTURE,	EXT_DATA_MAN_UNITT_SIZE_BYTE,	default_man_unitt),
+	// Extended File: User Data
+	FLASH_RECORD_EXTENDED(EXT_DATA_USER_START_INDEX+0,	FLASH_SECTION_USER,	EXT_DATA_USER_FCDT_SIZE_BYTE,	default_usr_fcdt),
+	// Extended File: Reserved Data
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+0,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_1_SIZE_BYTE,	default_reserved_1),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+1,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_2_SIZE_BYTE,	default_reserved_2),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+2,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_3_SIZE_BYTE,	default_reserved_3),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+3,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_4_SIZE_BYTE,	default_reserved_4),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+4,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_5_SIZE_BYTE,	default_reserved_5),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+5,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_6_SIZE_BYTE,	default_reserved_6),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+6,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_7_SIZE_BYTE,	default_reserved_7),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+7,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_8_SIZE_BYTE,	default_reserved_8),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+8,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_9_SIZE_BYTE,	default_reserved_9),
+	FLASH_RECORD_EXTENDED(EXT_DATA_RESERVED_START_INDEX+9,	FLASH_SECTION_RESERVED,	EXT_DATA_RESERVED_10_SIZE_BYTE,	default_reserved_10),
+};
+
+/** @Variable The Cache Loaded Flag */
+static bool 		is_flash_cache_loaded								= false;
+
+/** @Func Get the Row of One Record in the Record Table (NULL if the Index is Out of Range) */
+static const flash_record_desc_t * flash_record_of(const uint16_t index)
 {
-	uint8_t words_size	= CAL_WORD_ARRAY_SIZE(bytes_size,sizeof(uint32_t));
-	uint8_t residue 		= bytes_size % 4;
+	if(index > FLASH_RECORD_NUM || flash_records[index].section == FLASH_SECTION_OUT_OF_RANGE){
+		return NULL;
+	}
+	return &flash_records[index];
+}
+
+/** @Func Get the File ID and the Payload Size of One Record */
+static bool flash_record_layout(const uint16_t index, uint16_t *file_id, uint8_t *bytes_size)
+{
+	const flash_record_desc_t	*p_record	=	flash_record_of(index);
 	
-	if(residue == 0){
-		// For each word, compress each 4 bytes into one word.
-		for(int i=0,j=0; i<words_size; i++,j+=4){
-			words_array[i] = bytes_array[j] | bytes_array[j+1]<<8 | bytes_array[j+2]<<16 | bytes_array[j+3]<<24;
-		}
-		return words_size;
+	if(p_record == NULL){
+		return false;
 	}
-	else{
-		// For each word, compress each 4 bytes into one word.
-		for(int i=0,j=0; i<words_size-1; i++,j+=4){
-			words_array[i] = bytes_array[j] | bytes_array[j+1]<<8 | bytes_array[j+2]<<16 | bytes_array[j+3]<<24;
+	*file_id		=	p_record->file_id;
+	*bytes_size	=	p_record->bytes_size;
+	return true;
+}
+
+/** @Func Get the Slot of A Cached Record (NULL if the Record is Not Cached with This File ID and Size) */
+static uint8_t * flash_cache_slot(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size)
+{
+	if(!is_flash_cache_loaded || index == 0 || index > FLASH_CACHE_RECORD_NUM){
+		return NULL;
+	}
+	if(flash_cache_file_id[index-1] != file_id || flash_cache_size[index-1] != bytes_size){
+		return NULL;
+	}
+	return (uint8_t *)&flash_cache_data[flash_cache_offset[index-1]];
+}
+
+/** @Func Mark A Cached Record as Changed and Arm the Write-back Timer (Called in A Critical Region) */
+static void flash_cache_mark_dirty(const uint16_t index)
+{
+	flash_cache_dirty[(index-1)/32] |= (1UL << ((index-1)%32));
+	flash_cache_change_ticks = app_timer_cnt_get();
+	
+	// A Burst of Changes Costs One Timer Operation Only
+	if(!is_flash_cache_timer_running){
+		is_flash_cache_timer_running = (app_timer_start(flash_cache_timer_id, APP_TIMER_TICKS(FLASH_CACHE_FLUSH_DELAY_MS, FLASH_CACHE_TIMER_PRESCALER), NULL) == NRF_SUCCESS);
+	}
+}
+
+/** @Func Set or Clear the Bits of An Index Range (Called in A Critical Region) */
+static void flash_cache_bits_write(uint32_t *bits, const uint16_t first, const uint16_t last, const bool value)
+{
+	for(uint16_t index = first; index <= last; index++){
+		if(value){
+			bits[(index-1)/32] |= (1UL << ((index-1)%32));
 		}
-		// For the last few bytes, compress the residue bytes into the lower bits of the last word.
-		switch(residue){
-			case 1:
-				words_array[words_size-1] =	bytes_array[bytes_size-1];
-				break;
-			case 2:
-				words_array[words_size-1] = bytes_array[bytes_size-2] | bytes_array[bytes_size-1]<<8;
-				break;
-			case 3:
-				words_array[words_size-1] = bytes_array[bytes_size-3] | bytes_array[bytes_size-2]<<8 | bytes_array[bytes_size-1]<<16;
-				break;
+		else{
+			bits[(index-1)/32] &= ~(1UL << ((index-1)%32));
 		}
-		return words_size;
 	}
 }
 
-/** @Func Word Array to Byte Array Conversion */
-uint8_t words2bytes(const uint8_t bytes_size, uint8_t* bytes_array, const uint32_t* const words_array)
+/** @Func Get the Packed Color Block of An Index (FLASH_COLOR_BLOCK_NUM if the Index is Not A Color) */
+static uint8_t flash_color_block_of(const uint16_t index)
 {
-	uint8_t words_size	=	CAL_WORD_ARRAY_SIZE(bytes_size,sizeof(uint32_t));
-	uint8_t residue 		= bytes_size % 4;
-	
-	if (residue == 0){
-		// For each word, de-compress it into separate bytes and store them into the byte array.
-		for(int i=0,j=0;i<words_size;i++,j+=4){
-			bytes_array[j] 		= 	words_array[i] 			& 0x000000FF;
-			bytes_array[j+1]	=		(words_array[i]>>8) &	0x000000FF;
-			bytes_array[j+2]	=		(words_array[i]>>16)& 0x000000FF;
-			bytes_array[j+3]	=		(words_array[i]>>24)&	0x000000FF;
+	for(uint8_t block = 0; block < FLASH_COLOR_BLOCK_NUM; block++){
+		if(index >= flash_color_block_start[block] && index < flash_color_block_start[block] + flash_color_block_count[block]){
+			return block;
 		}
-		return words_size;
+	}
+	return FLASH_COLOR_BLOCK_NUM;
+}
+
+/** @Func Get the Indexes Written Back Together with One Record (Its Packed Color Block, or the Record Alone) */
+static void flash_cache_unit(const uint16_t index, uint16_t *first, uint16_t *last)
+{
+	uint8_t block = flash_color_block_of(index);
+	if(block != FLASH_COLOR_BLOCK_NUM){
+		*first	=	flash_color_block_start[block];
+		*last		=	flash_color_block_start[block] + flash_color_block_count[block] - 1;
 	}
 	else{
-		// For each word, de-compress it into separate bytes and store them into the byte array.
-		for(int i=0,j=0;i<words_size-1;i++,j+=4){
-			bytes_array[j] 		= 	words_array[i] 			& 0x000000FF;
-			bytes_array[j+1]	=		(words_array[i]>>8) &	0x000000FF;
-			bytes_array[j+2]	=		(words_array[i]>>16)& 0x000000FF;
-			bytes_array[j+3]	=		(words_array[i]>>24)&	0x000000FF;
-		}
-		switch(residue){
-			case 1:
-				bytes_array[bytes_size-1] 	= 	words_array[words_size-1] & 0x000000FF;
-				break;
-			case 2:
-				bytes_array[bytes_size-2]		= 	words_array[words_size-1] 		 & 0x000000FF;
-				bytes_array[bytes_size-1]		= 	(words_array[words_size-1]>>8) & 0x000000FF;
-				break;
-			case 3:
-				bytes_array[bytes_size-3]		= 	words_array[words_size-1] 		 	& 0x000000FF;
-				bytes_array[bytes_size-2]		= 	(words_array[words_size-1]>>8) 	& 0x000000FF;
-				bytes_array[bytes_size-1]		= 	(words_array[words_size-1]>>16) & 0x000000FF;
-		}
-		return words_size;
+		*first	=	index;
+		*last		=	index;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+//Essential Bricks: Utility Functions////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Byte Array to Word Array Conversion (The Words are Little-endian, so the Layout is the Same as the Byte Array) */
+uint8_t	bytes2words(const uint8_t bytes_size, const uint8_t* const bytes_array, uint32_t* words_array)
+{
+	uint8_t words_size	= CAL_WORD_ARRAY_SIZE(bytes_size,sizeof(uint32_t));
+	
+	// Zero the unused upper bytes of the last word
+	if(words_size != 0){
+		words_array[words_size-1] = 0;
 	}
+	memcpy(words_array,bytes_array,bytes_size);
+	return words_size;
+}
+
+/** @Func Word Array to Byte Array Conversion */
+uint8_t words2bytes(const uint8_t bytes_size, uint8_t* bytes_array, const uint32_t* const words_array)
+{
+	memcpy(bytes_array,words_array,bytes_size);
+	return CAL_WORD_ARRAY_SIZE(bytes_size,sizeof(uint32_t));
 }
 //First Layer: Basic Byte Array Functions////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Basic Functions to Operate Byte Arrays */
 
-/** @Func Write one Byte Array Record into the Flash */
-flash_status_t 	setByteArray(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, const uint8_t* const bytes_array)
+/** @Func Write a Word-array Record Image into the Flash (No Copy) */
+flash_status_t	setWordArray(const uint16_t file_id, const uint16_t index, const uint16_t words_size, const uint32_t* const words_array)
 {
-	uint8_t   	words_size		=	CAL_WORD_ARRAY_SIZE(bytes_size, sizeof(uint32_t));
-	uint32_t		*words_array	=	(uint32_t*)malloc(sizeof(uint32_t)*words_size);
 	ret_code_t 	ret_code 			= 0;
 	
-	// Turn into words array
-	bytes2words(bytes_size, bytes_array, words_array);
-	
-	// Set Up the Flash Record
+	// Set Up the Flash Record (The FDS Chunk Points at the Caller's Words)
   if(!fdsRecConfig(file_id, MAP_INDEX_TO_REC_ID(index), words_array, words_size)){
-		free(words_array); // Clean up the temporary variable if failed
 		return FLASH_STATUS_SETUP_ERR;
 	}
 	
@@ -122,78 +360,71 @@ flash_status_t 	setByteArray(const uint16_t file_id, const uint16_t index, const
 	
 	// First Time Writing (Create A New Record)
 	if(ret_code == FDS_ERR_NOT_FOUND){
-		if(fdsRecWrite() != FDS_SUCCESS){// Write the Record
-			if(fdsGC() != FDS_SUCCESS){	//Try Garbage Collection Once
-				free(words_array);// Clean up the temporary variable if failed
-				return FLASH_STATUS_GC_ERR;
-			}
-			if(fdsRecWrite() != FDS_SUCCESS){// Re-write the Record Again
-				free(words_array);// Clean up the temporary variable if failed
-				return FLASH_STATUS_WRITE_ERR;
-			}
-		}
-		// Clean Up and Return
-		free(words_array);
-		return FLASH_STATUS_SUCCESS;
+		ret_code = fdsRecWrite();
 	}
 	
 	// Not First Time Writing (Update the Existing Record)
 	else if(ret_code == FDS_SUCCESS){
-		if(fdsRecUpdate() != FDS_SUCCESS){// Update the Record
-			if(fdsGC() != FDS_SUCCESS){	//Try Garbage Collection Once
-				free(words_array);
-				return FLASH_STATUS_GC_ERR;
-			}
-			if(fdsRecUpdate() != FDS_SUCCESS){// Update the Record Again
-				free(words_array);
-				return FLASH_STATUS_WRITE_ERR;
-			}
-		}
-		// Clean Up and Return
-		free(words_array);
-		return FLASH_STATUS_SUCCESS;
+		ret_code = fdsRecUpdate();
 	}
 	
 	// Flash Look Up Error
 	else{
 		return FLASH_STATUS_LOOKUP_ERR;
 	}
+	
+	// Flash Full: The Storage Health Module Collects the Garbage (Try Again after Its Completion, No Waiting Here)
+	if(ret_code == FDS_ERR_NO_SPACE_IN_FLASH){
+		storageHealthRequestGC();
+		return FLASH_STATUS_FULL_ERR;
+	}
+	return (ret_code == FDS_SUCCESS) ? FLASH_STATUS_SUCCESS : FLASH_STATUS_WRITE_ERR;
+}
+
+/** @Func Write one Byte Array Record into the Flash */
+flash_status_t 	setByteArray(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, const uint8_t* const bytes_array)
+{
+	uint8_t   	words_size		=	CAL_WORD_ARRAY_SIZE(bytes_size, sizeof(uint32_t));
+	
+	// Whole Words at A Word Boundary Can Be Written in Place
+	if(((uintptr_t)bytes_array % sizeof(uint32_t)) == 0 && (bytes_size % sizeof(uint32_t)) == 0){
+		return setWordArray(file_id, index, words_size, (const uint32_t*)bytes_array);
+	}
+	
+	// Otherwise Pad the Bytes into the Scratch Words
+	if(words_size > FLASH_SCRATCH_WORDS){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	bytes2words(bytes_size, bytes_array, flash_scratch);
+	return setWordArray(file_id, index, words_size, flash_scratch);
 }
 
 /** @Func Read a Flash Record into the Destination Byte Array */
 flash_status_t	getByteArray(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, uint8_t* bytes_array)
 {
+	uint16_t		bytes_read		=	0;
+	ret_code_t  ret_code			=	0;
+	
 	// Set Up Record Meta Data
 	if(!fdsRecConfig(file_id, MAP_INDEX_TO_REC_ID(index), NULL, 0)){
 		return FLASH_STATUS_SETUP_ERR;
 	}
 	
-	// Temporary Variables for Record Reading
-	uint8_t   	words_size		= CAL_WORD_ARRAY_SIZE(bytes_size,sizeof(uint32_t));
-	uint32_t 	 	*words_array	=	(uint32_t*)malloc(sizeof(uint32_t)*words_size);
-	ret_code_t  ret_code			=	0;
-	
-	// Try to Read the Record Once
-	ret_code = fdsRecRead(words_array);
+	// Copy the Record Straight Out of the Flash
+	ret_code = fdsRecReadBytes(bytes_array, bytes_size, &bytes_read);
 	
 	// Record Not Found
 	if(ret_code == FDS_ERR_NOT_FOUND){
-		free(words_array); // Clean Up the Temporary Variable if Failed
 		return FLASH_STATUS_NOT_FOUND_ERR;
 	}
 	
-	// Flash Read Error
-	else if(ret_code != FDS_SUCCESS){
-		free(words_array);// Clean Up the Temporary Variable if Failed
+	// Flash Read Error (or the Record is Shorter than Expected)
+	else if(ret_code != FDS_SUCCESS || bytes_read != bytes_size){
 		return FLASH_STATUS_READ_ERR;
 	}
 	
 	// Reading Succeeded
 	else{
-		// Turn words array to bytes array
-		words2bytes(bytes_size, bytes_array, words_array);
-		// Clean Up and Return
-		free(words_array);
 		return FLASH_STATUS_SUCCESS;
 	}
 }
@@ -206,8 +437,15 @@ flash_status_t	delByteArray(const uint16_t file_id, const uint16_t index)
 		return FLASH_STATUS_SETUP_ERR;
 	}
 	
+	ret_code_t ret_code = fdsRecDelete();
+	
+	// Record Not Found
+	if(ret_code == FDS_ERR_NOT_FOUND){
+		return FLASH_STATUS_NOT_FOUND_ERR;
+	}
+	
 	// Flash Deletion Failed
-	if(fdsRecDelete() != FDS_SUCCESS){
+	else if(ret_code != FDS_SUCCESS){
 		return FLASH_STATUS_DEL_ERR;
 	}
 	
@@ -217,178 +455,308 @@ flash_status_t	delByteArray(const uint16_t file_id, const uint16_t index)
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/* Functions to Add the Record Status Tags */
+/* Packed Color Records (Header Word, Packed Tags, One Word per Value) */
 
-/** @Func Write a Single Byte-array Data into a Flash Record */
-flash_status_t setOneByteArrayData(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, const uint8_t * const bytes_array, const uint8_t tag)
+/** @Func Get the Record Image of A Packed Color Block */
+static uint32_t * flash_color_image(const uint8_t block)
 {
-	uint8_t 				*rec_data				=	(uint8_t*)malloc(bytes_size+1);// Plus one extra byte as the validation tag
-	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	uint16_t offset = 0;
+	for(uint8_t i = 0; i < block; i++){
+		offset += FLASH_COLOR_IMAGE_WORDS(flash_color_block_count[i]);
+	}
+	return &flash_color_image_data[offset];
+}
+
+/** @Func Get the Packed Tags and the Values of A Packed Color Record Image */
+static uint8_t * flash_color_image_tags(uint32_t *image)
+{
+	return (uint8_t *)&image[1];
+}
+
+static uint32_t * flash_color_image_values(uint32_t *image, const uint8_t count)
+{
+	return &image[1 + CAL_WORD_ARRAY_SIZE(count,sizeof(uint32_t))];
+}
+
+/** @Func Compute the Header Word of A Packed Color Record Image (The CRC Covers Everything after the Header) */
+static uint32_t flash_color_image_header(const uint8_t block)
+{
+	uint32_t const	*image	=	flash_color_image(block);
+	const uint8_t		count		=	flash_color_block_count[block];
+	uint16_t				crc			=	crc16_compute((uint8_t const *)&image[1], (FLASH_COLOR_IMAGE_WORDS(count)-1)*sizeof(uint32_t), NULL);
+	return FLASH_COLOR_BLOCK_VERSION | ((uint32_t)count << 8) | ((uint32_t)crc << 16);
+}
+
+/** @Func Read A Packed Color Block into Its Image (Built from the Per-index Records of Older Firmware if the Block is Missing or Corrupted) */
+static flash_status_t flash_color_block_fetch(const uint8_t block, bool *is_legacy)
+{
+	uint32_t				*image					=	flash_color_image(block);
+	const uint8_t		count						=	flash_color_block_count[block];
+	uint8_t					*tags						=	flash_color_image_tags(image);
+	uint32_t				*values					=	flash_color_image_values(image,count);
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	*is_legacy			=	false;
+	flash_ret_code	=	getByteArray(FLASH_FILEID_COLOR,FLASH_COLOR_BLOCK_REC_INDEX(block),FLASH_COLOR_IMAGE_WORDS(count)*sizeof(uint32_t),(uint8_t *)image);
+	if(flash_ret_code == FLASH_STATUS_SUCCESS && image[0] == flash_color_image_header(block)){
+		return FLASH_STATUS_SUCCESS;
+	}
+	
+	// A Block of Another Size is Read as A Reading Error, and is Replaced as A Corrupted One
+	if(flash_ret_code != FLASH_STATUS_SUCCESS && flash_ret_code != FLASH_STATUS_NOT_FOUND_ERR && flash_ret_code != FLASH_STATUS_READ_ERR){
+		return flash_ret_code;
+	}
+	
+	// Compatibility Reader: One Record (Tag + Value) per Index
+	memset(image, 0, FLASH_COLOR_IMAGE_WORDS(count)*sizeof(uint32_t));
+	for(uint8_t i = 0; i < count; i++){
+		flash_ret_code = getByteArray(FLASH_FILEID_COLOR,flash_color_block_start[block]+i,FLASH_COLOR_VALUE_SIZE_BYTE+1,(uint8_t *)flash_scratch);
+		if(flash_ret_code == FLASH_STATUS_SUCCESS){
+			tags[i] = ((uint8_t *)flash_scratch)[0];
+			memcpy(&values[i],&((uint8_t *)flash_scratch)[1],FLASH_COLOR_VALUE_SIZE_BYTE);
+			*is_legacy = true;
+		}
+		else if(flash_ret_code != FLASH_STATUS_NOT_FOUND_ERR){
+			return flash_ret_code;
+		}
+	}
+	return (*is_legacy) ? FLASH_STATUS_SUCCESS : FLASH_STATUS_NOT_FOUND_ERR;
+}
+
+/** @Func Write the Image of A Packed Color Block, then Delete the Per-index Records It Replaces */
+static flash_status_t flash_color_block_store(const uint8_t block, const bool is_legacy)
+{
+	uint32_t				*image					=	flash_color_image(block);
+	const uint8_t		count						=	flash_color_block_count[block];
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
 	
-	// Add the First Validation Tag
-	rec_data[0]=tag;
+	image[0]				=	flash_color_image_header(block);
+	flash_ret_code	=	setWordArray(FLASH_FILEID_COLOR,FLASH_COLOR_BLOCK_REC_INDEX(block),FLASH_COLOR_IMAGE_WORDS(count),image);
+	if(flash_ret_code != FLASH_STATUS_SUCCESS || !is_legacy){
+		return flash_ret_code;
+	}
 	
-	// Add the Rest of the Data
-	for(uint16_t i=1;i<bytes_size+1;i++){
-			rec_data[i]=bytes_array[i-1];
+	// The Old Records are Only Deleted Once the Block is in the Flash (A Missing One Fails to Be Deleted, which is Ignored)
+	for(uint8_t i = 0; i < count; i++){
+		delByteArray(FLASH_FILEID_COLOR,flash_color_block_start[block]+i);
 	}
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Copy the RAM Shadow Slots of A Color Block into Its Image (Called in A Critical Region) */
+static void flash_color_block_pack(const uint8_t block)
+{
+	uint32_t				*image		=	flash_color_image(block);
+	const uint8_t		count			=	flash_color_block_count[block];
+	uint8_t					*tags			=	flash_color_image_tags(image);
+	uint32_t				*values		=	flash_color_image_values(image,count);
 	
-	// Set the Byte Array
-	flash_ret_code=setByteArray(file_id,index,bytes_size+1,rec_data);
+	for(uint8_t i = 0; i < count; i++){
+		uint8_t const *slot = (uint8_t const *)&flash_cache_data[flash_cache_offset[flash_color_block_start[block]+i-1]];
+		tags[i] = slot[0];
+		memcpy(&values[i],&slot[1],FLASH_COLOR_VALUE_SIZE_BYTE);
+	}
+	image[0] = flash_color_image_header(block);
+}
+
+/** @Func Copy the Image of A Color Block into Its RAM Shadow Slots */
+static void flash_color_block_unpack(const uint8_t block)
+{
+	uint32_t				*image		=	flash_color_image(block);
+	const uint8_t		count			=	flash_color_block_count[block];
+	uint8_t					*tags			=	flash_color_image_tags(image);
+	uint32_t				*values		=	flash_color_image_values(image,count);
 	
-	// Clean Up
-	free(rec_data);
-	return flash_ret_code;
+	for(uint8_t i = 0; i < count; i++){
+		uint8_t *slot = (uint8_t *)&flash_cache_data[flash_cache_offset[flash_color_block_start[block]+i-1]];
+		slot[0] = tags[i];
+		memcpy(&slot[1],&values[i],FLASH_COLOR_VALUE_SIZE_BYTE);
+	}
 }
 
-/** @Func Read a Single Byte-array Record into the Flash */
-flash_status_t	getOneByteArrayData(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, uint8_t* bytes_array, uint8_t *tag_ptr)
+/** @Func Write One Entry of A Packed Color Block (Read-modify-write of the Block Record, without the RAM Shadow) */
+static flash_status_t flash_color_entry_set(const uint16_t index, const uint8_t bytes_size, const uint8_t * const bytes_array, const uint8_t tag)
 {
-	uint8_t 				*rec_data				=	(uint8_t*)malloc(bytes_size+1); // Add one extra byte to store the first validation tag
-	flash_status_t  flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	const uint8_t		block						=	flash_color_block_of(index);
+	uint32_t				*image					=	flash_color_image(block);
+	const uint8_t		i								=	index - flash_color_block_start[block];
+	bool						is_legacy				=	false;
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
 	
-	// Read in the entier byte array
-	flash_ret_code = getByteArray(file_id,index,bytes_size+1,rec_data);
+	if(bytes_size != FLASH_COLOR_VALUE_SIZE_BYTE){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	flash_ret_code = flash_color_block_fetch(block,&is_legacy);
+	if(flash_ret_code != FLASH_STATUS_SUCCESS && flash_ret_code != FLASH_STATUS_NOT_FOUND_ERR){
+		return flash_ret_code;
+	}
 	
-	// Record Reading Failed
+	flash_color_image_tags(image)[i] = tag;
+	if(bytes_array != NULL){
+		memcpy(&flash_color_image_values(image,flash_color_block_count[block])[i],bytes_array,FLASH_COLOR_VALUE_SIZE_BYTE);
+	}
+	return flash_color_block_store(block,is_legacy);
+}
+
+/** @Func Read One Entry of A Packed Color Block (Without the RAM Shadow) */
+static flash_status_t flash_color_entry_get(const uint16_t index, const uint8_t bytes_size, uint8_t *bytes_array, uint8_t *tag_ptr)
+{
+	const uint8_t		block						=	flash_color_block_of(index);
+	uint32_t				*image					=	flash_color_image(block);
+	const uint8_t		i								=	index - flash_color_block_start[block];
+	bool						is_legacy				=	false;
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	if(bytes_size != FLASH_COLOR_VALUE_SIZE_BYTE){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	flash_ret_code = flash_color_block_fetch(block,&is_legacy);
 	if(flash_ret_code != FLASH_STATUS_SUCCESS){
 		return flash_ret_code;
 	}
 	
-	// Check the First Byte(the Flag) in the Record
-	else{
-		if(tag_ptr != NULL){//Get the Tag Out
-			*tag_ptr = rec_data[0];
-		}
-		
-		// Move the read data into destination memory address
-		for(uint16_t i = 0;i<bytes_size;i++){
-			bytes_array[i] = rec_data[i+1];
-		}
-		
-		// Clean Up
-		free(rec_data);
-		return flash_ret_code;
+	if(flash_color_image_tags(image)[i] == FLASH_RECTAG_NONE_BYTE){
+		return FLASH_STATUS_NOT_FOUND_ERR;
+	}
+	if(tag_ptr != NULL){
+		*tag_ptr = flash_color_image_tags(image)[i];
 	}
+	if(bytes_array != NULL){
+		memcpy(bytes_array,&flash_color_image_values(image,flash_color_block_count[block])[i],FLASH_COLOR_VALUE_SIZE_BYTE);
+	}
+	return FLASH_STATUS_SUCCESS;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-/** @Func Functions to Check the Data Section */
-flash_section_t getDataSection(const uint16_t index)
+/* Functions to Add the Record Status Tags */
+
+/** @Func Write a Single Byte-array Data into a Flash Record */
+flash_status_t setOneByteArrayData(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, const uint8_t * const bytes_array, const uint8_t tag)
 {
-	if(index >= SET_DATA_DEVINFO_START_INDEX && index <= SET_DATA_DEVINFO_END_INDEX){
-		return FLASH_SECTION_DEVICE_INFO;
+	// Change the RAM Shadow Only (Written Back Later)
+	uint8_t					*slot						=	flash_cache_slot(file_id,index,bytes_size);
+	if(slot != NULL){
+		CRITICAL_REGION_ENTER();
+		slot[0] = tag;
+		memcpy(&slot[1],bytes_array,bytes_size);
+		flash_cache_mark_dirty(index);
+		CRITICAL_REGION_EXIT();
+		return FLASH_STATUS_SUCCESS;
+	}
+	
+	// Change the Entry in Its Packed Color Block
+	if(file_id == FLASH_FILEID_COLOR && flash_color_block_of(index) != FLASH_COLOR_BLOCK_NUM){
+		return flash_color_entry_set(index,bytes_size,bytes_array,tag);
+	}
+	
+	// Build the Record Image (Tag + Payload) in the Scratch Words
+	uint8_t 				words_size			=	CAL_WORD_ARRAY_SIZE(bytes_size+1,sizeof(uint32_t));
+	if(words_size > FLASH_SCRATCH_WORDS){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	flash_scratch[words_size-1]	=	0;
+	((uint8_t*)flash_scratch)[0]	=	tag;
+	memcpy(&((uint8_t*)flash_scratch)[1],bytes_array,bytes_size);
+	
+	return setWordArray(file_id,index,words_size,flash_scratch);
+}
+
+/** @Func Read a Single Byte-array Record into the Flash */
+flash_status_t	getOneByteArrayData(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, uint8_t* bytes_array, uint8_t *tag_ptr)
+{
+	// Copy out of the RAM Shadow
+	uint8_t const		*slot						=	flash_cache_slot(file_id,index,bytes_size);
+	if(slot != NULL){
+		if(slot[0] == FLASH_RECTAG_NONE_BYTE){
+			return FLASH_STATUS_NOT_FOUND_ERR;
+		}
+		CRITICAL_REGION_ENTER();
+		if(tag_ptr != NULL){
+			*tag_ptr = slot[0];
+		}
+		memcpy(bytes_array,&slot[1],bytes_size);
+		CRITICAL_REGION_EXIT();
+		return FLASH_STATUS_SUCCESS;
 	}
-	else if(index >= SET_DATA_DFU_START_INDEX && index <= SET_DATA_DFU_END_INDEX){
-		return FLASH_SECTION_DFU_INFO;
+	
+	// Read the Entry out of Its Packed Color Block
+	if(file_id == FLASH_FILEID_COLOR && flash_color_block_of(index) != FLASH_COLOR_BLOCK_NUM){
+		return flash_color_entry_get(index,bytes_size,bytes_array,tag_ptr);
 	}
-	else if(index >= SET_DATA_DEVSET_START_INDEX && index <= SET_DATA_DEVSET_END_INDEX){
-		return FLASH_SECTION_DEVICE_SETTINGS;
+	
+	// Read in the Entire Record Image (Tag + Payload)
+	if(CAL_WORD_ARRAY_SIZE(bytes_size+1,sizeof(uint32_t)) > FLASH_SCRATCH_WORDS){
+		return FLASH_STATUS_SETUP_ERR;
 	}
-	else if(index >= SET_DATA_SYS_START_INDEX && index <= SET_DATA_SYS_END_INDEX){
-		return FLASH_SECTION_SYS_STATUS;
+	flash_status_t  flash_ret_code	=	getByteArray(file_id,index,bytes_size+1,(uint8_t*)flash_scratch);
+	
+	// Record Reading Failed
+	if(flash_ret_code != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
 	}
-	else if(index >= SET_DATA_SENR_START_INDEX  && index <= SET_DATA_SENR_END_INDEX){
-		return FLASH_SECTION_SENSOR_SETTINGS;
+	
+	// Split the Tag and the Payload
+	if(tag_ptr != NULL){
+		*tag_ptr = ((uint8_t*)flash_scratch)[0];
 	}
-	else if(index >= COLOR_DATA_START_INDEX && index <= COLOR_DATA_END_INDEX){
-		return FLASH_SECTION_COLORS;
+	memcpy(bytes_array,&((uint8_t*)flash_scratch)[1],bytes_size);
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Read the Tag of a Single Record */
+flash_status_t	getOneRecordTag(const uint16_t file_id, const uint16_t index, uint8_t *tag_ptr)
+{
+	// Tag of the RAM Shadow Slot
+	if(is_flash_cache_loaded && index != 0 && index <= FLASH_CACHE_RECORD_NUM && flash_cache_file_id[index-1] == file_id){
+		*tag_ptr = ((uint8_t const *)&flash_cache_data[flash_cache_offset[index-1]])[0];
+		return (*tag_ptr == FLASH_RECTAG_NONE_BYTE) ? FLASH_STATUS_NOT_FOUND_ERR : FLASH_STATUS_SUCCESS;
 	}
-	else if(index >= EXT_DATA_MAN_START_INDEX && index <= EXT_DATA_MAN_END_INDEX){
-		return FLASH_SECTION_MANUFACTURE;
+	
+	// Tag of the Entry in Its Packed Color Block
+	if(file_id == FLASH_FILEID_COLOR && flash_color_block_of(index) != FLASH_COLOR_BLOCK_NUM){
+		return flash_color_entry_get(index,FLASH_COLOR_VALUE_SIZE_BYTE,NULL,tag_ptr);
 	}
-	else if(index >= EXT_DATA_USER_START_INDEX && index <= EXT_DATA_USER_END_INDEX){
-		return FLASH_SECTION_USER;
+	
+	// Only the First Byte is Read out of the Flash
+	uint16_t		bytes_read		=	0;
+	ret_code_t	ret_code			=	0;
+	if(!fdsRecConfig(file_id, MAP_INDEX_TO_REC_ID(index), NULL, 0)){
+		return FLASH_STATUS_SETUP_ERR;
 	}
-	else if(index >= EXT_DATA_RESERVED_START_INDEX && index <= EXT_DATA_RESERVED_END_INDEX){
-		return FLASH_SECTION_RESERVED;
+	ret_code = fdsRecReadBytes(tag_ptr, 1, &bytes_read);
+	if(ret_code == FDS_ERR_NOT_FOUND){
+		return FLASH_STATUS_NOT_FOUND_ERR;
 	}
-	else{
-		return FLASH_SECTION_OUT_OF_RANGE;
+	else if(ret_code != FDS_SUCCESS || bytes_read != 1){
+		return FLASH_STATUS_READ_ERR;
 	}
+	return FLASH_STATUS_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Functions to Check the Data Section */
+flash_section_t getDataSection(const uint16_t index)
+{
+	const flash_record_desc_t	*p_record	=	flash_record_of(index);
+	
+	return (p_record == NULL) ? FLASH_SECTION_OUT_OF_RANGE : p_record->section;
 }
 
 /** @Func Functions to Operate Any Record */
 flash_status_t getOneRecordStatus(const uint16_t index)
 {
-	// Try to Read the First Byte of the Record Once
-	const uint8_t  	*default_sizes	=	NULL; 									// Pointer to the default size array
+	uint16_t				file_id					=	0;
+	uint8_t					bytes_size			=	0;
 	uint8_t 				tag_byte				=	0; 											// Temporary byte to store the tag value.
-	uint8_t					*bytes_array		= NULL; 									// Byte array to store the read data.
 	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;		// Flash operation return code.
-	flash_section_t flash_sec_code	=	getDataSection(index);	// Data section code.
-	
-	// Switch Data Sections
-	switch(flash_sec_code){
-		case FLASH_SECTION_DEVICE_INFO:
-		{
-			default_sizes		=	getDevSizeInfo();
-			bytes_array			=	(uint8_t*)malloc(default_sizes[index-SET_DATA_DEVINFO_START_INDEX]);
-			flash_ret_code	=	getOneByteArrayData(FLASH_FILEID_SETTINGS,index,default_sizes[index-SET_DATA_DEVINFO_START_INDEX],bytes_array,&tag_byte);
-			free(bytes_array);
-			bytes_array			=	NULL;
-			break;
-		}
-		
-		// One-word (32-bit) Data Section
-		case FLASH_SECTION_DFU_INFO:
-		case FLASH_SECTION_DEVICE_SETTINGS:
-		case FLASH_SECTION_SYS_STATUS:
-		case FLASH_SECTION_SENSOR_SETTINGS:
-		{
-			bytes_array			=	(uint8_t*)malloc(4);
-			flash_ret_code	=	getOneByteArrayData(FLASH_FILEID_SETTINGS,index,4,bytes_array,&tag_byte);
-			free(bytes_array);
-			bytes_array			=	NULL;
-			break;
-		}
-		
-		// Color Data Section 
-		case FLASH_SECTION_COLORS:
-		{
-			bytes_array			=	(uint8_t*)malloc(4);
-			flash_ret_code	=	getOneByteArrayData(FLASH_FILEID_COLOR,index,4,bytes_array,&tag_byte);
-			free(bytes_array);
-			bytes_array			=	NULL;
-			break;
-		}
-		
-		// Manufacturer Data Section
-		case FLASH_SECTION_MANUFACTURE:
-		{
-			default_sizes		=	getManSizeInfo();
-			bytes_array			=	(uint8_t*)malloc(default_sizes[index-EXT_DATA_MAN_START_INDEX]);
-			flash_ret_code	=	getOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_MAN_START_INDEX],bytes_array,&tag_byte);
-			free(bytes_array);
-			bytes_array			=	NULL;
-			break;
-		}
-		
-		// User Data Section
-		case FLASH_SECTION_USER:
-		{
-			default_sizes		=	getUsrSizeInfo();
-			bytes_array			=	(uint8_t*)malloc(default_sizes[index-EXT_DATA_USER_START_INDEX]);
-			flash_ret_code	=	getOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_USER_START_INDEX],bytes_array,&tag_byte);
-			free(bytes_array);
-			bytes_array			=	NULL;
-			break;
-		}
-		
-		// Reserved Data Section
-		case FLASH_SECTION_RESERVED:
-		{
-			default_sizes		=	getReservedSizeInfo();
-			bytes_array			=	(uint8_t*)malloc(default_sizes[index-EXT_DATA_RESERVED_START_INDEX]);
-			flash_ret_code	=	getOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_RESERVED_START_INDEX],bytes_array,&tag_byte);
-			free(bytes_array);
-			bytes_array			=	NULL;
-			break;
-		}
-		default:
-			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+	
+	// Read the Tag Only (No Payload Buffer is Needed)
+	if(!flash_record_layout(index,&file_id,&bytes_size)){
+		return FLASH_STATUS_OUT_OF_RANGE_ERR;
 	}
+	flash_ret_code	=	getOneRecordTag(file_id,index,&tag_byte);
 	
 	// Record Reading Failed
 	if(flash_ret_code != FLASH_STATUS_SUCCESS){
@@ -415,179 +783,59 @@ flash_status_t getOneRecordStatus(const uint16_t index)
 /** @Func Functions to Set Any Record to Its Default Value */
 flash_status_t 	initOneRecord(const uint16_t index)
 {
-	const uint8_t			 				tag								=	FLASH_RECTAG_DEFAULT_BYTE;
-	const uint8_t						 	*default_sizes		=	NULL;
-	const uint8_t 					 	**default_values	=	NULL;
-	const union data_set_t 	 	*default_settings	=	NULL;
-	const union data_color_t 	*default_colors		=	NULL;
-	flash_section_t 					flash_sec_code		=	getDataSection(index);
-	
-	// Switch Data Sections
-	switch(flash_sec_code){
-		case FLASH_SECTION_DEVICE_INFO:
-		{
-			default_sizes=getDevSizeInfo();	// Get the Data Size at the Index
-			default_values=getDevInfo();		//Get the Default Values at the Index 
-			return setOneByteArrayData(FLASH_FILEID_SETTINGS,index,default_sizes[index-SET_DATA_DEVINFO_START_INDEX],default_values[index-SET_DATA_DEVINFO_START_INDEX],tag);
-		}
-		
-		// One-word (32-bit) Data Section
-		case FLASH_SECTION_DFU_INFO:
-		case FLASH_SECTION_DEVICE_SETTINGS:
-		case FLASH_SECTION_SYS_STATUS:
-		case FLASH_SECTION_SENSOR_SETTINGS:
-		{
-			default_settings=getOwSetInfo();
-			return setOneByteArrayData(FLASH_FILEID_SETTINGS,index,4,default_settings[index-SET_DATA_ONE_WORD_START_INDEX].byte,tag);
-		}
-		
-		// Color Data Section
-		case FLASH_SECTION_COLORS:
-		{
-			default_colors=getColorInfo();
-			return setOneByteArrayData(FLASH_FILEID_COLOR,index,4,default_colors[index-COLOR_DATA_START_INDEX].byte,tag);
-		}
-		
-		// Manufacturer Data Section
-		case FLASH_SECTION_MANUFACTURE:
-		{
-			default_sizes=getManSizeInfo();
-			default_values=getManInfo();
-			return setOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_MAN_START_INDEX],default_values[index-EXT_DATA_MAN_START_INDEX],tag);
-		}
-		
-		// User Data Section
-		case FLASH_SECTION_USER:
-		{
-			default_sizes=getUsrSizeInfo();
-			default_values=getUsrInfo();
-			return setOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_USER_START_INDEX],default_values[index-EXT_DATA_USER_START_INDEX],tag);
-		}
-		
-		// Reserved Data Section
-		case FLASH_SECTION_RESERVED:
-		{
-			default_sizes=getReservedSizeInfo();
-			default_values=getReservedInfo();
-			return setOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_RESERVED_START_INDEX],default_values[index-EXT_DATA_RESERVED_START_INDEX],tag);
-		}
-		default:
-			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+	const flash_record_desc_t	*p_record	=	flash_record_of(index);
+	
+	if(p_record == NULL){
+		return FLASH_STATUS_OUT_OF_RANGE_ERR;
 	}
+	return setOneByteArrayData(p_record->file_id,index,p_record->bytes_size,p_record->p_default,FLASH_RECTAG_DEFAULT_BYTE);
 }
 
 /** @Func Write a single record into the flash */
 flash_status_t setOneRecord(const uint16_t index, const uint8_t* const bytes_array)
 {
-	const uint8_t 		*default_sizes	=	NULL; // Variable to store the size of the byte array
-	const uint8_t 		tag							=	FLASH_RECTAG_CHANGED_BYTE;
-	flash_section_t 	flash_sec_code	=	getDataSection(index);
+	const flash_record_desc_t	*p_record	=	flash_record_of(index);
 	
-	// Switch Data Sections
-	switch(flash_sec_code){
-		case FLASH_SECTION_DEVICE_INFO:
-		{
-			default_sizes=getDevSizeInfo();
-			return setOneByteArrayData(FLASH_FILEID_SETTINGS,index,default_sizes[index-SET_DATA_DEVINFO_START_INDEX],bytes_array,tag);
-		}
-		
-		// One-word Data Section
-		case FLASH_SECTION_DFU_INFO:
-		case FLASH_SECTION_DEVICE_SETTINGS:
-		case FLASH_SECTION_SYS_STATUS:
-		case FLASH_SECTION_SENSOR_SETTINGS:
-			return setOneByteArrayData(FLASH_FILEID_SETTINGS,index,4,bytes_array,tag);
-		case FLASH_SECTION_COLORS:
-			return setOneByteArrayData(FLASH_FILEID_COLOR,index,4,bytes_array,tag);
-		
-		// Manufacturer Data Section
-		case FLASH_SECTION_MANUFACTURE:
-		{
-			default_sizes=getManSizeInfo();
-			return setOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_MAN_START_INDEX],bytes_array,tag);
-		}
-		
-		// User Data Section
-		case FLASH_SECTION_USER:
-		{
-			default_sizes=getUsrSizeInfo();
-			return setOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_USER_START_INDEX],bytes_array,tag);
-		}
-		
-		// Reserved Data Section
-		case FLASH_SECTION_RESERVED:
-		{
-			default_sizes=getReservedSizeInfo();
-			return setOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_RESERVED_START_INDEX],bytes_array,tag);
-		}
-		default:
-			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+	if(p_record == NULL){
+		return FLASH_STATUS_OUT_OF_RANGE_ERR;
 	}
+	return setOneByteArrayData(p_record->file_id,index,p_record->bytes_size,bytes_array,FLASH_RECTAG_CHANGED_BYTE);
 }
 
 /** @Func Read One Record Out of the Flash */
 flash_status_t		getOneRecord(const uint16_t index, uint8_t * bytes_array)
 {
-	const uint8_t   *default_sizes					=	NULL;
-	uint8_t  			  *tag_ptr								=	NULL;
-	flash_section_t flash_sec_code					=	getDataSection(index);
-	
-	// Switch Data Sections
-	switch(flash_sec_code){
-		case FLASH_SECTION_DEVICE_INFO:
-		{
-			default_sizes=getDevSizeInfo();
-			return getOneByteArrayData(FLASH_FILEID_SETTINGS,index,default_sizes[index-SET_DATA_DEVINFO_START_INDEX],bytes_array,tag_ptr);
-		}
-		case FLASH_SECTION_DFU_INFO:
-		case FLASH_SECTION_DEVICE_SETTINGS:
-		case FLASH_SECTION_SYS_STATUS:
-		case FLASH_SECTION_SENSOR_SETTINGS:
-			return getOneByteArrayData(FLASH_FILEID_SETTINGS,index,4,bytes_array,tag_ptr);
-		case FLASH_SECTION_COLORS:
-			return getOneByteArrayData(FLASH_FILEID_COLOR,index,4,bytes_array,tag_ptr);
-		case FLASH_SECTION_MANUFACTURE:
-		{
-			default_sizes=getManSizeInfo();
-			return getOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_MAN_START_INDEX],bytes_array,tag_ptr);
-		}
-		case FLASH_SECTION_USER:
-		{
-			default_sizes=getUsrSizeInfo();
-			return getOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_USER_START_INDEX],bytes_array,tag_ptr);
-		}
-		case FLASH_SECTION_RESERVED:
-		{
-			default_sizes=getReservedSizeInfo();
-			return getOneByteArrayData(FLASH_FILEID_EXTENDED,index,default_sizes[index-EXT_DATA_RESERVED_START_INDEX],bytes_array,tag_ptr);
-		}
-		default:
-			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+	const flash_record_desc_t	*p_record	=	flash_record_of(index);
+	
+	if(p_record == NULL){
+		return FLASH_STATUS_OUT_OF_RANGE_ERR;
 	}
+	return getOneByteArrayData(p_record->file_id,index,p_record->bytes_size,bytes_array,NULL);
 }
 
 /** @Func Delete One Record in the Flash */
 flash_status_t	delOneRecord(const uint16_t index)
 {
-	flash_section_t flash_sec_code = getDataSection(index);
-	
-	// Switch Data Sections
-	switch(flash_sec_code){
-		case FLASH_SECTION_DEVICE_INFO:
-		case FLASH_SECTION_DFU_INFO:
-		case FLASH_SECTION_DEVICE_SETTINGS:
-		case FLASH_SECTION_SYS_STATUS:
-		case FLASH_SECTION_SENSOR_SETTINGS:
-			return delByteArray(FLASH_FILEID_SETTINGS,index);
-		case FLASH_SECTION_COLORS:
-			return delByteArray(FLASH_FILEID_COLOR,index);
-		case FLASH_SECTION_MANUFACTURE:
-		case FLASH_SECTION_USER:
-		case FLASH_SECTION_RESERVED:
-			return delByteArray(FLASH_FILEID_EXTENDED,index);
-		default:
-			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+	const flash_record_desc_t	*p_record	=	flash_record_of(index);
+	
+	if(p_record == NULL){
+		return FLASH_STATUS_OUT_OF_RANGE_ERR;
 	}
+	
+	// Mark the Shadow Slot as Deleted (The Record is Deleted in the Write-back)
+	if(is_flash_cache_loaded){
+		CRITICAL_REGION_ENTER();
+		((uint8_t *)&flash_cache_data[flash_cache_offset[index-1]])[0] = FLASH_RECTAG_NONE_BYTE;
+		flash_cache_mark_dirty(index);
+		CRITICAL_REGION_EXIT();
+		return FLASH_STATUS_SUCCESS;
+	}
+	
+	// A Color is An Entry of Its Packed Color Block
+	if(p_record->section == FLASH_SECTION_COLORS){
+		return flash_color_entry_set(index,FLASH_COLOR_VALUE_SIZE_BYTE,NULL,FLASH_RECTAG_NONE_BYTE);
+	}
+	return delByteArray(p_record->file_id,index);
 }
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -617,4 +865,740 @@ bool isAllRecordValid(void)
 	return true;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** @Func Get the Schema Header Word of the Compiled Record Table (Version, Number of Records, CRC16 of the Layout) */
+static uint32_t flash_schema_header(void)
+{
+	const uint8_t	version	=	FLASH_COLOR_BLOCK_VERSION;
+	uint16_t			crc			=	crc16_compute(&version,1,NULL);
+	uint8_t				row[4];
+	
+	for(uint16_t index = 1; index <= FLASH_RECORD_NUM; index++){
+		row[0]	=	(uint8_t)flash_records[index].file_id;
+		row[1]	=	(uint8_t)(flash_records[index].file_id >> 8);
+		row[2]	=	flash_records[index].bytes_size;
+		row[3]	=	(uint8_t)flash_records[index].section;
+		crc			=	crc16_compute(row,sizeof(row),&crc);
+	}
+	return FLASH_SCHEMA_VERSION | ((uint32_t)FLASH_RECORD_NUM << 8) | ((uint32_t)crc << 16);
+}
+
+/** @Func Migrate One Record to Its Compiled Size (The Old Payload is Read Straight out of the Flash) */
+static flash_status_t flash_schema_migrate(const flash_record_desc_t *p_record, const uint16_t index, const uint8_t old_size)
+{
+	uint8_t					image[FLASH_RECORD_MAX_SIZE_BYTE+1];
+	uint8_t					bytes_size			=	(old_size < p_record->bytes_size) ? old_size : p_record->bytes_size;
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	// Default Value, then the Old Payload over It (Up to the Shorter Size)
+	image[0]	=	FLASH_RECTAG_DEFAULT_BYTE;
+	memcpy(&image[1],p_record->p_default,p_record->bytes_size);
+	flash_ret_code = getByteArray(p_record->file_id,index,bytes_size+1,image);
+	if(flash_ret_code == FLASH_STATUS_NOT_FOUND_ERR || flash_ret_code == FLASH_STATUS_READ_ERR){
+		return initOneRecord(index);
+	}
+	else if(flash_ret_code != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
+	}
+	return setOneByteArrayData(p_record->file_id,index,p_record->bytes_size,&image[1],image[0]);
+}
+
+/** @Func Create the Missing Records and Migrate the Changed Ones */
+flash_status_t	syncAllRecords(void)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	const uint32_t	header					=	flash_schema_header();
+	uint8_t					*old_sizes			=	(uint8_t *)&flash_schema_image[1];
+	uint16_t				old_num					=	0;
+	uint8_t					tag							=	0;
+	
+	// Look Up the Schema Record (One Read when Nothing Changed)
+	flash_ret_code = getByteArray(FLASH_FILEID_EXTENDED,FLASH_SCHEMA_REC_INDEX,sizeof(flash_schema_image),(uint8_t *)flash_schema_image);
+	if(flash_ret_code == FLASH_STATUS_SUCCESS && flash_schema_image[0] == header){
+		return FLASH_STATUS_SUCCESS;
+	}
+	if(flash_ret_code == FLASH_STATUS_SUCCESS && (flash_schema_image[0] & 0xFF) == FLASH_SCHEMA_VERSION){
+		old_num = (flash_schema_image[0] >> 8) & 0xFF;
+	}
+	
+	for(uint16_t index = 1; index <= FLASH_RECORD_NUM; index++){
+		const flash_record_desc_t	*p_record	=	flash_record_of(index);
+		if(p_record == NULL){
+			continue;
+		}
+		
+		// The Payload Size Changed since the Last Synchronization
+		if(index <= old_num && p_record->section != FLASH_SECTION_COLORS && old_sizes[index-1] != 0 && old_sizes[index-1] != p_record->bytes_size){
+			flash_ret_code = flash_schema_migrate(p_record,index,old_sizes[index-1]);
+		}
+		
+		// The Record Does Not Exist Yet
+		else if((flash_ret_code = getOneRecordTag(p_record->file_id,index,&tag)) == FLASH_STATUS_NOT_FOUND_ERR){
+			flash_ret_code = initOneRecord(index);
+		}
+		
+		if(flash_ret_code != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	
+	// All the Records Must Be in the Flash before the Schema Record
+	if((flash_ret_code = flushRecordCache()) != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
+	}
+	
+	memset(flash_schema_image,0,sizeof(flash_schema_image));
+	flash_schema_image[0] = header;
+	for(uint16_t index = 1; index <= FLASH_RECORD_NUM; index++){
+		old_sizes[index-1] = flash_records[index].bytes_size;
+	}
+	return setWordArray(FLASH_FILEID_EXTENDED,FLASH_SCHEMA_REC_INDEX,FLASH_SCHEMA_REC_WORDS,flash_schema_image);
+}
+
+//Fifth Layer: RAM Record Cache//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Queue the Write-back Scheduler Event (Called from Any Context) */
+static void flash_cache_flush_post(void)
+{
+	bool is_post	=	false;
+	
+	CRITICAL_REGION_ENTER();
+	if(!is_flash_cache_flush_posted){
+		is_flash_cache_flush_posted	=	true;
+		is_post											=	true;
+	}
+	CRITICAL_REGION_EXIT();
+	
+	if(is_post){
+		APP_ERROR_CHECK(app_sched_event_put(NULL,0,flash_cache_flush_handler));
+	}
+}
+
+/** @Func Complete the Requests of One Record (The Handlers are Called by the Write-back Scheduler Event) */
+static void flash_request_complete(const uint16_t index, const flash_status_t status)
+{
+	bool is_done	=	false;
+	
+	CRITICAL_REGION_ENTER();
+	for(uint8_t i = 0; i < FLASH_REQUEST_NUM; i++){
+		if(flash_requests[i].handle != FLASH_REQUEST_HANDLE_INVALID && flash_requests[i].index == index && !flash_requests[i].is_done){
+			flash_requests[i].status	=	status;
+			flash_requests[i].is_done	=	true;
+			is_done										=	true;
+		}
+	}
+	CRITICAL_REGION_EXIT();
+	
+	if(is_done){
+		flash_cache_flush_post();
+	}
+}
+
+/** @Func Call the Handlers of the Completed Requests (Scheduler Context) */
+static void flash_request_dispatch(void)
+{
+	flash_request_t request;
+	
+	for(uint8_t i = 0; i < FLASH_REQUEST_NUM; i++){
+		CRITICAL_REGION_ENTER();
+		request = flash_requests[i];
+		if(request.handle != FLASH_REQUEST_HANDLE_INVALID && request.is_done){
+			flash_requests[i].handle = FLASH_REQUEST_HANDLE_INVALID;
+		}
+		CRITICAL_REGION_EXIT();
+		
+		if(request.handle != FLASH_REQUEST_HANDLE_INVALID && request.is_done && request.handler != NULL){
+			request.handler(request.handle,request.index,request.status);
+		}
+	}
+}
+
+/** @Func FDS Request Completion Handler of the Write-back (FDS Event Context) */
+static void flash_cache_request_handler(const uint16_t handle, const uint16_t file_id, const uint16_t rec_key, const ret_code_t result)
+{
+	uint16_t				index			=	rec_key - MAP_INDEX_TO_REC_ID(0);
+	uint16_t				first			=	0;
+	uint16_t				last			=	0;
+	bool						is_dirty	=	false;
+	
+	// A Packed Color Block Completes All Its Indexes
+	if(index >= FLASH_COLOR_BLOCK_REC_INDEX(0) && index < FLASH_COLOR_BLOCK_REC_INDEX(FLASH_COLOR_BLOCK_NUM)){
+		index = flash_color_block_start[index - FLASH_COLOR_BLOCK_REC_INDEX(0)];
+	}
+	if(index == 0 || index > FLASH_CACHE_RECORD_NUM){
+		return;
+	}
+	flash_cache_unit(index,&first,&last);
+	
+	CRITICAL_REGION_ENTER();
+	flash_cache_bits_write(flash_cache_busy,first,last,false);
+	if(result != FDS_SUCCESS){
+		flash_cache_mark_dirty(first);		// Retried by the write-back timer
+	}
+	CRITICAL_REGION_EXIT();
+	
+	// Changed again during the write: the requests wait for the next write-back
+	for(index = first; index <= last; index++){
+		is_dirty = ((flash_cache_dirty[(index-1)/32] & (1UL << ((index-1)%32))) != 0);
+		if(result != FDS_SUCCESS){
+			flash_request_complete(index,FLASH_STATUS_WRITE_ERR);
+		}
+		else if(!is_dirty){
+			flash_request_complete(index,FLASH_STATUS_SUCCESS);
+		}
+	}
+	
+	// Queue the records left by a full queue
+	flash_cache_flush_post();
+}
+
+/** @Func Queue One Changed Record (or Its Packed Color Block) into FDS (The Dirty Bits are Cleared First, so A Change During the Write Schedules Another One) */
+static ret_code_t flash_cache_write_back_async(const uint16_t index)
+{
+	uint8_t const		*slot						=	(uint8_t const *)&flash_cache_data[flash_cache_offset[index-1]];
+	const uint8_t		block						=	flash_color_block_of(index);
+	ret_code_t			ret_code				=	FDS_SUCCESS;
+	uint16_t				first						=	0;
+	uint16_t				last						=	0;
+	
+	flash_cache_unit(index,&first,&last);
+	CRITICAL_REGION_ENTER();
+	flash_cache_bits_write(flash_cache_dirty,first,last,false);
+	flash_cache_bits_write(flash_cache_busy,first,last,true);
+	if(block != FLASH_COLOR_BLOCK_NUM){
+		flash_color_block_pack(block);
+	}
+	CRITICAL_REGION_EXIT();
+	
+	// The Slot (or the Block Image) is Written in Place, a Change before the Completion Marks the Record Dirty Again
+	if(block != FLASH_COLOR_BLOCK_NUM){
+		ret_code = fdsRecWriteAsync(FLASH_FILEID_COLOR,MAP_INDEX_TO_REC_ID(FLASH_COLOR_BLOCK_REC_INDEX(block)),flash_color_image(block),FLASH_COLOR_IMAGE_WORDS(flash_color_block_count[block]),flash_cache_request_handler,NULL);
+	}
+	else if(slot[0] == FLASH_RECTAG_NONE_BYTE){
+		ret_code = fdsRecDeleteAsync(flash_cache_file_id[index-1],MAP_INDEX_TO_REC_ID(index),flash_cache_request_handler,NULL);
+	}
+	else{
+		ret_code = fdsRecWriteAsync(flash_cache_file_id[index-1],MAP_INDEX_TO_REC_ID(index),(uint32_t const *)slot,FLASH_CACHE_SLOT_WORDS(flash_cache_size[index-1]),flash_cache_request_handler,NULL);
+	}
+	
+	// Not Queued (A Missing Record Needs No Deletion)
+	if(ret_code != FDS_SUCCESS){
+		CRITICAL_REGION_ENTER();
+		flash_cache_bits_write(flash_cache_busy,first,last,false);
+		if(ret_code != FDS_ERR_NOT_FOUND){
+			flash_cache_bits_write(flash_cache_dirty,first,last,true);
+		}
+		CRITICAL_REGION_EXIT();
+		if(ret_code == FDS_ERR_NOT_FOUND){
+			flash_request_complete(index,FLASH_STATUS_SUCCESS);
+			ret_code = FDS_SUCCESS;
+		}
+	}
+	return ret_code;
+}
+
+/** @Func Write One Changed Record (or Its Packed Color Block) Back and Wait (The Dirty Bits are Cleared First, so A Change During the Write Schedules Another One) */
+static flash_status_t flash_cache_write_back(const uint16_t index)
+{
+	uint8_t const		*slot						=	(uint8_t const *)&flash_cache_data[flash_cache_offset[index-1]];
+	const uint8_t		block						=	flash_color_block_of(index);
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	uint16_t				first						=	0;
+	uint16_t				last						=	0;
+	
+	flash_cache_unit(index,&first,&last);
+	CRITICAL_REGION_ENTER();
+	flash_cache_bits_write(flash_cache_dirty,first,last,false);
+	if(block != FLASH_COLOR_BLOCK_NUM){
+		flash_color_block_pack(block);
+	}
+	CRITICAL_REGION_EXIT();
+	
+	if(block != FLASH_COLOR_BLOCK_NUM){
+		flash_ret_code = setWordArray(FLASH_FILEID_COLOR,FLASH_COLOR_BLOCK_REC_INDEX(block),FLASH_COLOR_IMAGE_WORDS(flash_color_block_count[block]),flash_color_image(block));
+	}
+	else if(slot[0] == FLASH_RECTAG_NONE_BYTE){
+		flash_ret_code = delByteArray(flash_cache_file_id[index-1],index);
+		// A Record Never Written is Already Deleted
+		if(flash_ret_code == FLASH_STATUS_NOT_FOUND_ERR){
+			flash_ret_code = FLASH_STATUS_SUCCESS;
+		}
+	}
+	else{
+		flash_ret_code = setWordArray(flash_cache_file_id[index-1],index,FLASH_CACHE_SLOT_WORDS(flash_cache_size[index-1]),(uint32_t const *)slot);
+	}
+	
+	// Keep the Record Dirty to Retry Later
+	if(flash_ret_code != FLASH_STATUS_SUCCESS){
+		CRITICAL_REGION_ENTER();
+		flash_cache_mark_dirty(first);
+		CRITICAL_REGION_EXIT();
+	}
+	for(uint16_t i = first; i <= last; i++){
+		flash_request_complete(i,flash_ret_code);
+	}
+	return flash_ret_code;
+}
+
+/** @Func Find the First Changed Record that is Not Being Written (0 if None) */
+static uint16_t flash_cache_first_dirty(void)
+{
+	for(uint16_t i = 0; i < CAL_WORD_ARRAY_SIZE(FLASH_CACHE_RECORD_NUM,32); i++){
+		uint32_t bits = flash_cache_dirty[i] & ~flash_cache_busy[i];
+		if(bits != 0){
+			return i*32 + (31 - __CLZ(bits & (0UL - bits))) + 1;		// Lowest set bit (CLZ only, so the host simulation builds it too)
+		}
+	}
+	return 0;
+}
+
+/** @Func Scheduler Event Handler Queueing All the Changed Records into FDS at Once */
+static void flash_cache_flush_handler(void *p_event_data, uint16_t event_size)
+{
+	uint16_t				index				=	0;
+	ret_code_t			ret_code		=	FDS_SUCCESS;
+	
+	CRITICAL_REGION_ENTER();
+	is_flash_cache_flush_posted = false;
+	CRITICAL_REGION_EXIT();
+	
+	// Report the Completed Requests
+	flash_request_dispatch();
+	
+	// Flash Full: Continue after the Garbage Collection (flushRecordCacheOnGC)
+	if(is_flash_cache_gc_waiting){
+		return;
+	}
+	
+	// Pipeline the Changed Records (The Completions Post This Event Again for the Records Left)
+	while((index = flash_cache_first_dirty()) != 0){
+		ret_code = flash_cache_write_back_async(index);
+		
+		// Queue Full: Continue after the Next Completion
+		if(ret_code == FDS_ERR_NO_SPACE_IN_QUEUES){
+			break;
+		}
+		
+		// Flash Full: The Record Stays Dirty and Its Requests Pending until the Storage Health Module Reports the Garbage Collection
+		else if(ret_code == FDS_ERR_NO_SPACE_IN_FLASH){
+			is_flash_cache_gc_waiting = true;
+			storageHealthRequestGC();
+			break;
+		}
+		
+		// Other Errors: Retried by the Write-back Timer
+		else if(ret_code != FDS_SUCCESS){
+			CRITICAL_REGION_ENTER();
+			flash_cache_mark_dirty(index);
+			CRITICAL_REGION_EXIT();
+			flash_request_complete(index,FLASH_STATUS_WRITE_ERR);
+			break;
+		}
+	}
+}
+
+/** @Func Write-back Timer Time-out Handler */
+static void flash_cache_timer_handler(void * p_context)
+{
+	const uint32_t	delay_ticks	=	APP_TIMER_TICKS(FLASH_CACHE_FLUSH_DELAY_MS, FLASH_CACHE_TIMER_PRESCALER);
+	uint32_t				quiet_ticks	=	0;
+	
+	CRITICAL_REGION_ENTER();
+	app_timer_cnt_diff_compute(app_timer_cnt_get(), flash_cache_change_ticks, &quiet_ticks);
+	
+	// Changed Again within the Delay: Wait for the Rest of It
+	if(quiet_ticks + APP_TIMER_MIN_TIMEOUT_TICKS < delay_ticks){
+		is_flash_cache_timer_running = (app_timer_start(flash_cache_timer_id, delay_ticks - quiet_ticks, NULL) == NRF_SUCCESS);
+	}
+	else{
+		is_flash_cache_timer_running = false;
+	}
+	CRITICAL_REGION_EXIT();
+	
+	if(!is_flash_cache_timer_running){
+		flash_cache_flush_post();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Load All Records into the RAM Shadow */
+flash_status_t	loadRecordCache(void)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	uint16_t				offset					=	0;
+	uint8_t					*slot						=	NULL;
+	bool						is_legacy				=	false;
+	
+	if(!is_flash_cache_loaded){
+		APP_ERROR_CHECK(app_timer_create(&flash_cache_timer_id, APP_TIMER_MODE_SINGLE_SHOT, flash_cache_timer_handler));
+	}
+	fdsRequestWait();
+	is_flash_cache_loaded = false;
+	memset(flash_cache_dirty, 0, sizeof(flash_cache_dirty));
+	memset(flash_cache_busy, 0, sizeof(flash_cache_busy));
+	
+	for(uint16_t index = 1; index <= FLASH_CACHE_RECORD_NUM; index++){
+		// Place the Slot
+		if(!flash_record_layout(index,&flash_cache_file_id[index-1],&flash_cache_size[index-1])){
+			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+		}
+		flash_cache_offset[index-1]	=	offset;
+		offset										 += FLASH_CACHE_SLOT_WORDS(flash_cache_size[index-1]);
+		if(offset > FLASH_CACHE_DATA_WORDS){
+			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+		}
+		
+		// Read the Record Image (Tag + Payload) Straight into the Slot (The Colors are Read by Block Below)
+		slot						=	(uint8_t *)&flash_cache_data[flash_cache_offset[index-1]];
+		slot[0]					=	FLASH_RECTAG_NONE_BYTE;
+		if(flash_color_block_of(index) != FLASH_COLOR_BLOCK_NUM){
+			continue;
+		}
+		flash_ret_code	=	getByteArray(flash_cache_file_id[index-1],index,flash_cache_size[index-1]+1,slot);
+		if(flash_ret_code == FLASH_STATUS_NOT_FOUND_ERR || flash_ret_code == FLASH_STATUS_READ_ERR){
+			slot[0] = FLASH_RECTAG_NONE_BYTE;		// A shorter record has an older layout (Migrated by syncAllRecords)
+		}
+		else if(flash_ret_code != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	
+	// One Record per Color Block (Per-index Records of Older Firmware are Packed Now)
+	for(uint8_t block = 0; block < FLASH_COLOR_BLOCK_NUM; block++){
+		flash_ret_code = flash_color_block_fetch(block,&is_legacy);
+		if(flash_ret_code == FLASH_STATUS_NOT_FOUND_ERR){
+			continue;
+		}
+		else if(flash_ret_code != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+		flash_color_block_unpack(block);
+		if(is_legacy && (flash_ret_code = flash_color_block_store(block,true)) != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	
+	is_flash_cache_loaded = true;
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Write All Changed Records Back to the Flash */
+flash_status_t	flushRecordCache(void)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	uint16_t				index						=	0;
+	
+	if(!is_flash_cache_loaded){
+		return FLASH_STATUS_SUCCESS;
+	}
+	
+	CRITICAL_REGION_ENTER();
+	app_timer_stop(flash_cache_timer_id);
+	is_flash_cache_timer_running = false;
+	CRITICAL_REGION_EXIT();
+	
+	// Let the Queued Write-backs Complete (Their Records are Not Busy Any More)
+	fdsRequestWait();
+	
+	while((index = flash_cache_first_dirty()) != 0){
+		if((flash_ret_code = flash_cache_write_back(index)) != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Continue the Write-back after A Garbage Collection */
+void flushRecordCacheOnGC(const ret_code_t result)
+{
+	bool						is_waiting	=	is_flash_cache_gc_waiting;
+	
+	is_flash_cache_gc_waiting = false;
+	if(!is_flash_cache_loaded){
+		return;
+	}
+	
+	// Space Reclaimed: Write the Changed Records Left by the Full Flash
+	if(result == FDS_SUCCESS){
+		if(flash_cache_first_dirty() != 0){
+			flash_cache_flush_post();
+		}
+		return;
+	}
+	
+	// Nothing Reclaimed: The Records Stay Dirty (Written with the Next Change), the Waiting Requests Fail
+	for(uint16_t index = 1; is_waiting && index <= FLASH_CACHE_RECORD_NUM; index++){
+		if((flash_cache_dirty[(index-1)/32] & (1UL << ((index-1)%32))) != 0){
+			flash_request_complete(index,FLASH_STATUS_GC_ERR);
+		}
+	}
+}
+
+/** @Func Check Whether the RAM Shadow is in Use */
+bool isRecordCacheLoaded(void)
+{
+	return is_flash_cache_loaded;
+}
+
+/** @Func Check Whether Any Record Waits to Be Written Back */
+bool isRecordCacheDirty(void)
+{
+	return (flash_cache_first_dirty() != 0);
+}
+
+//Sixth Layer: Non-blocking Record Requests//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Register A Request on A Changed Record and Queue the Write-back at Once */
+static flash_status_t flash_request_start(const uint16_t index, flash_request_handler_t handler, uint16_t *p_handle)
+{
+	flash_request_t	*p_request	=	NULL;
+	
+	CRITICAL_REGION_ENTER();
+	for(uint8_t i = 0; i < FLASH_REQUEST_NUM; i++){
+		if(flash_requests[i].handle == FLASH_REQUEST_HANDLE_INVALID){
+			p_request = &flash_requests[i];
+			if(++flash_request_next_handle == FLASH_REQUEST_HANDLE_INVALID){
+				flash_request_next_handle++;
+			}
+			p_request->handle		=	flash_request_next_handle;
+			p_request->index		=	index;
+			p_request->status		=	FLASH_STATUS_SUCCESS;
+			p_request->is_done	=	false;
+			p_request->handler	=	handler;
+			break;
+		}
+	}
+	CRITICAL_REGION_EXIT();
+	
+	// The Change is Kept in the Shadow and Written Back by the Timer
+	if(p_request == NULL){
+		return FLASH_STATUS_BUSY_ERR;
+	}
+	if(p_handle != NULL){
+		*p_handle = p_request->handle;
+	}
+	
+	// No Quiet Time: Queue the Record with the Other Changed Ones
+	flash_cache_flush_post();
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Write One Record and Report the Completion */
+flash_status_t	setOneRecordAsync(const uint16_t index, const uint8_t* const bytes_array, flash_request_handler_t handler, uint16_t *p_handle)
+{
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	if(!is_flash_cache_loaded){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	if((flash_ret_code = setOneRecord(index,bytes_array)) != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
+	}
+	return flash_request_start(index,handler,p_handle);
+}
+
+/** @Func Delete One Record and Report the Completion */
+flash_status_t	delOneRecordAsync(const uint16_t index, flash_request_handler_t handler, uint16_t *p_handle)
+{
+	flash_status_t	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	if(!is_flash_cache_loaded){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	if((flash_ret_code = delOneRecord(index)) != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
+	}
+	return flash_request_start(index,handler,p_handle);
+}
+
+/** @Func Check Whether A Request is Not Completed Yet */
+bool isRecordRequestPending(const uint16_t handle)
+{
+	for(uint8_t i = 0; i < FLASH_REQUEST_NUM; i++){
+		if(handle != FLASH_REQUEST_HANDLE_INVALID && flash_requests[i].handle == handle){
+			return true;
+		}
+	}
+	return false;
+}
+
+//Seventh Layer: Record Transactions//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Get the Staged Indexes in the Commit Marker Image */
+static uint16_t * flash_transaction_indexes(void)
+{
+	return (uint16_t *)&flash_transaction_marker[1];
+}
+
+/** @Func Delete the Whole Shadow File (Nothing is Queued if It Holds No Record) */
+static flash_status_t flash_transaction_drop(void)
+{
+	if(fdsFileDelete(FLASH_FILEID_SHADOW) != FDS_SUCCESS){
+		return FLASH_STATUS_DEL_ERR;
+	}
+	
+	flash_transaction_count					=	0;
+	is_flash_transaction_committed	=	false;
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Delete the Commit Marker First (A Reset Afterwards Only Leaves Staged Records to Drop), then the Whole Shadow File */
+static flash_status_t flash_transaction_clear(void)
+{
+	flash_status_t 	flash_ret_code	=	delByteArray(FLASH_FILEID_SHADOW,FLASH_TRANSACTION_MARKER_INDEX);
+	
+	if(flash_ret_code != FLASH_STATUS_SUCCESS && flash_ret_code != FLASH_STATUS_NOT_FOUND_ERR){
+		return flash_ret_code;
+	}
+	return flash_transaction_drop();
+}
+
+/** @Func Write the Staged Records of A Committed Transaction to Their Own Records (Roll-forward, Can Be Repeated) */
+static flash_status_t flash_transaction_apply(void)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	uint32_t				value[FLASH_SCRATCH_WORDS];
+	uint16_t				file_id					=	0;
+	uint8_t					bytes_size			=	0;
+	uint16_t				index						=	0;
+	
+	for(uint16_t i = 0; i < flash_transaction_count; i++){
+		index = flash_transaction_indexes()[i];
+		if(!flash_record_layout(index,&file_id,&bytes_size)){
+			return FLASH_STATUS_OUT_OF_RANGE_ERR;
+		}
+		if((flash_ret_code = getByteArray(FLASH_FILEID_SHADOW,FLASH_SHADOW_INDEX(index),bytes_size,(uint8_t *)value)) != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+		if((flash_ret_code = setOneRecord(index,(const uint8_t *)value)) != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	
+	// The Records Must Be in the Flash before the Marker is Deleted
+	if((flash_ret_code = flushRecordCache()) != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
+	}
+	return flash_transaction_clear();
+}
+
+/** @Func Open A Transaction */
+flash_status_t	beginRecordTransaction(void)
+{
+	if(is_flash_transaction_open || is_flash_transaction_committed){
+		return FLASH_STATUS_BUSY_ERR;
+	}
+	
+	memset(flash_transaction_marker, 0, sizeof(flash_transaction_marker));
+	flash_transaction_count	=	0;
+	is_flash_transaction_open	=	true;
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Stage One Record in the Open Transaction */
+flash_status_t	stageOneRecord(const uint16_t index, const uint8_t* const bytes_array)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	uint16_t				file_id					=	0;
+	uint8_t					bytes_size			=	0;
+	uint16_t				i								=	0;
+	
+	if(!is_flash_transaction_open){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	if(!flash_record_layout(index,&file_id,&bytes_size)){
+		return FLASH_STATUS_OUT_OF_RANGE_ERR;
+	}
+	
+	// Write the Value into the Shadow File (An Index Staged Again is Updated and Listed Once)
+	if((flash_ret_code = setByteArray(FLASH_FILEID_SHADOW,FLASH_SHADOW_INDEX(index),bytes_size,bytes_array)) != FLASH_STATUS_SUCCESS){
+		return flash_ret_code;
+	}
+	while(i < flash_transaction_count && flash_transaction_indexes()[i] != index){
+		i++;
+	}
+	if(i == flash_transaction_count){
+		flash_transaction_indexes()[flash_transaction_count++] = index;
+	}
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Commit the Staged Records Together */
+flash_status_t	commitRecordTransaction(void)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	if(!is_flash_transaction_open){
+		return FLASH_STATUS_SETUP_ERR;
+	}
+	is_flash_transaction_open	=	false;
+	if(flash_transaction_count == 0){
+		return FLASH_STATUS_SUCCESS;
+	}
+	
+	// Commit Point: Once the Marker is in the Flash, the Transaction is Completed even after A Reset
+	flash_transaction_marker[0]	=	FLASH_TRANSACTION_VERSION | ((uint32_t)flash_transaction_count << 16);
+	if((flash_ret_code = setWordArray(FLASH_FILEID_SHADOW,FLASH_TRANSACTION_MARKER_INDEX,FLASH_TRANSACTION_MARKER_WORDS,flash_transaction_marker)) != FLASH_STATUS_SUCCESS){
+		flash_transaction_clear();
+		return flash_ret_code;
+	}
+	is_flash_transaction_committed	=	true;
+	
+	return flash_transaction_apply();
+}
+
+/** @Func Drop the Staged Records */
+flash_status_t	abortRecordTransaction(void)
+{
+	if(!is_flash_transaction_open){
+		return FLASH_STATUS_SUCCESS;
+	}
+	is_flash_transaction_open	=	false;
+	return flash_transaction_clear();
+}
+
+/** @Func Complete or Drop A Transaction Interrupted by A Reset */
+flash_status_t	recoverRecordTransaction(void)
+{
+	flash_status_t 	flash_ret_code	=	FLASH_STATUS_SUCCESS;
+	
+	if(is_flash_transaction_open){
+		return FLASH_STATUS_BUSY_ERR;
+	}
+	
+	// Look for the Commit Marker (Unless the Last Commit in This Session Has Not Completed)
+	if(!is_flash_transaction_committed){
+		// Empty Shadow File (Every Boot without An Interrupted Transaction): Nothing to Look for or to Delete
+		if(!fdsFileHasRecords(FLASH_FILEID_SHADOW)){
+			return FLASH_STATUS_SUCCESS;
+		}
+		
+		flash_ret_code = getByteArray(FLASH_FILEID_SHADOW,FLASH_TRANSACTION_MARKER_INDEX,sizeof(flash_transaction_marker),(uint8_t *)flash_transaction_marker);
+		
+		// No Marker: Roll Back (Drop the Records Staged without A Commit)
+		if(flash_ret_code == FLASH_STATUS_NOT_FOUND_ERR){
+			return flash_transaction_drop();
+		}
+		else if(flash_ret_code != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+		
+		// A Marker of Another Layout Cannot Be Rolled Forward
+		flash_transaction_count = flash_transaction_marker[0] >> 16;
+		if((flash_transaction_marker[0] & 0xFFFF) != FLASH_TRANSACTION_VERSION || flash_transaction_count > FLASH_TRANSACTION_RECORD_NUM){
+			return flash_transaction_clear();
+		}
+		is_flash_transaction_committed	=	true;
+	}
+	
+	// Marker: Roll Forward
+	return flash_transaction_apply();
+}
+
+/** @Func Check Whether A Transaction is Open */
+bool isRecordTransactionOpen(void)
+{
+	return is_flash_transaction_open;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
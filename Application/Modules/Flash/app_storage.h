@@ -8,13 +8,25 @@
 	*******************************************************************************************************************************
 	* This file includes four layers of functions:
 	* Basic Utilities (bytes2words,words2bytes)-Essential uitility functions used in this library.
-	* First Layer (setByteArray,getByteArray,delByteArray)-Interface of the FDS driver layer
-	* Second Layer (setOneByteArrayData,getOneByteArrayData)-Add the status tag in each record
+	* First Layer (setWordArray,setByteArray,getByteArray,delByteArray)-Interface of the FDS driver layer
+	* Second Layer (setOneByteArrayData,getOneByteArrayData,getOneRecordTag)-Add the status tag in each record
 	* Third Layer (getDataSection,getOneRecordStatus,initOneRecord,setOneRecord,getOneRecord,delOneRecord)-Basic application functions
-	* Fourth Layer (initAllRecords)- Application-oriented functions
+	* Fourth Layer (initAllRecords,syncAllRecords)- Application-oriented functions
+	* Fifth Layer (loadRecordCache,flushRecordCache,flushRecordCacheOnGC)- RAM shadow of all records with background write-back
+	* Sixth Layer (setOneRecordAsync,delOneRecordAsync)- Record changes with a request handle and a completion handler
+	* Seventh Layer (beginRecordTransaction,stageOneRecord,commitRecordTransaction,abortRecordTransaction,recoverRecordTransaction)- Crash-safe multi-record updates
 	********************************************************************************************************************************
 	* Note: 	1.Before using this module, initialization of the FDS system is required (Using the fdsInit function in "drv_storage.h").
 	* 			 	2.The FDS system needs some configuration. The configuration can be set in "sdk_config.h" file or include a separate "fds_config.h" file.
+	* 				3.Once loadRecordCache has succeeded, the second layer reads and writes the RAM shadow instead of the flash.
+	* 				  Changed records are written back from the scheduler context after FLASH_CACHE_FLUSH_DELAY_MS without any further change.
+	* 				  The write-back queues all the changed records into FDS at once (fdsRecWriteAsync) instead of waiting for each of them.
+	* 				4.The color records are packed into one flash record per calibration block (see FLASH_COLOR_BLOCK_VERSION).
+	* 				  The color indexes are still read and written one by one, only the flash layout is changed.
+	* 				5.A transaction stages its records in the shadow file and commits them with one marker record (see FLASH_FILEID_SHADOW).
+	* 				  After a reset, recoverRecordTransaction completes a committed transaction and drops an uncommitted one.
+	* 				6.The record layout is checked at boot by syncAllRecords against a schema record (see FLASH_SCHEMA_VERSION).
+	* 				  Only the missing records are created and only the records whose size changed are migrated, the others are kept.
 	*
 	*	@Macro	FLASH_RECTAG_DEFAULT_BYTE 	(Record Tag for Default Record Value)
 	*	@Macro	FLASH_RECTAG_CHANGED_BYTE 	(Record Tag for Record Value that Has Been Changed from its Default Value)
@@ -23,19 +35,44 @@
 	*	@Macro	FLASH_FILEID_EXTENDED				(File ID for Extended Data)
 	*	@Macro	CAL_WORD_ARRAY_SIZE					(Procedure for Calculation of the Word-Array Size)
 	* @Macro	MAP_INDEX_TO_REC_ID					(Precedure for Mapping An Index into A Record Key)
+	*	@Macro	FLASH_RECTAG_NONE_BYTE			(Record Tag of A Cached Record that Does Not Exist in the Flash)
+	*	@Macro	FLASH_CACHE_FLUSH_DELAY_MS	(Quiet Time before the Changed Records are Written Back)
+	*	@Macro	FLASH_RECORD_NUM						(Largest Record Index, the Size of the Record Table)
+	*	@Macro	FLASH_CACHE_RECORD_NUM			(Number of Records in the RAM Shadow)
+	*	@Macro	FLASH_CACHE_DATA_WORDS			(Size of the RAM Shadow in Words)
+	*	@Macro	FLASH_RECORD_MAX_SIZE_BYTE	(Size of the Largest Record Payload)
+	*	@Macro	FLASH_SCRATCH_WORDS					(Size of the Scratch Words for Padding A Record Image)
+	*	@Macro	FLASH_REQUEST_NUM						(Number of Non-blocking Record Requests Waiting for Completion)
+	*	@Macro	FLASH_REQUEST_HANDLE_INVALID	(Request Handle Never Returned)
+	*	@Macro	FLASH_COLOR_BLOCK_VERSION		(Format Version of the Packed Color Records)
+	*	@Macro	FLASH_COLOR_BLOCK_REC_INDEX	(Record Index of A Packed Color Block)
+	*	@Macro	FLASH_COLOR_IMAGE_WORDS			(Size of A Packed Color Record in Words)
+	*	@Macro	FLASH_FILEID_SHADOW					(File ID for the Records Staged by A Transaction)
+	*	@Macro	FLASH_SHADOW_INDEX					(Procedure for Mapping An Index into Its Staged Record Index)
+	*	@Macro	FLASH_TRANSACTION_MARKER_INDEX	(Record Index of the Commit Marker)
+	*	@Macro	FLASH_TRANSACTION_MARKER_WORDS	(Size of the Commit Marker in Words)
+	*	@Macro	FLASH_SCHEMA_VERSION				(Format Version of the Schema Record)
+	*	@Macro	FLASH_SCHEMA_REC_INDEX			(Record Index of the Schema Record)
+	*	@Macro	FLASH_SCHEMA_REC_WORDS			(Size of the Schema Record in Words)
 	*
 	*	@Type		flash_status_t							(Flash Operation Status)
 	*	@Type		flash_section_t							(Data Section)
+	*	@Type		flash_request_handler_t			(Completion Handler of A Non-blocking Record Request)
+	*	@Type		flash_request_t							(Non-blocking Record Request)
+	*	@Type		flash_color_block_t					(Packed Color Blocks)
+	*	@Type		flash_record_desc_t					(Row of the Record Table)
 	*
 	*	@Func		bytes2words									(Byte-array to Word-array Conversion)
 	*	@Func		words2bytes									(Word-array to Byte-array Conversion)
 	*
+	*	@Func		setWordArray								(Write a Word-array Record Image into the Flash without Copy)
 	*	@Func		setByteArray								(Write a Byte-array Record into the Flash)
 	*	@Func		getByteArray								(Read a Byte-array Record out of the Flash)
 	*	@Func		delByteArray								(Delete a Byte-array Record in the Flash)
 	*
 	*	@Func		setOneByteArrayData					(Write a Byte-array Record into the Flash with Record Tag)
 	*	@Func		getOneByteArrayData					(Read a Byte-array Record out of the Flash with Record Tag)
+	*	@Func		getOneRecordTag							(Read the Record Tag Only)
 	*
 	*	@Func		getDataSection							(Check the Data Section of the Specified Data Index)
 	*	@Func		getOneRecordStatus					(Read out the Record Status According to Its Tag)
@@ -47,6 +84,24 @@
 	*
 	*	@Func   initAllRecords							(Initialize All Records)
 	*	@Func		isAllRecordValid						(Check the Validity of the Record)
+	*	@Func		syncAllRecords							(Create the Missing Records and Migrate the Changed Ones)
+	*
+	*	@Func		loadRecordCache							(Load All Records into the RAM Shadow)
+	*	@Func		flushRecordCache						(Write All Changed Records Back to the Flash)
+	*	@Func		flushRecordCacheOnGC				(Continue the Write-back after A Garbage Collection)
+	*	@Func		isRecordCacheLoaded					(Check Whether the RAM Shadow is in Use)
+	*	@Func		isRecordCacheDirty					(Check Whether Any Record Waits to Be Written Back)
+	*
+	*	@Func		setOneRecordAsync						(Write One Record and Report the Completion)
+	*	@Func		delOneRecordAsync						(Delete One Record and Report the Completion)
+	*	@Func		isRecordRequestPending			(Check Whether A Request is Not Completed Yet)
+	*
+	*	@Func		beginRecordTransaction			(Open A Transaction)
+	*	@Func		stageOneRecord							(Stage One Record in the Open Transaction)
+	*	@Func		commitRecordTransaction			(Commit the Staged Records Together)
+	*	@Func		abortRecordTransaction			(Drop the Staged Records)
+	*	@Func		recoverRecordTransaction		(Complete or Drop A Transaction Interrupted by A Reset)
+	*	@Func		isRecordTransactionOpen			(Check Whether A Transaction is Open)
 	*
 */
 
@@ -59,6 +114,13 @@
 // FDS Driver Module
 #include "drv_storage.h"
 
+// Write-back Scheduling
+#include "app_timer.h"
+#include "app_scheduler.h"
+
+// Packed Color Records
+#include "crc16.h"
+
 // Application-oriented Data Files
 #include "data_colors.h"
 #include "data_settings.h"
@@ -100,6 +162,87 @@
 */
 #define MAP_INDEX_TO_REC_ID(A) (0x1000+A)
 
+/** @Macro Define the RAM shadow of the records
+	* Every record is kept in a word-aligned slot holding its flash image: the status tag followed by the payload.
+	* A slot tagged FLASH_RECTAG_NONE_BYTE holds a record that does not exist in the flash (or has been deleted).
+	* The data size is the sum of the slot sizes of all the records defined in the data files.
+*/
+#define FLASH_RECORD_MAX_SIZE_BYTE									 40				// SET_DATA_DEVINFO_FCDT, EXT_DATA_MAN_CALIBT/UNITT, EXT_DATA_USER_FCDT
+#define FLASH_SCRATCH_WORDS													 CAL_WORD_ARRAY_SIZE(FLASH_RECORD_MAX_SIZE_BYTE+1,sizeof(uint32_t))
+#define FLASH_RECTAG_NONE_BYTE											 0x00
+#define FLASH_CACHE_FLUSH_DELAY_MS									 2000
+#define FLASH_CACHE_TIMER_PRESCALER									 0				// Must be the same as APP_TIMER_PRESCALER
+#define FLASH_RECORD_NUM														 EXT_DATA_RESERVED_END_INDEX
+#define FLASH_CACHE_RECORD_NUM											 FLASH_RECORD_NUM
+
+#define FLASH_CACHE_SLOT_WORDS(A) CAL_WORD_ARRAY_SIZE((A)+1,sizeof(uint32_t))
+#define FLASH_CACHE_DATA_WORDS	(	FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_VMI_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_SN_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_MAC_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_NAME_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_MODN_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_MANN_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_HR_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_FR_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(SET_DATA_DEVINFO_FCDT_SIZE_BYTE) \
+																+ (SET_DATA_ONE_WORD_NUM) * FLASH_CACHE_SLOT_WORDS(4) \
+																+ (COLOR_DATA_NUM) * FLASH_CACHE_SLOT_WORDS(4) \
+																+ FLASH_CACHE_SLOT_WORDS(EXT_DATA_MAN_UNITN_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(EXT_DATA_MAN_CALIBT_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(EXT_DATA_MAN_UNITT_SIZE_BYTE) \
+																+ FLASH_CACHE_SLOT_WORDS(EXT_DATA_USER_FCDT_SIZE_BYTE) \
+																+ (EXT_DATA_RESERVED_NUM) * FLASH_CACHE_SLOT_WORDS(4) )
+
+/** @Macro Define the non-blocking record requests
+	* A request waits for the write-back of its record, and all the requests on the same record complete together.
+*/
+#define FLASH_REQUEST_NUM														 16
+#define FLASH_REQUEST_HANDLE_INVALID								 0
+
+/** @Macro Define the packed color records
+	* The colors are not stored as one record per index, but as one record per calibration block (mother, factory, greyscale factory,
+	* temperature, greyscale user, user temperature). The block record holds a header word (version, count, CRC16 of the rest),
+	* the tags of all the entries packed into whole words, then one word per entry value.
+	* The block records use the free record keys at the top of the record index window (after the last index of the data files).
+	* Per-index color records written by older firmware are still read, then packed into the block and deleted.
+*/
+#define FLASH_COLOR_BLOCK_VERSION										 1
+#define FLASH_COLOR_VALUE_SIZE_BYTE									 4
+#define FLASH_COLOR_BLOCK_REC_BASE									 0x78			// Record key 0x1078
+#define FLASH_COLOR_BLOCK_REC_INDEX(B) ((FLASH_COLOR_BLOCK_REC_BASE)+(B))
+#define FLASH_COLOR_IMAGE_WORDS(N) (1+CAL_WORD_ARRAY_SIZE((N),sizeof(uint32_t))+(N))
+#define FLASH_COLOR_IMAGE_DATA_WORDS	(	FLASH_COLOR_IMAGE_WORDS(COLOR_DATA_MOTHER_NUM) \
+																			+ FLASH_COLOR_IMAGE_WORDS(COLOR_DATA_FACTORY_NUM) \
+																			+ FLASH_COLOR_IMAGE_WORDS(COLOR_DATA_GREYSCALE_FACTORY_NUM) \
+																			+ FLASH_COLOR_IMAGE_WORDS(COLOR_DATA_TEMP_NUM) \
+																			+ FLASH_COLOR_IMAGE_WORDS(COLOR_DATA_GREYSCALE_USER_NUM) \
+																			+ FLASH_COLOR_IMAGE_WORDS(COLOR_DATA_TEMP_USER_NUM) )
+
+/** @Macro Define the record transactions
+	* The staged records are written into their own file, with the record key of the index moved up by FLASH_TRANSACTION_SHADOW_OFFSET
+	* (outside the record index window). The commit marker is one record of the same file holding a header word (version, count)
+	* and the staged indexes. FDS validates a record header last, so after a reset the marker is either complete or not found:
+	* a marker means all the staged records are in the flash and the transaction is written again (roll-forward),
+	* no marker means the staged records are dropped (roll-back).
+*/
+#define FLASH_FILEID_SHADOW													 0xADDD		//File ID for the Records Staged by A Transaction
+#define FLASH_TRANSACTION_VERSION										 1
+#define FLASH_TRANSACTION_SHADOW_OFFSET							 0x1000		// Record keys 0x2000 - 0x2FFF
+#define FLASH_TRANSACTION_RECORD_NUM								 FLASH_CACHE_RECORD_NUM
+#define FLASH_SHADOW_INDEX(A) ((A)+FLASH_TRANSACTION_SHADOW_OFFSET)
+#define FLASH_TRANSACTION_MARKER_INDEX							 FLASH_SHADOW_INDEX(0)
+#define FLASH_TRANSACTION_MARKER_WORDS							 (1+CAL_WORD_ARRAY_SIZE(FLASH_TRANSACTION_RECORD_NUM,sizeof(uint16_t)))
+
+/** @Macro Define the schema record
+	* The schema record holds a header word (version, number of records, CRC16 of the record table layout), then the payload size
+	* of every index as it was when the record was last synchronized. The CRC16 covers the file ID, the size and the section of
+	* each index and the packed color version, so any change of the data files is found with one record read at boot.
+	* It uses the last record key of the record index window, in the extended data file.
+*/
+#define FLASH_SCHEMA_VERSION												 1
+#define FLASH_SCHEMA_REC_INDEX											 0x7F			// Record key 0x107F
+#define FLASH_SCHEMA_REC_WORDS											 (1+CAL_WORD_ARRAY_SIZE(FLASH_RECORD_NUM,sizeof(uint32_t)))
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #ifdef __cplusplus
 extern "C" {
@@ -127,7 +270,9 @@ typedef enum {
 	FLASH_STATUS_OUT_OF_RANGE_ERR,    	//Flash Index Out of Range Error
 	FLASH_STATUS_REC_UNCHANGED,					//Flash Record Exists And Unchanged(Has the Default Value)
 	FLASH_STATUS_REC_CHANGED,						//Flash Record Exists But Was Changed
-	FLASH_STATUS_RECTAG_ERR							//Flash Record Flag Error(Something Happened and the Flag Does Not Equal to Valid or Invalid)		
+	FLASH_STATUS_RECTAG_ERR,						//Flash Record Flag Error(Something Happened and the Flag Does Not Equal to Valid or Invalid)		
+	FLASH_STATUS_BUSY_ERR,							//Flash Request Error(All the Request Entries are in Use, or A Transaction is Open)
+	FLASH_STATUS_FULL_ERR								//Flash Full Error(A Garbage Collection is Requested from the Storage Health Module, Try Again after It)
 }flash_status_t;
 
 /** @Type Flash Data Section */
@@ -144,13 +289,45 @@ typedef enum {
 	FLASH_SECTION_RESERVED							//Data Section of the Reserved Data
 }flash_section_t;
 
+/** @Type Packed Color Blocks (One Flash Record Each) */
+typedef enum {
+	FLASH_COLOR_BLOCK_MOTHER,						//Mother Calibration Coefficients
+	FLASH_COLOR_BLOCK_FACTORY,					//Factory Calibration Coefficients
+	FLASH_COLOR_BLOCK_GREYSCALE_FACTORY,//Factory Greyscale Calibration
+	FLASH_COLOR_BLOCK_TEMP,							//Factory Temperature Calibration
+	FLASH_COLOR_BLOCK_GREYSCALE_USER,		//User Greyscale Calibration
+	FLASH_COLOR_BLOCK_TEMP_USER,				//User Temperature Calibration
+	FLASH_COLOR_BLOCK_NUM
+}flash_color_block_t;
+
+/** @Type Completion Handler of A Non-blocking Record Request (Called in the Scheduler Context) */
+typedef void (*flash_request_handler_t)(const uint16_t handle, const uint16_t index, const flash_status_t status);
+
+/** @Type Non-blocking Record Request */
+typedef struct {
+	uint16_t								handle;							//Request Handle (FLASH_REQUEST_HANDLE_INVALID if the Entry is Free)
+	uint16_t								index;							//Record Index
+	flash_status_t					status;							//Completion Status
+	bool										is_done;						//The Record has been Written Back (The Handler is Not Called Yet)
+	flash_request_handler_t	handler;						//Completion Handler (or NULL)
+}flash_request_t;
+
+/** @Type Row of the Record Table (File ID, Payload Size, Default Value and Data Section of One Index) */
+typedef struct {
+	const uint8_t						*p_default;					//Default Value (bytes_size Bytes)
+	uint16_t								file_id;						//File ID of the Record
+	uint8_t									bytes_size;					//Payload Size in Bytes
+	flash_section_t					section;						//Data Section (FLASH_SECTION_OUT_OF_RANGE for A Missing Index)
+}flash_record_desc_t;
+
 /* Module Functions Declarations */
 //Essential Bricks: Utility Functions////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /** @Func Bytes to Words and Words to Bytes Conversion
 	*
 	* @Brief		The following two functions are used to perform conversions between byte arrays and word arrays.
-	* 			 		These two functions are internally used and should be transparent to the user of this module.
+	* 					The words are little-endian, so both conversions are plain copies (bytes2words zeroes the unused bytes of the last word).
+	* 			 		The storage functions no longer need them, as the records are kept in their word-aligned flash layout.
 	* 					Note: the maximum size of the byte array is 255(including the status tag).Exceeding this value will generate undefined errors.
 	*
 	*	@Para	 		bytes_size 	[uint8_t]		:	the length of the byte array
@@ -171,13 +348,18 @@ uint8_t 	words2bytes(const uint8_t words_size, uint8_t* bytes_array, const uint3
 	* @Brief	These functions act as wrappers of the bottom fds drivers.
 	* 			 	All these functions do not manage flash errors and only return the flash operation status.
 	*******************************************************************************************************************************
+	* @Brief 	setWordArray writes a record image into the flash memory using FDS system.
+	* 				The FDS chunk points straight at words_array (no copy). The function waits until the write has completed.
+	*******************************************************************************************************************************
 	* @Brief 	setByteArray writes an record into the flash memory using FDS system.
+	* 				A word-aligned byte array of whole words is written in place, other arrays are padded in the static scratch words.
 	* 				By default, setByteArray creates a new record on first-time writing and updates a record if it already exists.
-	* 				Garbage collection is automatically performed by the setByteArray function when the flash is full.
+	* 				When the flash is full, a garbage collection is requested from the storage health module (storageHealthRequestGC)
+	* 				and FLASH_STATUS_FULL_ERR is returned at once. The write can be tried again once the garbage collection has ended.
 	*******************************************************************************************************************************
 	* @Brief	getByteArray reads an existing record from the flash.
-	* 				getByteArray stores the read data in the parameter bytes_array which is a pointer to a byte array.
-	* 				The space to store the data should be created outside this function.
+	* 				getByteArray copies the data straight out of the flash into the parameter bytes_array which is a pointer to a byte array.
+	* 				The space to store the data should be created outside this function. A record shorter than bytes_size is a reading error.
 	*******************************************************************************************************************************
 	* @Brief	delByteArray deletes an existing record from the flash.
 	* 				delByteArray only deletes the record and DOES NOT perform garbage collection to release the space.
@@ -186,9 +368,11 @@ uint8_t 	words2bytes(const uint8_t words_size, uint8_t* bytes_array, const uint3
 	*	@Para		index				[uint16_t]	:	the index of the record
 	*	@Para		bytes_size	[uint8_t]		:	the length of the byte array of the record
 	*	@Para		bytes_array	[uint8_t*]	:	the address of the byte array
+	*	@Para		words_size	[uint16_t]	:	the length of the word array of the record
+	*	@Para		words_array	[uint32_t*]	:	the address of the word array
 	*
 	*	@Return	FLASH_STATUS_SETUP_ERR			: Record Setup Failed	
-	*	@Return	FLASH_STATUS_GC_ERR					:	Garbage Collection Failed
+	*	@Return	FLASH_STATUS_FULL_ERR				:	Flash Full (Garbage Collection Requested)
 	*	@Return FLASH_STATUS_WRITE_ERR			:	Record Writing Failed
 	*	@Return FLASH_STATUS_SUCCESS				:	Operation Succeeded
 	*	@Return	FLASH_STATUS_LOOKUP_ERR			:	Record Look Up Failed
@@ -197,6 +381,7 @@ uint8_t 	words2bytes(const uint8_t words_size, uint8_t* bytes_array, const uint3
 	*	@Return FLASH_STATUS_DEL_ERR				:	Record Deletion Failed
 	*
 */
+flash_status_t	setWordArray(const uint16_t file_id, const uint16_t index, const uint16_t words_size, const uint32_t* const words_array);
 flash_status_t 	setByteArray(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, const uint8_t* const bytes_array);
 flash_status_t	getByteArray(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, uint8_t* bytes_array);
 flash_status_t	delByteArray(const uint16_t file_id, const uint16_t index);
@@ -213,6 +398,9 @@ flash_status_t	delByteArray(const uint16_t file_id, const uint16_t index);
 	* @Brief	getOneByteArrayData reads one record from the flash.
 	* 				This function DOES NOT check the value of the tag. Instead, it only returns the tag value using the parameter "*tag_ptr".
 	* 				If *tag_ptr is set to NULL, this function discards the tag value and only read the payload of the record.
+	*******************************************************************************************************************************
+	* @Brief	getOneRecordTag reads the tag of one record only (the first byte of the record, or the tag of its RAM shadow slot).
+	* 				Both functions use the static scratch words instead of temporary heap buffers.
 	*
 	* @Para		file_id 		[uint16_t]	:	the file id of the record
 	*	@Para		index				[uint16_t]	: the record index
@@ -226,6 +414,7 @@ flash_status_t	delByteArray(const uint16_t file_id, const uint16_t index);
 */
 flash_status_t	setOneByteArrayData(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, const uint8_t * const bytes_array, const uint8_t tag);
 flash_status_t	getOneByteArrayData(const uint16_t file_id, const uint16_t index, const uint8_t bytes_size, uint8_t * bytes_array, uint8_t *tag_ptr);
+flash_status_t	getOneRecordTag(const uint16_t file_id, const uint16_t index, uint8_t *tag_ptr);
 
 //Third Layer(High-Level Interface): Record Operation Functions////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -256,7 +445,7 @@ flash_section_t	getDataSection(const uint16_t index);
 /** @Func Functions to check the status of one record
 	*
 	* @Brief 	This function is used to get the status of a single record.
-	* 				This function reads the entire record data but only checks its tag value and returns the record status.
+	* 				This function reads the tag value of the record only and returns the record status.
 	*
 	*	@Para		index [uint16_t]	:	the index of the record
 	*
@@ -318,6 +507,7 @@ flash_status_t	delOneRecord(const uint16_t index);
 /** @Func Initialize All Data to the Default Values
 	*
 	* @Brief 	This function intializes all the records to their default values stored in the data files.
+	* 				It erases all the changes (e.g. the user calibration), so it is a factory reset and is not called at boot (see syncAllRecords).
 	* 				This function returns the flash operation status.
 	*	@Return	Propagate internal errors
 	*
@@ -334,6 +524,124 @@ flash_status_t	initAllRecords(void);
 */
 bool isAllRecordValid(void);
 
+/** @Func Create the Missing Records and Migrate the Changed Ones
+	*
+	* @Brief 	This function is called once at boot instead of initAllRecords, so the records changed by the user are kept.
+	* 				If the schema record matches the compiled record table, nothing else is read or written.
+	* 				Otherwise every index is checked: a missing record is set to its default value, and a record whose payload size
+	* 				changed is migrated (the old payload is kept up to the new size, the rest is the default value, the tag is kept).
+	* 				The color sizes are not migrated here, the packed color blocks have their own version (FLASH_COLOR_BLOCK_VERSION).
+	* 				The new schema record is written after all the records are in the flash, so a reset in between only repeats the check.
+	* 				It should be called after loadRecordCache and recoverRecordTransaction (The changes are then written back at once).
+	* 				Records written before the schema record existed are taken as of the compiled sizes.
+	*
+	*	@Return	FLASH_STATUS_SUCCESS				: All the records match the record table
+	*	@Return	Propagate internal errors
+	*
+*/
+flash_status_t	syncAllRecords(void);
+
+//Fifth Layer: RAM Record Cache//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Functions to Manage the RAM Shadow of the Records
+	*
+	* @Brief 	loadRecordCache reads every record once into the RAM shadow (Missing records, and shorter records of an older layout, are marked as not found).
+	* 				After a successful load, getOneByteArrayData is a copy out of the shadow and setOneByteArrayData and delOneRecord
+	* 				only change the shadow and return at once. The changed records are coalesced and written back by the scheduler
+	* 				when no record has been changed for FLASH_CACHE_FLUSH_DELAY_MS. If the load fails, the flash is still accessed directly.
+	* 				The FDS system and the app timer must be initialized before the load.
+	*******************************************************************************************************************************
+	* @Brief	flushRecordCache writes all the changed records back at once and waits for the flash operations (e.g. before a reset).
+	* 				It must be called from the main context, not from an interrupt handler.
+	*
+	*	@Return	FLASH_STATUS_SUCCESS				: All the records are loaded/written
+	*	@Return	Propagate internal errors
+	*
+*/
+flash_status_t	loadRecordCache(void);
+flash_status_t	flushRecordCache(void);
+
+/** @Func Continue the Write-back after A Garbage Collection
+	*
+	* @Brief	When the flash is full, the write-back requests a garbage collection from the storage health module (storageHealthRequestGC)
+	* 				and keeps the records dirty and their requests pending. The storage health module calls this function once the garbage
+	* 				collection has ended (scheduler context). The write-back goes on if space has been reclaimed, otherwise the waiting requests
+	* 				complete with FLASH_STATUS_GC_ERR and the records are written with the next change.
+	*
+	*	@Para		result [ret_code_t] : the result of the garbage collection (FDS_ERR_NO_SPACE_IN_FLASH if nothing could be reclaimed)
+	*
+*/
+void flushRecordCacheOnGC(const ret_code_t result);
+
+/** @Func Functions to Check the State of the RAM Shadow
+	*
+	*	@Return	true		:	the shadow is loaded / at least one record waits to be written back
+	*	@Return	false		:	the flash is accessed directly / the flash holds all the changes
+	*
+*/
+bool isRecordCacheLoaded(void);
+bool isRecordCacheDirty(void);
+
+//Sixth Layer: Non-blocking Record Requests//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Functions to Change A Record without Waiting for the Flash
+	*
+	* @Brief 	setOneRecordAsync and delOneRecordAsync change the RAM shadow as setOneRecord and delOneRecord do and return at once
+	* 				with a request handle. The record is queued into FDS without the quiet time, together with all the other changed records,
+	* 				so a burst of requests (e.g. a full color calibration set) is written in one pipeline instead of one record after another.
+	* 				The handler is called in the scheduler context with the handle once the record is in the flash (or the write has failed).
+	* 				If the record is changed again before its write has completed, the request completes with the next write-back.
+	* 				The RAM shadow must be loaded (loadRecordCache), as the write-back reads the record straight out of its slot.
+	*******************************************************************************************************************************
+	* @Brief	isRecordRequestPending checks whether the handler of a request has not been called yet.
+	*
+	*	@Para		index 			[uint16_t]								: the index of the record
+	*	@Para		bytes_array	[uint8_t*]								:	the address of the byte array to be stored into the flash
+	*	@Para		handler			[flash_request_handler_t]	:	the completion handler (or NULL)
+	*	@Para		p_handle		[uint16_t*]								:	the handle of the request (or NULL)
+	*
+	*	@Return	FLASH_STATUS_SUCCESS				: The request is queued
+	*	@Return	FLASH_STATUS_SETUP_ERR			: The RAM shadow is not loaded
+	*	@Return	FLASH_STATUS_BUSY_ERR				: All the request entries are in use (The change is kept and written back by the timer)
+	*	@Return	Propagate internal errors
+	*
+*/
+flash_status_t	setOneRecordAsync(const uint16_t index, const uint8_t* const bytes_array, flash_request_handler_t handler, uint16_t *p_handle);
+flash_status_t	delOneRecordAsync(const uint16_t index, flash_request_handler_t handler, uint16_t *p_handle);
+bool						isRecordRequestPending(const uint16_t handle);
+
+//Seventh Layer: Record Transactions//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Functions to Change Several Records Together
+	*
+	* @Brief 	beginRecordTransaction opens a transaction. stageOneRecord writes the record value into the shadow file only,
+	* 				so the record itself (and getOneRecord) keeps its old value. Staging the same index again replaces its staged value.
+	* 				commitRecordTransaction writes the commit marker, then writes every staged value to its record as setOneRecord does,
+	* 				flushes the RAM shadow and deletes the marker and the shadow file. abortRecordTransaction deletes the shadow file.
+	* 				If the device resets between the marker and its deletion, the transaction is completed by recoverRecordTransaction.
+	* 				These functions wait for the flash, so they must be called from the main context, not from an interrupt handler.
+	*******************************************************************************************************************************
+	* @Brief	recoverRecordTransaction must be called once at boot, after fdsInit (and after loadRecordCache if the RAM shadow is used).
+	* 				It writes the records of a committed transaction again, or deletes the records staged without a commit.
+	* 				If the shadow file holds no record (no transaction was interrupted), it returns at once without any flash operation.
+	* 				If commitRecordTransaction fails after the marker is written, calling recoverRecordTransaction retries the writes.
+	*
+	*	@Para		index 			[uint16_t]	: the index of the record
+	*	@Para		bytes_array	[uint8_t*]	:	the address of the byte array to be staged
+	*
+	*	@Return	FLASH_STATUS_SUCCESS				: The operation succeeded
+	*	@Return	FLASH_STATUS_SETUP_ERR			: No transaction is open (stage, commit)
+	*	@Return	FLASH_STATUS_BUSY_ERR				: A transaction is open (begin, recover), or a committed one is not completed yet (begin)
+	*	@Return	Propagate internal errors
+	*
+*/
+flash_status_t	beginRecordTransaction(void);
+flash_status_t	stageOneRecord(const uint16_t index, const uint8_t* const bytes_array);
+flash_status_t	commitRecordTransaction(void);
+flash_status_t	abortRecordTransaction(void);
+flash_status_t	recoverRecordTransaction(void);
+bool						isRecordTransactionOpen(void);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Functions for Device Information Data */
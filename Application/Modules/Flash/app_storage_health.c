@@ -0,0 +1,275 @@
+/** Library Name : app_storage_health.c
+	*
+	* @Brief 		Implementation of the FDS statistics polling, the idle garbage collection and the page erase counts
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include "app_storage_health.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Erase Count Record Must Not Share A Key with the Data Files or the Packed Color Blocks */
+STATIC_ASSERT(STORAGE_HEALTH_REC_INDEX >= FLASH_COLOR_BLOCK_REC_INDEX(FLASH_COLOR_BLOCK_NUM));
+STATIC_ASSERT(MAP_INDEX_TO_REC_ID(STORAGE_HEALTH_REC_INDEX) < FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM);
+STATIC_ASSERT(STORAGE_HEALTH_REC_INDEX != FLASH_SCHEMA_REC_INDEX);
+
+/** @Variable The Storage Health Status */
+static storage_health_t storage_health;
+
+/** @Variable The Page Snapshot (Data Page Tag and First Record ID of Each Page) */
+static bool 		storage_health_page_data[STORAGE_HEALTH_PAGE_NUM];
+static uint32_t storage_health_page_first[STORAGE_HEALTH_PAGE_NUM];
+
+/** @Variable The Erase Count Record Image (Written without Copy, so It is Not Changed while the Write is Pending) */
+static uint32_t storage_health_rec_image[STORAGE_HEALTH_REC_WORDS];
+static bool is_storage_health_rec_pending = false;
+static bool is_storage_health_rec_dirty 	= false;
+
+/** @Variable The Scheduler Events */
+static bool is_storage_health_check_posted 	= false;
+static bool is_storage_health_gc_posted 		= false;
+static bool is_storage_health_gc_requested 	= false;
+static ret_code_t storage_health_gc_result 	= FDS_SUCCESS;
+
+/** @Variable The Polling Timer */
+APP_TIMER_DEF(storage_health_timer_id);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Take the Snapshot of All the FDS Pages */
+static void storage_health_snapshot(void)
+{
+	fds_page_info_t info;
+
+	for(uint8_t page = 0; page < STORAGE_HEALTH_PAGE_NUM; page++){
+		if(fdsPageInfo(page, &info) != FDS_SUCCESS){
+			info.is_data 	= false;
+			info.first_id = FDS_PAGE_RECORD_ID_NONE;
+		}
+		storage_health_page_data[page] 	= info.is_data;
+		storage_health_page_first[page] = info.first_id;
+	}
+}
+
+/** @Func Count the Pages Erased since the Snapshot, then Take A New Snapshot */
+static void storage_health_count_erases(void)
+{
+	fds_page_info_t info;
+
+	for(uint8_t page = 0; page < STORAGE_HEALTH_PAGE_NUM; page++){
+		if(fdsPageInfo(page, &info) != FDS_SUCCESS){
+			continue;
+		}
+
+		// A data page that became the swap page, or whose first record was replaced, has been erased
+		if(storage_health_page_data[page]){
+			if(!info.is_data || (storage_health_page_first[page] != FDS_PAGE_RECORD_ID_NONE && info.first_id != storage_health_page_first[page])){
+				if(storage_health.erase_count[page] != UINT16_MAX){
+					storage_health.erase_count[page]++;
+				}
+			}
+		}
+		storage_health_page_data[page] 	= info.is_data;
+		storage_health_page_first[page] = info.first_id;
+	}
+}
+
+/** @Func FDS Completion Handler of the Erase Count Record (FDS Event Context) */
+static void storage_health_rec_handler(const uint16_t handle, const uint16_t file_id, const uint16_t rec_key, const ret_code_t result)
+{
+	is_storage_health_rec_pending = false;
+	if(result != FDS_SUCCESS){
+		is_storage_health_rec_dirty = true;		// Written again at the next poll
+	}
+}
+
+/** @Func Queue the Erase Count Record into FDS (Scheduler Context) */
+static void storage_health_rec_store(void)
+{
+	if(is_storage_health_rec_pending){
+		is_storage_health_rec_dirty = true;		// Written again at the next poll
+		return;
+	}
+
+	storage_health_rec_image[0] = STORAGE_HEALTH_REC_VERSION | ((uint32_t)STORAGE_HEALTH_PAGE_NUM << 8);
+	storage_health_rec_image[1] = storage_health.gc_runs;
+	memcpy(&storage_health_rec_image[2], storage_health.erase_count, sizeof(storage_health.erase_count));
+
+	is_storage_health_rec_pending = true;
+	if(fdsRecWriteAsync(FLASH_FILEID_EXTENDED, MAP_INDEX_TO_REC_ID(STORAGE_HEALTH_REC_INDEX), storage_health_rec_image, STORAGE_HEALTH_REC_WORDS, storage_health_rec_handler, NULL) == FDS_SUCCESS){
+		is_storage_health_rec_dirty 	= false;
+	}else{
+		is_storage_health_rec_pending = false;
+		is_storage_health_rec_dirty 	= true;
+	}
+}
+
+/** @Func Read the Erase Count Record out of the Flash (Counts from Zero if It is Missing or of Another Layout) */
+static void storage_health_rec_load(void)
+{
+	if(getByteArray(FLASH_FILEID_EXTENDED, STORAGE_HEALTH_REC_INDEX, sizeof(storage_health_rec_image), (uint8_t *)storage_health_rec_image) == FLASH_STATUS_SUCCESS
+		&& storage_health_rec_image[0] == (STORAGE_HEALTH_REC_VERSION | ((uint32_t)STORAGE_HEALTH_PAGE_NUM << 8))){
+		storage_health.gc_runs = storage_health_rec_image[1];
+		memcpy(storage_health.erase_count, &storage_health_rec_image[2], sizeof(storage_health.erase_count));
+	}else{
+		storage_health.gc_runs = 0;
+		memset(storage_health.erase_count, 0, sizeof(storage_health.erase_count));
+	}
+}
+
+/** @Func Check Whether Nothing Waits to Be Written */
+static bool storage_health_is_idle(void)
+{
+	return storage_health.is_idle && fdsRequestPending() == 0 && !isRecordCacheDirty();
+}
+
+/** @Func Scheduler Event Handler Polling the FDS Statistics and Starting the Garbage Collection */
+static void storage_health_check_handler(void *p_event_data, uint16_t event_size)
+{
+	is_storage_health_check_posted = false;
+
+	// Write the erase counts that could not be queued before
+	if(is_storage_health_rec_dirty){
+		storage_health_rec_store();
+	}
+
+	// One garbage collection at a time (Started here or by fdsGC)
+	if(fdsGCRunning() || fds_stat(&storage_health.stat) != FDS_SUCCESS){
+		return;
+	}
+
+	// Nothing to reclaim (A garbage collection would only erase pages, the write-back waiting for space gives up)
+	if(storage_health.stat.freeable_words == 0){
+		is_storage_health_gc_requested = false;
+		flushRecordCacheOnGC(FDS_ERR_NO_SPACE_IN_FLASH);
+		return;
+	}
+
+	// Needed at once, or worth doing while idle
+	bool is_needed 	= is_storage_health_gc_requested || storage_health.stat.largest_contig < STORAGE_HEALTH_GC_MIN_CONTIG_WORDS;
+	bool is_worth 	= storage_health.stat.freeable_words >= STORAGE_HEALTH_GC_FREEABLE_WORDS && storage_health_is_idle();
+	if(!is_needed && !is_worth){
+		return;
+	}
+
+	// The pages may have changed since the last garbage collection (The first record of an empty page)
+	storage_health_snapshot();
+
+	ret_code_t ret = fdsGCAsync();
+	if(ret == FDS_SUCCESS){
+		is_storage_health_gc_requested 	= false;
+	}else if(is_needed){
+		flushRecordCacheOnGC(ret);
+	}
+}
+
+/** @Func Scheduler Event Handler Counting the Erases of A Finished Garbage Collection */
+static void storage_health_gc_handler(void *p_event_data, uint16_t event_size)
+{
+	is_storage_health_gc_posted 	= false;
+
+	if(storage_health_gc_result != FDS_SUCCESS){
+		storage_health.gc_failures++;
+		storage_health_snapshot();
+	}else{
+		storage_health.gc_runs++;
+		storage_health_count_erases();
+		storage_health_rec_store();
+	}
+
+	// Let the write-back waiting for space go on
+	flushRecordCacheOnGC(storage_health_gc_result);
+}
+
+/** @Func Queue the Check Scheduler Event (Called from Any Context) */
+static void storage_health_check_post(void)
+{
+	bool is_post	=	false;
+
+	CRITICAL_REGION_ENTER();
+	if(!is_storage_health_check_posted){
+		is_storage_health_check_posted	=	true;
+		is_post													=	true;
+	}
+	CRITICAL_REGION_EXIT();
+
+	if(is_post){
+		APP_ERROR_CHECK(app_sched_event_put(NULL,0,storage_health_check_handler));
+	}
+}
+
+/** @Func Polling Timer Time-out Handler */
+static void storage_health_timer_handler(void * p_context)
+{
+	storage_health_check_post();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Initialization of the Storage Health Module */
+void storageHealthInit(void)
+{
+	memset(&storage_health, 0, sizeof(storage_health));
+	storage_health_rec_load();
+	storage_health_snapshot();
+
+	APP_ERROR_CHECK(app_timer_create(&storage_health_timer_id, APP_TIMER_MODE_REPEATED, storage_health_timer_handler));
+	APP_ERROR_CHECK(app_timer_start(storage_health_timer_id, APP_TIMER_TICKS(STORAGE_HEALTH_POLL_INTERVAL_MS, STORAGE_HEALTH_TIMER_PRESCALER), NULL));
+}
+
+/** @Func Tell Whether the Device is Idle */
+void storageHealthSetIdle(const bool is_idle)
+{
+	storage_health.is_idle = is_idle;
+	if(is_idle){
+		storage_health_check_post();
+	}
+}
+
+/** @Func Request A Garbage Collection as Soon as Possible */
+void storageHealthRequestGC(void)
+{
+	is_storage_health_gc_requested = true;
+	storage_health_check_post();
+}
+
+/** @Func Report the End of A Garbage Collection */
+void storageHealthOnGC(const ret_code_t result)
+{
+	bool is_post	=	false;
+
+	CRITICAL_REGION_ENTER();
+	storage_health_gc_result = result;
+	if(!is_storage_health_gc_posted){
+		is_storage_health_gc_posted	=	true;
+		is_post											=	true;
+	}
+	CRITICAL_REGION_EXIT();
+
+	if(is_post){
+		APP_ERROR_CHECK(app_sched_event_put(NULL,0,storage_health_gc_handler));
+	}
+}
+
+/** @Func Get the Storage Health Status */
+void storageHealthGetStatus(storage_health_t * p_health)
+{
+	CRITICAL_REGION_ENTER();
+	*p_health 								= storage_health;
+	p_health->is_gc_running 	= fdsGCRunning();
+	CRITICAL_REGION_EXIT();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
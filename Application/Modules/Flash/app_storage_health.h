@@ -0,0 +1,157 @@
+/** Library Name : app_storage_health.h
+	*
+	* @Brief 		This module watches the FDS pages and runs the garbage collection before the flash runs out of space
+	* @Brief		The FDS statistics (fds_stat) are polled with an app timer, and the garbage collection is started from the scheduler
+	* @Brief		context while the device is idle (advertising with no record waiting to be written), so it does not land in a write
+	* @Brief		The erases of each FDS page are counted and kept in a reserved record of the extended data file
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Req			This module requires the following modules to be enabled
+	* @Req			- Flash Storage Module (FDS Initialized)	(Included in "app_storage.h")
+	* @Req			- App Timer													(Configured in "sdk_config.h")
+	* @Req			- App Scheduler											(Configured in "sdk_config.h")
+	*
+	* @Note			The erase counts are an estimate. FDS does not report which pages it erased, so the page tag of every page and the
+	* @Note			ID of its first record are compared before and after each garbage collection. A data page that became the swap page,
+	* @Note			or that holds another first record, has been erased once.
+	*
+	* @Macro		STORAGE_HEALTH_POLL_INTERVAL_MS			(Interval of the FDS Statistics Polling)
+	* @Macro		STORAGE_HEALTH_GC_FREEABLE_WORDS		(Reclaimable Words that Start A Garbage Collection when Idle)
+	* @Macro		STORAGE_HEALTH_GC_MIN_CONTIG_WORDS	(Largest Free Space below which A Garbage Collection Starts at Once)
+	* @Macro		STORAGE_HEALTH_PAGE_NUM							(Number of FDS Pages)
+	* @Macro		STORAGE_HEALTH_REC_INDEX						(Record Index of the Erase Counts)
+	* @Macro		STORAGE_HEALTH_REC_WORDS						(Size of the Erase Count Record in Words)
+	*
+	* @Type			storage_health_t										(Data Type of the Storage Health Status)
+	*
+	* @Func			storageHealthInit										(Initialization of the Storage Health Module)
+	* @Func			storageHealthSetIdle								(Tell Whether the Device is Idle)
+	* @Func			storageHealthRequestGC							(Request A Garbage Collection as Soon as Possible)
+	* @Func			storageHealthOnGC										(Report the End of A Garbage Collection)
+	* @Func			storageHealthGetStatus							(Get the Storage Health Status)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __APP_STORAGE_HEALTH_H__
+#define __APP_STORAGE_HEALTH_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include "app_storage.h"
+#include "fds.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Header */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Polling and Garbage Collection Thresholds */
+#define STORAGE_HEALTH_POLL_INTERVAL_MS											10000
+#define STORAGE_HEALTH_TIMER_PRESCALER											0				// Must be the same as APP_TIMER_PRESCALER
+#define STORAGE_HEALTH_GC_FREEABLE_WORDS										(FDS_VIRTUAL_PAGE_SIZE/4)
+#define STORAGE_HEALTH_GC_MIN_CONTIG_WORDS									(FDS_VIRTUAL_PAGE_SIZE/8)
+
+/** @Macro Erase Count Record
+	* The record holds a header word (version, number of pages), the number of garbage collections, then one 16-bit count per page.
+	* It uses the free record key after the packed color blocks in the extended data file.
+*/
+#define STORAGE_HEALTH_PAGE_NUM															FDS_VIRTUAL_PAGES
+#define STORAGE_HEALTH_REC_VERSION													1
+#define STORAGE_HEALTH_REC_INDEX														0x7E		// Record key 0x107E
+#define STORAGE_HEALTH_REC_WORDS														(2+CAL_WORD_ARRAY_SIZE(STORAGE_HEALTH_PAGE_NUM,2))
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Type Declarations */
+
+/** @Type 	Data Type of the Storage Health Status
+	*
+	* @Brief 	stat 						: the FDS statistics of the last poll
+	* @Brief 	gc_runs 				: the number of garbage collections completed (kept in the flash)
+	* @Brief 	gc_failures 		: the number of garbage collections failed since the boot
+	* @Brief 	erase_count 		: the estimated number of erases of each FDS page (kept in the flash)
+	* @Brief 	is_idle 				: the idle state set by storageHealthSetIdle
+	* @Brief 	is_gc_running 	: a garbage collection is not finished yet (fdsGCRunning, whichever function started it)
+	*
+*/
+typedef struct{
+	fds_stat_t			stat;
+	uint32_t				gc_runs;
+	uint32_t				gc_failures;
+	uint16_t				erase_count[STORAGE_HEALTH_PAGE_NUM];
+	bool						is_idle;
+	bool						is_gc_running;
+}storage_health_t;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func 	Initialization of the Storage Health Module
+	*
+	* @Brief	This function reads the erase counts out of the flash, takes the first page snapshot and starts the polling timer
+	* @Brief	It must be called after fdsInit
+	*
+*/
+void storageHealthInit(void);
+
+/** @Func 	Tell Whether the Device is Idle
+	*
+	* @Brief	A garbage collection that is only worth doing (not needed) is started while the device is idle
+	* @Brief	This function can be called from any context (e.g. the advertising and the connection events)
+	*
+	* @Para		is_idle [bool] : true if nothing time-critical is running
+	*
+*/
+void storageHealthSetIdle(const bool is_idle);
+
+/** @Func 	Request A Garbage Collection as Soon as Possible
+	*
+	* @Brief	The garbage collection is started from the scheduler context, without waiting for the idle state
+	* @Brief	This function can be called from any context (e.g. the peer manager storage full event)
+	*
+*/
+void storageHealthRequestGC(void);
+
+/** @Func 	Report the End of A Garbage Collection
+	*
+	* @Brief	This function must be called on FDS_EVT_GC by the application FDS event handler (FDS event context)
+	* @Brief	The erase counts are updated and written back from the scheduler context, then the record write-back is resumed (flushRecordCacheOnGC)
+	*
+	* @Para		result [ret_code_t] : the result of the garbage collection
+	*
+*/
+void storageHealthOnGC(const ret_code_t result);
+
+/** @Func 	Get the Storage Health Status
+	*
+	* @Para		p_health [storage_health_t*] : the structure to be written into
+	*
+*/
+void storageHealthGetStatus(storage_health_t * p_health);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Library Header */
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //__APP_STORAGE_HEALTH_H__
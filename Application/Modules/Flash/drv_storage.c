@@ -7,6 +7,9 @@
 
 /* Include the library header */
 #include "drv_storage.h"
+#include "fstorage.h"
+#include "section_vars.h"
+#include <string.h>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /* Set two internal variables and one default async operation function */
@@ -15,6 +18,186 @@
 static fds_state_t	fds_state; //Internal variable to store the fds state.
 static fds_flags_t	fds_flags; //Internal variable to store all fds flags.
 
+/** @Variable Record index of the keys in the index window */
+static fds_index_entry_t	fds_index[FDS_INDEX_KEY_NUM];
+static bool								fds_index_built = false;
+static bool								fds_index_stale = false;		//Set by a failed request or a file deletion (The index is rebuilt when the request queue is empty)
+
+/** @Variable Non-blocking requests in flight */
+static fds_request_t			fds_requests[FDS_REQUEST_QUEUE_SIZE];
+static uint8_t						fds_request_count				=	0;
+static uint8_t						fds_request_idle				=	1;		//Waited on by fdsRequestWait
+static uint16_t						fds_request_next_handle	=	FDS_REQUEST_HANDLE_INVALID;
+
+/** @Variable Garbage collection in flight (Started by fdsGCAsync, whether fdsGC waits for it or not) */
+static uint8_t						fds_gc_idle							=	1;		//Waited on by fdsGC
+static ret_code_t					fds_gc_result						=	FDS_SUCCESS;
+
+/** @Variable Event handler of the application (Called after the request completion) */
+static fds_evt_handler_t	fds_user_handler				=	NULL;
+
+/** @Macro Page tag values of FDS (The same as "fds_internal_defs.h") and the header layout the first record ID is read with */
+#define FDS_PAGE_TAG_MAGIC_WORD			0xDEADC0DE
+#define FDS_PAGE_TAG_DATA_WORD			0xF11E01FE
+#define FDS_PAGE_TAG_SWAP_WORD			0xF11E01FF
+STATIC_ASSERT(sizeof(fds_header_t) == 3*sizeof(uint32_t));
+STATIC_ASSERT(FDS_PAGE_FIRST_ID_WORD == 4);		//Page tag (2 words), then the TL, the IC and the record ID of the first record
+
+/** @Variable The fstorage configurations (FDS registers the only one of this firmware, the peer manager stores through FDS) */
+NRF_SECTION_VARS_CREATE_SECTION(fs_data, fs_config_t);
+
+/** @Func Get the fstorage configuration of FDS (Its variable is static in "fds.c", the page addresses are set by fs_init) */
+static fs_config_t const * fds_fs_config(void){
+	if(NRF_SECTION_VARS_COUNT(fs_config_t, fs_data) != 1){
+		return NULL;
+	}
+	return NRF_SECTION_VARS_GET(0, fs_config_t, fs_data);
+}
+
+/** @Func Get the index entry of a record key (NULL if the key is outside the index window or the index is not built) */
+static fds_index_entry_t * fds_index_entry(const uint16_t rec_key){
+	if(!fds_index_built || rec_key < FDS_INDEX_KEY_BASE || rec_key >= FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM){
+		return NULL;
+	}
+	return &fds_index[rec_key - FDS_INDEX_KEY_BASE];
+}
+
+/** @Func Store a record descriptor into the index entry of its key */
+static void fds_index_set(const uint16_t file_id, const uint16_t rec_key, fds_record_desc_t const * p_desc){
+	fds_index_entry_t * p_entry = fds_index_entry(rec_key);
+	if(p_entry != NULL){
+		p_entry->record_id		=	p_desc->record_id;
+		p_entry->p_record			=	p_desc->p_record;
+		p_entry->gc_run_count	=	p_desc->gc_run_count;
+		p_entry->file_id			=	file_id;
+	}
+}
+
+/** @Func Clear the index entry of a key */
+static void fds_index_reset(const uint16_t rec_key){
+	fds_index_entry_t * p_entry = fds_index_entry(rec_key);
+	if(p_entry != NULL){
+		memset(p_entry, 0x00, sizeof(fds_index_entry_t));
+	}
+}
+
+/** @Func Check whether the index holds a record of a file */
+static bool fds_index_has_file(const uint16_t file_id){
+	for(uint16_t i = 0; fds_index_built && i < FDS_INDEX_KEY_NUM; i++){
+		if(fds_index[i].record_id != 0 && fds_index[i].file_id == file_id){
+			return true;
+		}
+	}
+	return false;
+}
+
+/** @Func Store the descriptor of the current record into its index entry */
+static void fds_index_store(void){
+	fds_index_set(fds_state.record.rec_info.file_id, fds_state.record.rec_info.key, &fds_state.rec_desc);
+}
+
+/** @Func Clear the index entry of the current record */
+static void fds_index_clear(void){
+	fds_index_reset(fds_state.record.rec_info.key);
+}
+
+/** @Func Locate a record through the index, or by searching the flash for keys outside the index window (Never called in a critical region: it may walk the flash) */
+static ret_code_t fds_locate(const uint16_t file_id, const uint16_t rec_key, fds_record_desc_t * p_desc){
+	fds_find_token_t		ftok;
+	
+	// Resynchronise the index after a failed request or a file deletion (Only when no other request can change it)
+	if(fds_index_stale && fds_request_count == 0){
+		fds_index_stale = false;
+		fdsIndexBuild();
+	}
+	
+	fds_index_entry_t	* p_entry	=	fds_index_entry(rec_key);
+	
+	//	Look up the index (The descriptor is rebuilt without scanning the flash)
+	if(p_entry != NULL){
+		if(p_entry->record_id == 0 || p_entry->file_id != file_id){
+			return FDS_ERR_NOT_FOUND;
+		}
+		p_desc->record_id				=	p_entry->record_id;
+		p_desc->p_record				=	p_entry->p_record;
+		p_desc->gc_run_count		=	p_entry->gc_run_count;
+		p_desc->record_is_open	=	false;
+		return FDS_SUCCESS;
+	}
+	
+	// 	Zero-initialize the token before usage and search for the record
+	memset(&ftok, 0x00, sizeof(fds_find_token_t));
+	return fds_record_find(file_id, rec_key, p_desc, &ftok);
+}
+
+/** @Func Get a free request entry (Called in a critical region) */
+static fds_request_t * fds_request_alloc(void){
+	for(uint8_t i = 0; i < FDS_REQUEST_QUEUE_SIZE; i++){
+		if(fds_requests[i].record_id == 0){
+			return &fds_requests[i];
+		}
+	}
+	return NULL;
+}
+
+/** @Func Fill in a request entry whose operation has been queued (Called in a critical region) */
+static void fds_request_start(fds_request_t * p_request, const uint32_t record_id, const uint16_t file_id, const uint16_t rec_key, fds_request_handler_t handler, uint16_t * p_handle){
+	if(++fds_request_next_handle == FDS_REQUEST_HANDLE_INVALID){
+		fds_request_next_handle++;
+	}
+	p_request->record_id	=	record_id;
+	p_request->handle			=	fds_request_next_handle;
+	p_request->file_id		=	file_id;
+	p_request->rec_key		=	rec_key;
+	p_request->handler		=	handler;
+	fds_request_count++;
+	fds_request_idle			=	0;
+	if(p_handle != NULL){
+		*p_handle = p_request->handle;
+	}
+}
+
+/** @Func Complete the request of an FDS event (Matched by the record ID) */
+static void fds_request_complete(fds_evt_t const * const p_fds_evt){
+	uint32_t				record_id	=	0;
+	fds_request_t		request;
+	
+	switch(p_fds_evt->id){
+		case FDS_EVT_WRITE:
+		case FDS_EVT_UPDATE:
+			record_id	=	p_fds_evt->write.record_id;
+			break;
+		case FDS_EVT_DEL_RECORD:
+			record_id	=	p_fds_evt->del.record_id;
+			break;
+		default:
+			return;
+	}
+	
+	request.record_id	=	0;
+	CRITICAL_REGION_ENTER();
+	for(uint8_t i = 0; i < FDS_REQUEST_QUEUE_SIZE; i++){
+		if(record_id != 0 && fds_requests[i].record_id == record_id){
+			request										=	fds_requests[i];
+			fds_requests[i].record_id	=	0;
+			fds_request_count--;
+			fds_request_idle					=	(fds_request_count == 0);
+			break;
+		}
+	}
+	
+	// The index has been changed when the request was queued, so it is wrong now
+	if(request.record_id != 0 && p_fds_evt->result != FDS_SUCCESS){
+		fds_index_stale	=	true;
+		fds_index_built	=	false;
+	}
+	CRITICAL_REGION_EXIT();
+	
+	if(request.record_id != 0 && request.handler != NULL){
+		request.handler(request.handle, request.file_id, request.rec_key, p_fds_evt->result);
+	}
+}
+
 /** @Func Power Management Function (Entering low power mode while waiting for async operations */
 static void fds_wait(uint8_t* flag){
 	while(*flag == 0) {
@@ -22,6 +205,16 @@ static void fds_wait(uint8_t* flag){
 	}
 }
 
+/** @Func FDS Event Handler Registered by fdsInit (Completes the requests and the garbage collection, then calls the application handler) */
+static void fds_event_handler_request(fds_evt_t const * const p_fds_evt){
+	fds_request_complete(p_fds_evt);
+	if(p_fds_evt->id == FDS_EVT_GC){
+		fds_gc_result	=	p_fds_evt->result;
+		fds_gc_idle		=	1;
+	}
+	fds_user_handler(p_fds_evt);
+}
+
 /** @Func Default FDS Event Handler */
 static void fds_event_handler_default(fds_evt_t const * const p_fds_evt){
 	switch (p_fds_evt->id){
@@ -132,13 +325,14 @@ ret_code_t fdsInit (fds_evt_handler_t event_handler){
 	//	Initializing essential fields
 	fdsResetVars();
 	
-	// Register FDS Event Handler
+	// Register FDS Event Handler (The requests are completed before the event is passed on)
 	if(event_handler != NULL){
-		fds_state.ret 		 =	fds_register(event_handler);
+		fds_user_handler	=	event_handler;
 	}
 	else{
-		fds_state.ret 		 =	fds_register(fds_event_handler_default);
+		fds_user_handler	=	fds_event_handler_default;
 	}
+	fds_state.ret 		 =	fds_register(fds_event_handler_request);
 	
 	// Handle Handler Registration Error
 	if (fds_state.ret != FDS_SUCCESS){
@@ -163,11 +357,52 @@ ret_code_t fdsInit (fds_evt_handler_t event_handler){
 	}
 	
 	// fds_verify_crc_on_writes(1); //Possible CRC checking.
-	return fds_state.ret;
+	
+	// Index all the records in one pass
+	return fdsIndexBuild();
+}
+
+/** @Func Build the Record Index */
+ret_code_t fdsIndexBuild(void){
+	fds_record_desc_t		desc;
+	fds_flash_record_t	flash_record;
+	fds_find_token_t		ftok;
+	ret_code_t					ret;
+	
+	fds_index_built	=	false;
+	memset(fds_index, 0x00, sizeof(fds_index));
+	memset(&ftok, 0x00, sizeof(fds_find_token_t));
+	
+	// Walk through all the records once
+	while(fds_record_iterate(&desc, &ftok) == FDS_SUCCESS){
+		if(fds_record_open(&desc, &flash_record) != FDS_SUCCESS){
+			continue;
+		}
+		uint16_t rec_key	=	flash_record.p_header->tl.record_key;
+		uint16_t file_id	=	flash_record.p_header->ic.file_id;
+		ret = fds_record_close(&desc);
+		if(ret != FDS_SUCCESS){
+			return ret;
+		}
+		
+		// Keep the first record found for each key (as fds_record_find does)
+		if(rec_key >= FDS_INDEX_KEY_BASE && rec_key < FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM && fds_index[rec_key - FDS_INDEX_KEY_BASE].record_id == 0){
+			fds_index[rec_key - FDS_INDEX_KEY_BASE].record_id			=	desc.record_id;
+			fds_index[rec_key - FDS_INDEX_KEY_BASE].p_record			=	desc.p_record;
+			fds_index[rec_key - FDS_INDEX_KEY_BASE].gc_run_count	=	desc.gc_run_count;
+			fds_index[rec_key - FDS_INDEX_KEY_BASE].file_id				=	file_id;
+		}
+	}
+	
+	fds_index_built	=	true;
+	return FDS_SUCCESS;
 }
 
 /** @Func Write a Record */
 ret_code_t fdsRecWrite(void){
+	// Let the queued requests complete first
+	fdsRequestWait();
+	
 	// Write into Flash
 	fds_flags.fds_write_flag =	0; //Set the Flag
 	fds_state.ret						 = fds_record_write(&fds_state.rec_desc, &fds_state.record.rec_info);
@@ -184,6 +419,9 @@ ret_code_t fdsRecWrite(void){
 	// Async Operation
 	fds_state.async_fun(&fds_flags.fds_write_flag);
 	
+	// Index the new record
+	fds_index_store();
+	
 	// Write record result check and Logging
 	if(fds_flags.fds_log_flag){
 		NRF_LOG_INFO("FDS_LOG: <fdsRecWrite> Writing Succeeded @ Record(FileID: 0x%4x, RecordKey: 0x%4x)\r\n", fds_state.record.rec_info.file_id, fds_state.record.rec_info.key);
@@ -195,11 +433,8 @@ ret_code_t fdsRecWrite(void){
 
 /** @Func Locate an FDS record */
 ret_code_t fdsRecFind(void){
-	// 	Zero-initialize the token before usage.
-	memset(&(fds_state.ftok), 0x00, sizeof(fds_find_token_t));
-	
-	//	Search for the record
-	fds_state.ret	=	fds_record_find(fds_state.record.rec_info.file_id, fds_state.record.rec_info.key, &fds_state.rec_desc, &fds_state.ftok);
+	//	Look up the index or search the flash
+	fds_state.ret	=	fds_locate(fds_state.record.rec_info.file_id, fds_state.record.rec_info.key, &fds_state.rec_desc);
 	
 	//	Print the logs if logging is allowed
 	if(fds_flags.fds_log_flag){
@@ -247,6 +482,9 @@ ret_code_t fdsRecRead(uint32_t* data_read){
 		// Close the record when done.
 		fds_state.ret = fds_record_close(&fds_state.rec_desc);	
 		
+		// Keep the location found by the open (e.g. after a garbage collection) in the index.
+		fds_index_store();
+		
 		// Handle the errors.
 		if (fds_state.ret != FDS_SUCCESS){
 			NRF_LOG_INFO("FDS_ERROR [Error Code:0x%2x] : <fdsRecRead> Record Close Failed!\r\n", fds_state.ret);
@@ -277,8 +515,52 @@ ret_code_t fdsRecRead(uint32_t* data_read){
 	}
 }
 
+/** @Func Read a record into a byte array */
+ret_code_t fdsRecReadBytes(uint8_t* data_read, const uint16_t bytes_size, uint16_t* p_bytes_read){
+	// Locate the record (Index look-up for the keys in the index window)
+	if(fdsRecFind() != FDS_SUCCESS){
+		return fds_state.ret;
+	}
+	
+	// Open the record and copy the data straight out of the flash
+	fds_flash_record_t  flash_record;
+	fds_state.ret = fds_record_open(&fds_state.rec_desc, &flash_record);
+	if (fds_state.ret != FDS_SUCCESS){
+		NRF_LOG_INFO("FDS_ERROR [Error Code:0x%2x] : <fdsRecReadBytes> Record Open Failed!\r\n", fds_state.ret);
+		NRF_LOG_FLUSH();
+		return fds_state.ret;
+	}
+	
+	uint16_t record_bytes = flash_record.p_header->tl.length_words * sizeof(uint32_t);
+	uint16_t bytes_read		= (record_bytes < bytes_size) ? record_bytes : bytes_size;
+	memcpy(data_read, flash_record.p_data, bytes_read);
+	if(p_bytes_read != NULL){
+		*p_bytes_read = bytes_read;
+	}
+	
+	// Close the record and keep its location in the index
+	fds_state.ret = fds_record_close(&fds_state.rec_desc);
+	fds_index_store();
+	if (fds_state.ret != FDS_SUCCESS){
+		NRF_LOG_INFO("FDS_ERROR [Error Code:0x%2x] : <fdsRecReadBytes> Record Close Failed!\r\n", fds_state.ret);
+		NRF_LOG_FLUSH();
+		return fds_state.ret;
+	}
+	
+	//	Print the logs if logging is allowed
+	if(fds_flags.fds_log_flag){
+		NRF_LOG_INFO("FDS_LOG: <fdsRecReadBytes> Reading %d Bytes Succeeded @ Record(FileID: 0x%4x, RecordKey: 0x%4x)\r\n", bytes_read, fds_state.record.rec_info.file_id, fds_state.record.rec_info.key);
+		NRF_LOG_FLUSH();
+	}
+	
+	return fds_state.ret;
+}
+
 /** @Func Update a Record */
 ret_code_t fdsRecUpdate(void){
+	// Let the queued requests complete first
+	fdsRequestWait();
+	
 	// Search all the records according to the file_id and record_key
 	if(fdsRecFind() != FDS_SUCCESS){// Search failed
 		return fds_state.ret;
@@ -300,6 +582,9 @@ ret_code_t fdsRecUpdate(void){
 		//	Async Operation
 		fds_state.async_fun(&fds_flags.fds_update_flag);
 		
+		// Index the new copy of the record
+		fds_index_store();
+		
 		// Update logs if logging is allowed.
 		if(fds_flags.fds_log_flag){
 			NRF_LOG_INFO("FDS_LOG: <fdsRecUpdate> Updating Succeeded @ Record(FileID: 0x%4x, RecordKey: 0x%4x)\r\n", fds_state.record.rec_info.file_id, fds_state.record.rec_info.key);
@@ -312,6 +597,9 @@ ret_code_t fdsRecUpdate(void){
 
 /** @Func Delete a Record */
 ret_code_t fdsRecDelete(void){
+	// Let the queued requests complete first
+	fdsRequestWait();
+	
 	// Search all the records according to the file_id and record_key
 	if(fdsRecFind() != FDS_SUCCESS){// Search failed
 		return fds_state.ret;
@@ -332,6 +620,9 @@ ret_code_t fdsRecDelete(void){
 		//	Async Operation
 		fds_state.async_fun(&fds_flags.fds_del_flag);
 		
+		// Remove the record from the index
+		fds_index_clear();
+		
 		// Print the logs if logging is allowed
 		if(fds_flags.fds_log_flag){
 			NRF_LOG_INFO("FDS_LOG: <fdsRecDelete> Deleting Succeeded @ Record(FileID: 0x%4x, RecordKey: 0x%4x)\r\n", fds_state.record.rec_info.file_id, fds_state.record.rec_info.key);
@@ -342,28 +633,213 @@ ret_code_t fdsRecDelete(void){
 	}
 }
 
-/** @Func Garbage Collection */
-ret_code_t fdsGC(void){
-	fds_flags.fds_gc_flag = 0;
+/** @Func Delete All the Records of a File */
+ret_code_t fdsFileDelete(const uint16_t file_id){
+	// Let the queued requests complete first
+	fdsRequestWait();
 	
-	//	Start garbage collection
-	fds_state.ret	 = fds_gc();
+	// Nothing to delete (No FDS operation is queued and the index is kept)
+	if(!fdsFileHasRecords(file_id)){
+		fds_state.ret = FDS_SUCCESS;
+		return fds_state.ret;
+	}
 	
-	// Handle the errors
+	bool is_indexed					=	fds_index_has_file(file_id);
+	fds_flags.fds_del_flag	=	0;
+	fds_state.ret 					= fds_file_delete(file_id);
+	
+	// Handle errors
 	if(fds_state.ret != FDS_SUCCESS){
 		if(fds_flags.fds_log_flag){
-			NRF_LOG_INFO("FDS_LOG [Error Code:0x%2x] : <fdsGC> Garbage Collection Failed\r\n", fds_state.ret);
+			NRF_LOG_INFO("FDS_LOG [Error Code:0x%2x] : <fdsFileDelete> Deleting Failed @ File(FileID: 0x%4x)\r\n", fds_state.ret, file_id);
 			NRF_LOG_FLUSH();
 		}
 		return fds_state.ret;
 	}
 	
 	//	Async Operation
-	fds_state.async_fun(&fds_flags.fds_gc_flag);
+	fds_state.async_fun(&fds_flags.fds_del_flag);
+	
+	// The deleted records were in the index (Another file may hold the same keys, so the index is rebuilt)
+	if(is_indexed){
+		fds_index_stale	=	true;
+		fds_index_built	=	false;
+	}
 	
 	return fds_state.ret;
 }
 
+/** @Func Check Whether a File Holds Any Record */
+bool fdsFileHasRecords(const uint16_t file_id){
+	fds_record_desc_t		desc;
+	fds_find_token_t		ftok;
+	
+	// 	Zero-initialize the token before usage and search for the first record of the file
+	memset(&ftok, 0x00, sizeof(fds_find_token_t));
+	return fds_record_find_in_file(file_id, &desc, &ftok) == FDS_SUCCESS;
+}
+
+/** @Func Garbage Collection */
+ret_code_t fdsGC(void){
+	// Let the queued requests complete first
+	fdsRequestWait();
+	
+	//	Start garbage collection (A garbage collection in flight is waited for instead of starting another one)
+	if(fds_gc_idle){
+		fds_state.ret	 = fdsGCAsync();
+		if(fds_state.ret != FDS_SUCCESS){
+			return fds_state.ret;
+		}
+	}
+	
+	//	Async Operation
+	fds_state.async_fun(&fds_gc_idle);
+	
+	fds_state.ret	=	fds_gc_result;
+	return fds_state.ret;
+}
+
+/** @Func Start Garbage Collection */
+ret_code_t fdsGCAsync(void){
+	ret_code_t	ret	=	FDS_ERR_BUSY;
+	
+	//	Only one garbage collection at a time
+	CRITICAL_REGION_ENTER();
+	if(fds_gc_idle){
+		// Marked as running first, FDS reports a garbage collection without any page to collect before fds_gc returns
+		fds_gc_idle	=	0;
+		ret	=	fds_gc();
+		if(ret != FDS_SUCCESS){
+			fds_gc_idle	=	1;
+		}
+	}
+	CRITICAL_REGION_EXIT();
+	
+	// Handle the errors
+	if(ret != FDS_SUCCESS && fds_flags.fds_log_flag){
+		NRF_LOG_INFO("FDS_LOG [Error Code:0x%2x] : <fdsGCAsync> Garbage Collection Not Started\r\n", ret);
+	}
+	return ret;
+}
+
+/** @Func Check Whether A Garbage Collection is Running */
+bool fdsGCRunning(void){
+	return fds_gc_idle == 0;
+}
+
+/** @Func Queue the Write or the Update of a Record */
+ret_code_t fdsRecWriteAsync(const uint16_t file_id, const uint16_t rec_key, const uint32_t* const data_array, const uint16_t data_length, fds_request_handler_t handler, uint16_t* p_handle){
+	fds_record_chunk_t	chunk;
+	fds_record_t				record;
+	fds_record_desc_t		desc;
+	fds_request_t				*p_request;
+	ret_code_t					ret;
+	
+	//Check the record (The same limits as fdsRecConfig)
+	if(file_id > 0xBFFF || rec_key == 0x0000 || rec_key > 0xBFFF || data_length > FDS_VIRTUAL_PAGE_SIZE-5){
+		return FDS_ERR_INVALID_ARG;
+	}
+	
+	//Set up the record (FDS copies the chunk into its chunk queue, the data array itself is not copied)
+	chunk.p_data						=	data_array;
+	chunk.length_words			=	data_length;
+	record.file_id					=	file_id;
+	record.key							=	rec_key;
+	record.data.p_chunks		=	&chunk;
+	record.data.num_chunks	=	1;
+	
+	//Look up the record before masking the interrupts (A stale index or a key outside the index window walks the flash)
+	ret	=	fds_locate(file_id, rec_key, &desc);
+	
+	//The completion event can not be handled before the request entry is filled in
+	if(ret == FDS_SUCCESS || ret == FDS_ERR_NOT_FOUND){
+		CRITICAL_REGION_ENTER();
+		p_request	=	fds_request_alloc();
+		if(p_request == NULL){
+			ret	=	FDS_ERR_NO_SPACE_IN_QUEUES;
+		}
+		else{
+			if(ret == FDS_SUCCESS){
+				ret	=	fds_record_update(&desc, &record);
+			}
+			else{
+				ret	=	fds_record_write(&desc, &record);
+			}
+			if(ret == FDS_SUCCESS){
+				fds_request_start(p_request, desc.record_id, file_id, rec_key, handler, p_handle);
+				fds_index_set(file_id, rec_key, &desc);
+			}
+		}
+		CRITICAL_REGION_EXIT();
+	}
+	
+	if(ret != FDS_SUCCESS && fds_flags.fds_log_flag){
+		NRF_LOG_INFO("FDS_LOG [Error Code:0x%2x] : <fdsRecWriteAsync> Queueing Failed @ Record(FileID: 0x%4x, RecordKey: 0x%4x)\r\n", ret, file_id, rec_key);
+	}
+	return ret;
+}
+
+/** @Func Queue the Deletion of a Record */
+ret_code_t fdsRecDeleteAsync(const uint16_t file_id, const uint16_t rec_key, fds_request_handler_t handler, uint16_t* p_handle){
+	fds_record_desc_t		desc;
+	fds_request_t				*p_request;
+	ret_code_t					ret;
+	
+	//Look up the record before masking the interrupts (A stale index or a key outside the index window walks the flash)
+	ret	=	fds_locate(file_id, rec_key, &desc);
+	
+	//The completion event can not be handled before the request entry is filled in
+	if(ret == FDS_SUCCESS){
+		CRITICAL_REGION_ENTER();
+		p_request	=	fds_request_alloc();
+		if(p_request == NULL){
+			ret	=	FDS_ERR_NO_SPACE_IN_QUEUES;
+		}
+		else{
+			ret	=	fds_record_delete(&desc);
+			if(ret == FDS_SUCCESS){
+				fds_request_start(p_request, desc.record_id, file_id, rec_key, handler, p_handle);
+				fds_index_reset(rec_key);
+			}
+		}
+		CRITICAL_REGION_EXIT();
+	}
+	
+	if(ret != FDS_SUCCESS && ret != FDS_ERR_NOT_FOUND && fds_flags.fds_log_flag){
+		NRF_LOG_INFO("FDS_LOG [Error Code:0x%2x] : <fdsRecDeleteAsync> Queueing Failed @ Record(FileID: 0x%4x, RecordKey: 0x%4x)\r\n", ret, file_id, rec_key);
+	}
+	return ret;
+}
+
+/** @Func Get the Number of Queued Requests */
+uint8_t fdsRequestPending(void){
+	return fds_request_count;
+}
+
+/** @Func Wait for All Queued Requests */
+void fdsRequestWait(void){
+	fds_state.async_fun(&fds_request_idle);
+}
+
+/** @Func Describe One FDS Page */
+ret_code_t fdsPageInfo(const uint8_t page, fds_page_info_t * p_info){
+	fs_config_t const *	p_config	=	fds_fs_config();
+	
+	if(page >= FDS_VIRTUAL_PAGES){
+		return FDS_ERR_INVALID_ARG;
+	}
+	if(p_config == NULL || p_config->p_start_addr == NULL){
+		return FDS_ERR_NOT_INITIALIZED;
+	}
+	
+	//	The pages follow each other from the start address of FDS
+	p_info->p_addr		=	p_config->p_start_addr + (uint32_t)page * FDS_VIRTUAL_PAGE_SIZE;
+	p_info->is_data		=	(p_info->p_addr[0] == FDS_PAGE_TAG_MAGIC_WORD && p_info->p_addr[1] == FDS_PAGE_TAG_DATA_WORD);
+	p_info->is_swap		=	(p_info->p_addr[0] == FDS_PAGE_TAG_MAGIC_WORD && p_info->p_addr[1] == FDS_PAGE_TAG_SWAP_WORD);
+	p_info->first_id	=	p_info->p_addr[FDS_PAGE_FIRST_ID_WORD];
+	return FDS_SUCCESS;
+}
+
 /** @Func Set Async Operation */
 void fdsSetAsynFun(fds_fptr_t func){
 	fds_state.async_fun = func;
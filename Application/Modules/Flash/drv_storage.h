@@ -13,10 +13,17 @@
 	*************************************************************************************************************************************************
 	*	Main FDS operation functions include : 
 	*	fdsInit(FDS system initialization),fdsRecWrite(Write a record)
-	*	fdsRecRead(read a record),fdsRecUpdate(update an existing record),fdsRecDelete(delete an existing record),fdsGC(perform garbage collection).
+	*	fdsRecRead(read a record),fdsRecReadBytes(read a record into a byte array),fdsRecUpdate(update an existing record),fdsRecDelete(delete an existing record),fdsFileDelete(delete all the records of a file),fdsGC(perform garbage collection).
+	*	fdsGCAsync(start garbage collection without waiting),fdsGCRunning(check whether a garbage collection is in flight).
+	*	fdsFileHasRecords(check whether a file holds any record).
 	*	Utility functions :
 	*	fdsResetVars(reset all the internal variables to zero values),fdsRecSetup(fill in the metadata of a record)
 	*	fdsRecFind(look up an FDS record),fdsSetAsynFun(change the async function).
+	*	fdsIndexBuild(map every record key in the index window to its descriptor in one pass over the flash).
+	*	Non-blocking operations :
+	*	fdsRecWriteAsync(queue a write or an update),fdsRecDeleteAsync(queue a deletion),fdsRequestPending(number of queued requests),fdsRequestWait(wait for all queued requests).
+	*	Page layout :
+	*	fdsPageInfo(read the page tag and the first record ID of an FDS page).
 	*	Accessors :
 	*	fdsGetState(return the internal FDS state),fdsGetFlags(return an object of type fds_flags_t)
 	*	fdsSetInitFlag(change the initialization flag),fdsSetWriteFlag(change the writing flag),fdsSetUpdateFlag(change the update flag)
@@ -25,12 +32,26 @@
 	*	This module defines two internal variables, noted by "static", and one default async function. These are defined in the "drv_storage.c" file.
 	*	The two variables include fds_state and fds_flags which store the fds internal states and all the fds internal flags respectively.
 	*	The default async function is fds_wait which put the MCU into sleeping mode and wait until the flash operation is done.
+	*	The non-blocking functions do not use fds_state. Each of them queues the operation into FDS at once and keeps a request entry
+	*	(FDS_REQUEST_QUEUE_SIZE entries) that is completed from the FDS event by its record ID, so several operations can be in flight.
+	*	The blocking functions first wait for all the queued requests, so the operation flags can not be set by a request completion.
 	*************************************************************************************************************************************************
 	*	@Type	fds_rec_t							(Record Data Description Type)
 	*	@Type	fds_state_t						(Record State Type)
 	*	@Type fds_flags_t						(FDS Operation Flags Type)
 	*	@Type fds_fptr_t						(Function Pointer for Waiting FDS Operation to Complete)
 	*	@Type fds_evt_handler_t			(The FDS event handler type)
+	*	@Type fds_index_entry_t			(Record Index Entry Type)
+	*	@Type fds_request_t					(Non-blocking Request Entry Type)
+	*	@Type fds_request_handler_t	(Non-blocking Request Completion Handler Type)
+	*	@Type fds_page_info_t				(FDS Page Description Type)
+	*
+	*	@Macro FDS_INDEX_KEY_BASE		(First Record Key Covered by the Record Index)
+	*	@Macro FDS_INDEX_KEY_NUM		(Number of Record Keys Covered by the Record Index)
+	*	@Macro FDS_REQUEST_QUEUE_SIZE	(Number of Non-blocking Requests in Flight, Must Be Less than FDS_OP_QUEUE_SIZE)
+	*	@Macro FDS_PAGE_TAG_WORDS		(Size of the Page Tag in Words)
+	*	@Macro FDS_PAGE_FIRST_ID_WORD	(Word Offset of the Record ID of the First Record in A Page)
+	*	@Macro FDS_PAGE_RECORD_ID_NONE	(First Record ID of A Page without Records)
 	*
 	*	@Func	fdsResetVars					(Zero-initialize the Internal Variables)
 	*	@Func fdsRecConfig					(Setup an FDS Record)
@@ -38,10 +59,21 @@
 	* @Func fdsRecWrite						(Write a Record)
 	* @Func fdsRecFind						(Locate a Record)
 	*	@Func fdsRecRead						(Read a Record)
+	*	@Func fdsRecReadBytes				(Read a Record into a Byte Array)
 	* @Func	fdsRecUpdate					(Update a Record)
 	* @Func fdsRecDelete					(Delete a Record)
+	* @Func fdsFileDelete					(Delete All the Records of a File)
+	* @Func fdsFileHasRecords			(Check Whether a File Holds Any Record)
 	*	@Func fdsGC									(Garbage Collection)
+	*	@Func fdsGCAsync						(Start Garbage Collection)
+	*	@Func fdsGCRunning					(Check Whether A Garbage Collection is Running)
 	*	@Func fdsSetAsynFun					(Set Async Operation)
+	*	@Func fdsIndexBuild					(Build the Record Index)
+	*	@Func fdsRecWriteAsync			(Queue the Write or the Update of a Record)
+	*	@Func fdsRecDeleteAsync			(Queue the Deletion of a Record)
+	*	@Func fdsRequestPending			(Get the Number of Queued Requests)
+	*	@Func fdsRequestWait				(Wait for All Queued Requests)
+	*	@Func fdsPageInfo						(Describe One FDS Page)
 	*	@Func fdsGetState						(Get FDS Status)
 	* @Func fdsGetFlags						(Get FDS Flags)
 	*
@@ -59,16 +91,40 @@
 #define __DRV_STORAGE_H__
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /* Include Essential Headers */
+#include <stddef.h>
 #include "app_error.h"
 #include "fds.h"
 
-/* Include the Event Handlers */
-#include "event_handlers.h"
-
 /* Include NRF Libraries */
 #include "nrf_log.h"
 #include "nrf_delay.h"
 #include "nrf_log_ctrl.h"
+#include "nrf_soc.h"
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Record Index Window
+ * The records with keys in [FDS_INDEX_KEY_BASE, FDS_INDEX_KEY_BASE + FDS_INDEX_KEY_NUM) are located through a RAM index
+ * filled by one pass over the flash (fdsIndexBuild) and kept up to date by the write, update and delete functions.
+ * Records outside the window are still located with fds_record_find.
+*/
+#define FDS_INDEX_KEY_BASE					0x1000
+#define FDS_INDEX_KEY_NUM						128
+
+/* Non-blocking Request Queue
+ * The FDS op queue (FDS_OP_QUEUE_SIZE in "sdk_config.h") also holds the operations of the peer manager and of the blocking functions,
+ * so only a part of it is given to the non-blocking requests.
+*/
+#define FDS_REQUEST_QUEUE_SIZE			8
+#define FDS_REQUEST_HANDLE_INVALID	0
+
+/* FDS Page Layout
+ * Each FDS page starts with a page tag of FDS_PAGE_TAG_WORDS words, then the records follow, each starting with an fds_header_t.
+ * The page tag values are internal to FDS ("fds_internal_defs.h", whose fds_flags_t clashes with the type of this module),
+ * so the pages are only read through fdsPageInfo.
+*/
+#define FDS_PAGE_TAG_WORDS					2
+#define FDS_PAGE_FIRST_ID_WORD			(FDS_PAGE_TAG_WORDS + offsetof(fds_header_t, record_id)/sizeof(uint32_t))
+#define FDS_PAGE_RECORD_ID_NONE			0xFFFFFFFF		//Erased flash word (No record after the page tag)
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #ifdef __cplusplus
 extern "C" {
@@ -106,6 +162,37 @@ typedef struct
 	uint8_t 										fds_log_flag;		//FDS logging flag
 }fds_flags_t;
 
+/** @Type The type to store one entry of the record index (The fields of fds_record_desc_t needed to open the record directly) */
+typedef struct
+{
+	uint32_t										record_id;		//Unique record ID (0 if the key has no record)
+	uint32_t const *						p_record;			//Last known location of the record
+	uint16_t										gc_run_count;	//Garbage collection count when the location was taken
+	uint16_t										file_id;			//File ID of the record
+}fds_index_entry_t;
+
+/** @Type The completion handler type of the non-blocking requests (Called in the FDS event context) */
+typedef void (*fds_request_handler_t)(const uint16_t handle, const uint16_t file_id, const uint16_t rec_key, const ret_code_t result);
+
+/** @Type The type to store one non-blocking request in flight */
+typedef struct
+{
+	uint32_t										record_id;		//Record ID reported by the completion event (0 if the entry is free)
+	uint16_t										handle;				//Request handle returned to the caller
+	uint16_t										file_id;			//File ID of the record
+	uint16_t										rec_key;			//Record key of the record
+	fds_request_handler_t				handler;			//Completion handler (or NULL)
+}fds_request_t;
+
+/** @Type The type to describe one FDS page (Filled in by fdsPageInfo) */
+typedef struct
+{
+	uint32_t const *						p_addr;				//Address of the page
+	bool												is_data;			//The page is tagged as a data page
+	bool												is_swap;			//The page is tagged as the swap page
+	uint32_t										first_id;			//Record ID of the first record (FDS_PAGE_RECORD_ID_NONE if the page holds no record)
+}fds_page_info_t;
+
 /** @Type The function pointer type to store the async function */
 typedef void (*fds_fptr_t)(uint8_t*);
 
@@ -134,6 +221,7 @@ void fdsResetVars (void);
 	*	@Para			file_id 		[uint16_t]	: File ID
 	*	@Para			rec_key 		[uint16_t]	: Record Key
 	*	@Para			data_array	[uint32_t*]	:	Address of the data array to be stored.(When locating or reading a record, set it to NULL)
+	*																		The array is written as it is (no copy), so it must stay unchanged until the write has completed.
 	*	@Para			data_length [uint16_t]	: Array length of the data array.(When locating a record, set it to 0)
 	*
 	*	@Return		false	: Record set up failed (invalid input parameters)
@@ -187,6 +275,21 @@ ret_code_t fdsRecFind(void);
 */
 ret_code_t fdsRecRead(uint32_t* data_read);
 
+/** @Func Read a Record into a Byte Array
+	*
+	* @Brief 	This function copies the data of an existing record straight out of the flash into the destination byte array.
+	* 				At most bytes_size bytes are copied, so the destination can never overflow, and it does not have to be word-aligned.
+	* 				Before calling this function, fdsRecSetup must be called and FDS system initialized.
+	*
+	* @Para 	data_read 		[uint8_t*] 	: the array address to store the data read from the FDS system
+	* @Para 	bytes_size 		[uint16_t] 	: the size of the destination array
+	* @Para 	p_bytes_read 	[uint16_t*] : the number of bytes actually copied (the record may be shorter), or NULL
+	*
+	*	@Return	Propogate internal errors
+	*
+*/
+ret_code_t fdsRecReadBytes(uint8_t* data_read, const uint16_t bytes_size, uint16_t* p_bytes_read);
+
 /** @Func Update a Record
 	*
 	* @Brief 	This function updates an existing record in the flash.
@@ -209,15 +312,121 @@ ret_code_t fdsRecUpdate(void);
 */
 ret_code_t fdsRecDelete(void);
 
-/** @Func Run Garbage Collection
+/** @Func Delete All the Records of a File
 	*
-	* @Brief This function performs garbage collection operation of the flash.
+	* @Brief	This function deletes every record with the given file ID in one FDS operation and waits for it.
+	* 				Nothing is queued if the file holds no record. If the index held records of the file, it is marked stale,
+	* 				so it is rebuilt at the next lookup.
+	*
+	*	@Para		file_id [uint16_t] : File ID
 	*
 	*	@Return Propogate internal errors
 	*
 */
+ret_code_t fdsFileDelete(const uint16_t file_id);
+
+/** @Func Check Whether a File Holds Any Record
+	*
+	* @Brief	This function looks for the first record of the file (fds_record_find_in_file). It does not wait for the queued requests.
+	*
+	*	@Para		file_id [uint16_t] : File ID
+	*
+	*	@Return true if a record of the file is found
+	*
+*/
+bool fdsFileHasRecords(const uint16_t file_id);
+
+/** @Func Run Garbage Collection
+	*
+	* @Brief This function performs garbage collection operation of the flash and waits for its end.
+	* 			If a garbage collection started by fdsGCAsync is running, it waits for that one instead of starting another one.
+	*
+	*	@Return Propogate internal errors (The result of the garbage collection)
+	*
+*/
 ret_code_t fdsGC(void);
 
+/** @Func Start Garbage Collection
+	*
+	* @Brief This function queues the garbage collection into FDS and returns at once. Its end is reported by FDS_EVT_GC.
+	* 			This is the only place a garbage collection is started, so only one of them is in flight.
+	*
+	*	@Return FDS_ERR_BUSY			: A garbage collection is running already
+	*	@Return Propogate internal errors
+	*
+*/
+ret_code_t fdsGCAsync(void);
+
+/** @Func Check Whether A Garbage Collection is Running
+	*
+	*	@Return	true from the start of a garbage collection until its FDS_EVT_GC
+	*
+*/
+bool fdsGCRunning(void);
+
+/** @Func Build the Record Index
+	*
+	* @Brief 	This function walks through all the records once (fds_record_iterate) and stores the descriptor of every record
+	* 				whose key is in the index window. It is called by fdsInit, and can be called again to resynchronise the index.
+	* 				After the index is built, fdsRecFind resolves these keys without scanning the flash pages.
+	* 				Note: If several records share a key, only the first one found is indexed (as with fdsRecFind).
+	*
+	*	@Return	Propogate internal errors
+	*
+*/
+ret_code_t fdsIndexBuild(void);
+
+/** @Func Queue the Write or the Update of a Record
+	*
+	* @Brief 	This function queues the record into FDS and returns at once. The record is updated if it exists, otherwise it is written.
+	* 				The data array is written as it is (no copy), so it must stay valid until the completion handler is called.
+	* 				The record index is updated when the request is queued. If the request fails, the index is rebuilt when the queue is empty.
+	* 				Note: This function does not use the record set up by fdsRecConfig and does not run garbage collection.
+	*
+	*	@Para		file_id 		[uint16_t]							: File ID
+	*	@Para		rec_key 		[uint16_t]							: Record Key
+	*	@Para		data_array	[uint32_t*]							:	Address of the data array to be stored
+	*	@Para		data_length [uint16_t]							: Array length of the data array
+	*	@Para		handler			[fds_request_handler_t]	: Completion handler called in the FDS event context (or NULL)
+	*	@Para		p_handle		[uint16_t*]							: The handle of the request (or NULL)
+	*
+	*	@Return FDS_ERR_NO_SPACE_IN_QUEUES	: All the request entries (or the FDS queues) are in use, try again after a completion
+	*	@Return	Propogate internal errors
+	*
+*/
+ret_code_t fdsRecWriteAsync(const uint16_t file_id, const uint16_t rec_key, const uint32_t* const data_array, const uint16_t data_length, fds_request_handler_t handler, uint16_t* p_handle);
+
+/** @Func Queue the Deletion of a Record
+	*
+	* @Brief 	This function queues the deletion of an existing record into FDS and returns at once.
+	*
+	*	@Para		file_id 		[uint16_t]							: File ID
+	*	@Para		rec_key 		[uint16_t]							: Record Key
+	*	@Para		handler			[fds_request_handler_t]	: Completion handler called in the FDS event context (or NULL)
+	*	@Para		p_handle		[uint16_t*]							: The handle of the request (or NULL)
+	*
+	*	@Return FDS_ERR_NOT_FOUND						: The record does not exist (Nothing is queued)
+	*	@Return FDS_ERR_NO_SPACE_IN_QUEUES	: All the request entries (or the FDS queues) are in use, try again after a completion
+	*	@Return	Propogate internal errors
+	*
+*/
+ret_code_t fdsRecDeleteAsync(const uint16_t file_id, const uint16_t rec_key, fds_request_handler_t handler, uint16_t* p_handle);
+
+/** @Func Get the Number of Queued Requests
+	*
+	*	@Return	The number of non-blocking requests not completed yet
+	*
+*/
+uint8_t fdsRequestPending(void);
+
+/** @Func Wait for All Queued Requests
+	*
+	* @Brief 	This function waits with the async function until all the non-blocking requests are completed.
+	* 				It must be called from the main context, not from an interrupt handler.
+	*
+*/
+void fdsRequestWait(void);
+
 /** @Func Set Async Operation
 	*
 	* @Brief 	This function sets the internal function pointer to the desired async function.
@@ -228,6 +437,20 @@ ret_code_t fdsGC(void);
 */
 void fdsSetAsynFun(fds_fptr_t func);
 
+/** @Func Describe One FDS Page
+	*
+	* @Brief 	This function reads the page tag and the ID of the first record of an FDS page straight from the flash.
+	* 				The page addresses are set by FDS during fdsInit.
+	*
+	*	@Para		page		[uint8_t]						: Page number (0 to FDS_VIRTUAL_PAGES-1)
+	*	@Para		p_info	[fds_page_info_t*]	: The page description to be written into
+	*
+	*	@Return FDS_ERR_INVALID_ARG				: The page does not exist
+	*	@Return FDS_ERR_NOT_INITIALIZED		: FDS is not initialized (or another module has registered an fstorage configuration)
+	*
+*/
+ret_code_t fdsPageInfo(const uint8_t page, fds_page_info_t * p_info);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Interface for Accessing Internal States of this Module */
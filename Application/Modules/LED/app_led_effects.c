@@ -32,136 +32,163 @@ static const uint8_t leds_rgb_list[LEDS_NUMBER] 	= LEDS_LIST;
 #endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/* PWM Wave Sequence Data Definitions */
+/* Procedural LED Effect Definitions */
 
-/** @Variable Define variables for the first LED effect */
-static const nrf_pwm_clk_t 	clk_led_eff_1_r 			= NRF_PWM_CLK_1MHz;		//PWM basic clock
-static const uint16_t 			top_val_led_eff_1_r 	= 10000;							//Top value for each time-out cycle(this defines the period of the PWM wave)
-static const uint16_t			 	seq_len_led_eff_1_r 	= 300;								//The length of one sequence data(this defines the total time of sequence execution)
-static uint16_t 						seq_data_led_eff_1_r[seq_len_led_eff_1_r];  //The data array to store the sequence data
+/** @Variable Keyframes of the first LED effect (red, green and blue pulse one after the other) */
+static const led_keyframe_t led_keys_first[] =
+{
+	{0,			{0,		0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{500,		{250,	0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{1000,	{0,		0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{1500,	{0,		250,	0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{2000,	{0,		0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{2500,	{0,		0,		250	}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{3000,	{0,		0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+};
+
+/** @Variable Keyframes of the second LED effect (all three channels breathe together) */
+static const led_keyframe_t led_keys_second[] =
+{
+	{0,			{0,		0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{1000,	{252,	252,	252	}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+	{2000,	{0,		0,		0		}, {LED_EASE_LINEAR, LED_EASE_LINEAR, LED_EASE_LINEAR}},
+};
 
-static const nrf_pwm_clk_t 	clk_led_eff_1_g 			= NRF_PWM_CLK_1MHz;
-static const uint16_t 			top_val_led_eff_1_g 	= 10000;
-static const uint16_t			 	seq_len_led_eff_1_g 	= 300;
-static uint16_t 						seq_data_led_eff_1_g[seq_len_led_eff_1_g];
+/** @Variable Keyframes of the rainbow effect (the hue wraps from 255 back to 0 at the end of each loop) */
+static const led_keyframe_t led_keys_rainbow[] =
+{
+	{0,			{0,		255,	255	}, {LED_EASE_LINEAR, LED_EASE_STEP, LED_EASE_STEP}},
+	{3000,	{255,	255,	255	}, {LED_EASE_LINEAR, LED_EASE_STEP, LED_EASE_STEP}},
+};
 
-static const nrf_pwm_clk_t 	clk_led_eff_1_b 			= NRF_PWM_CLK_1MHz;
-static const uint16_t 			top_val_led_eff_1_b 	= 10000;
-static const uint16_t			 	seq_len_led_eff_1_b 	= 300;
-static uint16_t 						seq_data_led_eff_1_b[seq_len_led_eff_1_b];
+/** @Variable Descriptions of the PWM effects, in the order of led_effect_t from LED_EFFECT_FIRST */
+static const led_effect_desc_t led_effect_descs[LED_EFFECT_NUM - LED_EFFECT_FIRST] =
+{
+	{led_keys_first,		sizeof(led_keys_first) 		/ sizeof(led_keyframe_t), LED_SPACE_RGB, 2},	// LED_EFFECT_FIRST
+	{led_keys_second,		sizeof(led_keys_second) 	/ sizeof(led_keyframe_t), LED_SPACE_RGB, 3},	// LED_EFFECT_SECOND
+	{led_keys_rainbow,	sizeof(led_keys_rainbow) 	/ sizeof(led_keyframe_t), LED_SPACE_HSV, 0},	// LED_EFFECT_RAINBOW
+};
 
-/** @Variable Define variables for the second LED effect */
-static const nrf_pwm_clk_t 	clk_led_eff_2_r 			= NRF_PWM_CLK_1MHz;		//PWM basic clock
-static const uint16_t 			top_val_led_eff_2_r 	= 10000;							//Top value for each time-out cycle(this defines the period of the PWM wave)
-static const uint16_t			 	seq_len_led_eff_2_r 	= 200;								//The length of one sequence data(this defines the total time of sequence execution)
-static uint16_t 						seq_data_led_eff_2_r[seq_len_led_eff_2_r];  //The data array to store the sequence data
+/** @Variable The description of the registered PWM effect */
+static const led_effect_desc_t * p_led_effect_desc	= NULL;
 
-static const nrf_pwm_clk_t 	clk_led_eff_2_g 			= NRF_PWM_CLK_1MHz;
-static const uint16_t 			top_val_led_eff_2_g 	= 10000;
-static const uint16_t			 	seq_len_led_eff_2_g 	= 200;
-static uint16_t 						seq_data_led_eff_2_g[seq_len_led_eff_2_g];
+/** @Variable The next step to render */
+static uint32_t led_effect_step;
 
-static const nrf_pwm_clk_t 	clk_led_eff_2_b 			= NRF_PWM_CLK_1MHz;
-static const uint16_t 			top_val_led_eff_2_b 	= 10000;
-static const uint16_t			 	seq_len_led_eff_2_b 	= 200;
-static uint16_t 						seq_data_led_eff_2_b[seq_len_led_eff_2_b];
+/** @Variable The two halves of the interleaved PWM sequence of the RGB channels */
+static nrf_pwm_values_individual_t led_effect_seq[2][LED_EFFECT_CHUNK_LEN];
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/* Function Implementations for LED Effect Operations */
+/* Internal Functions for Rendering the Procedural LED Effects */
 
-/** @Func Initialize a pre-defined effect */
-void ledEffectFillSeq(led_effect_t effect)
+/** @Func Interpolate from one value to another along an easing curve (pos is the progress in 1/256, 0 ~ 256) */
+static uint8_t led_ease_value(const led_ease_t ease, const uint8_t from, const uint8_t to, uint32_t pos)
 {
-	switch (effect){
-		/** @Effect First LED effect sequence filling */
-		case LED_EFFECT_FIRST:
-		{
-			uint16_t i,step;
-			uint16_t inc_start,inc_end,dec_start,dec_end;
-			
-			// Channel One
-			inc_start	=	0;
-			inc_end		=	seq_len_led_eff_1_r/6-1;
-			dec_start	=	seq_len_led_eff_1_r/6;
-			dec_end		= seq_len_led_eff_1_r/3-1;
-			for(i=inc_start,step=200;i<=inc_end;i++){
-				seq_data_led_eff_1_r[i] = step*i;
-			}
-			for(i=dec_start,step=200;i<=dec_end;i++){
-				seq_data_led_eff_1_r[i] = seq_data_led_eff_1_r[inc_end]-step*(i-dec_start);
-			}
-			for(i=dec_end+1;i<seq_len_led_eff_1_r;i++){
-				seq_data_led_eff_1_r[i]	= 0;
-			}
-			
-			// Channel Two
-			inc_start	=	seq_len_led_eff_1_g/3;
-			inc_end		= seq_len_led_eff_1_g/2-1;
-			dec_start	=	seq_len_led_eff_1_g/2;
-			dec_end		= seq_len_led_eff_1_g/3*2-1;
-			for(i=0;i<inc_start;i++){
-				seq_data_led_eff_1_g[i]=0;
-			}
-			for(i=inc_start,step=200;i<=inc_end;i++){
-				seq_data_led_eff_1_g[i] = step*(i-inc_start);
-			}
-			for(i=dec_start,step=200;i<=dec_end;i++){
-				seq_data_led_eff_1_g[i] = seq_data_led_eff_1_g[inc_end]-step*(i-dec_start);
-			}
-			for(i=dec_end+1;i<seq_len_led_eff_1_g;i++){
-				seq_data_led_eff_1_g[i]	= 0;
-			}
-			
-			// Channel Three
-			inc_start	=	seq_len_led_eff_1_b/3*2;
-			inc_end		=	seq_len_led_eff_1_b/6*5-1;
-			dec_start	= seq_len_led_eff_1_b/6*5;
-			dec_end		= seq_len_led_eff_1_b-1;
-			for(i=0;i<=inc_start;i++){
-				seq_data_led_eff_1_b[i] = 0;
-			}
-			for(i=inc_start,step=200;i<=inc_end;i++){
-				seq_data_led_eff_1_b[i]	=	step*(i-inc_start);
-			}
-			for(i=dec_start;i<=dec_end;i++){
-				seq_data_led_eff_1_b[i]	= seq_data_led_eff_1_b[inc_end]-step*(i-dec_start);
-			}
-			return;
+	switch (ease){
+		case LED_EASE_STEP:
+			pos = (pos >= 256) ? 256 : 0;
+			break;
+		case LED_EASE_IN:
+			pos = (pos * pos) >> 8;
+			break;
+		case LED_EASE_OUT:
+			pos = 256 - (((256 - pos) * (256 - pos)) >> 8);
+			break;
+		case LED_EASE_IN_OUT:
+			pos = (pos * pos * (768 - 2 * pos)) >> 16;
+			break;
+		case LED_EASE_LINEAR:
+		default:
+			break;
+	}
+	return (uint8_t)((int32_t)from + ((((int32_t)to - (int32_t)from) * (int32_t)pos) >> 8));
+}
+
+/** @Func Convert a hue/saturation/value triple into red/green/blue levels (integer, six sectors of 43 hue steps) */
+static void led_hsv_to_rgb(const uint8_t hsv[3], uint8_t rgb[3])
+{
+	uint8_t		h 			= hsv[0];
+	uint32_t	s 			= hsv[1];
+	uint32_t	v 			= hsv[2];
+	uint8_t		sector 	= h / 43;
+	uint32_t	rem 		= (h - sector * 43) * 6;
+	uint8_t		p 			= (v * (255 - s)) >> 8;
+	uint8_t		q 			= (v * (255 - ((s * rem) >> 8))) >> 8;
+	uint8_t		t 			= (v * (255 - ((s * (255 - rem)) >> 8))) >> 8;
+	
+	switch (sector){
+		case 0:		rgb[0] = v; rgb[1] = t; rgb[2] = p; return;
+		case 1:		rgb[0] = q; rgb[1] = v; rgb[2] = p; return;
+		case 2:		rgb[0] = p; rgb[1] = v; rgb[2] = t; return;
+		case 3:		rgb[0] = p; rgb[1] = q; rgb[2] = v; return;
+		case 4:		rgb[0] = t; rgb[1] = p; rgb[2] = v; return;
+		default:	rgb[0] = v; rgb[1] = p; rgb[2] = q; return;
+	}
+}
+
+/** @Func Render the RGB levels of an effect at a given time (returns false once the last loop has finished, holding the last keyframe) */
+static bool led_effect_render(const led_effect_desc_t * const p_desc, uint32_t time_ms, uint8_t rgb[3])
+{
+	const led_keyframe_t *	p_keys 	= p_desc->p_keys;
+	const uint8_t						last		= p_desc->key_num - 1;
+	const uint32_t					period	= p_keys[last].time_ms;
+	uint8_t									value[3];
+	bool										is_more	= true;
+	
+	if(p_desc->loops != 0 && time_ms >= period * p_desc->loops){
+		// The effect has finished, hold the last keyframe
+		value[0] = p_keys[last].value[0];
+		value[1] = p_keys[last].value[1];
+		value[2] = p_keys[last].value[2];
+		is_more	 = false;
+	}
+	else{
+		// Find the keyframes around the time in this loop
+		uint8_t		k = 1;
+		time_ms	 %= period;
+		while(k < last && p_keys[k].time_ms <= time_ms){
+			k++;
 		}
-		
-		/** @Effect Second LED effect sequence filling */
-		case LED_EFFECT_SECOND:
-		{
-			uint16_t i,step;
-			
-			// Channel One
-			for(i=0,step=100;i<seq_len_led_eff_2_r/2;i++){
-				seq_data_led_eff_2_r[i] = step * i;
-			}
-			for(i=seq_len_led_eff_2_r/2,step=100;i<seq_len_led_eff_2_r;i++){
-				seq_data_led_eff_2_r[i]	=	seq_data_led_eff_2_r[seq_len_led_eff_2_r/2-1]-step*(i-seq_len_led_eff_2_r/2);
-			}
-			
-			// Channel Two
-			for(i=0,step=100;i<seq_len_led_eff_2_g/2;i++){
-				seq_data_led_eff_2_g[i] = step * i;
-			}
-			for(i=seq_len_led_eff_2_g/2,step=100;i<seq_len_led_eff_2_g;i++){
-				seq_data_led_eff_2_g[i]	=	seq_data_led_eff_2_g[seq_len_led_eff_2_g/2-1]-step*(i-seq_len_led_eff_2_g/2);
-			}
-			
-			// Channel Three
-			for(i=0,step=100;i<seq_len_led_eff_2_b/2;i++){
-				seq_data_led_eff_2_b[i] = step * i;
-			}
-			for(i=seq_len_led_eff_2_b/2,step=100;i<seq_len_led_eff_2_b;i++){
-				seq_data_led_eff_2_b[i]	=	seq_data_led_eff_2_b[seq_len_led_eff_2_b/2-1]-step*(i-seq_len_led_eff_2_b/2);
-			}
-			return;
+		uint32_t	span	= p_keys[k].time_ms - p_keys[k - 1].time_ms;
+		uint32_t	pos		= span ? ((time_ms - p_keys[k - 1].time_ms) << 8) / span : 256;
+		for(uint8_t c = 0; c < 3; c++){
+			value[c] = led_ease_value(p_keys[k].ease[c], p_keys[k - 1].value[c], p_keys[k].value[c], pos);
 		}
 	}
+	
+	if(p_desc->space == LED_SPACE_HSV){
+		led_hsv_to_rgb(value, rgb);
+	}
+	else{
+		rgb[0] = value[0];
+		rgb[1] = value[1];
+		rgb[2] = value[2];
+	}
+	return is_more;
+}
+
+/** @Func Render the next steps into a played half of the interleaved PWM sequence (PWM interrupt context) */
+static bool led_effect_refill(nrf_pwm_values_individual_t * p_values, const uint16_t length)
+{
+	uint8_t				rgb[3];
+	bool					is_more	= true;
+	
+	for(uint16_t i = 0; i < length; i++){
+		is_more 							= led_effect_render(p_led_effect_desc, led_effect_step * LED_EFFECT_STEP_MS, rgb);
+		p_values[i].channel_0 = (uint16_t)(((uint32_t)rgb[0] * LED_EFFECT_PWM_TOP) / LED_LEVEL_MAX);
+		p_values[i].channel_1 = (uint16_t)(((uint32_t)rgb[1] * LED_EFFECT_PWM_TOP) / LED_LEVEL_MAX);
+		p_values[i].channel_2 = (uint16_t)(((uint32_t)rgb[2] * LED_EFFECT_PWM_TOP) / LED_LEVEL_MAX);
+		p_values[i].channel_3 = 0;
+		if(is_more){
+			led_effect_step++;
+		}
+	}
+	return is_more;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Function Implementations for LED Effect Operations */
+
 /** @Func Register one specified LED effect */
 void ledEffectRegister(led_effect_t effect)
 {
@@ -194,30 +221,16 @@ void ledEffectRegister(led_effect_t effect)
 			return;
 		}
 		
-		// First PWM effect
+		// PWM effects
 		case LED_EFFECT_FIRST:
-		{
-			// Set up the PWM configuration structures
-			pwmConfig(clk_led_eff_1_r,top_val_led_eff_1_r,seq_data_led_eff_1_r,seq_len_led_eff_1_r,leds_rgb_list[0],'r');
-			pwmConfig(clk_led_eff_1_g,top_val_led_eff_1_g,seq_data_led_eff_1_g,seq_len_led_eff_1_g,leds_rgb_list[1],'g');
-			pwmConfig(clk_led_eff_1_b,top_val_led_eff_1_b,seq_data_led_eff_1_b,seq_len_led_eff_1_b,leds_rgb_list[2],'b');	
-			
-			// Set the flag to notify that this is a PWM effect
-			is_pwm_effect			 = true;
-			
-			// Store Current LED Effect
-			current_led_effect = effect;
-			
-			return;
-		}
-		
-		// Second PWM effect
 		case LED_EFFECT_SECOND:
+		case LED_EFFECT_RAINBOW:
 		{
-			// Set up the PWM configuration structures
-			pwmConfig(clk_led_eff_2_r,top_val_led_eff_2_r,seq_data_led_eff_2_r,seq_len_led_eff_2_r,leds_rgb_list[0],'r');
-			pwmConfig(clk_led_eff_2_g,top_val_led_eff_2_g,seq_data_led_eff_2_g,seq_len_led_eff_2_g,leds_rgb_list[1],'g');
-			pwmConfig(clk_led_eff_2_b,top_val_led_eff_2_b,seq_data_led_eff_2_b,seq_len_led_eff_2_b,leds_rgb_list[2],'b');
+			// Set up the PWM configuration structure of the RGB channels
+			pwmConfig(LED_EFFECT_PWM_CLK,LED_EFFECT_PWM_TOP,led_effect_seq[0],LED_EFFECT_CHUNK_LEN,leds_rgb_list[0],leds_rgb_list[1],leds_rgb_list[2]);
+			
+			// Select the description to render
+			p_led_effect_desc  = &led_effect_descs[effect - LED_EFFECT_FIRST];
 			
 			// Set the flag to notify that this is a PWM effect
 			is_pwm_effect			 = true;
@@ -306,25 +319,15 @@ void ledEffectRun(void)
 			return;
 		}
 		
-		// Run the first LED effect
+		// Run the PWM effects
 		case LED_EFFECT_FIRST:
-		{
-			// Run the PWM effect
-			pwmRun('r',PWM_RUN_MODE_FINITE_LOOP,2);
-			pwmRun('g',PWM_RUN_MODE_FINITE_LOOP,2);
-			pwmRun('b',PWM_RUN_MODE_FINITE_LOOP,2);
-			// Set the LED effect running flag
-			is_led_effect_running	= true;
-			return;
-		}
-		
-		// Run the second LED effect
 		case LED_EFFECT_SECOND:
+		case LED_EFFECT_RAINBOW:
 		{
-			// Run the PWM effect				
-			pwmRun('r',PWM_RUN_MODE_FINITE_LOOP,3);
-			pwmRun('g',PWM_RUN_MODE_FINITE_LOOP,3);
-			pwmRun('b',PWM_RUN_MODE_FINITE_LOOP,3);		
+			// Render from the start of the effect
+			led_effect_step = 0;
+			// Run the PWM effect
+			pwmRunStream(led_effect_seq[0],led_effect_seq[1],LED_EFFECT_CHUNK_LEN,led_effect_refill);
 			// Set the LED effect running flag
 			is_led_effect_running	= true;
 			return;
@@ -343,9 +346,7 @@ void ledEffectStop(void)
 	}
 	
 	if(is_pwm_effect){//PWM LED effect
-		pwmStop('r',PWM_STOP_MODE_RESTORE,LEDS_ACTIVE_STATE);
-		pwmStop('g',PWM_STOP_MODE_RESTORE,LEDS_ACTIVE_STATE);
-		pwmStop('b',PWM_STOP_MODE_RESTORE,LEDS_ACTIVE_STATE);
+		pwmStop(PWM_STOP_MODE_RESTORE,LEDS_ACTIVE_STATE);
 		// Clear the LED effect running flag
 		is_led_effect_running = false;
 	}
@@ -368,9 +369,7 @@ void ledEffectClear(void)
 	}
 		
 	if(is_pwm_effect){//PWM LED effect
-		pwmStop('r',PWM_STOP_MODE_TURNOFF,LEDS_ACTIVE_STATE);
-		pwmStop('g',PWM_STOP_MODE_TURNOFF,LEDS_ACTIVE_STATE);
-		pwmStop('b',PWM_STOP_MODE_TURNOFF,LEDS_ACTIVE_STATE);
+		pwmStop(PWM_STOP_MODE_TURNOFF,LEDS_ACTIVE_STATE);
 		// Clear the LED effect running flag
 		is_led_effect_running = false;
 	}
@@ -9,11 +9,18 @@
  * @Req 		- PWM Driver Module 											(Configured in sdk_config.h)
  * @Req			- Board IO Interface Definition Module		(Defined in "board_select.h")
  *
- * @Type 		- led_effect_t											(LED Effect Data Type)
+ * @Macro		- LED_EFFECT_STEP_MS								(Duration of one rendered step)
+ * @Macro		- LED_EFFECT_PWM_TOP								(PWM top value, one period per step)
+ * @Macro		- LED_EFFECT_CHUNK_LEN							(Steps rendered per half of the double buffer)
+ * @Macro		- LED_LEVEL_MAX											(Full scale of a keyframe value)
  *
- * @Func		- ledEffectFillSeq									(Fill in the PWM sequence of a pre-defined effect)
+ * @Type 		- led_effect_t											(LED Effect Data Type)
+ * @Type 		- led_ease_t												(Keyframe Easing Curve Type)
+ * @Type 		- led_space_t												(Keyframe Colour Space Type)
+ * @Type 		- led_keyframe_t										(Keyframe Data Type)
+ * @Type 		- led_effect_desc_t									(Procedural LED Effect Description Type)
  *
- * @Func		- ledEffectRegister									(Register the PWM instance of one channel)
+ * @Func		- ledEffectRegister									(Register the PWM instance of the RGB channels)
  * @Func		- ledEffectRun											(Run a pre-defined LED effect)
  * @Func		- ledEffectStop											(Stop a pre-defined effect and restore the pin to its initial state)
  * @Func		-	ledEffectClear										(Clear any currently running LED effect)
@@ -45,10 +52,24 @@
 extern "C" {
 #endif
 	
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Macro Definitions for the Procedural LED Effects */
+
+/** @Macro Define the duration of one rendered step (one PWM period with a 1MHz clock) */
+#define LED_EFFECT_STEP_MS			10
+#define LED_EFFECT_PWM_CLK			NRF_PWM_CLK_1MHz
+#define LED_EFFECT_PWM_TOP			(LED_EFFECT_STEP_MS * 1000)
+
+/** @Macro Define the number of RGB steps rendered into each half of the interleaved double buffer (160ms of effect per refill) */
+#define LED_EFFECT_CHUNK_LEN		16
+
+/** @Macro Define the full scale of a keyframe value (R/G/B, or H/S/V) */
+#define LED_LEVEL_MAX						255
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /* Internal Variable Type Declarations */
 	
-/** @Type Declare LED Effect Data Type */
+/** @Type Declare LED Effect Data Type (PWM effects start from LED_EFFECT_FIRST, in the order of their descriptions in "app_led_effects.c") */
 	
 typedef enum
 {
@@ -59,29 +80,54 @@ typedef enum
 	LED_EFFECT_RGB_ON,						// All RGB LEDs are On
 	LED_EFFECT_RGB_OFF,						// All RGB LEDs are Off
 	LED_EFFECT_FIRST,							// First LED Effect
-	LED_EFFECT_SECOND							// Second LED Effect
+	LED_EFFECT_SECOND,						// Second LED Effect
+	LED_EFFECT_RAINBOW,						// Hue Cycle (Runs until stopped)
+	LED_EFFECT_NUM								// The number of LED effects (not an effect)
 }led_effect_t;
 
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** @Type Declare the easing curve from the previous keyframe to a keyframe */
+typedef enum
+{
+	LED_EASE_STEP = 0,						// Hold the previous value, jump at the keyframe
+	LED_EASE_LINEAR,							// Constant speed
+	LED_EASE_IN,									// Slow start (quadratic)
+	LED_EASE_OUT,									// Slow end (quadratic)
+	LED_EASE_IN_OUT								// Slow start and end (smoothstep)
+}led_ease_t;
+
+/** @Type Declare the colour space of the keyframe values */
+typedef enum
+{
+	LED_SPACE_RGB = 0,						// value[] holds the red, green and blue levels
+	LED_SPACE_HSV									// value[] holds the hue, saturation and value (converted to RGB per step)
+}led_space_t;
 
-/* Function Declarations for LED Effect Operations */
+/** @Type Declare the keyframe data type */
+typedef struct
+{
+	uint16_t		time_ms;					// Time of the keyframe since the start of the loop
+	uint8_t			value[3];					// Values reached at this keyframe (0 ~ LED_LEVEL_MAX)
+	led_ease_t	ease[3];					// Easing curve of each channel from the previous keyframe
+}led_keyframe_t;
 
-/** @Func Fill in the PWM sequence of a pre-defined effect
-	*	
-	*	@Brief This function fills in the PWM sequence of the specified effect
-	* @Brief The data arrays to store the sequences should be defined in "app_led_effects.c"
-	*
-	* @Para effect [led_effect_t]: The specified LED effect
-	*
-*/
-void ledEffectFillSeq(led_effect_t effect);
+/** @Type Declare the procedural LED effect description (keys must start at 0ms, increase in time, and number at least 2) */
+typedef struct
+{
+	const led_keyframe_t *	p_keys;	// The keyframes of one loop
+	uint8_t									key_num;// The number of keyframes
+	led_space_t							space;	// The colour space of the keyframe values
+	uint8_t									loops;	// The number of loops (0 runs until stopped)
+}led_effect_desc_t;
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations for LED Effect Operations */
 
-/** @Func Register the PWM instance of one channel
+/** @Func Register the PWM instance of the RGB channels
   * 
 	* @Brief This function registers the specified LED effect
-	*	@Brief This function sets up the configuration structures of the three PWM instances
-	* @Brief This function initializes the three PWM instances which can be controlled independently
+	*	@Brief This function sets up the configuration structure of the PWM instance shared by the three RGB channels
+	* @Brief For PWM LED effects, the effect is rendered from its keyframes while running, so nothing is filled in advance
 	* @Brief For non-PWM LED effects, this function configures the relevant pins as outputs
 	*
 	*	@Para  effect [led_effect_t]: The specified LED effect
@@ -93,13 +139,10 @@ void ledEffectRegister(led_effect_t effect);
 /** @Func Run a pre-defined LED effect
 	*
 	*	@Brief This function runs the registered LED effect
-	* @Brief For PWM LED effects, this function runs the pwm sequence
-	* @Brief The PWM sequence running mode should be designated in this function
-	* @Brief For different LED effects, not only the PWM sequences filled are different,
-	* @Brief but the running mode should also be specified in this function
+	* @Brief For PWM LED effects, this function starts rendering the keyframes into the double-buffered PWM sequences
 	*	@Brief For non-PWM effects, this function turns on/off relevant LEDs
 	*	
-	* @Brief For all new LED effects, this function should be modified
+	* @Brief New PWM effects only need a keyframe table and a description in "app_led_effects.c"
 	*
 */
 void ledEffectRun(void);
@@ -127,7 +170,7 @@ void ledEffectClear(void);
 /** @Func Release the allocated PWM instance
 	*
 	*	@Brief This function unregisters the current LED effect
-	* @Brief For PWM LED effect, this function destroys the three PWM instances.
+	* @Brief For PWM LED effect, this function releases the PWM instance.
 	* @Brief For non-PWM LED effect, this function does nothing.
 	*
 */
@@ -1,27 +1,31 @@
 /** Library Name: "drv_pwm.h" 
  * @Brief 	This library declares functions for low-level pwm drivers
+ * @Brief 	The RGB LEDs share one PWM instance (three of its four channels), loaded individually from one interleaved sequence
  *
  * @Auther 	Feng Yuan
  * @Time 		25/08/2017
  * @Version	1.0
  *
  * @Req 		This library requires the following modules to function
- * @Req 		- PWM Driver SDK Module 											(Configured in sdk_config.h)
+ * @Req 		- PWM Driver SDK Module 											(Configured in sdk_config.h, the instance selected by PWM_RGB_INSTANCE)
  * @Req			- GPIO Driver SDK Module											(Configured in sdk_config.h)
  * @Req			- APP Utility SDK Module 											(Defined in app_util_platform.c)
  *
- * @Type 		- pwm_instance_rgb_t													(PWM Instance Type)
- * @Type		-	pwm_sequence_rgb_t													(PWM Sequence Type)
- * @Type		-	pwm_config_rgb_t														(PWM Configuration Structure Type)
+ * @Macro		- PWM_RGB_INSTANCE														(PWM Instance Driving the RGB LEDs)
+ * @Macro		- PWM_RGB_STEP_VALUES													(Number of Duty Cycle Values in One Interleaved Step)
+ *
  * @Type		- pwm_pin_val_rgb_t														(PWM Pin Value Storage Type)
- * @Type		- pwm_status_flags_rgb_t											(PWM Running Status Flag Type)
  * @Type		- pwm_run_mode_t															(PWM Running Mode Type)
  * @Type		- pwm_stop_mode_t															(PWM Stom Mode Type)
+ * @Type		- pwm_refill_handler_t												(PWM Sequence Refill Handler Type)
+ * @Type		- pwm_stream_t																(PWM Double-buffered Stream Type)
  *
  * @Func		- pwmConfig																		(Set up the PWM configuration structure)
- * @Func		- pwmRun																			(Run the PWM sequence on one channel)
+ * @Func		- pwmRun																			(Run the PWM sequence on the RGB channels)
  * @Func		- pwmUpdateSeq																(Update the PWM sequence on an existing instance)
+ * @Func		- pwmRunStream																(Run a double-buffered PWM sequence refilled on the fly)
  * @Func		-	pwmStop																			(Stop PWM sequence)
+ * @Func		-	pwmIsRunning																(Get PWM status)
  *
 */
 
@@ -48,32 +52,16 @@ extern "C" {
 #endif
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/* Declare the Basic Data Types */
-	
-/** @Type Declare the data type to store PWM instances */
+/* Macro Definitions */
 
-typedef struct
-{
-	nrf_drv_pwm_t pwm_inst_red;
-	nrf_drv_pwm_t pwm_inst_green;
-	nrf_drv_pwm_t	pwm_inst_blue;
-}pwm_instance_rgb_t;
+/** @Macro Define the PWM instance driving the RGB LEDs (PWM1 and PWM2 are left free for other uses) */
+#define PWM_RGB_INSTANCE					0
 
-/** @Type Declare the data type to store the PWM sequences */
-typedef struct
-{
-	nrf_pwm_sequence_t pwm_seq_red;
-	nrf_pwm_sequence_t pwm_seq_green;
-	nrf_pwm_sequence_t pwm_seq_blue;
-}pwm_sequence_rgb_t;
+/** @Macro Define the number of duty cycle values in one step of the interleaved sequence (red, green, blue, unused) */
+#define PWM_RGB_STEP_VALUES				(sizeof(nrf_pwm_values_individual_t) / sizeof(uint16_t))
 
-/** @Type Declare the data type to store the PWM configuration structures */
-typedef struct
-{
-	nrf_drv_pwm_config_t pwm_config_red;
-	nrf_drv_pwm_config_t pwm_config_green;
-	nrf_drv_pwm_config_t pwm_config_blue;
-}pwm_config_rgb_t;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/* Declare the Basic Data Types */
 
 /** @Type Declare the data type to store/restore the pin values */
 typedef struct
@@ -83,14 +71,6 @@ typedef struct
 	uint32_t pwm_pin_val_blue;
 }pwm_pin_val_rgb_t;
 
-/** @Type Declare the data type to store the PWM runing status flags */
-typedef struct
-{
-	uint8_t pwm_running_flag_red;
-	uint8_t pwm_running_flag_green;
-	uint8_t pwm_running_flag_blue;
-}pwm_status_flags_rgb_t;
-
 /** @Type Declare the data type to represent the PWM sequence running mode (finite loop or infinite loop) */
 typedef enum
 {
@@ -98,78 +78,109 @@ typedef enum
 	PWM_RUN_MODE_INFINITE_LOOP
 }pwm_run_mode_t;
 
-/** @Type Declare the data type to represent the PWM sequence stop mode(stop,restore previous LED state or stop,turn off the LED)*/
+/** @Type Declare the data type to represent the PWM stopping mode (turn off all the LEDs or restore the previous LED states) */
 typedef enum
 {
 	PWM_STOP_MODE_TURNOFF	=	0,
 	PWM_STOP_MODE_RESTORE
 }pwm_stop_mode_t;
 
+/** @Type Declare the function pointer type to render the next steps into a played half of a stream (PWM interrupt context)
+	*
+	* @Brief channel_0, channel_1 and channel_2 of each step hold the red, green and blue duty cycles
+	*
+	* @Return true if more steps follow, false if these are the last steps (The stream stops after they are played)
+	*
+*/
+typedef bool (* pwm_refill_handler_t)(nrf_pwm_values_individual_t * p_values, const uint16_t length);
+
+/** @Type Declare the data type to store the double-buffered stream */
+typedef struct
+{
+	nrf_pwm_sequence_t		pwm_seq[2];							// The two halves, played one after the other
+	pwm_refill_handler_t	pwm_refill_handler;			// Renders the next steps into the half just played
+	bool									is_last_rendered;				// The last steps are in one of the halves
+	uint8_t								played_after_last;			// The number of halves played since then
+}pwm_stream_t;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/* PWM Driver Functions */
 
-/** @Func Setup the Duty Cycle Sequence in One Channel
+/* PWM Driver Function Declarations */
+
+/** @Func Set up the PWM Configuration Structures
 	*
-	* @Brief This function is used to setup the PWM configuration structures and the sequences in each channel
+	* @Brief This function is used to setup the PWM configuration structure and the interleaved sequence of the RGB channels
 	* 
-	* @Para clk 				[nrf_pwm_clk_t clk]: 	The basic clock frequency of the PWM module
-	* @Para cycle_top		[uint16_t]:						The top value in each duty cycle
-	*																					(this value together with the clock frquency determines the pulse width for each pwm wave)
-	* @Para seq_data   	[uint16_t*]: 					The pointer to the data sequence of the PWM wave in the designated channel
-	* @Para seq_length  [uint16_t]:						The length of the data sequence for the designated channel
-	* @Para pin					[uint8_t]: 						The output pin number of the PWM channel
-	* @Para channel 		[char]: 							The selection of one of the RGB channels (must be 'r','g','b',or 'R','G','B')
+	* @Para clk 				[nrf_pwm_clk_t clk]: 						The basic clock frequency of the PWM module
+	* @Para cycle_top		[uint16_t]:											The top value in each duty cycle
+	*																										(this value together with the clock frquency determines the pulse width for each pwm wave)
+	* @Para seq_data   	[nrf_pwm_values_individual_t*]: The pointer to the interleaved data sequence (red, green, blue and one unused value per step)
+	* @Para seq_length  [uint16_t]:											The number of steps in the data sequence
+	* @Para pin_red			[uint8_t]: 											The output pin number of the red channel
+	* @Para pin_green		[uint8_t]: 											The output pin number of the green channel
+	* @Para pin_blue		[uint8_t]: 											The output pin number of the blue channel
 	*
 */
-void pwmConfig(const nrf_pwm_clk_t clk, const uint16_t cycle_top, const uint16_t * const seq_data, const uint16_t seq_length, const uint8_t pin, const char channel);
+void pwmConfig(const nrf_pwm_clk_t clk, const uint16_t cycle_top, const nrf_pwm_values_individual_t * const seq_data, const uint16_t seq_length, const uint8_t pin_red, const uint8_t pin_green, const uint8_t pin_blue);
 
 
-/** @Func Run the Sequence in One Channel
+/** @Func Run the Sequence on the RGB Channels
 	*
-	* @Brief This function is used to initialize the PWM peripheral for the designated channel
+	* @Brief This function is used to initialize the PWM peripheral and play the sequence on all three channels in phase
 	* 
-	* @Para channel			[char]:								The selection of one of the RGB channels (must be 'r','g','b',or 'R','G','B')
 	* @Para run_mode		[pwm_run_mode_t]:			The PWM sequence running mode (PWM_RUN_MODE_FINITE_LOOP,PWM_RUN_MODE_INFINITE_LOOP)
 	* @Para loop_times	[uint16_t]:						The total number of loops to be executed when running the sequence
 	*
 */
-void pwmRun(const char channel, const pwm_run_mode_t run_mode, const uint16_t loop_times);
+void pwmRun(const pwm_run_mode_t run_mode, const uint16_t loop_times);
 
 
-/** @Func Update the Data Sequence of One Channel
+/** @Func Update the Data Sequence
 	*
-	* @Brief This function is used to update the sequence of one channel
+	* @Brief This function is used to update the interleaved sequence of the RGB channels
 	*
-	* @Para seq_data   	[uint16_t*]:					The pointer to the data sequence of the PWM wave in the designated channel
-	* @Para seq_length  [uint16_t]:						The length of the data sequence for the designated channel
-	* @Para channel 		[char]:								The selection of one of the RGB channels (must be 'r','g','b',or 'R','G','B')
+	* @Para seq_data   	[nrf_pwm_values_individual_t*]:	The pointer to the interleaved data sequence
+	* @Para seq_length  [uint16_t]:											The number of steps in the data sequence
 	*
 */
-void pwmUpdateSeq(const uint16_t * const seq_data, const uint16_t seq_length, const char channel);
+void pwmUpdateSeq(const nrf_pwm_values_individual_t * const seq_data, const uint16_t seq_length);
 
 
-/** @Func Stop the Sequence in One Channel
+/** @Func Run a Double-buffered Sequence on the RGB Channels
 	*
-	* @Brief This function is used to stop the PWM periperal for the designated channel
+	* @Brief This function renders both halves with the refill handler and plays them in a loop (complex playback)
+	* @Brief At the end of each half, the handler renders the next steps into it while the other half is played,
+	* @Brief so an effect of any length only needs the RAM of the two halves
+	* @Brief The configuration must have been set up by pwmConfig. The stream is stopped by pwmStop, or by itself after the last steps.
+	*
+	* @Para seq_data_0			[nrf_pwm_values_individual_t*]:	The first half (in RAM, not on the stack)
+	* @Para seq_data_1			[nrf_pwm_values_individual_t*]:	The second half (in RAM, not on the stack)
+	* @Para seq_length			[uint16_t]:											The number of steps in each half
+	* @Para refill_handler	[pwm_refill_handler_t]:					The handler rendering the steps
+	*
+*/
+void pwmRunStream(nrf_pwm_values_individual_t * const seq_data_0, nrf_pwm_values_individual_t * const seq_data_1, const uint16_t seq_length, const pwm_refill_handler_t refill_handler);
+
+
+/** @Func Stop the Sequence
+	*
+	* @Brief This function is used to stop the PWM periperal driving the RGB channels
 	* @Brief This function also releases the PWM resource
 	* 
-	* @Para  channel		[char]: 							The selection of one of the RGB channels (must be 'r','g','b',or 'R','G','B')
-	* @Para  mode				[uint8_t]:						PWM_STOP_MODE_TURNOFF is for turning off the LED after stopping the PWM, 
-	*																					and PWM_STOP_MODE_RESTORE is for restoring the LED previous state after stopping the PWM
-	*	@Para  led_active_state [bool]:					The active state of the LED(true for active high, false for active low)
+	* @Para  mode				[uint8_t]:						PWM_STOP_MODE_TURNOFF is for turning off the LEDs after stopping the PWM, 
+	*																					and PWM_STOP_MODE_RESTORE is for restoring the LEDs previous states after stopping the PWM
+	*	@Para  led_active_state [bool]:					The active state of the LEDs(true for active high, false for active low)
 	*
 */
-void pwmStop(const char channel, const pwm_stop_mode_t mode, const bool led_active_state);
+void pwmStop(const pwm_stop_mode_t mode, const bool led_active_state);
 
 
 /** @Func Get PWM Status
 	*
-	* @Brief This function is used to check whether a PWM channel is running
-	*
-	* @Para  channel		[char]: 							The selection of one of the RGB channels (must be 'r','g','b',or 'R','G','B')
+	* @Brief This function is used to check whether the RGB channels are running
 	*
 */
-bool pwmIsRunning(const char channel);
+bool pwmIsRunning(void);
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -34,6 +34,23 @@ static sensor_led_current_t	sensor_led_current =
 	.led_blue_current = BLUE_CURRENT
 };
 
+/** @Variable The Exposure Settings (Loaded from the SET_DATA_SENR_* Records and Adjusted by the Auto-exposure Controller) */
+static sensor_exposure_t sensor_exposure =
+{
+	.gain						= SENSOR_CTRL_GAIN_SELECT_LOW,
+	.int_mode				= SENSOR_CTRL_INT_MODE_MANUAL_SETTING,
+	.int_time				= INTEGRATION_TIME,
+	.manual_timing	= MANUAL_TIMING
+};
+
+/** @Variable The Length of One Integration Time Unit (in microsecond) Indexed by the Integration Time Setting */
+static const uint32_t sensor_int_time_unit_us[4] = {32, 1000, 16000, 131000};
+
+/** @Variable The Auto-exposure Flags */
+static bool is_sensor_ae_enabled 		= false;	// The controller adjusts the settings after every sample
+static bool is_sensor_ae_stable 		= true;		// The last update did not change the settings
+static bool is_sensor_settings_dirty = false;	// The settings have changed since they were loaded or saved
+
 /** @Variable The Temporary Data Structure to Store the Byte Array MetaData */
 static sensor_data_t sensor_data = 
 {
@@ -50,37 +67,144 @@ static sensor_led_flags_t sensor_led_status =
 	.is_led_blue_on 	= false
 };
 
+/** @Variable The LED Charge Accounting (Turn-on Time and Current of Each LED, Charge Drawn Since the Boot) */
+static uint32_t sensor_led_on_ticks[3];
+static uint32_t sensor_led_on_current_ua[3];
+static uint32_t sensor_led_charge_uc 		= 0;		// In microcoulomb (wraps around)
+static uint32_t sensor_led_charge_rem 	= 0;		// The part below one microcoulomb (in microampere x millisecond)
+
+/** @Variable The Upper Limit of the LED Current Levels (Lowered by the Application on A Weak Battery) */
+static uint8_t sensor_led_level_limit 	= SENSOR_AE_LED_LEVEL_MAX;
+
+/** @Variable The Oversampling Settings */
+static uint8_t 					sensor_oversample_count		= SENSOR_OVERSAMPLE_DEFAULT;
+static sensor_reduce_t 	sensor_reduce_method 			= SENSOR_REDUCE_MEDIAN;
+
+/** @Variable The Exposures of the Channel Being Sampled */
+static uint8_t sensor_oversample_buffer[SENSOR_OVERSAMPLE_MAX][SENSOR_CHANNEL_FULL_DATA_SIZE];
+
+/** @Variable The Quality Score of the Last Sample */
+static uint8_t sensor_sample_quality = SENSOR_QUALITY_MAX;
+
+/** @Variable The Die Temperature Tag of the Last Sample (0.25 degC Units) */
+static int16_t sensor_sample_temperature = SENSOR_TEMPERATURE_INVALID;
+
+/** @Variable The Sampling Mode (Which Channels are Exposed and How Many Data Bytes are Read per Exposure) */
+static sensor_sample_mode_t sensor_sample_mode = SENSOR_SAMPLE_MODE_RGB;
+
+/** @Variable The Context of the Non-blocking Color Sampling State Machine */
+static volatile sensor_sample_context_t sensor_sample =
+{
+	.state					= SENSOR_STATE_IDLE,
+	.mode						= SENSOR_SAMPLE_MODE_RGB,
+	.channel				= RED,
+	.array					= NULL,
+	.length					= 0,
+	.ready_handler	= NULL
+};
+
+/** @Variable The Transaction Used by the Sampling State Machine (Must Stay Valid Until the Transaction is Finished) */
+static sensor_transaction_t sensor_sample_transaction;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Function Implementations (Internal Functions) */
 
-/** @Func RTC Event Handler */
-static void sensor_rtc_event_handler(nrf_drv_rtc_int_type_t int_type)
+/** @Func Work Out the Integration Time (in microsecond) of One Channel */
+static uint32_t sensor_exposure_us(void)
 {
-	if(int_type == NRF_DRV_RTC_INT_COMPARE0){
-		// Stop the RTC
-		nrf_drv_rtc_counter_clear(&rtc_obj);
-		nrf_drv_rtc_disable(&rtc_obj);
-		
-		// Read the Acquired Data	
-		APP_ERROR_CHECK(sensorReadByteArray(sensor_data.array, sensor_data.length, sensor_data.reg_name));
+	uint32_t units = (sensor_exposure.int_mode == SENSOR_CTRL_INT_MODE_MANUAL_SETTING) ? sensor_exposure.manual_timing : 1;
+	return sensor_int_time_unit_us[sensor_exposure.int_time & 0x03] * units;
+}
+
+/** @Func Work Out the Waiting Time (in millisecond) of One Integration */
+static uint32_t sensor_wait_time_ms(void)
+{
+	// Four channels are integrated in sequence, plus the post sample margin (Rounded up)
+	uint32_t units = (sensor_exposure.int_mode == SENSOR_CTRL_INT_MODE_MANUAL_SETTING) ? sensor_exposure.manual_timing : 1;
+	uint64_t wait_us_x100 = (uint64_t)sensor_int_time_unit_us[sensor_exposure.int_time & 0x03] * units * 4 * POST_SAMPLE_WAIT_TIME_MARGIN_PERCENT;
+	return (uint32_t)((wait_us_x100 + 99999) / 100000);
+}
+
+/** @Func Control Register Values of the Current Exposure Settings */
+static uint8_t sensor_ctrl_setup(void)
+{
+	return SENSOR_CTRL_RESET_OPERATION|SENSOR_CTRL_REG_RESET_03_TO_0A|sensor_exposure.gain|sensor_exposure.int_mode;
+}
 
-		// Put the Sensor into Sleep
-		APP_ERROR_CHECK(sensorSleep());
+static uint8_t sensor_ctrl_start(void)
+{
+	return SENSOR_CTRL_RESET_OPERATION|SENSOR_CTRL_SLEEP_OPERATION|SENSOR_CTRL_REG_RESET_RESET_RELEASE \
+				|sensor_exposure.gain|sensor_exposure.int_mode|sensor_exposure.int_time;
+}
+
+static uint8_t sensor_ctrl_sleep(void)
+{
+	return SENSOR_CTRL_SLEEP_SLEEP|sensor_exposure.gain|sensor_exposure.int_mode;
+}
+
+/** @Func Append the Timing Setup and the Sampling Command of the Current Exposure Settings to the Sensor Transaction */
+static uint8_t sensor_transaction_add_exposure(sensor_transaction_t * p_trans)
+{
+	uint8_t err_code;
+	uint8_t setup[3] = {sensor_ctrl_setup(), (sensor_exposure.manual_timing >> 8) & 0xff, sensor_exposure.manual_timing & 0xff};
+	uint8_t start = sensor_ctrl_start();
 	
-		// Turn off LEDs
-		if(sensor_led_status.is_led_red_on){//If LED Red is on, then turn it off
-			sensorTurnOffLed(RED);
-		}
-		if(sensor_led_status.is_led_green_on){//If LED Green is on, then turn it off
-			sensorTurnOffLed(GREEN);
-		}
-		if(sensor_led_status.is_led_blue_on){//If LED Blue is on, then turn it off
-			sensorTurnOffLed(BLUE);
-		}
+	if((err_code = sensorTransactionAddWrite(p_trans, SENSOR_REG_CONTROL, setup, 3)) != NRF_SUCCESS){return err_code;}
+	return sensorTransactionAddWrite(p_trans, SENSOR_REG_CONTROL, &start, 1);
+}
+
+/** @Func Get the LED Current Level (0 ~ 15) of A Specified LED */
+static uint8_t sensor_led_level_get(const led_type_t led_type)
+{
+	switch(led_type){
+		case RED:
+			return sensor_led_current.led_red_current & 0x0f;
+		case GREEN:
+			return (sensor_led_current.led_green_current >> 4) & 0x0f;
+		default:
+			return sensor_led_current.led_blue_current & 0x0f;
+	}
+}
+
+/** @Func Set the LED Current Level (0 ~ 15) of A Specified LED */
+static void sensor_led_level_set(const led_type_t led_type, const uint8_t level)
+{
+	switch(led_type){
+		case RED:
+			sensor_led_current.led_red_current = level & 0x0f;
+			break;
+		case GREEN:
+			sensor_led_current.led_green_current = (level & 0x0f) << 4;
+			break;
+		default:
+			sensor_led_current.led_blue_current = level & 0x0f;
+			break;
 	}
 }
 
+/** @Func Set the Exposure Settings from an Integration Time (in microsecond) */
+static void sensor_exposure_us_set(uint32_t exposure_us)
+{
+	// Use the shortest integration time unit whose manual timing count fits into the 16-bit register
+	uint8_t int_time = SENSOR_CTRL_INT_TIME_SETTING_32US;
+	while(int_time < SENSOR_CTRL_INT_TIME_SETTING_131MS && exposure_us / sensor_int_time_unit_us[int_time] > 0xffff){
+		int_time++;
+	}
+	
+	uint32_t units = exposure_us / sensor_int_time_unit_us[int_time];
+	sensor_exposure.int_mode 			= SENSOR_CTRL_INT_MODE_MANUAL_SETTING;
+	sensor_exposure.int_time 			= int_time;
+	sensor_exposure.manual_timing = (units == 0) ? 1 : ((units > 0xffff) ? 0xffff : units);
+}
+
+/** @Func Read One 16-bit Data Word (High Byte First) */
+static uint16_t sensor_data_word(uint8_t const * p_data, const uint8_t word_index)
+{
+	return (uint16_t)((p_data[2 * word_index] << 8) | p_data[2 * word_index + 1]);
+}
+
+#ifndef SENSOR_HOST_SIMULATION
 /** @Func Start the RTC2 Timer to Delay Specified Time(in milliseccond) */
 static void sensor_delay_ms(uint32_t delay_time_ms)
 {
@@ -91,6 +215,380 @@ static void sensor_delay_ms(uint32_t delay_time_ms)
   nrf_drv_rtc_enable(&rtc_obj);
 }
 
+/** @Func Stop the RTC2 Timer after the Compare Event */
+static void sensor_delay_stop(void)
+{
+	nrf_drv_rtc_counter_clear(&rtc_obj);
+	nrf_drv_rtc_disable(&rtc_obj);
+}
+#else
+/** @Func Start and Stop the Delay of the Host Simulation (Simulation/sim_sensor.c Raises the RTC Compare Event) */
+void sensor_delay_ms(uint32_t delay_time_ms);
+void sensor_delay_stop(void);
+#endif
+
+/** @Func Get the LED Current Level (0 ~ 15) Driven for A Specified LED (Below the Upper Limit) */
+static uint8_t sensor_led_level_drive(const led_type_t led_type)
+{
+	uint8_t level = sensor_led_level_get(led_type);
+	return (level > sensor_led_level_limit) ? sensor_led_level_limit : level;
+}
+
+/** @Func Fill the LED Current and LED Command Bytes for A Specified LED */
+static uint8_t sensor_led_commands(const led_type_t led_type, uint8_t * current, uint8_t * command)
+{
+	// Set the Common Register Address of the Color Sensor
+	current[0] = SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1;
+	command[0] = SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1;
+	
+	switch (led_type){
+		case RED:
+			current[1] = LED_OFF_COMMAND|sensor_led_level_drive(RED);
+			current[2] = SENSOR_LED_GREEN_CURRENT_0MA|SENSOR_LED_BLUE_CURRENT_0MA;
+			command[1] = LED_ON_COMMAND|sensor_led_level_drive(RED);
+			return NRF_SUCCESS;
+		case GREEN:
+			current[1] = LED_OFF_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
+			current[2] = (sensor_led_level_drive(GREEN) << 4)|SENSOR_LED_BLUE_CURRENT_0MA;
+			command[1] = LED_ON_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
+			return NRF_SUCCESS;
+		case BLUE:
+			current[1] = LED_OFF_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
+			current[2] = SENSOR_LED_GREEN_CURRENT_0MA|sensor_led_level_drive(BLUE);
+			command[1] = LED_ON_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
+			return NRF_SUCCESS;
+		default:
+			return NRF_ERROR_INVALID_PARAM;
+	}
+}
+
+/** @Func Work Out the Number of Data Bytes Read per Exposure in the Specified Sampling Mode */
+static uint8_t sensor_channel_data_size(const sensor_sample_mode_t mode)
+{
+	return (mode == SENSOR_SAMPLE_MODE_RGB) ? SENSOR_CHANNEL_DATA_SIZE : SENSOR_CHANNEL_FULL_DATA_SIZE;
+}
+
+/** @Func Account the Charge Drawn by A Specified LED (Turned On: Start the Time, Turned Off: Add Time x Current) */
+static void sensor_led_charge_account(const led_type_t led_type, bool is_on)
+{
+	uint32_t ticks;
+	uint32_t on_ms;
+	uint32_t current_ua;
+	
+	if(is_on){
+		sensor_led_on_ticks[led_type] 			= app_timer_cnt_get();
+		sensor_led_on_current_ua[led_type] 	= (uint32_t)sensor_led_level_drive(led_type) * SENSOR_LED_LEVEL_CURRENT_UA;
+		return;
+	}
+	
+	app_timer_cnt_diff_compute(app_timer_cnt_get(), sensor_led_on_ticks[led_type], &ticks);
+	on_ms 			= (ticks * 125 * (SENSOR_LED_TIMER_PRESCALER + 1)) / (APP_TIMER_CLOCK_FREQ / 8);		// 1000 / 32768 = 125 / 4096
+	current_ua 	= sensor_led_on_current_ua[led_type];
+	
+	// Split the current, so the product cannot overflow for a long exposure
+	CRITICAL_REGION_ENTER();
+	sensor_led_charge_rem 	+= on_ms * (current_ua % 1000);
+	sensor_led_charge_uc 		+= on_ms * (current_ua / 1000) + sensor_led_charge_rem / 1000;
+	sensor_led_charge_rem 	%= 1000;
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Set the On/Off Status of A Specified LED */
+static void sensor_led_status_set(const led_type_t led_type, bool is_on)
+{
+	bool * p_is_on;
+	
+	switch(led_type){
+		case RED:
+			p_is_on = &sensor_led_status.is_led_red_on;
+			break;
+		case GREEN:
+			p_is_on = &sensor_led_status.is_led_green_on;
+			break;
+		case BLUE:
+			p_is_on = &sensor_led_status.is_led_blue_on;
+			break;
+		default:
+			return;
+	}
+	
+	// Account the LED time on each change of the status
+	if(*p_is_on != is_on){
+		sensor_led_charge_account(led_type, is_on);
+	}
+	*p_is_on = is_on;
+}
+
+/** @Func Read the Die Temperature while the LEDs Integrate (Skipped if the SoftDevice is Not Enabled) */
+static void sensor_temperature_accumulate(void)
+{
+	int32_t temperature;
+	
+	if(sd_temp_get(&temperature) == NRF_SUCCESS){
+		sensor_sample.temperature_sum += temperature;
+		sensor_sample.temperature_count++;
+	}
+}
+
+/** @Func Tag the Sample with the Average Die Temperature of Its Exposures */
+static void sensor_temperature_commit(void)
+{
+	sensor_sample_temperature = (sensor_sample.temperature_count == 0) ? SENSOR_TEMPERATURE_INVALID \
+															: (int16_t)(sensor_sample.temperature_sum / sensor_sample.temperature_count);
+	sensor_sample.temperature_sum 	= 0;
+	sensor_sample.temperature_count = 0;
+}
+
+/** @Func Lower the Quality Score of the Sample */
+static void sensor_quality_lower(const uint8_t penalty)
+{
+	sensor_sample.quality = (sensor_sample.quality > penalty) ? (sensor_sample.quality - penalty) : 0;
+}
+
+/** @Func Account One Finished Exposure (Returns true if the Exposure Must be Retried) */
+static bool sensor_exposure_check(const sensor_sample_mode_t mode)
+{
+	uint8_t const * p_data = sensor_oversample_buffer[sensor_sample.exposure];
+	
+	// A lit exposure reading all zeros is a failed conversion (A dark frame may legally read zeros)
+	if(mode != SENSOR_SAMPLE_MODE_AMBIENT && sensor_data_word(p_data, 0) == 0 && sensor_data_word(p_data, 1) == 0 && sensor_data_word(p_data, 2) == 0){
+		if(sensor_sample.retry < SENSOR_EXPOSURE_MAX_RETRY){
+			sensor_sample.retry++;
+			sensor_quality_lower(SENSOR_QUALITY_RETRY_PENALTY);
+			return true;
+		}
+		sensor_quality_lower(SENSOR_QUALITY_ZERO_PENALTY);
+	}
+	
+	sensor_sample.exposure++;
+	return false;
+}
+
+/** @Func Combine the Exposures of the Current Channel Word by Word into the Sample Array */
+static void sensor_oversample_reduce(uint8_t * byte_array, const uint8_t size)
+{
+	uint8_t 	count 			= sensor_oversample_count;
+	uint32_t 	spread_max 	= 0;
+	bool			is_clip			= false;
+	
+	for(uint8_t word = 0; word < size / 2; word++){
+		uint16_t value[SENSOR_OVERSAMPLE_MAX];
+		uint32_t result;
+		
+		// Insertion Sort of the Exposures (At Most SENSOR_OVERSAMPLE_MAX Values)
+		for(uint8_t i = 0; i < count; i++){
+			uint16_t v = sensor_data_word(sensor_oversample_buffer[i], word);
+			uint8_t  j = i;
+			for(; j > 0 && value[j - 1] > v; j--){
+				value[j] = value[j - 1];
+			}
+			value[j] = v;
+		}
+		
+		if(sensor_reduce_method == SENSOR_REDUCE_MEDIAN){
+			result = (count & 0x01) ? value[count / 2] : ((uint32_t)value[count / 2 - 1] + value[count / 2] + 1) / 2;
+		}
+		else{
+			uint8_t  first 	= (count >= 3) ? 1 : 0;
+			uint8_t  last 	= (count >= 3) ? (count - 1) : count;
+			uint32_t sum 		= 0;
+			for(uint8_t i = first; i < last; i++){
+				sum += value[i];
+			}
+			result = (sum + (last - first) / 2) / (last - first);
+		}
+		
+		byte_array[2 * word] 			= (result >> 8) & 0xff;
+		byte_array[2 * word + 1] 	= result & 0xff;
+		
+		is_clip |= (value[count - 1] >= SENSOR_AE_SATURATION_LEVEL);
+		if(result > 0 && (value[count - 1] - value[0]) * 100 / result > spread_max){
+			spread_max = (value[count - 1] - value[0]) * 100 / result;
+		}
+	}
+	
+	if(is_clip){
+		sensor_quality_lower(SENSOR_QUALITY_SATURATION_PENALTY);
+	}
+	sensor_quality_lower((spread_max > SENSOR_QUALITY_SPREAD_PENALTY_MAX) ? SENSOR_QUALITY_SPREAD_PENALTY_MAX : spread_max);
+	
+	// Start Over for the Next Channel
+	sensor_sample.exposure 	= 0;
+	sensor_sample.retry 		= 0;
+}
+
+/** @Func Sample One Channel in Blocking Mode (All Exposures Including the Retries) */
+static uint8_t sensor_channel_sample_blocking(const sensor_sample_mode_t mode, const led_type_t channel, uint8_t * byte_array, const uint8_t size)
+{
+	uint8_t err_code;
+	
+	while(sensor_sample.exposure < sensor_oversample_count){
+		if(mode != SENSOR_SAMPLE_MODE_AMBIENT){
+			if((err_code = sensorTurnOnLed(channel)) != NRF_SUCCESS){return err_code;}
+		}
+		sensor_temperature_accumulate();
+		if((err_code = sensorReadData(sensor_oversample_buffer[sensor_sample.exposure], size)) != NRF_SUCCESS){return err_code;}
+		if(mode != SENSOR_SAMPLE_MODE_AMBIENT){
+			if((err_code = sensorTurnOffLed(channel)) != NRF_SUCCESS){return err_code;}
+		}
+		sensor_exposure_check(mode);
+	}
+	
+	sensor_oversample_reduce(byte_array, size);
+	return NRF_SUCCESS;
+}
+
+/** @Func Finish the Sampling State Machine and Post the Sample Ready Event into the Scheduler */
+static void sensor_sample_finish(uint8_t err_code)
+{
+	sensor_sample_evt_t evt =
+	{
+		.array 		= sensor_sample.array,
+		.length		= sensor_sample.length,
+		.mode			= sensor_sample.mode,
+		.err_code	= err_code,
+		.quality	= sensor_sample.quality
+	};
+	
+	app_sched_event_handler_t ready_handler = sensor_sample.ready_handler;
+	
+	sensor_temperature_commit();
+	evt.temperature				= sensor_sample_temperature;
+	sensor_sample_quality = sensor_sample.quality;
+	
+	// Adjust the Exposure Settings for the Next Sample
+	if(err_code == NRF_SUCCESS && is_sensor_ae_enabled){
+		sensorAutoExposureUpdate(sensor_sample.array, sensor_sample.mode);
+	}
+	
+	// Release the State Machine before Posting the Event so that the Handler can Start a New Sample
+	sensor_sample.state = SENSOR_STATE_IDLE;
+	APP_TRACE(APP_TRACE_SENSOR_DONE);
+	
+	if(ready_handler != NULL){
+		APP_ERROR_CHECK(app_sched_event_put(&evt, sizeof(evt), ready_handler));
+	}
+}
+
+/** @Func TWI Transaction Callback of the Sampling State Machine */
+static void sensor_twi_callback(ret_code_t result, void * p_user_data);
+
+/** @Func Schedule the TWI Transaction of the Current State */
+static void sensor_state_run(void)
+{
+	uint8_t err_code;
+	
+	sensorTransactionInit(&sensor_sample_transaction);
+	
+	switch(sensor_sample.state){
+		case SENSOR_STATE_START:// LED current, LED on, timing setup and sampling command in one transaction
+			if(sensor_sample.mode == SENSOR_SAMPLE_MODE_AMBIENT){
+				err_code = sensorTransactionAddAmbientStart(&sensor_sample_transaction);
+			}
+			else{
+				err_code = sensorTransactionAddChannelStart(&sensor_sample_transaction, sensor_sample.channel);
+			}
+			break;
+		case SENSOR_STATE_READ:// Burst read of the exposure data, sensor sleep and LED off in one transaction
+		{
+			uint8_t channel_size = sensor_channel_data_size(sensor_sample.mode);
+			err_code = sensorTransactionAddRead(&sensor_sample_transaction, SENSOR_REG_RED_DATA_HIGH_BYTE, \
+																					sensor_oversample_buffer[sensor_sample.exposure], channel_size);
+			if(err_code == NRF_SUCCESS){
+				err_code = sensorTransactionAddChannelStop(&sensor_sample_transaction);
+			}
+			break;
+		}
+		default:
+			return;
+	}
+	
+	// Queue the transaction (Non-blocking/Asynchronous Approach)
+	if(sensor_sample.state == SENSOR_STATE_START){
+		APP_TRACE(APP_TRACE_SENSOR_EXPOSURE);
+	}
+	if(err_code == NRF_SUCCESS){
+		err_code = sensorTransactionSchedule(&sensor_sample_transaction, sensor_twi_callback, NULL);
+	}
+	if(err_code != NRF_SUCCESS){
+		sensor_sample_finish(err_code);
+	}
+}
+
+/** @Func TWI Transaction Callback of the Sampling State Machine */
+static void sensor_twi_callback(ret_code_t result, void * p_user_data)
+{
+	if(result != NRF_SUCCESS){
+		sensor_sample_finish(result);
+		return;
+	}
+	
+	// Move to the Next State
+	switch(sensor_sample.state){
+		case SENSOR_STATE_START:// Integrate: the CPU sleeps until the RTC2 compare event
+			APP_TRACE(APP_TRACE_SENSOR_TWI_START);
+			if(sensor_sample.mode != SENSOR_SAMPLE_MODE_AMBIENT){
+				sensor_led_status_set(sensor_sample.channel, true);
+			}
+			sensor_sample.state = SENSOR_STATE_INTEGRATE;
+			sensor_delay_ms(sensor_wait_time_ms());
+			sensor_temperature_accumulate();
+			break;
+		case SENSOR_STATE_READ:
+			APP_TRACE(APP_TRACE_SENSOR_TWI_READ);
+			sensor_led_status_set(sensor_sample.channel, false);
+			
+			// Expose the Channel Again (Retry of A Zero-reading or the Next Exposure of the Channel)
+			if(sensor_exposure_check(sensor_sample.mode) || sensor_sample.exposure < sensor_oversample_count){
+				sensor_sample.state = SENSOR_STATE_START;
+				sensor_state_run();
+				break;
+			}
+			
+			uint8_t channel_size = sensor_channel_data_size(sensor_sample.mode);
+			sensor_oversample_reduce(&sensor_sample.array[sensor_sample.channel * channel_size], channel_size);
+			
+			if(sensor_sample.mode == SENSOR_SAMPLE_MODE_AMBIENT || sensor_sample.channel == BLUE){// All exposures are sampled
+				sensor_sample_finish(NRF_SUCCESS);
+				return;
+			}
+			sensor_sample.channel = (led_type_t)(sensor_sample.channel + 1);
+			sensor_sample.state = SENSOR_STATE_START;
+			sensor_state_run();
+			break;
+		default:
+			break;
+	}
+}
+
+/** @Func RTC Event Handler */
+static void sensor_rtc_event_handler(nrf_drv_rtc_int_type_t int_type)
+{
+	if(int_type == NRF_DRV_RTC_INT_COMPARE0){
+		// Stop the RTC
+		sensor_delay_stop();
+		
+		// The Integration of the Sampling State Machine is Finished
+		if(sensor_sample.state == SENSOR_STATE_INTEGRATE){
+			APP_TRACE(APP_TRACE_SENSOR_INTEGRATE);
+			sensor_sample.state = SENSOR_STATE_READ;
+			sensor_state_run();
+			return;
+		}
+		
+		// Read the Acquired Data, Put the Sensor into Sleep and Turn off LEDs (One Transaction)
+		sensor_transaction_t trans;
+		sensorTransactionInit(&trans);
+		APP_ERROR_CHECK(sensorTransactionAddRead(&trans, sensor_data.reg_name, sensor_data.array, sensor_data.length));
+		APP_ERROR_CHECK(sensorTransactionAddChannelStop(&trans));
+		APP_ERROR_CHECK(sensorTransactionPerform(&trans));
+		
+		sensor_led_status_set(RED, false);
+		sensor_led_status_set(GREEN, false);
+		sensor_led_status_set(BLUE, false);
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /** @Func TWI Configuration */
@@ -151,6 +649,54 @@ void sensorLedCurrentConfig(const uint8_t current, const led_type_t led_type)
 	}
 }
 
+/** @Func Set the Sampling Mode */
+uint8_t sensorSampleModeConfig(const sensor_sample_mode_t mode)
+{
+	if(mode > SENSOR_SAMPLE_MODE_AMBIENT){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	// The Mode of the Sample in Flight Cannot be Changed
+	if(sensorIsSampling()){
+		return NRF_ERROR_BUSY;
+	}
+	
+	sensor_sample_mode = mode;
+	return NRF_SUCCESS;
+}
+
+/** @Func Set the Number of Exposures per Channel and the Combining Method */
+uint8_t sensorOversampleConfig(const uint8_t count, const sensor_reduce_t method)
+{
+	if(count == 0 || count > SENSOR_OVERSAMPLE_MAX || method > SENSOR_REDUCE_TRIMMED_MEAN){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	// The Settings of the Sample in Flight Cannot be Changed
+	if(sensorIsSampling()){
+		return NRF_ERROR_BUSY;
+	}
+	
+	sensor_oversample_count = count;
+	sensor_reduce_method 		= method;
+	return NRF_SUCCESS;
+}
+
+/** @Func Get the Data Size of One Sample in the Specified Sampling Mode */
+uint8_t sensorSampleDataSize(const sensor_sample_mode_t mode)
+{
+	switch(mode){
+		case SENSOR_SAMPLE_MODE_RGB:
+			return SENSOR_COLOR_DATA_SIZE;
+		case SENSOR_SAMPLE_MODE_RGBIR:
+			return SENSOR_COLOR_FULL_DATA_SIZE;
+		case SENSOR_SAMPLE_MODE_AMBIENT:
+			return SENSOR_CHANNEL_FULL_DATA_SIZE;
+		default:
+			return 0;
+	}
+}
+
 /** @Func Write a Byte Array into the Sensor Register from the Specified Address */
 uint8_t sensorWriteByteArray(uint8_t * byte_array, const uint8_t array_length, const uint8_t address)
 {
@@ -180,10 +726,114 @@ uint8_t sensorReadByteArray(uint8_t * byte_array, const uint8_t array_length, co
 	return app_twi_perform(&twi_obj, data, number_of_transfers, NULL);
 }
 
+/** @Func Initialize an Empty Sensor Transaction */
+void sensorTransactionInit(sensor_transaction_t * p_trans)
+{
+	p_trans->buffer_used					= 0;
+	p_trans->number_of_transfers	= 0;
+}
+
+/** @Func Append a Register Write to the Sensor Transaction */
+uint8_t sensorTransactionAddWrite(sensor_transaction_t * p_trans, const uint8_t reg_address, uint8_t const * data, const uint8_t length)
+{
+	// Check the Space Left in the Transaction
+	if(p_trans->number_of_transfers >= SENSOR_TWI_MAX_TRANSFERS || p_trans->buffer_used + length + 1 > SENSOR_TWI_BUFFER_SIZE){
+		return NRF_ERROR_NO_MEM;
+	}
+	
+	// Copy the Register Address and the Data into the Transaction Buffer
+	uint8_t * p_data = &p_trans->buffer[p_trans->buffer_used];
+	p_data[0] = reg_address;
+	for(uint8_t i = 0; i < length; i++){
+		p_data[i + 1] = data[i];
+	}
+	p_trans->buffer_used += length + 1;
+	
+	// Append the Transfer
+	p_trans->transfers[p_trans->number_of_transfers++] = (app_twi_transfer_t)APP_TWI_WRITE(SENSOR_ADDRESS, p_data, length + 1, 0);
+	return NRF_SUCCESS;
+}
+
+/** @Func Append a Register Burst Read to the Sensor Transaction */
+uint8_t sensorTransactionAddRead(sensor_transaction_t * p_trans, const uint8_t reg_address, uint8_t * byte_array, const uint8_t array_length)
+{
+	// Check the Space Left in the Transaction
+	if(p_trans->number_of_transfers + 2 > SENSOR_TWI_MAX_TRANSFERS || p_trans->buffer_used + 1 > SENSOR_TWI_BUFFER_SIZE){
+		return NRF_ERROR_NO_MEM;
+	}
+	
+	// Copy the Register Address into the Transaction Buffer
+	uint8_t * p_data = &p_trans->buffer[p_trans->buffer_used++];
+	*p_data = reg_address;
+	
+	// Append the Address Write (Repeated Start) and the Read Transfers
+	p_trans->transfers[p_trans->number_of_transfers++] = (app_twi_transfer_t)APP_TWI_WRITE(SENSOR_ADDRESS, p_data, 1, APP_TWI_NO_STOP);
+	p_trans->transfers[p_trans->number_of_transfers++] = (app_twi_transfer_t)APP_TWI_READ(SENSOR_ADDRESS, byte_array, array_length, 0);
+	return NRF_SUCCESS;
+}
+
+/** @Func Append the Start Sequence of A Channel to the Sensor Transaction */
+uint8_t sensorTransactionAddChannelStart(sensor_transaction_t * p_trans, const led_type_t led_type)
+{
+	uint8_t err_code;
+	uint8_t current[3];
+	uint8_t command[2];
+	
+	if((err_code = sensor_led_commands(led_type, current, command)) != NRF_SUCCESS){
+		return err_code;
+	}
+	
+	// LED Current -> LED On -> Timing Setup -> Sampling Command
+	if((err_code = sensorTransactionAddWrite(p_trans, current[0], &current[1], 2)) != NRF_SUCCESS){return err_code;}
+	if((err_code = sensorTransactionAddWrite(p_trans, command[0], &command[1], 1)) != NRF_SUCCESS){return err_code;}
+	return sensor_transaction_add_exposure(p_trans);
+}
+
+/** @Func Append the Start Sequence of An Ambient Exposure to the Sensor Transaction */
+uint8_t sensorTransactionAddAmbientStart(sensor_transaction_t * p_trans)
+{
+	uint8_t err_code;
+	uint8_t led_off[2] = {LED_OFF_COMMAND|SENSOR_LED_RED_CURRENT_0MA, SENSOR_LED_GREEN_CURRENT_0MA|SENSOR_LED_BLUE_CURRENT_0MA};
+	
+	// All LEDs Off -> Timing Setup -> Sampling Command
+	if((err_code = sensorTransactionAddWrite(p_trans, SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1, led_off, 2)) != NRF_SUCCESS){return err_code;}
+	return sensor_transaction_add_exposure(p_trans);
+}
+
+/** @Func Append the Stop Sequence of A Channel to the Sensor Transaction */
+uint8_t sensorTransactionAddChannelStop(sensor_transaction_t * p_trans)
+{
+	uint8_t err_code;
+	uint8_t sleep = sensor_ctrl_sleep();
+	uint8_t led_off[2] = {LED_OFF_COMMAND|SENSOR_LED_RED_CURRENT_0MA, SENSOR_LED_GREEN_CURRENT_0MA|SENSOR_LED_BLUE_CURRENT_0MA};
+	
+	// Sensor Sleep -> LED Off
+	if((err_code = sensorTransactionAddWrite(p_trans, SENSOR_REG_CONTROL, &sleep, 1)) != NRF_SUCCESS){return err_code;}
+	return sensorTransactionAddWrite(p_trans, SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1, led_off, 2);
+}
+
+#ifndef SENSOR_HOST_SIMULATION
+/** @Func Perform the Sensor Transaction (Blocking Mode) */
+uint8_t sensorTransactionPerform(sensor_transaction_t * p_trans)
+{
+	return app_twi_perform(&twi_obj, p_trans->transfers, p_trans->number_of_transfers, NULL);
+}
+
+/** @Func Schedule the Sensor Transaction (Non-blocking Mode) */
+uint8_t sensorTransactionSchedule(sensor_transaction_t * p_trans, app_twi_callback_t callback, void * p_user_data)
+{
+	p_trans->transaction.callback							= callback;
+	p_trans->transaction.p_user_data					= p_user_data;
+	p_trans->transaction.p_transfers					= p_trans->transfers;
+	p_trans->transaction.number_of_transfers	= p_trans->number_of_transfers;
+	return app_twi_schedule(&twi_obj, &p_trans->transaction);
+}
+#endif	// The host simulation runs the transactions on its sensor model (Simulation/sim_sensor.c)
+
 /** @Func Run-time Configuration of the Color Sensor */
 uint8_t sensorSetup(const uint16_t value)
 {
-	uint8_t setup_data[4] = {SENSOR_REG_CONTROL, SENSOR_SETUP, (value >> 8) & 0xff, value & 0xff};
+	uint8_t setup_data[4] = {SENSOR_REG_CONTROL, sensor_ctrl_setup(), (value >> 8) & 0xff, value & 0xff};
 	return sensorWriteByteArray(setup_data,4,SENSOR_ADDRESS);
 }
 
@@ -194,56 +844,20 @@ uint8_t sensorTurnOnLed(const led_type_t led_type)
 	uint8_t	current[3];
 	uint8_t command[2];
 	
-	// Set the Common Register Address of the Color Sensor
-	current[0] = SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1;
-	command[0] = SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1;
+	// Set the Commands
+	if((err_code = sensor_led_commands(led_type, current, command)) != NRF_SUCCESS){
+		return err_code;
+	}
 	
-	switch (led_type){
-		case RED:
-		{
-			// Set the Commands
-			current[1] = LED_OFF_COMMAND|sensor_led_current.led_red_current;
-			current[2] = SENSOR_LED_GREEN_CURRENT_0MA|SENSOR_LED_BLUE_CURRENT_0MA;
-			command[1] = LED_ON_COMMAND|sensor_led_current.led_red_current;
-			// Write into the sensor registors through the TWI interface
-			if((err_code = sensorWriteByteArray(current,3,SENSOR_ADDRESS)) == NRF_SUCCESS){
-				if((err_code = sensorWriteByteArray(command,2,SENSOR_ADDRESS)) == NRF_SUCCESS){
-					sensor_led_status.is_led_red_on = true;
-				}
-			}
-			return err_code;
-		}
-		case GREEN:
-		{
-			// Set the Commands
-			current[1] = LED_OFF_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
-			current[2] = sensor_led_current.led_green_current|SENSOR_LED_BLUE_CURRENT_0MA;
-			command[1] = LED_ON_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
-			// Write into the sensor registors through the TWI interface
-			if((err_code = sensorWriteByteArray(current,3,SENSOR_ADDRESS)) == NRF_SUCCESS){
-				if((err_code = sensorWriteByteArray(command,2,SENSOR_ADDRESS)) == NRF_SUCCESS){
-					sensor_led_status.is_led_green_on = true;
-				}
-			}
-			return err_code;
-		}
-		case BLUE:
-		{
-			// Set the Commands
-			current[1] = LED_OFF_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
-			current[2] = SENSOR_LED_GREEN_CURRENT_0MA|sensor_led_current.led_blue_current;
-			command[1] = LED_ON_COMMAND|SENSOR_LED_RED_CURRENT_0MA;
-			// Write into the sensor registors through the TWI interface
-			if((err_code = sensorWriteByteArray(current,3,SENSOR_ADDRESS)) == NRF_SUCCESS){
-				if((err_code = sensorWriteByteArray(command,2,SENSOR_ADDRESS)) == NRF_SUCCESS){
-					sensor_led_status.is_led_blue_on = true;
-				}
-			}
-			return err_code;
-		}
-		default:
-			return NRF_ERROR_INVALID_PARAM;
+	// Write into the sensor registors through the TWI interface (Both writes in one transaction)
+	sensor_transaction_t trans;
+	sensorTransactionInit(&trans);
+	if((err_code = sensorTransactionAddWrite(&trans, current[0], &current[1], 2)) != NRF_SUCCESS){return err_code;}
+	if((err_code = sensorTransactionAddWrite(&trans, command[0], &command[1], 1)) != NRF_SUCCESS){return err_code;}
+	if((err_code = sensorTransactionPerform(&trans)) == NRF_SUCCESS){
+		sensor_led_status_set(led_type, true);
 	}
+	return err_code;
 }
 
 /** @Func Turn Off A Specified LED */
@@ -262,19 +876,10 @@ uint8_t sensorTurnOffLed(const led_type_t led_type)
 	
 	// Set the LED on/off status
 	if(err_code == NRF_SUCCESS){
-		switch(led_type){
-			case RED:
-				sensor_led_status.is_led_red_on = false;
-				break;
-			case GREEN:
-				sensor_led_status.is_led_green_on = false;
-				break;
-			case BLUE:
-				sensor_led_status.is_led_blue_on = false;
-				break;
-			default:
-				return NRF_ERROR_INVALID_PARAM;
+		if(led_type > BLUE){
+			return NRF_ERROR_INVALID_PARAM;
 		}
+		sensor_led_status_set(led_type, false);
 	}
 	return err_code;
 }
@@ -282,80 +887,242 @@ uint8_t sensorTurnOffLed(const led_type_t led_type)
 /** @Func Start Color Sampling */
 uint8_t sensorSampleStart(void)
 {
-	uint8_t data[2]  = {SENSOR_REG_CONTROL, START_SAMPLING};
+	uint8_t data[2]  = {SENSOR_REG_CONTROL, sensor_ctrl_start()};
 	return sensorWriteByteArray(data,2,SENSOR_ADDRESS);
 }
 
 /** @Func Put the Sensor into Sleeping */
 uint8_t sensorSleep(void)
 {
-	uint8_t data[2]  = {SENSOR_REG_CONTROL, SENSOR_SLEEP};
+	uint8_t data[2]  = {SENSOR_REG_CONTROL, sensor_ctrl_sleep()};
 	return sensorWriteByteArray(data,2,SENSOR_ADDRESS);
 }
 
 /** @Func Read Out the Acquired Sensor Data */
 uint8_t sensorReadData(uint8_t * byte_array, const uint8_t array_length)
 {
-	uint16_t timing = MANUAL_TIMING;
+	uint8_t sleep = sensor_ctrl_sleep();
 	uint8_t err_code;
+	sensor_transaction_t trans;
 	
-	// Configure the Color Sensor into Manual Timing Mode
-	if((err_code = sensorSetup(timing)) == NRF_SUCCESS){
+	// Configure the Color Sensor with the Exposure Settings and Send the Sensor Sampling Command (One Transaction)
+	sensorTransactionInit(&trans);
+	if((err_code = sensor_transaction_add_exposure(&trans)) != NRF_SUCCESS){return err_code;}
+	if((err_code = sensorTransactionPerform(&trans)) != NRF_SUCCESS){return err_code;}
+	
+	// Determine the Waiting Time
+	uint32_t wait_time = sensor_wait_time_ms();
+	
+	// Non-blocking Mode
+	if (sensor_rtc_event_handler_default != NULL){
 		
-		// Initial Delay
-		// nrf_delay_ms(2);
+		// Memorize the Temporary Data to be Passed into the Timer Event Handler
+		sensor_data.array 		= byte_array;
+		sensor_data.length 		= array_length;
+		sensor_data.reg_name	=	SENSOR_REG_RED_DATA_HIGH_BYTE;
+	
+		// Start the Timer
+		sensor_delay_ms(wait_time);
+		return NRF_SUCCESS;
+	}
+	
+	// Blocking Mode
+	
+	// Waiting till Sampling is Finished
+	nrf_delay_ms(wait_time);
+
+	// Read the Acquired Data and Put the Sensor into Sleep (One Transaction)
+	sensorTransactionInit(&trans);
+	if((err_code = sensorTransactionAddRead(&trans, SENSOR_REG_RED_DATA_HIGH_BYTE, byte_array, array_length)) != NRF_SUCCESS){return err_code;}
+	if((err_code = sensorTransactionAddWrite(&trans, SENSOR_REG_CONTROL, &sleep, 1)) != NRF_SUCCESS){return err_code;}
+	return sensorTransactionPerform(&trans);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Exposure Control Functions */
+
+/** @Func Set the Exposure Settings */
+uint8_t sensorExposureConfig(sensor_exposure_t const * p_exposure)
+{
+	if(p_exposure->int_time > SENSOR_CTRL_INT_TIME_SETTING_131MS || p_exposure->manual_timing == 0 \
+		|| (p_exposure->gain != SENSOR_CTRL_GAIN_SELECT_HIGH && p_exposure->gain != SENSOR_CTRL_GAIN_SELECT_LOW) \
+		|| (p_exposure->int_mode != SENSOR_CTRL_INT_MODE_FIXED_TIME && p_exposure->int_mode != SENSOR_CTRL_INT_MODE_MANUAL_SETTING)){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+	
+	// The Settings of the Sample in Flight Cannot be Changed
+	if(sensorIsSampling()){
+		return NRF_ERROR_BUSY;
+	}
+	
+	sensor_exposure = *p_exposure;
+	is_sensor_settings_dirty = true;
+	return NRF_SUCCESS;
+}
+
+/** @Func Get the Exposure Settings */
+void sensorGetExposure(sensor_exposure_t * p_exposure)
+{
+	*p_exposure = sensor_exposure;
+}
+
+/** @Func Enable or Disable the Auto-exposure Controller */
+void sensorAutoExposureEnable(const bool is_enabled)
+{
+	is_sensor_ae_enabled = is_enabled;
+}
+
+/** @Func Adjust the Exposure Settings from the Previous Reading */
+void sensorAutoExposureUpdate(uint8_t const * byte_array, const sensor_sample_mode_t mode)
+{
+	// The dark frame says nothing about the LED exposures
+	if(mode == SENSOR_SAMPLE_MODE_AMBIENT){
+		return;
+	}
+	
+	uint8_t 	size 					= sensor_channel_data_size(mode);
+	uint16_t 	peak_max			= 0;
+	bool			is_saturated	= false;
+	bool			is_changed		= false;
+	
+	for(uint8_t channel = RED; channel <= BLUE; channel++){
+		uint8_t const * p_data 	= &byte_array[channel * size];
+		uint16_t 				peak 		= sensor_data_word(p_data, channel);	// The own colour of the LED (R under red, G under green, ...)
+		bool						is_clip	= false;
 		
-		// Send the Sensor Sampling Command
-		if((err_code = sensorSampleStart()) == NRF_SUCCESS){
-			
-			// Determine the Waiting Time
-			uint32_t wait_time;
-			switch(INTEGRATION_TIME){
-				case SENSOR_CTRL_INT_TIME_SETTING_32US:
-					wait_time = (uint32_t)(0.032 * MANUAL_TIMING * 4 * POST_SAMPLE_WAIT_TIME_MARGIN);
-					break;
-				case SENSOR_CTRL_INT_TIME_SETTING_1MS:
-					wait_time = (uint32_t)(1 * MANUAL_TIMING * 4 * POST_SAMPLE_WAIT_TIME_MARGIN);
-					break;
-				case SENSOR_CTRL_INT_TIME_SETTING_16MS:
-					wait_time = (uint32_t)(16.0 * MANUAL_TIMING * 4 * POST_SAMPLE_WAIT_TIME_MARGIN);
-					break;
-				case SENSOR_CTRL_INT_TIME_SETTING_131MS:
-					wait_time = (uint32_t)(131.0 * MANUAL_TIMING * 4 * POST_SAMPLE_WAIT_TIME_MARGIN);
-					break;
-				default:
-					wait_time = (uint32_t)(0.032 * MANUAL_TIMING * 4 * POST_SAMPLE_WAIT_TIME_MARGIN);
-					break;
-			}
-			
-			// Non-blocking Mode
-			if (sensor_rtc_event_handler_default != NULL){
-				
-				// Memorize the Temporary Data to be Passed into the Timer Event Handler
-				sensor_data.array 		= byte_array;
-				sensor_data.length 		= array_length;
-				sensor_data.reg_name	=	SENSOR_REG_RED_DATA_HIGH_BYTE;
-			
-				// Start the Timer
-				sensor_delay_ms(wait_time);
-			}
-			
-			// Blocking Mode
-			else{
-				
-				// Waiting till Sampling is Finished
-				nrf_delay_ms(wait_time);
-			
-				// Read the Acquired Data
-				err_code = sensorReadByteArray(byte_array,array_length,SENSOR_REG_RED_DATA_HIGH_BYTE);
-			
-				if(err_code == NRF_SUCCESS){
-					return sensorSleep();	//Put the sensor into sleep
-				}
+		// Any word of the exposure at full scale means the reading is clipped
+		for(uint8_t i = 0; i < size / 2; i++){
+			if(sensor_data_word(p_data, i) >= SENSOR_AE_SATURATION_LEVEL){
+				is_clip = true;
 			}
 		}
+		
+		// Balance the channels with the LED currents
+		uint8_t level = sensor_led_level_get((led_type_t)channel);
+		if((is_clip || peak > SENSOR_AE_TARGET_HIGH) && level > SENSOR_AE_LED_LEVEL_MIN){
+			sensor_led_level_set((led_type_t)channel, level - 1);
+			is_changed = true;
+		}
+		else if(peak < SENSOR_AE_TARGET_LOW && level < SENSOR_AE_LED_LEVEL_MAX){
+			sensor_led_level_set((led_type_t)channel, level + 1);
+			is_changed = true;
+		}
+		
+		is_saturated |= is_clip;
+		if(peak > peak_max){
+			peak_max = peak;
+		}
 	}
-	return err_code;
+	
+	// One control per reading: the peaks above were read before the level steps, so the integration time
+	// is only rescaled once the LED levels have settled in the target window or reached their limits
+	if(is_changed){
+		is_sensor_ae_stable 		 	= false;
+		is_sensor_settings_dirty 	= true;
+		return;
+	}
+	
+	// Scale the integration time so that the brightest channel lands on the target (At most 4 times per step)
+	uint32_t exposure_us 	= sensor_exposure_us();
+	uint32_t new_us				= exposure_us;
+	if(is_saturated){
+		new_us = exposure_us / 4;
+	}
+	else if(peak_max < SENSOR_AE_TARGET_LOW || peak_max > SENSOR_AE_TARGET_HIGH){
+		uint64_t scaled = (uint64_t)exposure_us * SENSOR_AE_TARGET / (peak_max ? peak_max : 1);
+		new_us = (scaled > (uint64_t)exposure_us * 4) ? exposure_us * 4 : (uint32_t)scaled;
+		new_us = (new_us < exposure_us / 4) ? exposure_us / 4 : new_us;
+	}
+	
+	// Trade the integration time against the gain before hitting the limits
+	if(new_us > SENSOR_AE_MAX_EXPOSURE_US && sensor_exposure.gain == SENSOR_CTRL_GAIN_SELECT_LOW){
+		sensor_exposure.gain = SENSOR_CTRL_GAIN_SELECT_HIGH;
+		new_us /= SENSOR_AE_GAIN_RATIO;
+		is_changed = true;
+	}
+	else if(new_us < SENSOR_AE_MIN_EXPOSURE_US && sensor_exposure.gain == SENSOR_CTRL_GAIN_SELECT_HIGH){
+		sensor_exposure.gain = SENSOR_CTRL_GAIN_SELECT_LOW;
+		new_us *= SENSOR_AE_GAIN_RATIO;
+		is_changed = true;
+	}
+	
+	// A dark target stays at the longest allowed window instead of growing further
+	new_us = (new_us > SENSOR_AE_MAX_EXPOSURE_US) ? SENSOR_AE_MAX_EXPOSURE_US : new_us;
+	new_us = (new_us < SENSOR_AE_MIN_EXPOSURE_US) ? SENSOR_AE_MIN_EXPOSURE_US : new_us;
+	if(new_us != exposure_us){
+		sensor_exposure_us_set(new_us);
+		is_changed = (sensor_exposure_us() != exposure_us) || is_changed;
+	}
+	
+	is_sensor_ae_stable = !is_changed;
+	is_sensor_settings_dirty |= is_changed;
+}
+
+/** @Func Load the Sensor Settings from the SET_DATA_SENR_* Records */
+flash_status_t sensorSettingsLoad(void)
+{
+	union data_set_t	value[SET_DATA_SENR_NUM];
+	flash_status_t		flash_ret_code;
+	
+	for(uint16_t i = 0; i < SET_DATA_SENR_NUM; i++){
+		if((flash_ret_code = getOneRecord(SET_DATA_SENR_START_INDEX + i, value[i].byte)) != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	
+	sensor_exposure_t exposure =
+	{
+		.gain						= value[SET_DATA_SENR_GSEL_INDEX - SET_DATA_SENR_START_INDEX].byte[0],
+		.int_mode				= value[SET_DATA_SENR_INTMOD_INDEX - SET_DATA_SENR_START_INDEX].byte[0],
+		.int_time				= value[SET_DATA_SENR_INTSET_INDEX - SET_DATA_SENR_START_INDEX].byte[0],
+		.manual_timing	= (uint16_t)value[SET_DATA_SENR_MANT_INDEX - SET_DATA_SENR_START_INDEX].word
+	};
+	if(sensorExposureConfig(&exposure) != NRF_SUCCESS){
+		return FLASH_STATUS_READ_ERR;
+	}
+	
+	sensor_led_current.led_red_current 		= value[SET_DATA_SENR_RLEDCUR_INDEX - SET_DATA_SENR_START_INDEX].byte[0];
+	sensor_led_current.led_green_current 	= value[SET_DATA_SENR_GLEDCUR_INDEX - SET_DATA_SENR_START_INDEX].byte[0];
+	sensor_led_current.led_blue_current 	= value[SET_DATA_SENR_BLEDCUR_INDEX - SET_DATA_SENR_START_INDEX].byte[0];
+	
+	is_sensor_settings_dirty = false;
+	return FLASH_STATUS_SUCCESS;
+}
+
+/** @Func Save the Sensor Settings into the SET_DATA_SENR_* Records */
+flash_status_t sensorSettingsSave(void)
+{
+	// Only write once the controller has settled, so a converging sequence costs one flash write
+	if(!is_sensor_settings_dirty || !is_sensor_ae_stable){
+		return FLASH_STATUS_SUCCESS;
+	}
+	
+	const struct{
+		uint16_t index;
+		uint32_t word;
+	}records[] =
+	{
+		{SET_DATA_SENR_GSEL_INDEX,		sensor_exposure.gain},
+		{SET_DATA_SENR_INTMOD_INDEX,	sensor_exposure.int_mode},
+		{SET_DATA_SENR_INTSET_INDEX,	sensor_exposure.int_time},
+		{SET_DATA_SENR_MANT_INDEX,		sensor_exposure.manual_timing},
+		{SET_DATA_SENR_RLEDCUR_INDEX,	sensor_led_current.led_red_current},
+		{SET_DATA_SENR_GLEDCUR_INDEX,	sensor_led_current.led_green_current},
+		{SET_DATA_SENR_BLEDCUR_INDEX,	sensor_led_current.led_blue_current}
+	};
+	
+	flash_status_t flash_ret_code;
+	for(uint8_t i = 0; i < sizeof(records)/sizeof(records[0]); i++){
+		union data_set_t value;
+		value.word = records[i].word;
+		if((flash_ret_code = setOneRecord(records[i].index, value.byte)) != FLASH_STATUS_SUCCESS){
+			return flash_ret_code;
+		}
+	}
+	
+	is_sensor_settings_dirty = false;
+	return FLASH_STATUS_SUCCESS;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -366,7 +1133,7 @@ uint8_t sensorReadData(uint8_t * byte_array, const uint8_t array_length)
 uint8_t sensorSampleColor(uint8_t * byte_array, uint8_t array_length)
 {
 	// Check the Input Array Length
-	if(array_length < 18){
+	if(array_length < sensorSampleDataSize(sensor_sample_mode)){
 		return NRF_ERROR_INVALID_LENGTH;
 	}
 	
@@ -374,49 +1141,84 @@ uint8_t sensorSampleColor(uint8_t * byte_array, uint8_t array_length)
 	
 	/* Non-blocking Mode */
 	if(sensor_rtc_event_handler_default != NULL){
-		
-		// Sampling On the Red Channel
-		while(sensor_led_status.is_led_red_on || sensor_led_status.is_led_green_on || sensor_led_status.is_led_blue_on){__WFE();} // Wait until all LEDs are turned off
-		if((err_code = sensorTurnOnLed(RED)) != NRF_SUCCESS){return err_code;} 																										// Turn on Red LED
-		if((err_code = sensorReadData(&byte_array[0],6)) != NRF_SUCCESS){return err_code;} 																				// Sample the Red Channel
-	
-		// Sampling On the Green Channel
-		while(sensor_led_status.is_led_red_on || sensor_led_status.is_led_green_on || sensor_led_status.is_led_blue_on){__WFE();} // Wait until all LEDs are turned off
-		if((err_code = sensorTurnOnLed(GREEN)) != NRF_SUCCESS){return err_code;} 																									// Turn on Green LED
-		if((err_code = sensorReadData(&byte_array[6],6)) != NRF_SUCCESS){return err_code;} 																				// Sample the Green Channel
-
-		// Sampling On the Blue Channel
-		while(sensor_led_status.is_led_red_on || sensor_led_status.is_led_green_on || sensor_led_status.is_led_blue_on){__WFE();} // Wait until all LEDs are turned off
-		if((err_code = sensorTurnOnLed(BLUE)) != NRF_SUCCESS){return err_code;} 																									// Turn on Blue LED
-		if((err_code = sensorReadData(&byte_array[12],6)) != NRF_SUCCESS){return err_code;} 																			// Sample the Blue Channel
-	
-		// Wait Till All Sampling is Completed
-		while(sensor_led_status.is_led_red_on || sensor_led_status.is_led_green_on || sensor_led_status.is_led_blue_on){__WFE();} // Wait until all LEDs are turned off
-		return err_code;
+		return sensorSampleColorStart(byte_array, array_length, NULL);
 	}
 	
 	/* Blocking Mode */
 	else{
 		
-		// Sampling On the Red Channel
-		if((err_code = sensorTurnOnLed(RED)) != NRF_SUCCESS){return err_code;} // Turn on the Red LED
-		if((err_code = sensorReadData(&byte_array[0],6)) != NRF_SUCCESS){return err_code;} // Sample the Red Channel
-		if((err_code = sensorTurnOffLed(RED)) != NRF_SUCCESS){return err_code;} // Turn off the Red LED
+		uint8_t size = sensor_channel_data_size(sensor_sample_mode);
 		
-		// Sampling On the Green Channel
-		if((err_code = sensorTurnOnLed(GREEN)) != NRF_SUCCESS){return err_code;} // Turn on the Green LED
-		if((err_code = sensorReadData(&byte_array[6],6)) != NRF_SUCCESS){return err_code;} // Sample the Green Channel
-		if((err_code = sensorTurnOffLed(GREEN)) != NRF_SUCCESS){return err_code;} // Turn off the Green LED
+		sensor_sample.exposure 	= 0;
+		sensor_sample.retry 		= 0;
+		sensor_sample.quality 	= SENSOR_QUALITY_MAX;
 		
-		// Sampling On the Blue Channel
-		if((err_code = sensorTurnOnLed(BLUE)) != NRF_SUCCESS){return err_code;} // Turn on the Blue LED
-		if((err_code = sensorReadData(&byte_array[12],6)) != NRF_SUCCESS){return err_code;} // Sample the Blue Channel
-		if((err_code = sensorTurnOffLed(BLUE)) != NRF_SUCCESS){return err_code;} // Turn off the Blue LED
+		// Ambient Sampling (One Channel with All LEDs Off)
+		if(sensor_sample_mode == SENSOR_SAMPLE_MODE_AMBIENT){
+			err_code = sensor_channel_sample_blocking(sensor_sample_mode, RED, &byte_array[0], size);
+		}
+		
+		// Sampling On the Red, Green and Blue Channels
+		else{
+			for(uint8_t channel = RED; channel <= BLUE && err_code == NRF_SUCCESS; channel++){
+				err_code = sensor_channel_sample_blocking(sensor_sample_mode, (led_type_t)channel, &byte_array[channel * size], size);
+			}
+		}
 		
+		sensor_temperature_commit();
+		sensor_sample_quality = sensor_sample.quality;
+		
+		// Adjust the Exposure Settings for the Next Sample
+		if(err_code == NRF_SUCCESS && is_sensor_ae_enabled && sensor_sample_mode != SENSOR_SAMPLE_MODE_AMBIENT){
+			sensorAutoExposureUpdate(byte_array, sensor_sample_mode);
+		}
 		return err_code;
 	}
 }
 
+/** @Func Start Sampling From All Three Channels (Non-blocking Mode) */
+uint8_t sensorSampleColorStart(uint8_t * byte_array, const uint8_t array_length, app_sched_event_handler_t sample_ready_handler)
+{
+	// Check the Input Array Length
+	if(array_length < sensorSampleDataSize(sensor_sample_mode)){
+		return NRF_ERROR_INVALID_LENGTH;
+	}
+	
+	// The State Machine is Driven by the Default RTC Event Handler
+	if(sensor_rtc_event_handler_default != sensor_rtc_event_handler){
+		return NRF_ERROR_INVALID_STATE;
+	}
+	
+	// Only One Sample Can Be in Flight
+	CRITICAL_REGION_ENTER();
+	bool is_idle = (sensor_sample.state == SENSOR_STATE_IDLE);
+	if(is_idle){
+		sensor_sample.state = SENSOR_STATE_START;
+	}
+	CRITICAL_REGION_EXIT();
+	if(!is_idle){
+		return NRF_ERROR_BUSY;
+	}
+	
+	// Memorize the Sampling Context
+	sensor_sample.mode					= sensor_sample_mode;
+	sensor_sample.channel				= RED;
+	sensor_sample.array					= byte_array;
+	sensor_sample.length				= array_length;
+	sensor_sample.ready_handler	= sample_ready_handler;
+	sensor_sample.temperature_sum 	= 0;
+	sensor_sample.temperature_count	= 0;
+	sensor_sample.exposure					= 0;
+	sensor_sample.retry							= 0;
+	sensor_sample.quality						= SENSOR_QUALITY_MAX;
+	
+	APP_TRACE(APP_TRACE_SENSOR_START);
+	
+	// Kick Off the First Transaction (The Rest is Driven by the TWI Callbacks and the RTC Compare Event)
+	sensor_state_run();
+	return NRF_SUCCESS;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Accessor Functions */
@@ -444,4 +1246,55 @@ bool sensorIsBlueOn(void)
 {
 	return sensor_led_status.is_led_blue_on;
 }
+
+/** @Func Get the Current Sampling Mode */
+sensor_sample_mode_t sensorGetSampleMode(void)
+{
+	return sensor_sample_mode;
+}
+
+/** @Func Test Whether A Non-blocking Color Sample is in Flight */
+bool sensorIsSampling(void)
+{
+	return sensor_sample.state != SENSOR_STATE_IDLE;
+}
+
+/** @Func Get the Quality Score of the Last Sample */
+uint8_t sensorGetSampleQuality(void)
+{
+	return sensor_sample_quality;
+}
+
+/** @Func Get the Charge Drawn by the LEDs */
+uint32_t sensorGetLedCharge(void)
+{
+	return sensor_led_charge_uc;
+}
+
+/** @Func Get the Highest LED Pulse Current */
+uint32_t sensorGetLedPeakCurrent(void)
+{
+	uint8_t level = sensor_led_level_drive(RED);
+	
+	// Only one LED is on at a time
+	if(sensor_led_level_drive(GREEN) > level){
+		level = sensor_led_level_drive(GREEN);
+	}
+	if(sensor_led_level_drive(BLUE) > level){
+		level = sensor_led_level_drive(BLUE);
+	}
+	return (uint32_t)level * SENSOR_LED_LEVEL_CURRENT_UA;
+}
+
+/** @Func Limit the LED Current Levels */
+void sensorLedLevelLimit(const uint8_t max_level)
+{
+	sensor_led_level_limit = (max_level > SENSOR_AE_LED_LEVEL_MAX) ? SENSOR_AE_LED_LEVEL_MAX : max_level;
+}
+
+/** @Func Get the Die Temperature Tag of the Last Sample */
+int16_t sensorGetSampleTemperature(void)
+{
+	return sensor_sample_temperature;
+}
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -10,18 +10,42 @@
 	* @Req			- TWI Transaction Manager 					(Configured in "sdk_config.h")
 	* @Req		  - RTC Driver												(Configured in "sdk_config.h")
 	* @Req		  - NRF Delay													(Included in "nrf_delay.h")
+	* @Req			- App Scheduler											(Configured in "sdk_config.h")
+	* @Req			- Storage Module										(Included in "app_storage.h")
+	* @Req			- SoftDevice Temperature Sensor			(Included in "nrf_soc.h")
+	*
+	* @Macro		SENSOR_HOST_SIMULATION							(Defined by the Host Build: the Transactions and the RTC2 Delay are Run on the Sensor Model of Simulation/sim_sensor.c)
 	*
 	* @Type			led_type_t													(LED Types)
+	* @Type			sensor_sample_mode_t								(Sampling Modes)
 	*	@Type			reg_type_t													(Register Types)
 	*	@Type			sensor_led_current_t								(Data Type to Store the LED Current Settings)
 	*	@Type			sensor_data_t												(Data Type to Store the Byte Array Address and Array Length)
 	* @Type			sensor_led_flags_t									(Data Type to Store the LED Status)
+	* @Type			sensor_transaction_t								(Data Type of A Chained Sensor Transaction)
+	* @Type			sensor_state_t											(States of the Non-blocking Sampling State Machine)
+	* @Type			sensor_sample_context_t							(Data Type to Store the Context of the Non-blocking Sampling)
+	* @Type			sensor_sample_evt_t									(Data Type of the Sample Ready Event Posted into the Scheduler)
+	* @Type			sensor_exposure_t										(Data Type to Store the Gain and Integration Time Settings)
+	* @Type			sensor_reduce_t											(Methods to Combine the Exposures of One Channel)
 	*
 	*	@Func			sensorConfig												(Configuration of the Sensor Module including the TWI Peripheral)
 	* @Func			sensorSetLedCurrent									(Set Sensor LED Current)
+	* @Func			sensorSampleModeConfig							(Set the Sampling Mode)
+	* @Func			sensorOversampleConfig							(Set the Number of Exposures per Channel and the Combining Method)
+	* @Func			sensorSampleDataSize								(Get the Data Size of One Sample in the Specified Sampling Mode)
 	*
 	* @Func			sensorWriteByteArray								(Write a Byte Array into the Sensor Register from the Specified Address)
 	* @Func			sensorReadByteArray									(Read Out the Register Data into a Byte Array from the Specified Address)
+	* @Func			sensorTransactionInit								(Initialize an Empty Sensor Transaction)
+	* @Func			sensorTransactionAddWrite						(Append a Register Write to the Sensor Transaction)
+	* @Func			sensorTransactionAddRead						(Append a Register Burst Read to the Sensor Transaction)
+	* @Func			sensorTransactionAddChannelStart		(Append the Start Sequence of A Channel to the Sensor Transaction)
+	* @Func			sensorTransactionAddAmbientStart		(Append the Start Sequence of An Ambient Exposure to the Sensor Transaction)
+	* @Func			sensorTransactionAddChannelStop			(Append the Stop Sequence of A Channel to the Sensor Transaction)
+	* @Func			sensorTransactionPerform						(Perform the Sensor Transaction in Blocking Mode)
+	* @Func			sensorTransactionSchedule						(Schedule the Sensor Transaction in Non-blocking Mode)
+	*
 	* @Func			sensorTurnOnLed											(Turn On A Specified LED)
 	* @Func			sensorTurnOffLed										(Turn Off A Specified LED)
 	*	@Func			sensorSetup													(Configuration of the Color Sensor)
@@ -30,11 +54,26 @@
 	*
 	* @Func			sensorReadData											(Read Out the Acquired Sensor Data)
 	*	@Func			sensorSampleColor										(Sampling From All Three Channels)
+	*	@Func			sensorSampleColorStart							(Start Sampling From All Three Channels in Non-blocking Mode)
+	*
+	* @Func			sensorExposureConfig								(Set the Gain and Integration Time Settings)
+	* @Func			sensorGetExposure										(Get the Gain and Integration Time Settings)
+	* @Func			sensorAutoExposureEnable						(Enable or Disable the Auto-exposure Controller)
+	* @Func			sensorAutoExposureUpdate						(Adjust the Exposure Settings from the Previous Reading)
+	* @Func			sensorSettingsLoad									(Load the Sensor Settings from the SET_DATA_SENR_* Records)
+	* @Func			sensorSettingsSave									(Save the Sensor Settings into the SET_DATA_SENR_* Records)
 	*
 	* @Func			sensorGetInstance										(Get the Address of the Internal TWI Instance)
 	* @Func			sensorIsRedOn												(Test Whether the Red LED is Currently On)
 	* @Func			sensorIsGreenOn											(Test Whether the Green LED is Currently On)
 	* @Func			sensorIsBlueOn											(Test Whether the Blue LED is Currently On)
+	* @Func			sensorGetSampleMode									(Get the Current Sampling Mode)
+	* @Func			sensorIsSampling										(Test Whether A Non-blocking Color Sample is in Flight)
+	* @Func			sensorGetSampleTemperature					(Get the Die Temperature Tag of the Last Sample)
+	* @Func			sensorGetSampleQuality							(Get the Quality Score of the Last Sample)
+	* @Func			sensorGetLedCharge									(Get the Charge Drawn by the LEDs)
+	* @Func			sensorGetLedPeakCurrent							(Get the Highest LED Pulse Current)
+	* @Func			sensorLedLevelLimit									(Limit the LED Current Levels)
 	*
 */
 
@@ -52,6 +91,10 @@
 #include "app_twi.h"
 #include "nrf_drv_rtc.h"
 #include "nrf_delay.h"
+#include "app_scheduler.h"
+#include "app_storage.h"
+#include "nrf_soc.h"
+#include "app_trace.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -76,6 +119,21 @@ typedef enum{
 	BLUE
 }led_type_t;
 
+/** @Type Sampling Modes
+	*
+	* @Brief SENSOR_SAMPLE_MODE_RGB 			: three LED exposures, R/G/B data (6 bytes) read per exposure, 18 bytes in total
+	* @Brief SENSOR_SAMPLE_MODE_RGBIR 		: three LED exposures, R/G/B/IR data (8 bytes) read per exposure, 24 bytes in total
+	* @Brief SENSOR_SAMPLE_MODE_AMBIENT 	: one exposure with all LEDs off, R/G/B/IR data (8 bytes), used as the dark-frame reference
+	*
+	* @Brief The data of every exposure is stored as high byte first in the register order (R, G, B, IR)
+	*
+*/
+typedef enum{
+	SENSOR_SAMPLE_MODE_RGB,
+	SENSOR_SAMPLE_MODE_RGBIR,
+	SENSOR_SAMPLE_MODE_AMBIENT
+}sensor_sample_mode_t;
+
 /** @Type Register Types
 	*
 	* @Brief This is an enumerate type representing the internal color sensor registers
@@ -122,6 +180,90 @@ typedef struct{
 	bool 		is_led_blue_on;
 }sensor_led_flags_t;
 
+/** @Type 	Data Type of A Chained Sensor Transaction
+	*
+	* @Brief 	This structure collects several register writes and reads into one TWI transaction (see sensorTransaction* functions)
+	* @Brief 	The written bytes are copied into the internal buffer, so the structure must stay valid until the transaction is finished
+	*
+*/
+typedef struct{
+	app_twi_transfer_t			transfers[SENSOR_TWI_MAX_TRANSFERS];
+	uint8_t									buffer[SENSOR_TWI_BUFFER_SIZE];
+	uint8_t									buffer_used;
+	uint8_t									number_of_transfers;
+	app_twi_transaction_t		transaction;
+}sensor_transaction_t;
+
+/** @Type 	States of the Non-blocking Sampling State Machine
+	*
+	* @Brief 	Each channel goes through start (LED current, LED on, setup, start) -> integrate -> read (burst read, sleep, LED off)
+	* @Brief 	SENSOR_STATE_START and SENSOR_STATE_READ are one chained TWI transaction each, which is advanced by its completion callback
+	* @Brief 	SENSOR_STATE_INTEGRATE is ended by the RTC2 compare event, so the CPU can sleep during the whole integration window
+	*
+*/
+typedef enum{
+	SENSOR_STATE_IDLE,
+	SENSOR_STATE_START,
+	SENSOR_STATE_INTEGRATE,
+	SENSOR_STATE_READ
+}sensor_state_t;
+
+/** @Type 	Data Type to Store the Context of the Non-blocking Sampling
+	*
+	* @Brief 	This structure records the current state, the channel being sampled, the destination array and the handler of the sample ready event
+	* @Brief 	The die temperature readings taken during the integrations are summed up to tag the sample
+	* @Brief 	exposure and retry count the exposures of the current channel, quality is the running quality score of the sample
+	*
+*/
+typedef struct{
+	sensor_state_t							state;
+	sensor_sample_mode_t				mode;
+	led_type_t									channel;
+	uint8_t										* array;
+	uint8_t											length;
+	app_sched_event_handler_t		ready_handler;
+	int32_t											temperature_sum;
+	uint8_t											temperature_count;
+	uint8_t											exposure;
+	uint8_t											retry;
+	uint8_t											quality;
+}sensor_sample_context_t;
+
+/** @Type 	Data Type of the Sample Ready Event Posted into the Scheduler
+	*
+	* @Brief 	This structure is passed as the event data of the sample ready event (It must fit into SCHED_MAX_EVENT_DATA_SIZE)
+	*
+*/
+typedef struct{
+	uint8_t			* array;
+	uint8_t				length;
+	uint8_t				mode;
+	uint8_t				err_code;
+	uint8_t				quality;
+	int16_t				temperature;
+}sensor_sample_evt_t;
+
+/** @Type 	Data Type to Store the Gain and Integration Time Settings
+	*
+	* @Brief 	gain 					: SENSOR_CTRL_GAIN_SELECT_HIGH or SENSOR_CTRL_GAIN_SELECT_LOW
+	* @Brief 	int_mode 			: SENSOR_CTRL_INT_MODE_FIXED_TIME or SENSOR_CTRL_INT_MODE_MANUAL_SETTING
+	* @Brief 	int_time 			: SENSOR_CTRL_INT_TIME_SETTING_32US ~ SENSOR_CTRL_INT_TIME_SETTING_131MS
+	* @Brief 	manual_timing : the number of integration time units in manual timing mode (1 ~ 65535)
+	*
+*/
+typedef struct{
+	uint8_t				gain;
+	uint8_t				int_mode;
+	uint8_t				int_time;
+	uint16_t			manual_timing;
+}sensor_exposure_t;
+
+/** @Type 	Methods to Combine the Exposures of One Channel */
+typedef enum{
+	SENSOR_REDUCE_MEDIAN,					// The median of the exposures
+	SENSOR_REDUCE_TRIMMED_MEAN		// The mean of the exposures without the minimum and the maximum (Plain mean below 3 exposures)
+}sensor_reduce_t;
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Function Declarations */
@@ -148,6 +290,43 @@ void sensorConfig(const uint8_t scl_pin_no, const uint8_t sda_pin_no, nrf_drv_rt
 */
 void sensorLedCurrentConfig(const uint8_t current, const led_type_t led_type);
 
+/** @Func 	Set the Sampling Mode
+	*
+	* @Brief	This function selects the channels exposed and the data read by sensorSampleColor and sensorSampleColorStart
+	*
+	* @Para		mode [sensor_sample_mode_t] : the sampling mode
+	*
+	* @Return NRF_SUCCESS 							: The mode is set
+	* @Return NRF_ERROR_INVALID_PARAM	: The mode is invalid
+	* @Return NRF_ERROR_BUSY						: A sample is in flight
+	*
+*/
+uint8_t sensorSampleModeConfig(const sensor_sample_mode_t mode);
+
+/** @Func 	Set the Number of Exposures per Channel and the Combining Method
+	*
+	* @Brief	Every channel is exposed the specified number of times and the exposures are combined word by word
+	* @Brief	An exposure reading all zeros is discarded and retried (up to SENSOR_EXPOSURE_MAX_RETRY times per channel)
+	*
+	* @Para		count 	[uint8_t] 				: the number of exposures per channel (1 ~ SENSOR_OVERSAMPLE_MAX)
+	* @Para		method 	[sensor_reduce_t] : the combining method
+	*
+	* @Return NRF_SUCCESS 							: The operation succeeded
+	* @Return NRF_ERROR_INVALID_PARAM	: The settings are out of range
+	* @Return NRF_ERROR_BUSY 						: A non-blocking color sample is in flight
+	*
+*/
+uint8_t sensorOversampleConfig(const uint8_t count, const sensor_reduce_t method);
+
+/** @Func 	Get the Data Size of One Sample in the Specified Sampling Mode
+	*
+	* @Para		mode [sensor_sample_mode_t] : the sampling mode
+	*
+	* @Return	[uint8_t] : the number of data bytes of one sample (0 for an invalid mode)
+	*
+*/
+uint8_t sensorSampleDataSize(const sensor_sample_mode_t mode);
+
 /** @Func 	Write a Byte Array into the Sensor Register from the Specified Address
 	*
 	* @Brief 	This function writes a byte array into the specified register address through the TWI interface
@@ -178,6 +357,109 @@ uint8_t sensorReadByteArray(uint8_t * byte_array, const uint8_t array_length, co
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/* Transaction Builder Functions */
+
+/** @Func 	Initialize an Empty Sensor Transaction
+	*
+	* @Para		p_trans [sensor_transaction_t*] : the transaction to be initialized
+	*
+*/
+void sensorTransactionInit(sensor_transaction_t * p_trans);
+
+/** @Func 	Append a Register Write to the Sensor Transaction
+	*
+	* @Brief	This function appends one write transfer (register address followed by the data bytes) to the transaction
+	*
+	* @Para		p_trans 		[sensor_transaction_t*] : the transaction to be appended to
+	* @Para		reg_address	[uint8_t]								: the register address of the color sensor
+	* @Para		data				[uint8_t*]							: the data bytes to be written (copied into the transaction)
+	* @Para		length			[uint8_t]								: the number of data bytes
+	*
+	* @Return NRF_SUCCESS 		: The transfer is appended
+	* @Return NRF_ERROR_NO_MEM	: The transaction is full (see SENSOR_TWI_MAX_TRANSFERS and SENSOR_TWI_BUFFER_SIZE)
+	*
+*/
+uint8_t sensorTransactionAddWrite(sensor_transaction_t * p_trans, const uint8_t reg_address, uint8_t const * data, const uint8_t length);
+
+/** @Func 	Append a Register Burst Read to the Sensor Transaction
+	*
+	* @Brief	This function appends the register address write (repeated start) and one burst read to the transaction
+	*
+	* @Para		p_trans 			[sensor_transaction_t*] : the transaction to be appended to
+	* @Para		reg_address		[uint8_t]								: the first register address to be read
+	* @Para		byte_array		[uint8_t*]							: the address of the byte array to be read into
+	* @Para		array_length	[uint8_t]								: the number of bytes to be read
+	*
+	* @Return NRF_SUCCESS 		: The transfers are appended
+	* @Return NRF_ERROR_NO_MEM	: The transaction is full
+	*
+*/
+uint8_t sensorTransactionAddRead(sensor_transaction_t * p_trans, const uint8_t reg_address, uint8_t * byte_array, const uint8_t array_length);
+
+/** @Func 	Append the Start Sequence of A Channel to the Sensor Transaction
+	*
+	* @Brief	This function appends the LED current, LED on, timing setup and sampling commands of the specified channel
+	*
+	* @Para		p_trans 	[sensor_transaction_t*] : the transaction to be appended to
+	* @Para		led_type	[led_type_t]						: the LED of the channel which should be choosen from RED, GREEN, and BLUE
+	*
+	* @Return NRF_SUCCESS 		: The transfers are appended
+	* @Return NRF_ERROR_NO_MEM	: The transaction is full
+	* @Return NRF_ERROR_INVALID_PARAM : The LED type is invalid
+	*
+*/
+uint8_t sensorTransactionAddChannelStart(sensor_transaction_t * p_trans, const led_type_t led_type);
+
+/** @Func 	Append the Start Sequence of An Ambient Exposure to the Sensor Transaction
+	*
+	* @Brief	This function appends the all-LEDs-off, timing setup and sampling commands
+	*
+	* @Para		p_trans [sensor_transaction_t*] : the transaction to be appended to
+	*
+	* @Return NRF_SUCCESS 		: The transfers are appended
+	* @Return NRF_ERROR_NO_MEM	: The transaction is full
+	*
+*/
+uint8_t sensorTransactionAddAmbientStart(sensor_transaction_t * p_trans);
+
+/** @Func 	Append the Stop Sequence of A Channel to the Sensor Transaction
+	*
+	* @Brief	This function appends the sensor sleep and LED off commands
+	*
+	* @Para		p_trans [sensor_transaction_t*] : the transaction to be appended to
+	*
+	* @Return NRF_SUCCESS 		: The transfers are appended
+	* @Return NRF_ERROR_NO_MEM	: The transaction is full
+	*
+*/
+uint8_t sensorTransactionAddChannelStop(sensor_transaction_t * p_trans);
+
+/** @Func 	Perform the Sensor Transaction in Blocking Mode
+	*
+	* @Para		p_trans [sensor_transaction_t*] : the transaction to be performed
+	*
+	* @Return NRF_SUCCESS : The operation succeeded
+	* @Return Propagate the TWI operation errors
+	*
+*/
+uint8_t sensorTransactionPerform(sensor_transaction_t * p_trans);
+
+/** @Func 	Schedule the Sensor Transaction in Non-blocking Mode
+	*
+	* @Brief	This function queues the transaction into the TWI transaction manager and returns immediately
+	*
+	* @Para		p_trans 		[sensor_transaction_t*] : the transaction to be scheduled (It must stay valid until the callback is called)
+	* @Para		callback		[app_twi_callback_t]		: the function to be called when the transaction is finished
+	* @Para		p_user_data	[void*]									: the user data passed to the callback
+	*
+	* @Return NRF_SUCCESS : The transaction is queued
+	* @Return Propagate the TWI transaction manager errors
+	*
+*/
+uint8_t sensorTransactionSchedule(sensor_transaction_t * p_trans, app_twi_callback_t callback, void * p_user_data);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /** @Func 	Turn On A Specified LED
 	*
 	* @Brief 	This function turns on the specified LED by setting its current to non-zero value and setting the currents of other LEDs to zero
@@ -247,11 +529,81 @@ uint8_t sensorReadData(uint8_t * byte_array, const uint8_t array_length);
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/* Exposure Control Functions */
+
+/** @Func 	Set the Gain and Integration Time Settings
+	*
+	* @Brief	This function replaces the exposure settings used by all the following samples
+	*
+	* @Para		p_exposure [sensor_exposure_t*] : the new exposure settings
+	*
+	* @Return NRF_SUCCESS 							: The operation succeeded
+	* @Return NRF_ERROR_INVALID_PARAM	: The settings are out of range
+	* @Return NRF_ERROR_BUSY 						: A non-blocking color sample is in flight
+	*
+*/
+uint8_t sensorExposureConfig(sensor_exposure_t const * p_exposure);
+
+/** @Func 	Get the Gain and Integration Time Settings
+	*
+	* @Para		p_exposure [sensor_exposure_t*] : the structure to be written into
+	*
+*/
+void sensorGetExposure(sensor_exposure_t * p_exposure);
+
+/** @Func 	Enable or Disable the Auto-exposure Controller
+	*
+	* @Brief	When enabled, the exposure settings and the LED currents are adjusted after every successful color sample
+	*
+	* @Para		is_enabled [bool] : true to enable the controller
+	*
+*/
+void sensorAutoExposureEnable(const bool is_enabled);
+
+/** @Func 	Adjust the Exposure Settings from the Previous Reading
+	*
+	* @Brief	The LED current of each channel is stepped to keep its own colour reading inside the target window
+	* @Brief	The shared integration time (and gain) is scaled so that the brightest channel lands on SENSOR_AE_TARGET without saturating
+	* @Brief	Only one control acts per reading: the integration time is scaled once no LED level has moved (settled or at its limits)
+	* @Brief	Ambient samples are ignored
+	*
+	* @Para		byte_array 	[uint8_t*] 							: the sample data read in the specified mode
+	* @Para		mode 				[sensor_sample_mode_t] 	: the sampling mode of the sample data
+	*
+*/
+void sensorAutoExposureUpdate(uint8_t const * byte_array, const sensor_sample_mode_t mode);
+
+/** @Func 	Load the Sensor Settings from the SET_DATA_SENR_* Records
+	*
+	* @Brief	This function loads the gain, integration time and LED current settings saved in flash
+	*
+	* @Return FLASH_STATUS_SUCCESS 		: The settings are loaded
+	* @Return FLASH_STATUS_READ_ERR 	: The saved settings are invalid (The current settings are kept)
+	* @Return Propagate the storage errors
+	*
+*/
+flash_status_t sensorSettingsLoad(void);
+
+/** @Func 	Save the Sensor Settings into the SET_DATA_SENR_* Records
+	*
+	* @Brief	This function writes the settings only if they have changed and the auto-exposure controller has settled,
+	* @Brief	so a converging sequence of samples costs one flash write
+	*
+	* @Return FLASH_STATUS_SUCCESS : The settings are saved (or nothing needs to be saved)
+	* @Return Propagate the storage errors
+	*
+*/
+flash_status_t sensorSettingsSave(void);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /* Top Layer Functions */
 
 /** @Func 	Sampling From All Three Channels
 	*
 	*	@Brief	This function takes the color sensor data for all three RGB channels
+	* @Brief	The exposures and the data read depend on the sampling mode (see sensorSampleModeConfig)
+	* @Brief	In non-blocking mode, this function only starts the sampling (see sensorSampleColorStart) and no event is posted
 	*
 	* @Para		byte_array 		[uint8_t*] 	: the address of the byte array to be read into
 	* @Para		array_length 	[uint8_t]		: the length of the byte array to be read into
@@ -262,6 +614,24 @@ uint8_t sensorReadData(uint8_t * byte_array, const uint8_t array_length);
 */
 uint8_t sensorSampleColor(uint8_t * byte_array, const uint8_t array_length);
 
+/** @Func 	Start Sampling From All Three Channels in Non-blocking Mode
+	*
+	*	@Brief	This function starts the sampling state machine and returns immediately
+	* @Brief	The exposures are sampled one after another by TWI transaction callbacks and the RTC2 compare event
+	* @Brief	When all sensorSampleDataSize() bytes of the current sampling mode are read, a single sample ready event (sensor_sample_evt_t) is posted into the scheduler
+	*
+	* @Para		byte_array 					[uint8_t*] 									: the address of the byte array to be read into (It must stay valid until the event is posted)
+	* @Para		array_length 				[uint8_t]										: the length of the byte array to be read into
+	* @Para		sample_ready_handler [app_sched_event_handler_t] : the scheduler event handler of the sample ready event (NULL means no event is posted)
+	*
+	* @Return NRF_SUCCESS 							: The sampling is started
+	* @Return NRF_ERROR_INVALID_LENGTH	: The array is shorter than the data size of the current sampling mode
+	* @Return NRF_ERROR_INVALID_STATE	: The module is not configured in non-blocking mode with the default RTC event handler
+	* @Return NRF_ERROR_BUSY						: Another sample is in flight
+	*
+*/
+uint8_t sensorSampleColorStart(uint8_t * byte_array, const uint8_t array_length, app_sched_event_handler_t sample_ready_handler);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Accessor Functions */
@@ -305,6 +675,68 @@ bool sensorIsGreenOn(void);
 */
 bool sensorIsBlueOn(void);
 
+/** @Func 	Test Whether A Non-blocking Color Sample is in Flight
+	*
+	* @Brief	This function returns the status of the sampling state machine
+	*
+	* @Return true 	[bool] : A sample is in flight
+	* @Return	false [bool] : The state machine is idle
+	*
+*/
+bool sensorIsSampling(void);
+
+/** @Func 	Get the Die Temperature Tag of the Last Sample
+	*
+	* @Brief	The die temperature is read through the SoftDevice while the LEDs integrate, and averaged over the exposures of the sample
+	*
+	* @Return	[int16_t] : the die temperature in 0.25 degC units (SENSOR_TEMPERATURE_INVALID if no reading was available)
+	*
+*/
+int16_t sensorGetSampleTemperature(void);
+
+/** @Func 	Get the Quality Score of the Last Sample
+	*
+	* @Brief	The score starts at SENSOR_QUALITY_MAX and is lowered by retried exposures, kept zero-readings, saturation and the spread of the exposures
+	*
+	* @Return	[uint8_t] : the quality score (0 ~ SENSOR_QUALITY_MAX)
+	*
+*/
+uint8_t sensorGetSampleQuality(void);
+
+/** @Func 	Get the Charge Drawn by the LEDs
+	*
+	* @Brief	The on-time of each LED is timed with the app timer and multiplied by its drive current when it is turned off
+	* @Brief	The battery module uses the difference between two readings as the LED part of the consumed charge
+	*
+	* @Return	[uint32_t] : the charge drawn since the boot in microcoulomb (wraps around)
+	*
+*/
+uint32_t sensorGetLedCharge(void);
+
+/** @Func 	Get the Highest LED Pulse Current
+	*
+	* @Return	[uint32_t] : the drive current of the strongest LED in microampere (with the upper limit applied)
+	*
+*/
+uint32_t sensorGetLedPeakCurrent(void);
+
+/** @Func 	Limit the LED Current Levels
+	*
+	* @Brief	The LEDs are driven at most at this level, whatever the settings and the auto-exposure controller ask for
+	* @Brief	The settings themselves are kept, so the full current comes back when the limit is raised again
+	*
+	* @Para		max_level [uint8_t] : the highest LED current level (0 ~ SENSOR_AE_LED_LEVEL_MAX)
+	*
+*/
+void sensorLedLevelLimit(const uint8_t max_level);
+
+/** @Func 	Get the Current Sampling Mode
+	*
+	* @Return	[sensor_sample_mode_t] : the current sampling mode
+	*
+*/
+sensor_sample_mode_t sensorGetSampleMode(void);
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 /* C++ Library Header */
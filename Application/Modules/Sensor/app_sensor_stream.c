@@ -0,0 +1,187 @@
+/** Library Name : app_sensor_stream.c
+	*
+	* @Brief 		Implementation of the continuous (streaming) acquisition mode of the color sensor
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include <stddef.h>
+#include "app_sensor_stream.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Sample Ring (Produced in the scheduler context and consumed by the application) */
+NRF_QUEUE_DEF(sensor_stream_sample_t, sensor_stream_queue, SENSOR_STREAM_QUEUE_SIZE, NRF_QUEUE_MODE_NO_OVERFLOW);
+
+/** @Variable The Repeated Timer Triggering the Samples */
+APP_TIMER_DEF(sensor_stream_timer_id);
+
+/** @Variable The Samples Being Acquired or Waiting to be Pushed (A new sample is started while the previous one waits for the scheduler) */
+static sensor_stream_sample_t sensor_stream_pending[SENSOR_STREAM_PENDING_NUM];
+
+/** @Variable The Number of Pending Samples in Use (Taken in the timer context, released in the scheduler context) */
+static volatile uint8_t sensor_stream_pending_busy = 0;
+
+/** @Variable The Next Pending Sample to be Started */
+static uint8_t sensor_stream_pending_head = 0;
+
+/** @Variable The Sequence Number of the Next Triggered Sample */
+static uint16_t sensor_stream_sequence = 0;
+
+/** @Variable The Streaming Statistics */
+static sensor_stream_stats_t sensor_stream_stats;
+
+/** @Variable The Streaming Running Flag */
+static bool is_sensor_stream_running = false;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Release the Oldest Pending Sample */
+static void sensor_stream_pending_release(void)
+{
+	CRITICAL_REGION_ENTER();
+	sensor_stream_pending_busy--;
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Sample Ready Event Handler (Scheduler Context) */
+static void sensor_stream_ready_handler(void * p_event_data, uint16_t event_size)
+{
+	sensor_sample_evt_t const * p_evt = (sensor_sample_evt_t const *)p_event_data;
+	
+	// The event carries the data array of the pending sample it finished
+	sensor_stream_sample_t * p_pending = (sensor_stream_sample_t *)((uint8_t *)p_evt->array - offsetof(sensor_stream_sample_t, data));
+
+	if(p_evt->err_code != NRF_SUCCESS){
+		sensor_stream_pending_release();
+		sensor_stream_stats.failed++;
+		return;
+	}
+
+	p_pending->mode 				= p_evt->mode;
+	p_pending->length 			= sensorSampleDataSize((sensor_sample_mode_t)p_evt->mode);
+	p_pending->temperature 	= p_evt->temperature;
+	p_pending->quality 			= p_evt->quality;
+
+	// Push the sample into the ring (Rejected if the consumer has not drained the ring in time)
+	ret_code_t err_code = nrf_queue_push(&sensor_stream_queue, p_pending);
+	sensor_stream_pending_release();
+	if(err_code != NRF_SUCCESS){
+		sensor_stream_stats.dropped++;
+		return;
+	}
+	sensor_stream_stats.produced++;
+
+	uint32_t utilization = nrf_queue_utilization_get(&sensor_stream_queue);
+	if(utilization > sensor_stream_stats.max_utilization){
+		sensor_stream_stats.max_utilization = utilization;
+	}
+}
+
+/** @Func Stream Timer Time-out Handler */
+static void sensor_stream_timer_handler(void * p_context)
+{
+	uint16_t sequence = sensor_stream_sequence++;
+
+	// The previous sample (or a one-shot sample) is still in flight, or every pending sample still waits to be pushed
+	if(sensorIsSampling() || sensor_stream_pending_busy >= SENSOR_STREAM_PENDING_NUM){
+		sensor_stream_stats.missed++;
+		return;
+	}
+
+	// The timestamp and the sequence number stay with the sample until it is pushed
+	sensor_stream_sample_t * p_pending = &sensor_stream_pending[sensor_stream_pending_head];
+	p_pending->timestamp 	= app_timer_cnt_get();
+	p_pending->sequence		= sequence;
+
+	if(sensorSampleColorStart(p_pending->data, SENSOR_SAMPLE_MAX_DATA_SIZE, sensor_stream_ready_handler) != NRF_SUCCESS){
+		sensor_stream_stats.missed++;
+		return;
+	}
+	sensor_stream_pending_busy++;
+	sensor_stream_pending_head = (sensor_stream_pending_head + 1) % SENSOR_STREAM_PENDING_NUM;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Initialization of the Streaming Module */
+void sensorStreamInit(void)
+{
+	APP_ERROR_CHECK(app_timer_create(&sensor_stream_timer_id, APP_TIMER_MODE_REPEATED, sensor_stream_timer_handler));
+	nrf_queue_reset(&sensor_stream_queue);
+	sensorStreamResetStats();
+}
+
+/** @Func Start Streaming at the Specified Rate */
+uint8_t sensorStreamStart(const uint8_t rate)
+{
+	if(rate == 0 || rate > SENSOR_STREAM_MAX_RATE){
+		return NRF_ERROR_INVALID_PARAM;
+	}
+
+	// Restart the timer with the new period
+	if(is_sensor_stream_running){
+		app_timer_stop(sensor_stream_timer_id);
+	}
+
+	uint8_t err_code = app_timer_start(sensor_stream_timer_id, APP_TIMER_TICKS(1000/rate, SENSOR_STREAM_TIMER_PRESCALER), NULL);
+	is_sensor_stream_running = (err_code == NRF_SUCCESS);
+	return err_code;
+}
+
+/** @Func Stop Streaming */
+uint8_t sensorStreamStop(void)
+{
+	uint8_t err_code = app_timer_stop(sensor_stream_timer_id);
+	if(err_code == NRF_SUCCESS){
+		is_sensor_stream_running = false;
+	}
+	return err_code;
+}
+
+/** @Func Drain a Batch of Samples out of the Ring */
+uint16_t sensorStreamRead(sensor_stream_sample_t * p_samples, const uint16_t max_count)
+{
+	return (uint16_t)nrf_queue_out(&sensor_stream_queue, p_samples, max_count);
+}
+
+/** @Func Get the Number of Samples in the Ring */
+uint16_t sensorStreamAvailable(void)
+{
+	return (uint16_t)nrf_queue_utilization_get(&sensor_stream_queue);
+}
+
+/** @Func Get the Streaming Statistics */
+void sensorStreamGetStats(sensor_stream_stats_t * p_stats)
+{
+	CRITICAL_REGION_ENTER();
+	*p_stats = sensor_stream_stats;
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Reset the Streaming Statistics */
+void sensorStreamResetStats(void)
+{
+	CRITICAL_REGION_ENTER();
+	memset(&sensor_stream_stats, 0, sizeof(sensor_stream_stats));
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Test Whether the Streaming Mode is Running */
+bool sensorStreamIsRunning(void)
+{
+	return is_sensor_stream_running;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
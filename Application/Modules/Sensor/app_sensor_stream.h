@@ -0,0 +1,179 @@
+/** Library Name : app_sensor_stream.h
+	*
+	* @Brief 		This module implements the continuous (streaming) acquisition mode of the color sensor
+	* @Brief		Samples are taken at a configurable rate and stored with timestamps in a single-producer/single-consumer ring
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Req			This module requires the following modules to be enabled
+	* @Req			- Color Sensor Module (Non-blocking Mode)	(Included in "app_sensor.h")
+	* @Req			- App Timer													(Configured in "sdk_config.h")
+	* @Req			- NRF Queue													(Configured in "sdk_config.h")
+	*
+	* @Type			sensor_stream_sample_t							(Data Type of One Timestamped Color Sample in the Ring)
+	* @Type			sensor_stream_stats_t								(Data Type to Store the Streaming Statistics and Overrun Counters)
+	*
+	* @Func			sensorStreamInit										(Initialization of the Streaming Module)
+	* @Func			sensorStreamStart										(Start Streaming at the Specified Rate)
+	* @Func			sensorStreamStop										(Stop Streaming)
+	* @Func			sensorStreamRead										(Drain a Batch of Samples out of the Ring)
+	* @Func			sensorStreamAvailable								(Get the Number of Samples in the Ring)
+	* @Func			sensorStreamGetStats								(Get the Streaming Statistics)
+	* @Func			sensorStreamResetStats							(Reset the Streaming Statistics)
+	* @Func			sensorStreamIsRunning								(Test Whether the Streaming Mode is Running)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __APP_SENSOR_STREAM_H__
+#define __APP_SENSOR_STREAM_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include "app_sensor.h"
+#include "app_timer.h"
+#include "nrf_queue.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Header */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Type Declarations */
+
+/** @Type 	Data Type of One Timestamped Color Sample in the Ring
+	*
+	* @Brief 	The timestamp is the RTC1 (app_timer) counter value when the sample was triggered
+	* @Brief 	The sequence number increases by one for every triggered sample, so gaps show the missed or dropped samples
+	* @Brief 	The mode and length fields record the sampling mode (sensor_sample_mode_t) and the valid bytes in data
+	* @Brief 	The temperature field is the die temperature tag of the sample (0.25 degC units), the quality field its quality score
+	*
+*/
+typedef struct{
+	uint32_t				timestamp;
+	uint16_t				sequence;
+	uint8_t					mode;
+	uint8_t					length;
+	int16_t					temperature;
+	uint8_t					quality;
+	uint8_t					data[SENSOR_SAMPLE_MAX_DATA_SIZE];
+}sensor_stream_sample_t;
+
+/** @Type 	Data Type to Store the Streaming Statistics and Overrun Counters
+	*
+	* @Brief 	produced 				: the number of samples pushed into the ring
+	* @Brief 	dropped 				: the number of finished samples lost because the ring was full (consumer overrun)
+	* @Brief 	missed 					: the number of triggers skipped because the previous sample was still in flight (producer overrun)
+	* @Brief 	failed 					: the number of samples aborted by TWI errors
+	* @Brief 	max_utilization	: the peak number of samples held in the ring
+	*
+*/
+typedef struct{
+	uint32_t				produced;
+	uint32_t				dropped;
+	uint32_t				missed;
+	uint32_t				failed;
+	uint32_t				max_utilization;
+}sensor_stream_stats_t;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func 	Initialization of the Streaming Module
+	*
+	* @Brief	This function creates the repeated app timer that triggers the samples and empties the ring
+	* @Brief	The sensor module must be configured in non-blocking mode (sensorConfig) before streaming is started
+	*
+*/
+void sensorStreamInit(void);
+
+/** @Func 	Start Streaming at the Specified Rate
+	*
+	* @Brief	This function starts taking color samples at the specified rate
+	* @Brief	A trigger is skipped (and counted as missed) if the previous sample has not finished yet,
+	* @Brief	or if SENSOR_STREAM_PENDING_NUM finished samples are still waiting for the scheduler to push them
+	*
+	* @Para		rate [uint8_t] : the number of samples per second (1 ~ SENSOR_STREAM_MAX_RATE)
+	*
+	* @Return NRF_SUCCESS 							: The streaming is started
+	* @Return NRF_ERROR_INVALID_PARAM	: The rate is out of range
+	* @Return	Propagate the app timer errors
+	*
+*/
+uint8_t sensorStreamStart(const uint8_t rate);
+
+/** @Func 	Stop Streaming
+	*
+	* @Brief	This function stops triggering new samples (A sample in flight is still pushed into the ring when it finishes)
+	*
+	* @Return NRF_SUCCESS : The operation succeeded
+	* @Return	Propagate the app timer errors
+	*
+*/
+uint8_t sensorStreamStop(void);
+
+/** @Func 	Drain a Batch of Samples out of the Ring
+	*
+	* @Brief	This function copies up to max_count of the oldest samples out of the ring
+	*
+	* @Para		p_samples [sensor_stream_sample_t*] : the array to be read into
+	* @Para		max_count	[uint16_t]								: the maximum number of samples to be read
+	*
+	* @Return	[uint16_t] : the number of samples actually read
+	*
+*/
+uint16_t sensorStreamRead(sensor_stream_sample_t * p_samples, const uint16_t max_count);
+
+/** @Func 	Get the Number of Samples in the Ring
+	*
+	* @Return	[uint16_t] : the number of samples waiting to be read
+	*
+*/
+uint16_t sensorStreamAvailable(void);
+
+/** @Func 	Get the Streaming Statistics
+	*
+	* @Brief	This function copies the statistics and overrun counters into the specified structure
+	*
+	* @Para		p_stats [sensor_stream_stats_t*] : the structure to be written into
+	*
+*/
+void sensorStreamGetStats(sensor_stream_stats_t * p_stats);
+
+/** @Func 	Reset the Streaming Statistics
+	*
+	* @Brief	This function clears all the counters (The samples in the ring are kept)
+	*
+*/
+void sensorStreamResetStats(void);
+
+/** @Func 	Test Whether the Streaming Mode is Running
+	*
+	* @Return true 	[bool] : The streaming mode is running
+	* @Return	false [bool] : The streaming mode is stopped
+	*
+*/
+bool sensorStreamIsRunning(void);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Library Header */
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //__APP_SENSOR_STREAM_H__
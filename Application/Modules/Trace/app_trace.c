@@ -0,0 +1,202 @@
+/** Library Name : app_trace.c
+	*
+	* @Brief 		Implementation of the latency trace of the sample path
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include "app_trace.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if APP_TRACE_ENABLED
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Root Stage (No Parent) */
+#define APP_TRACE_ROOT																			APP_TRACE_STAGE_NUM
+
+/** @Macro DWT Cycles per Microsecond (64 MHz CPU Clock) */
+#define APP_TRACE_CYCLES_PER_US															(SystemCoreClock / 1000000)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Parent of Each Stage */
+static const uint8_t app_trace_parent[APP_TRACE_STAGE_NUM] = {
+	APP_TRACE_ROOT,											// APP_TRACE_SENSOR_REQUEST
+	APP_TRACE_SENSOR_REQUEST,						// APP_TRACE_SENSOR_START
+	APP_TRACE_ROOT,											// APP_TRACE_SENSOR_EXPOSURE
+	APP_TRACE_SENSOR_EXPOSURE,					// APP_TRACE_SENSOR_TWI_START
+	APP_TRACE_SENSOR_TWI_START,					// APP_TRACE_SENSOR_INTEGRATE
+	APP_TRACE_SENSOR_INTEGRATE,					// APP_TRACE_SENSOR_TWI_READ
+	APP_TRACE_SENSOR_START,							// APP_TRACE_SENSOR_DONE
+	APP_TRACE_SENSOR_DONE,							// APP_TRACE_SENSOR_DISPATCH
+	APP_TRACE_SENSOR_DISPATCH,					// APP_TRACE_SENSOR_CONSUMED
+	APP_TRACE_ROOT,											// APP_TRACE_ADC_START
+	APP_TRACE_ADC_START,								// APP_TRACE_ADC_DONE
+};
+
+/** @Variable The Name of Each Stage (Log Output) */
+static const char * const app_trace_name[APP_TRACE_STAGE_NUM] = {
+	"REQUEST", "START", "EXPOSURE", "TWI_START", "INTEGRATE", "TWI_READ", "DONE", "DISPATCH", "CONSUMED", "ADC_START", "ADC_DONE",
+};
+
+/** @Variable The Timestamp Ring */
+static app_trace_record_t app_trace_ring[APP_TRACE_RING_SIZE];
+static uint8_t app_trace_ring_head = 0;
+static uint8_t app_trace_ring_count = 0;
+
+/** @Variable The Last Cycle Count of Each Stage (Consumed by the First Child Stage) */
+static uint32_t app_trace_last_cycles[APP_TRACE_STAGE_NUM];
+static bool is_app_trace_last_valid[APP_TRACE_STAGE_NUM];
+
+/** @Variable The Statistics of Each Stage */
+static app_trace_stats_t app_trace_stats[APP_TRACE_STAGE_NUM];
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Accumulate One Stage Time into the Statistics */
+static void app_trace_stats_add(app_trace_stats_t * p_stats, const uint32_t time_us)
+{
+	if(p_stats->count == 0 || time_us < p_stats->min_us){
+		p_stats->min_us = time_us;
+	}
+	if(time_us > p_stats->max_us){
+		p_stats->max_us = time_us;
+	}
+	p_stats->sum_us += time_us;
+	p_stats->count++;
+
+	// Log2 bin (Bin 0 also holds 0 us, the last bin holds everything above)
+	uint8_t bin = 0;
+	uint32_t value = time_us >> 1;
+	while(value != 0 && bin < APP_TRACE_HIST_BINS - 1){
+		value >>= 1;
+		bin++;
+	}
+	if(p_stats->hist[bin] != UINT16_MAX){
+		p_stats->hist[bin]++;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** @Func Initialization of the Trace Module */
+void appTraceInit(void)
+{
+	// Enable the trace block and start the cycle counter
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	appTraceReset();
+}
+
+/** @Func Timestamp A Stage Boundary */
+void appTraceMark(const app_trace_stage_t stage)
+{
+	if(stage >= APP_TRACE_STAGE_NUM){
+		return;
+	}
+
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t ticks 	= app_timer_cnt_get();
+
+	CRITICAL_REGION_ENTER();
+
+	// Ring (Overwrite the oldest timestamp when full)
+	app_trace_record_t * p_record = &app_trace_ring[app_trace_ring_head];
+	p_record->cycles 	= cycles;
+	p_record->ticks 	= ticks;
+	p_record->stage 	= (uint8_t)stage;
+	app_trace_ring_head = (app_trace_ring_head + 1) % APP_TRACE_RING_SIZE;
+	if(app_trace_ring_count < APP_TRACE_RING_SIZE){
+		app_trace_ring_count++;
+	}
+
+	// Time from the parent stage (The unsigned difference is correct across one counter wrap)
+	uint8_t parent = app_trace_parent[stage];
+	if(parent != APP_TRACE_ROOT && is_app_trace_last_valid[parent]){
+		app_trace_stats_add(&app_trace_stats[stage], (cycles - app_trace_last_cycles[parent]) / APP_TRACE_CYCLES_PER_US);
+		is_app_trace_last_valid[parent] = false;
+	}
+	app_trace_last_cycles[stage] 		= cycles;
+	is_app_trace_last_valid[stage] 	= true;
+
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Get the Statistics of One Stage */
+void appTraceGetStats(const app_trace_stage_t stage, app_trace_stats_t * p_stats)
+{
+	if(stage >= APP_TRACE_STAGE_NUM){
+		memset(p_stats, 0, sizeof(app_trace_stats_t));
+		return;
+	}
+
+	CRITICAL_REGION_ENTER();
+	*p_stats = app_trace_stats[stage];
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Copy the Latest Timestamps out of the Ring */
+uint8_t appTraceRead(app_trace_record_t * p_records, const uint8_t max_count)
+{
+	CRITICAL_REGION_ENTER();
+
+	uint8_t count = (max_count < app_trace_ring_count) ? max_count : app_trace_ring_count;
+	uint8_t index = (app_trace_ring_head + APP_TRACE_RING_SIZE - count) % APP_TRACE_RING_SIZE;
+	for(uint8_t i = 0; i < count; i++){
+		p_records[i] = app_trace_ring[index];
+		index = (index + 1) % APP_TRACE_RING_SIZE;
+	}
+
+	CRITICAL_REGION_EXIT();
+
+	return count;
+}
+
+/** @Func Clear the Ring and the Statistics */
+void appTraceReset(void)
+{
+	CRITICAL_REGION_ENTER();
+	app_trace_ring_head 	= 0;
+	app_trace_ring_count 	= 0;
+	memset(is_app_trace_last_valid, 0, sizeof(is_app_trace_last_valid));
+	memset(app_trace_stats, 0, sizeof(app_trace_stats));
+	CRITICAL_REGION_EXIT();
+}
+
+/** @Func Print the Statistics through NRF_LOG */
+void appTraceDump(void)
+{
+	app_trace_stats_t stats;
+
+	for(uint8_t stage = 0; stage < APP_TRACE_STAGE_NUM; stage++){
+		appTraceGetStats((app_trace_stage_t)stage, &stats);
+		if(stats.count == 0){
+			continue;
+		}
+		NRF_LOG_INFO("%s n=%d\r\n", (uint32_t)app_trace_name[stage], stats.count);
+		NRF_LOG_INFO("  min %d avg %d max %d us\r\n", stats.min_us, (uint32_t)(stats.sum_us / stats.count), stats.max_us);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //APP_TRACE_ENABLED
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,186 @@
+/** Library Name : app_trace.h
+	*
+	* @Brief 		This module implements a lightweight latency trace of the sample path using the DWT cycle counter
+	* @Brief		Every stage boundary is timestamped (CPU cycles and RTC1 ticks) into a fixed RAM ring,
+	* @Brief		and the time from the parent stage is accumulated into min/avg/max statistics and a log2 histogram
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Req			This module requires the following modules to be enabled
+	* @Req			- DWT Cycle Counter (Cortex-M4)			(Included in "nrf.h")
+	* @Req			- App Timer													(Configured in "sdk_config.h")
+	* @Req			- NRF Log														(Configured in "sdk_config.h")
+	*
+	* @Macro		APP_TRACE_ENABLED										(Compile the Trace in (1) or Remove All Trace Macros (0))
+	* @Macro		APP_TRACE_RING_SIZE									(Number of Timestamps Kept in the Ring)
+	* @Macro		APP_TRACE_HIST_BINS									(Number of Log2 Histogram Bins, Bin i Holds [2^i, 2^(i+1)) us)
+	* @Macro		APP_TRACE_INIT											(Initialization of the Trace Module)
+	* @Macro		APP_TRACE														(Timestamp A Stage Boundary)
+	* @Macro		APP_TRACE_DUMP											(Print the Statistics through NRF_LOG)
+	*
+	* @Type			app_trace_stage_t										(Stage Boundaries of the Sample Path)
+	* @Type			app_trace_record_t									(Data Type of One Timestamp in the Ring)
+	* @Type			app_trace_stats_t										(Data Type of the Statistics of One Stage)
+	*
+	* @Func			appTraceInit												(Initialization of the Trace Module)
+	* @Func			appTraceMark												(Timestamp A Stage Boundary)
+	* @Func			appTraceGetStats										(Get the Statistics of One Stage)
+	* @Func			appTraceRead												(Copy the Latest Timestamps out of the Ring)
+	* @Func			appTraceReset												(Clear the Ring and the Statistics)
+	* @Func			appTraceDump												(Print the Statistics through NRF_LOG)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __APP_TRACE_H__
+#define __APP_TRACE_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf.h"
+#include "app_util_platform.h"
+#include "app_timer.h"
+#include "nrf_log.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Header */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Trace Switch (Define APP_TRACE_ENABLED=1 in the Project to Compile the Trace in) */
+#ifndef APP_TRACE_ENABLED
+#define APP_TRACE_ENABLED																		0
+#endif
+
+/** @Macro Trace Storage */
+#define APP_TRACE_RING_SIZE																	32
+#define APP_TRACE_HIST_BINS																	20		// Up to 2^20 us (about one second)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Type Declarations */
+
+/** @Type 	Stage Boundaries of the Sample Path
+	*
+	* @Brief 	The statistics of a stage measure the time from the last boundary of its parent stage (shown in brackets)
+	* @Brief 	A stage whose parent has not been marked since its previous use is only timestamped
+	*
+*/
+typedef enum{
+	APP_TRACE_SENSOR_REQUEST,						// Sample requested by the board event (Root)
+	APP_TRACE_SENSOR_START,							// Sample started in the sensor module (Request : scheduler queueing)
+	APP_TRACE_SENSOR_EXPOSURE,					// Start transaction of one exposure queued (Root)
+	APP_TRACE_SENSOR_TWI_START,					// LED on and sampling command sent (Exposure : TWI queueing and transfer, LED switching)
+	APP_TRACE_SENSOR_INTEGRATE,					// RTC2 integration wait elapsed (TWI start : integration wait)
+	APP_TRACE_SENSOR_TWI_READ,					// Data read, sensor asleep and LED off (Integrate : TWI read transfer)
+	APP_TRACE_SENSOR_DONE,							// Sample ready event posted (Start : whole sample)
+	APP_TRACE_SENSOR_DISPATCH,					// Sample ready event handled (Done : scheduler queueing)
+	APP_TRACE_SENSOR_CONSUMED,					// Sample data picked up by the main loop for sending (Dispatch : main loop latency)
+	APP_TRACE_ADC_START,								// Battery conversion started (Root)
+	APP_TRACE_ADC_DONE,									// Battery conversion filtered (ADC start : conversion)
+	APP_TRACE_STAGE_NUM
+}app_trace_stage_t;
+
+/** @Type 	Data Type of One Timestamp in the Ring */
+typedef struct{
+	uint32_t				cycles;					// DWT->CYCCNT (64 MHz, wraps after about 67 s)
+	uint32_t				ticks;					// RTC1 counter (app_timer)
+	uint8_t					stage;					// app_trace_stage_t
+}app_trace_record_t;
+
+/** @Type 	Data Type of the Statistics of One Stage (in microsecond) */
+typedef struct{
+	uint32_t				count;
+	uint32_t				min_us;
+	uint32_t				max_us;
+	uint64_t				sum_us;
+	uint16_t				hist[APP_TRACE_HIST_BINS];
+}app_trace_stats_t;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Trace Macros (Removed at Compile Time if the Trace is Disabled) */
+
+#if APP_TRACE_ENABLED
+#define APP_TRACE_INIT()																		appTraceInit()
+#define APP_TRACE(stage)																		appTraceMark(stage)
+#define APP_TRACE_DUMP()																		appTraceDump()
+#else
+#define APP_TRACE_INIT()																		((void)0)
+#define APP_TRACE(stage)																		((void)0)
+#define APP_TRACE_DUMP()																		((void)0)
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func 	Initialization of the Trace Module
+	*
+	* @Brief	This function enables the DWT cycle counter and clears the ring and the statistics
+	*
+*/
+void appTraceInit(void);
+
+/** @Func 	Timestamp A Stage Boundary
+	*
+	* @Brief	This function can be called from any interrupt level (The update is done in a critical region)
+	*
+	* @Para		stage [app_trace_stage_t] : the stage boundary reached
+	*
+*/
+void appTraceMark(const app_trace_stage_t stage);
+
+/** @Func 	Get the Statistics of One Stage
+	*
+	* @Para		stage 	[app_trace_stage_t] 	: the stage to be read
+	* @Para		p_stats [app_trace_stats_t*] 	: the structure to be written into
+	*
+*/
+void appTraceGetStats(const app_trace_stage_t stage, app_trace_stats_t * p_stats);
+
+/** @Func 	Copy the Latest Timestamps out of the Ring
+	*
+	* @Para		p_records [app_trace_record_t*] : the array to be read into (Oldest first)
+	* @Para		max_count [uint8_t]							: the maximum number of timestamps to be read
+	*
+	* @Return	[uint8_t] : the number of timestamps actually read
+	*
+*/
+uint8_t appTraceRead(app_trace_record_t * p_records, const uint8_t max_count);
+
+/** @Func 	Clear the Ring and the Statistics */
+void appTraceReset(void);
+
+/** @Func 	Print the Statistics through NRF_LOG
+	*
+	* @Brief	One line per stage with the count and the min/avg/max time in microsecond
+	*
+*/
+void appTraceDump(void);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* C++ Library Header */
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif //__APP_TRACE_H__
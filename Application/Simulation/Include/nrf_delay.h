@@ -0,0 +1,33 @@
+/** Library Name : nrf_delay.h (Host Simulation)
+	*
+	* @Brief 		Replaces the busy-wait loops of the SDK delay header (ARM assembly) in the host build
+	* @Brief		The delays advance the virtual time of the simulation instead of spinning (see sim_platform.c)
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _NRF_DELAY_H
+#define _NRF_DELAY_H
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include <stdint.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func Delay in Microseconds (Advances the Virtual Time) */
+void nrf_delay_us(uint32_t number_of_us);
+
+/** @Func Delay in Milliseconds (Advances the Virtual Time) */
+void nrf_delay_ms(uint32_t number_of_ms);
+
+#endif
@@ -0,0 +1,155 @@
+/** Library Name : check_adc.c
+	*
+	* @Brief 		Checks of the integer kernels and the millivolt conversion of app_adc.c
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include "sim_check.h"
+#include "sim_platform.h"
+#include "app_adc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Checks) */
+
+/** @Func The Conversion into Millivolts Matches the Real Arithmetic at Every Gain and Code */
+static void check_millivolts(void)
+{
+	static const struct{
+		nrf_saadc_gain_t	gain;
+		double						full_scale_mv;
+	}gains[] =
+	{
+		{NRF_SAADC_GAIN1_6, 3600.0},
+		{NRF_SAADC_GAIN1_5, 3000.0},
+		{NRF_SAADC_GAIN1_4, 2400.0},
+		{NRF_SAADC_GAIN1_3, 1800.0},
+		{NRF_SAADC_GAIN1_2, 1200.0},
+		{NRF_SAADC_GAIN1, 	 600.0},
+		{NRF_SAADC_GAIN2, 	 300.0},
+		{NRF_SAADC_GAIN4, 	 150.0},
+	};
+
+	for(uint8_t g = 0; g < sizeof(gains)/sizeof(gains[0]); g++){
+		uint32_t 	scale 		= adcGainScale(gains[g].gain);
+		double 		max_error = 0.0;
+		for(int32_t code = 0; code < ADC_RESOLUTION_VAL; code++){
+			double error = adcValueToMillivolts((nrf_saadc_value_t)code, scale) - code * gains[g].full_scale_mv / ADC_RESOLUTION_VAL;
+			if(error < 0.0){
+				error = -error;
+			}
+			max_error = (error > max_error) ? error : max_error;
+		}
+		// Rounding to the millivolt plus the truncation of the Q16 scale over the full range
+		SIM_CHECK(max_error <= 0.5 + (double)ADC_RESOLUTION_VAL / (1UL << ADC_SCALE_SHIFT));
+	}
+
+	SIM_CHECK_EQUAL(adcValueToMillivolts(ADC_RESOLUTION_VAL / 2, adcGainScale(NRF_SAADC_GAIN1_6)), 1800);
+	SIM_CHECK_EQUAL(adcValueToMillivolts(-3, adcGainScale(NRF_SAADC_GAIN1_6)), 0);
+	SIM_CHECK_EQUAL(adcGainScale((nrf_saadc_gain_t)0xff), adcGainScale(NRF_SAADC_GAIN1_6));
+}
+
+/** @Func The Moving Average Follows the Mean of the Last N Values */
+static void check_moving_average(void)
+{
+	static const nrf_saadc_value_t input[] 		= {100, 200, 300, 400, 500, -500};
+	static const nrf_saadc_value_t expected[] = {100, 150, 200, 250, 350, 175};
+	adc_kernel_t kernel;
+
+	adcKernelInit(&kernel, adcKernelMovingAverage, 4);
+	for(uint8_t i = 0; i < sizeof(input)/sizeof(input[0]); i++){
+		SIM_CHECK_EQUAL(adcKernelMovingAverage(&kernel, input[i]), expected[i]);
+	}
+
+	// The window length is kept within 1 ~ ADC_KERNEL_WINDOW_SIZE
+	adcKernelInit(&kernel, adcKernelMovingAverage, 0);
+	SIM_CHECK_EQUAL(kernel.adc_kernel_len, 1);
+	adcKernelInit(&kernel, adcKernelMovingAverage, ADC_KERNEL_WINDOW_SIZE + 5);
+	SIM_CHECK_EQUAL(kernel.adc_kernel_len, ADC_KERNEL_WINDOW_SIZE);
+}
+
+/** @Func The Median Rejects A Single Spike and Averages the Middle Pair of An Even Window */
+static void check_median(void)
+{
+	adc_kernel_t kernel;
+
+	adcKernelInit(&kernel, adcKernelMedian, 3);
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 1), 1);
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 2), 2);		// (1 + 2) / 2 rounded
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 3000), 2);
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 3), 3);
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 4), 4);
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, -2000), 3);
+
+	// The window holds the last N values only
+	adcKernelInit(&kernel, adcKernelMedian, 3);
+	for(uint8_t i = 0; i < 10; i++){
+		adcKernelMedian(&kernel, 100);
+	}
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 900), 100);
+	SIM_CHECK_EQUAL(adcKernelMedian(&kernel, 900), 900);
+}
+
+/** @Func The IIR Filter Starts from the First Value, Moves by 1/2^K and Settles without Bias */
+static void check_iir(void)
+{
+	adc_kernel_t kernel;
+
+	adcKernelInit(&kernel, adcKernelIIR, 2);
+	SIM_CHECK_EQUAL(adcKernelIIR(&kernel, 1000), 1000);
+	SIM_CHECK_EQUAL(adcKernelIIR(&kernel, 2000), 1250);
+	SIM_CHECK_EQUAL(adcKernelIIR(&kernel, 2000), 1438);
+
+	nrf_saadc_value_t value = 0;
+	for(uint8_t i = 0; i < 100; i++){
+		value = adcKernelIIR(&kernel, 2000);
+	}
+	SIM_CHECK_EQUAL(value, 2000);
+
+	// Negative values (noise around zero) are filtered the same way
+	adcKernelInit(&kernel, adcKernelIIR, 4);
+	SIM_CHECK_EQUAL(adcKernelIIR(&kernel, -16), -16);
+	for(uint8_t i = 0; i < 200; i++){
+		value = adcKernelIIR(&kernel, -40);
+	}
+	SIM_CHECK_EQUAL(value, -40);
+
+	// The shift is kept within 0 ~ 15
+	adcKernelInit(&kernel, adcKernelIIR, 20);
+	SIM_CHECK_EQUAL(kernel.adc_kernel_len, 15);
+}
+
+/** @Func A Buffer Larger than One SAMPLE Task Fills is Clamped (Otherwise the Conversion Never Ends) */
+static void check_buffer_size(void)
+{
+	static uint16_t buffer[8];
+
+	adcBufferConfig(buffer, sizeof(buffer)/sizeof(buffer[0]));
+	SIM_CHECK(adcGetConfig()->adc_buffer_addr == buffer);
+	SIM_CHECK_EQUAL(adcGetConfig()->adc_buffer_size, ADC_BUFFER_SIZE);
+
+	adcBufferConfig(NULL, 0);
+	SIM_CHECK(adcGetConfig()->adc_buffer_addr != buffer);
+	SIM_CHECK_EQUAL(adcGetConfig()->adc_buffer_size, ADC_BUFFER_SIZE);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	check_millivolts();
+	check_moving_average();
+	check_median();
+	check_iir();
+	check_buffer_size();
+
+	SIM_CHECK_EQUAL(simErrorCount(), 0);
+	SIM_CHECK_REPORT();
+}
@@ -0,0 +1,238 @@
+/** Library Name : check_battery.c
+	*
+	* @Brief 		Checks of the discharge curve and the state of charge estimate of app_battery.c
+	* @Brief		The module source is included, so the internal functions are called directly;
+	* @Brief		the LED load of the Color Sensor Module is replaced by the check_led_* variables
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include "sim_check.h"
+#include "sim_platform.h"
+#include "app_battery.c"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The LED Load Seen by the Module (Charge Counter in uC, Peak Current in uA) */
+static uint32_t check_led_charge_uc 		= 0;
+static uint32_t check_led_peak_ua 			= 0;
+
+/** @Variable The Number of Calls of the State of Charge Handler */
+static uint32_t check_soc_handler_count = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Color Sensor Module Accessors) */
+
+bool sensorIsRedOn(void)
+{
+	return false;
+}
+
+bool sensorIsGreenOn(void)
+{
+	return false;
+}
+
+bool sensorIsBlueOn(void)
+{
+	return false;
+}
+
+bool sensorIsSampling(void)
+{
+	return false;
+}
+
+uint32_t sensorGetLedCharge(void)
+{
+	return check_led_charge_uc;
+}
+
+uint32_t sensorGetLedPeakCurrent(void)
+{
+	return check_led_peak_ua;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Count the Calls of the State of Charge Handler */
+static void check_soc_handler(battery_soc_t const * p_soc)
+{
+	(void)p_soc;
+	check_soc_handler_count++;
+}
+
+/** @Func Run One Estimate from A Reading Taken with the LEDs Off */
+static void check_reading(const uint16_t mv, const bool is_usb_present, const bool is_charge_full)
+{
+	battery_power.battery_mv 			= mv;
+	battery_power.is_usb_present 	= is_usb_present;
+	battery_power.is_charge_full 	= is_charge_full;
+	is_battery_reading_valid 			= true;
+	battery_update_handler(NULL, 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Checks) */
+
+/** @Func The Discharge Curve is Clamped at Both Ends, Interpolated Linearly and Monotonic */
+static void check_curve(void)
+{
+	SIM_CHECK_EQUAL(battery_curve_lookup(4300), 10000);
+	SIM_CHECK_EQUAL(battery_curve_lookup(4200), 10000);
+	SIM_CHECK_EQUAL(battery_curve_lookup(4150), 9500);
+	SIM_CHECK_EQUAL(battery_curve_lookup(3750), 4000);
+	SIM_CHECK_EQUAL(battery_curve_lookup(3725), 3400);
+	SIM_CHECK_EQUAL(battery_curve_lookup(3300), 0);
+	SIM_CHECK_EQUAL(battery_curve_lookup(3200), 0);
+
+	bool is_monotonic = true;
+	for(uint16_t mv = 3000; mv < 4400; mv++){
+		is_monotonic = is_monotonic && (battery_curve_lookup(mv + 1) >= battery_curve_lookup(mv));
+	}
+	SIM_CHECK(is_monotonic);
+}
+
+/** @Func The First Reading Sets the Estimate, then the Charge is Counted Down and Pulled towards the Curve */
+static void check_soc_discharge(void)
+{
+	battery_soc_t soc;
+
+	batterySocHandlerConfig(check_soc_handler);
+
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, 5000);
+	SIM_CHECK_EQUAL(soc.ocv_mv, 3800);
+	SIM_CHECK_EQUAL(soc.state, BATTERY_STATE_NORMAL);
+	SIM_CHECK_EQUAL(batteryGetLevel(), BATTERY_DIVIDER_IS_SET ? 50 : 100);
+	SIM_CHECK_EQUAL(battery_bas.battery_level_last, BATTERY_DIVIDER_IS_SET ? 50 : 0);
+
+	// 200 steps drawn by the LEDs: 5000 - 200 = 4800, then 1/8 of the way back to the curve
+	check_led_charge_uc += 200 * BATTERY_SOC_STEP_UC;
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, 4825);
+
+	// The charge below one step is carried over to the next estimate
+	check_led_charge_uc += BATTERY_SOC_STEP_UC + BATTERY_SOC_STEP_UC / 2;
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, 4846);
+	check_led_charge_uc += BATTERY_SOC_STEP_UC / 2;
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, 4864);
+
+	// The LED charge counter wraps around
+	check_led_charge_uc = UINT32_MAX - BATTERY_SOC_STEP_UC + 1;
+	battery_led_charge_last = check_led_charge_uc;
+	check_led_charge_uc += 2 * BATTERY_SOC_STEP_UC;
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, 4862 + (5000 - 4862) / 8);
+
+	// The handler (and the level) is held back until the divider ratio is set
+	SIM_CHECK_EQUAL(check_soc_handler_count, BATTERY_DIVIDER_IS_SET ? 5 : 0);
+}
+
+/** @Func The USB Supply Only Moves the Estimate Up, and the Charge Full Signal Sets It Full */
+static void check_soc_charge(void)
+{
+	battery_soc_t soc, soc_last;
+	union data_set_t charges, charges_last;
+
+	charges.word = 3;
+	simRecordSet(SET_DATA_SYS_CHRNUM_INDEX, charges.byte);
+
+	batteryGetSoc(&soc_last);
+	check_reading(4150, true, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, soc_last.soc + (9500 - soc_last.soc) / 8);
+	SIM_CHECK_EQUAL(soc.state, BATTERY_STATE_CHARGING);
+
+	// A reading below the estimate does not move it down while charging
+	soc_last = soc;
+	check_reading(3700, true, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, soc_last.soc);
+
+	check_reading(4200, true, true);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, BATTERY_SOC_FULL);
+	SIM_CHECK_EQUAL(batteryGetLevel(), 100);
+
+	// One charge is counted per connection of the USB supply
+	simRecordGet(SET_DATA_SYS_CHRNUM_INDEX, charges_last.byte);
+	SIM_CHECK_EQUAL(charges_last.word, 4);
+	check_reading(4100, false, false);
+	check_reading(4100, true, false);
+	simRecordGet(SET_DATA_SYS_CHRNUM_INDEX, charges_last.byte);
+	SIM_CHECK_EQUAL(charges_last.word, 5);
+}
+
+/** @Func The State Follows the Estimate and the Voltage under the Peak LED Current */
+static void check_soc_state(void)
+{
+	battery_soc_t soc;
+
+	is_battery_soc_valid = false;
+	check_reading(3400, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, 200);
+	SIM_CHECK_EQUAL(soc.state, BATTERY_STATE_CRITICAL);
+
+	is_battery_soc_valid = false;
+	check_reading(3600, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.state, BATTERY_STATE_LOW);
+
+	// 2 A over 300 mOhm leaves 3200 mV, a little more is a brown-out
+	is_battery_soc_valid 	= false;
+	check_led_peak_ua 		= 2000000;
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.pulse_mv, 3200);
+	SIM_CHECK_EQUAL(soc.state, BATTERY_STATE_NORMAL);
+
+	is_battery_soc_valid 	= false;
+	check_led_peak_ua 		= 2100000;
+	check_reading(3800, false, false);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.pulse_mv, 3170);
+	SIM_CHECK_EQUAL(soc.state, BATTERY_STATE_CRITICAL);
+	check_led_peak_ua 		= 0;
+
+	// A reading disturbed by an LED is retried and leaves the estimate
+	battery_soc_t soc_last = soc;
+	is_battery_reading_valid = false;
+	battery_update_handler(NULL, 0);
+	batteryGetSoc(&soc);
+	SIM_CHECK_EQUAL(soc.soc, soc_last.soc);
+	SIM_CHECK_EQUAL(battery_retry_count, 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	check_curve();
+	check_soc_discharge();
+	check_soc_charge();
+	check_soc_state();
+
+	SIM_CHECK_EQUAL(simErrorCount(), 0);
+	SIM_CHECK_REPORT();
+}
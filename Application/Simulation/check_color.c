@@ -0,0 +1,291 @@
+/** Library Name : check_color.c
+	*
+	* @Brief 		Checks of the fixed-point calibration engine of app_color.c against the same model in double precision
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <math.h>
+#include "sim_check.h"
+#include "sim_platform.h"
+#include "app_color.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Sample Size of the RGB Mode (Three Exposures of Three Words) */
+#define CHECK_SAMPLE_SIZE																		18
+
+/** @Macro Tolerance of the XYZ Values (0 ~ 100 Scale) */
+#define CHECK_XYZ_TOLERANCE																	0.02
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Feature Readings Used by the Checks (A White Tile, A Mid Grey, A Dark Red and A Near-black Reading) */
+static const uint16_t check_readings[][COLOR_FEATURE_NUM] =
+{
+	{13470,   567,   978,  2385, 13904,  3115,   691,  5997, 24399},
+	{ 6735,   284,   489,  1193,  6952,  1558,   346,  2999, 12200},
+	{ 9000,   120,   150,   400,   900,   300,   100,   200,  1500},
+	{   20,     1,     2,     4,    21,     5,     1,     9,    37},
+};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Pack Nine Feature Readings into An RGB Mode Sample (Big-endian Words as Read from the Sensor) */
+static void check_sample_make(uint16_t const * reading, uint8_t * byte_array)
+{
+	for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+		byte_array[2 * i] 		= (uint8_t)(reading[i] >> 8);
+		byte_array[2 * i + 1] = (uint8_t)reading[i];
+	}
+}
+
+/** @Func Get One Calibration Value (The Stored Record, or the Default Value if it Does Not Exist) */
+static double check_record(const uint16_t index)
+{
+	union data_color_t record;
+
+	if(!simRecordGet(index, record.byte)){
+		return getColorInfo()[index - COLOR_DATA_START_INDEX].flt;
+	}
+	return record.flt;
+}
+
+/** @Func Write One Calibration Record */
+static void check_record_set(const uint16_t index, const float value)
+{
+	union data_color_t record;
+
+	record.flt = value;
+	simRecordSet(index, record.byte);
+}
+
+/** @Func Store the Default Values as the Calibration Records */
+static void check_records_store_defaults(void)
+{
+	simRecordClear();
+	for(uint16_t index = COLOR_DATA_START_INDEX; index <= COLOR_DATA_END_INDEX; index++){
+		check_record_set(index, getColorInfo()[index - COLOR_DATA_START_INDEX].flt);
+	}
+}
+
+/** @Func The Calibration Model of app_color.h in Double Precision (dT in degC) */
+static void check_xyz_reference(uint16_t const * reading, const double delta_temp, double * xyz)
+{
+	double feature[COLOR_FEATURE_NUM];
+	double response = 1.0 + check_record(COLOR_DATA_TEMP_START_INDEX + 1) * delta_temp;
+
+	for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+		feature[i] = reading[i] * check_record(COLOR_DATA_FACTORY_START_INDEX + i) \
+							 * check_record(COLOR_DATA_FACTORY_START_INDEX + COLOR_FEATURE_NUM + i) \
+							 / check_record(COLOR_DATA_GREYSCALE_USER_START_INDEX + i) / response;
+	}
+	for(uint8_t k = 0; k < COLOR_XYZ_NUM; k++){
+		double sum = check_record(COLOR_DATA_MOTHER_START_INDEX + 27 + 2 * k);
+		for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+			sum += check_record(COLOR_DATA_MOTHER_START_INDEX + COLOR_FEATURE_NUM * k + i) * feature[i];
+		}
+		xyz[k] = 100.0 * sum / check_record(COLOR_DATA_MOTHER_START_INDEX + 28 + 2 * k);
+	}
+}
+
+/** @Func Check the Fixed-point XYZ of All the Readings against the Reference */
+static void check_xyz_all(const int16_t temperature, const double delta_temp)
+{
+	uint8_t 		sample[CHECK_SAMPLE_SIZE];
+	color_xyz_t xyz;
+	double 			reference[COLOR_XYZ_NUM];
+
+	for(uint8_t r = 0; r < sizeof(check_readings)/sizeof(check_readings[0]); r++){
+		check_sample_make(check_readings[r], sample);
+		check_xyz_reference(check_readings[r], delta_temp, reference);
+		SIM_CHECK_EQUAL(colorCalibXYZ(sample, SENSOR_SAMPLE_MODE_RGB, temperature, &xyz), NRF_SUCCESS);
+		SIM_CHECK_NEAR(xyz.X / 65536.0, reference[0], CHECK_XYZ_TOLERANCE);
+		SIM_CHECK_NEAR(xyz.Y / 65536.0, reference[1], CHECK_XYZ_TOLERANCE);
+		SIM_CHECK_NEAR(xyz.Z / 65536.0, reference[2], CHECK_XYZ_TOLERANCE);
+	}
+}
+
+/** @Func The CIE 1976 Companding Function in Double Precision */
+static double check_lab_f(const double t)
+{
+	return (t > 216.0 / 24389.0) ? cbrt(t) : t * 841.0 / 108.0 + 4.0 / 29.0;
+}
+
+/** @Func Check the Fixed-point Lab of One XYZ against the Reference (Hundredths, a* and b* Amplify the Q16 Rounding by 500 and 200) */
+static void check_lab(const double X, const double Y, const double Z)
+{
+	color_xyz_t xyz = {(int32_t)lround(X * 65536.0), (int32_t)lround(Y * 65536.0), (int32_t)lround(Z * 65536.0)};
+	color_lab_t lab;
+	double fx = check_lab_f(((X > 0.0) ? X : 0.0) / 95.047);
+	double fy = check_lab_f(((Y > 0.0) ? Y : 0.0) / 100.0);
+	double fz = check_lab_f(((Z > 0.0) ? Z : 0.0) / 108.883);
+
+	colorCalibLab(&xyz, &lab);
+	SIM_CHECK_NEAR(lab.L, 100.0 * (116.0 * fy - 16.0), 2.0);
+	SIM_CHECK_NEAR(lab.a, 100.0 * 500.0 * (fx - fy), 8.0);
+	SIM_CHECK_NEAR(lab.b, 100.0 * 200.0 * (fy - fz), 4.0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Checks) */
+
+/** @Func No Sample is Converted before the Table is Loaded, nor An Ambient Sample */
+static void check_not_ready(void)
+{
+	uint8_t 		sample[CHECK_SAMPLE_SIZE];
+	color_xyz_t xyz;
+
+	check_sample_make(check_readings[0], sample);
+	SIM_CHECK_EQUAL(colorCalibXYZ(sample, SENSOR_SAMPLE_MODE_RGB, SENSOR_TEMPERATURE_INVALID, &xyz), NRF_ERROR_INVALID_STATE);
+	SIM_CHECK_EQUAL(colorCalibXYZ(sample, SENSOR_SAMPLE_MODE_AMBIENT, SENSOR_TEMPERATURE_INVALID, &xyz), NRF_ERROR_NOT_SUPPORTED);
+}
+
+/** @Func Without Records the Table is Built from the Default Values */
+static void check_defaults(void)
+{
+	simRecordClear();
+	SIM_CHECK_EQUAL(colorCalibLoad(), NRF_ERROR_NOT_FOUND);
+	SIM_CHECK(!colorCalibIsLoaded());
+
+	color_calib_table_t const * p_table = colorCalibGetTable();
+	for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+		double scale = check_record(COLOR_DATA_FACTORY_START_INDEX + i) * check_record(COLOR_DATA_FACTORY_START_INDEX + COLOR_FEATURE_NUM + i) \
+								 / check_record(COLOR_DATA_GREYSCALE_USER_START_INDEX + i);
+		SIM_CHECK_NEAR(p_table->feature_scale[i] / 65536.0, scale, 1e-4);
+	}
+	SIM_CHECK_EQUAL(p_table->drift, 0);
+
+	check_xyz_all(SENSOR_TEMPERATURE_INVALID, 0.0);
+}
+
+/** @Func The Stored Records are Loaded, and Out-of-range Records Fall Back to the Default Values */
+static void check_stored(void)
+{
+	check_records_store_defaults();
+	check_record_set(COLOR_DATA_FACTORY_START_INDEX + 4, 1.5f * getColorInfo()[COLOR_DATA_FACTORY_START_INDEX + 4 - COLOR_DATA_START_INDEX].flt);
+	SIM_CHECK_EQUAL(colorCalibLoad(), NRF_SUCCESS);
+	SIM_CHECK(colorCalibIsLoaded());
+	check_xyz_all(SENSOR_TEMPERATURE_INVALID, 0.0);
+
+	// A zero greyscale reading cannot be used
+	check_record_set(COLOR_DATA_GREYSCALE_USER_START_INDEX + 2, 0.0f);
+	SIM_CHECK_EQUAL(colorCalibLoad(), NRF_ERROR_INVALID_DATA);
+	SIM_CHECK(!colorCalibIsLoaded());
+	simRecordClear();
+	check_xyz_all(SENSOR_TEMPERATURE_INVALID, 0.0);
+}
+
+/** @Func The Drift Correction is Neutral at the Reference Temperature and Divides the Features by (1 + drift x dT) */
+static void check_drift(void)
+{
+	uint8_t 		sample[CHECK_SAMPLE_SIZE];
+	color_xyz_t xyz_ref, xyz_none;
+
+	check_records_store_defaults();
+	check_record_set(COLOR_DATA_TEMP_START_INDEX, 25.0f);
+	check_record_set(COLOR_DATA_TEMP_START_INDEX + 1, 0.002f);
+	SIM_CHECK_EQUAL(colorCalibLoad(), NRF_SUCCESS);
+	SIM_CHECK_EQUAL(colorCalibGetTable()->ref_temperature, 100);
+	SIM_CHECK_EQUAL(colorCalibGetTable()->drift, lround(0.002f * (1UL << COLOR_Q_DRIFT)));
+
+	check_sample_make(check_readings[0], sample);
+	colorCalibXYZ(sample, SENSOR_SAMPLE_MODE_RGB, 100, &xyz_ref);
+	colorCalibXYZ(sample, SENSOR_SAMPLE_MODE_RGB, SENSOR_TEMPERATURE_INVALID, &xyz_none);
+	SIM_CHECK_EQUAL(xyz_ref.X, xyz_none.X);
+	SIM_CHECK_EQUAL(xyz_ref.Y, xyz_none.Y);
+	SIM_CHECK_EQUAL(xyz_ref.Z, xyz_none.Z);
+
+	check_xyz_all(140, 10.0);
+	check_xyz_all(60, -10.0);
+
+	// The user calibration temperature replaces the factory one as the reference
+	SIM_CHECK_EQUAL(colorCalibUserTemperatureSet(120), NRF_SUCCESS);
+	SIM_CHECK_EQUAL(colorCalibGetTable()->ref_temperature, 120);
+	check_xyz_all(140, 5.0);
+	SIM_CHECK_EQUAL(colorCalibUserTemperatureSet(SENSOR_TEMPERATURE_INVALID), NRF_ERROR_INVALID_PARAM);
+}
+
+/** @Func The Drift Fit Stores the Relative Change per degC and the Cold Temperature */
+static void check_drift_fit(void)
+{
+	uint16_t 	cold[COLOR_FEATURE_NUM], warm[COLOR_FEATURE_NUM];
+	uint8_t 	sample_cold[CHECK_SAMPLE_SIZE], sample_warm[CHECK_SAMPLE_SIZE];
+
+	for(uint8_t i = 0; i < COLOR_FEATURE_NUM; i++){
+		cold[i] = 10000;
+		warm[i] = 10250;
+	}
+	check_sample_make(cold, sample_cold);
+	check_sample_make(warm, sample_warm);
+
+	check_records_store_defaults();
+	SIM_CHECK_EQUAL(colorCalibDriftFit(sample_cold, 100, sample_warm, 140, SENSOR_SAMPLE_MODE_RGB), NRF_SUCCESS);
+	SIM_CHECK_NEAR(check_record(COLOR_DATA_TEMP_START_INDEX), 25.0, 1e-6);
+	SIM_CHECK_NEAR(check_record(COLOR_DATA_TEMP_START_INDEX + 1), 0.0025, 1e-6);
+	SIM_CHECK(colorCalibIsLoaded());
+
+	// Too close temperatures or an ambient sample cannot be fitted
+	SIM_CHECK_EQUAL(colorCalibDriftFit(sample_cold, 100, sample_warm, 104, SENSOR_SAMPLE_MODE_RGB), NRF_ERROR_INVALID_PARAM);
+	SIM_CHECK_EQUAL(colorCalibDriftFit(sample_cold, 100, sample_warm, 140, SENSOR_SAMPLE_MODE_AMBIENT), NRF_ERROR_INVALID_PARAM);
+}
+
+/** @Func The Lab Conversion Matches the CIE Formula on Both Segments */
+static void check_lab_conversion(void)
+{
+	color_xyz_t xyz = {(int32_t)(95.047 * 65536 + 0.5), 100 << 16, (int32_t)(108.883 * 65536 + 0.5)};
+	color_lab_t lab;
+
+	// The reference white
+	colorCalibLab(&xyz, &lab);
+	SIM_CHECK_NEAR(lab.L, 10000, 1);
+	SIM_CHECK_NEAR(lab.a, 0, 1);
+	SIM_CHECK_NEAR(lab.b, 0, 1);
+
+	// Surface colours around the white point (the chromaticity of X and Z up to 40% away from D65)
+	for(double Y = 0.25; Y < 105.0; Y += 4.7){
+		for(double x_ratio = 0.6; x_ratio < 1.45; x_ratio += 0.1){
+			for(double z_ratio = 0.6; z_ratio < 1.45; z_ratio += 0.2){
+				check_lab(0.95047 * x_ratio * Y, Y, 1.08883 * z_ratio * Y);
+			}
+		}
+	}
+
+	// The linear segment below (6/29)^3 and the negative values of a dark sample
+	check_lab(0.3, 0.2, 0.1);
+	check_lab(-1.0, 0.0, -0.5);
+
+	// a* beyond the int16_t range of the hundredths saturates
+	xyz.X = 90 << 16;
+	xyz.Y = 1 << 16;
+	colorCalibLab(&xyz, &lab);
+	SIM_CHECK_EQUAL(lab.a, INT16_MAX);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	check_not_ready();
+	check_defaults();
+	check_stored();
+	check_drift();
+	check_drift_fit();
+	check_lab_conversion();
+
+	SIM_CHECK_EQUAL(simErrorCount(), 0);
+	SIM_CHECK_REPORT();
+}
@@ -0,0 +1,187 @@
+/** Library Name : check_led_effects.c
+	*
+	* @Brief 		Checks of the keyframe renderer of app_led_effects.c through the double-buffered stream of the PWM model
+	* @Brief		The module source is included, so the easing and the colour space conversion are called directly
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include "sim_check.h"
+#include "sim_platform.h"
+#include "app_led_effects.c"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Maximum Number of Steps Collected from the Stream */
+#define CHECK_STEP_NUM																			(64 * LED_EFFECT_CHUNK_LEN)
+
+/** @Macro Duty of A Level (The Conversion of led_effect_refill) */
+#define CHECK_DUTY(level)																		(((uint32_t)(level) * LED_EFFECT_PWM_TOP) / LED_LEVEL_MAX)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Steps Played by the PWM Model */
+static nrf_pwm_values_individual_t check_steps[CHECK_STEP_NUM];
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Play the Stream Half by Half until It Stops (Returns the Number of Steps Played) */
+static uint32_t check_stream_play(void)
+{
+	uint32_t step_num = 0;
+	uint8_t  half 		= 0;
+
+	while(!simPwmIsStopped() && step_num + LED_EFFECT_CHUNK_LEN <= CHECK_STEP_NUM){
+		nrf_pwm_values_individual_t const * p_values;
+		uint16_t length = simPwmGetHalf(half, &p_values);
+		for(uint16_t i = 0; i < length; i++){
+			check_steps[step_num++] = p_values[i];
+		}
+		simPwmPlayHalf(half);
+		half ^= 1;
+	}
+	return step_num;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Checks) */
+
+/** @Func Every Easing Curve Starts and Ends at the Keyframe Values */
+static void check_ease(void)
+{
+	for(led_ease_t ease = LED_EASE_LINEAR; ease <= LED_EASE_IN_OUT; ease++){
+		SIM_CHECK_EQUAL(led_ease_value(ease, 10, 200, 0), 10);
+		SIM_CHECK_EQUAL(led_ease_value(ease, 10, 200, 256), 200);
+	}
+
+	// Half way along each curve
+	SIM_CHECK_EQUAL(led_ease_value(LED_EASE_LINEAR, 10, 200, 128), 105);
+	SIM_CHECK_EQUAL(led_ease_value(LED_EASE_LINEAR, 200, 10, 128), 105);
+	SIM_CHECK_EQUAL(led_ease_value(LED_EASE_STEP, 10, 200, 255), 10);
+	SIM_CHECK_EQUAL(led_ease_value(LED_EASE_IN, 10, 200, 128), 57);
+	SIM_CHECK_EQUAL(led_ease_value(LED_EASE_OUT, 10, 200, 128), 152);
+	SIM_CHECK_EQUAL(led_ease_value(LED_EASE_IN_OUT, 10, 200, 128), 105);
+}
+
+/** @Func The Primary Hues Give the Primary Colours, No Saturation Gives A Grey */
+static void check_hsv(void)
+{
+	static const struct{
+		uint8_t hsv[3];
+		uint8_t rgb[3];
+	}colors[] =
+	{
+		{{0,		255,	255},	{255,	0,		0		}},
+		{{86,		255,	255},	{0,		255,	0		}},
+		{{172,	255,	255},	{0,		0,		255	}},
+		{{0,		255,	0		},	{0,		0,		0		}},
+	};
+	uint8_t rgb[3];
+
+	for(uint8_t i = 0; i < sizeof(colors)/sizeof(colors[0]); i++){
+		led_hsv_to_rgb(colors[i].hsv, rgb);
+		SIM_CHECK_EQUAL(rgb[0], colors[i].rgb[0]);
+		SIM_CHECK_EQUAL(rgb[1], colors[i].rgb[1]);
+		SIM_CHECK_EQUAL(rgb[2], colors[i].rgb[2]);
+	}
+
+	// The integer conversion keeps a grey within one level
+	uint8_t grey[3] = {100, 0, 255};
+	led_hsv_to_rgb(grey, rgb);
+	SIM_CHECK(rgb[0] >= 254 && rgb[1] >= 254 && rgb[2] >= 254);
+}
+
+/** @Func The First Effect Pulses Red, Green and Blue, Plays Two Loops, Then Holds Off and Stops */
+static void check_effect_first(void)
+{
+	ledEffectRegister(LED_EFFECT_FIRST);
+	SIM_CHECK_EQUAL(simPwmGetTop(), LED_EFFECT_PWM_TOP);
+	ledEffectRun();
+	SIM_CHECK(ledEffectIsRunning());
+
+	uint32_t step_num = check_stream_play();
+	uint32_t period 	= led_keys_first[sizeof(led_keys_first)/sizeof(led_keys_first[0]) - 1].time_ms / LED_EFFECT_STEP_MS;
+
+	// The half holding the end of the second loop is the last one played
+	SIM_CHECK(simPwmIsStopped());
+	SIM_CHECK_EQUAL(step_num, (2 * period / LED_EFFECT_CHUNK_LEN + 1) * LED_EFFECT_CHUNK_LEN);
+
+	for(uint8_t loop = 0; loop < 2; loop++){
+		nrf_pwm_values_individual_t const * p_loop = &check_steps[loop * period];
+		SIM_CHECK_EQUAL(p_loop[0].channel_0, 0);
+		SIM_CHECK_EQUAL(p_loop[25].channel_0, CHECK_DUTY(125));			// Half way to the red keyframe
+		SIM_CHECK_EQUAL(p_loop[50].channel_0, CHECK_DUTY(250));
+		SIM_CHECK_EQUAL(p_loop[50].channel_1, 0);
+		SIM_CHECK_EQUAL(p_loop[150].channel_1, CHECK_DUTY(250));
+		SIM_CHECK_EQUAL(p_loop[150].channel_0, 0);
+		SIM_CHECK_EQUAL(p_loop[250].channel_2, CHECK_DUTY(250));
+		SIM_CHECK_EQUAL(p_loop[275].channel_2, CHECK_DUTY(125));
+	}
+
+	// The red ramp never falls on its way up
+	bool is_rising = true;
+	for(uint32_t i = 1; i <= 50; i++){
+		is_rising = is_rising && (check_steps[i].channel_0 >= check_steps[i - 1].channel_0);
+	}
+	SIM_CHECK(is_rising);
+
+	// The last keyframe is held after the end
+	bool is_off = true;
+	for(uint32_t i = 2 * period; i < step_num; i++){
+		is_off = is_off && (check_steps[i].channel_0 == 0) && (check_steps[i].channel_1 == 0) && (check_steps[i].channel_2 == 0);
+	}
+	SIM_CHECK(is_off);
+
+	ledEffectClear();
+	SIM_CHECK(!ledEffectIsRunning());
+}
+
+/** @Func The Rainbow Effect Starts at Red and Loops until It is Stopped */
+static void check_effect_rainbow(void)
+{
+	ledEffectRegister(LED_EFFECT_RAINBOW);
+	ledEffectRun();
+
+	uint32_t step_num = check_stream_play();
+	SIM_CHECK_EQUAL(step_num, CHECK_STEP_NUM);
+	SIM_CHECK(!simPwmIsStopped());
+	SIM_CHECK_EQUAL(check_steps[0].channel_0, LED_EFFECT_PWM_TOP);
+	SIM_CHECK_EQUAL(check_steps[0].channel_1, 0);
+	SIM_CHECK_EQUAL(check_steps[0].channel_2, 0);
+
+	// The hue wraps at the end of each loop
+	uint32_t period = led_keys_rainbow[1].time_ms / LED_EFFECT_STEP_MS;
+	SIM_CHECK_EQUAL(check_steps[period].channel_0, check_steps[0].channel_0);
+	SIM_CHECK_EQUAL(check_steps[period + 100].channel_1, check_steps[100].channel_1);
+
+	ledEffectStop();
+	SIM_CHECK(simPwmIsStopped());
+	ledEffectUnregister();
+	SIM_CHECK(!ledEffectIsRegistered());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	check_ease();
+	check_hsv();
+	check_effect_first();
+	check_effect_rainbow();
+
+	SIM_CHECK_EQUAL(simErrorCount(), 0);
+	SIM_CHECK_REPORT();
+}
@@ -0,0 +1,250 @@
+/** Library Name : check_sensor.c
+	*
+	* @Brief 		Checks of the sampling state machine of app_sensor.c on the sensor model of sim_sensor.c
+	* @Brief		The samples run in virtual time, so the latency of one sample is printed with the results
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include "sim_check.h"
+#include "sim_platform.h"
+#include "sim_sensor.h"
+#include "app_sensor.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro The TWI Pins (Not Used by the Model) */
+#define CHECK_SCL_PIN																				7
+#define CHECK_SDA_PIN																				8
+
+/** @Macro The LED Current Levels Set by the Checks */
+#define CHECK_LEVEL_RED																			6
+#define CHECK_LEVEL_GREEN																		5
+#define CHECK_LEVEL_BLUE																		3
+
+/** @Macro The Integration of the Default Exposure (32 us x 1875 Units x 4 Channels) */
+#define CHECK_INTEGRATION_US																(32UL * MANUAL_TIMING * 4)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Sample Ready Events Received */
+static sensor_sample_evt_t	check_evt;
+static uint32_t							check_evt_count = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Sample Ready Event Handler */
+static void check_sample_ready_handler(void * p_event_data, uint16_t event_size)
+{
+	SIM_CHECK_EQUAL(event_size, sizeof(sensor_sample_evt_t));
+	memcpy(&check_evt, p_event_data, sizeof(check_evt));
+	check_evt_count++;
+}
+
+/** @Func Get One Data Word of A Sample (High Byte First) */
+static uint16_t check_word(uint8_t const * byte_array, const uint8_t word_index)
+{
+	return (uint16_t)((byte_array[2 * word_index] << 8) | byte_array[2 * word_index + 1]);
+}
+
+/** @Func Queue One Frame per Channel (Each LED Lights Its Own Colour Most) */
+static void check_frames_queue(void)
+{
+	simSensorFrameQueue(4000, 	300, 	120, 	50);
+	simSensorFrameQueue(250, 	5000, 	400, 	60);
+	simSensorFrameQueue(90, 	350, 	6000, 	70);
+}
+
+/** @Func Start the Model and the Module from the Reset State in Non-blocking Mode */
+static void check_setup(const bool is_blocking_mode)
+{
+	simSensorReset();
+	simTemperatureSet(100);
+	sensorConfig(CHECK_SCL_PIN, CHECK_SDA_PIN, NULL, is_blocking_mode);
+	sensorLedCurrentConfig(CHECK_LEVEL_RED, RED);
+	sensorLedCurrentConfig(CHECK_LEVEL_GREEN << 4, GREEN);
+	sensorLedCurrentConfig(CHECK_LEVEL_BLUE, BLUE);
+	SIM_CHECK_EQUAL(sensorSampleModeConfig(SENSOR_SAMPLE_MODE_RGB), NRF_SUCCESS);
+	SIM_CHECK_EQUAL(sensorOversampleConfig(1, SENSOR_REDUCE_MEDIAN), NRF_SUCCESS);
+}
+
+/** @Func Run One Non-blocking Sample to the End (Returns the Virtual Time It Took in Microseconds) */
+static uint64_t check_sample_run(uint8_t * byte_array, const uint8_t array_length)
+{
+	uint64_t start_us = simTimeGet();
+
+	check_evt_count = 0;
+	SIM_CHECK_EQUAL(sensorSampleColorStart(byte_array, array_length, check_sample_ready_handler), NRF_SUCCESS);
+	SIM_CHECK(sensorIsSampling());
+	simSensorRun();
+	SIM_CHECK(!sensorIsSampling());
+	SIM_CHECK_EQUAL(simSchedExecute(), 1);
+	SIM_CHECK_EQUAL(check_evt_count, 1);
+	return simTimeGet() - start_us;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Checks) */
+
+/** @Func One RGB Sample Lights the Red, Green and Blue LEDs in Turn and Reads Each Frame after Its Integration */
+static void check_sample_rgb(void)
+{
+	uint8_t 													sample[SENSOR_COLOR_DATA_SIZE];
+	sim_sensor_integration_t const *	p_log;
+
+	check_setup(false);
+	check_frames_queue();
+	uint64_t latency_us = check_sample_run(sample, sizeof(sample));
+
+	// The sample holds the R/G/B words of each frame
+	static const uint16_t expected[9] = {4000, 300, 120, 250, 5000, 400, 90, 350, 6000};
+	for(uint8_t i = 0; i < 9; i++){
+		SIM_CHECK_EQUAL(check_word(sample, i), expected[i]);
+	}
+
+	// The event
+	SIM_CHECK(check_evt.array == sample);
+	SIM_CHECK_EQUAL(check_evt.err_code, NRF_SUCCESS);
+	SIM_CHECK_EQUAL(check_evt.mode, SENSOR_SAMPLE_MODE_RGB);
+	SIM_CHECK_EQUAL(check_evt.quality, SENSOR_QUALITY_MAX);
+	SIM_CHECK_EQUAL(check_evt.temperature, 100);
+	SIM_CHECK_EQUAL(sensorGetSampleTemperature(), 100);
+
+	// One integration per channel with its own LED at its own level, no data read before the end
+	SIM_CHECK_EQUAL(simSensorGetLog(&p_log), 3);
+	SIM_CHECK_EQUAL(p_log[0].led_drive, CHECK_LEVEL_RED << 8);
+	SIM_CHECK_EQUAL(p_log[1].led_drive, CHECK_LEVEL_GREEN << 4);
+	SIM_CHECK_EQUAL(p_log[2].led_drive, CHECK_LEVEL_BLUE);
+	SIM_CHECK_EQUAL(p_log[0].end_us - p_log[0].start_us, CHECK_INTEGRATION_US);
+	SIM_CHECK_EQUAL(simSensorGetEarlyReads(), 0);
+	SIM_CHECK_EQUAL(simSensorGetDelayCount(), 3);
+
+	// The LEDs are off and their charge is counted
+	SIM_CHECK(!sensorIsRedOn() && !sensorIsGreenOn() && !sensorIsBlueOn());
+	SIM_CHECK(sensorGetLedCharge() > 0);
+	SIM_CHECK_EQUAL(simSensorRegGet(SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1) & (SENSOR_LED_RESET_RESET|SENSOR_LED_SLEEP_SLEEP), SENSOR_LED_RESET_RESET|SENSOR_LED_SLEEP_SLEEP);
+
+	// The latency is the three integrations with the 5% margin, rounded up to the RTC2 tick, plus the bus time
+	printf("check_sensor.c: one RGB sample takes %.1f ms (integration %.1f ms per channel)\n", latency_us / 1000.0, CHECK_INTEGRATION_US / 1000.0);
+	SIM_CHECK(latency_us > 3 * CHECK_INTEGRATION_US * POST_SAMPLE_WAIT_TIME_MARGIN_PERCENT / 100);
+	SIM_CHECK(latency_us < 3 * CHECK_INTEGRATION_US * (POST_SAMPLE_WAIT_TIME_MARGIN_PERCENT + 2) / 100);
+
+	// The parameters and the state are checked
+	SIM_CHECK_EQUAL(sensorSampleColorStart(sample, sizeof(sample) - 1, NULL), NRF_ERROR_INVALID_LENGTH);
+	SIM_CHECK_EQUAL(sensorSampleColorStart(sample, sizeof(sample), NULL), NRF_SUCCESS);
+	SIM_CHECK_EQUAL(sensorSampleColorStart(sample, sizeof(sample), NULL), NRF_ERROR_BUSY);
+	SIM_CHECK_EQUAL(sensorSampleModeConfig(SENSOR_SAMPLE_MODE_AMBIENT), NRF_ERROR_BUSY);
+	simSensorRun();
+	SIM_CHECK_EQUAL(simSchedExecute(), 0);
+}
+
+/** @Func The Oversampled Channel Rejects A Spike by Its Median and Scores the Spread */
+static void check_sample_oversample(void)
+{
+	uint8_t 													sample[SENSOR_COLOR_DATA_SIZE];
+	sim_sensor_integration_t const *	p_log;
+
+	check_setup(false);
+	SIM_CHECK_EQUAL(sensorOversampleConfig(3, SENSOR_REDUCE_MEDIAN), NRF_SUCCESS);
+	simSensorFrameQueue(1000, 	300, 	120, 	50);
+	simSensorFrameQueue(1010, 	300, 	120, 	50);
+	simSensorFrameQueue(5000, 	300, 	120, 	50);
+	for(uint8_t i = 0; i < 3; i++){
+		simSensorFrameQueue(250, 	5000, 	400, 	60);
+	}
+	for(uint8_t i = 0; i < 3; i++){
+		simSensorFrameQueue(90, 	350, 	6000, 	70);
+	}
+	check_sample_run(sample, sizeof(sample));
+
+	SIM_CHECK_EQUAL(check_word(sample, 0), 1010);
+	SIM_CHECK_EQUAL(check_word(sample, 1), 300);
+	SIM_CHECK_EQUAL(check_evt.quality, SENSOR_QUALITY_MAX - SENSOR_QUALITY_SPREAD_PENALTY_MAX);
+	SIM_CHECK_EQUAL(simSensorGetLog(&p_log), 9);
+}
+
+/** @Func A Zero Reading is Exposed Again and Lowers the Quality */
+static void check_sample_retry(void)
+{
+	uint8_t 													sample[SENSOR_COLOR_DATA_SIZE];
+	sim_sensor_integration_t const *	p_log;
+
+	check_setup(false);
+	simSensorFrameQueue(0, 0, 0, 0);
+	check_frames_queue();
+	check_sample_run(sample, sizeof(sample));
+
+	SIM_CHECK_EQUAL(check_word(sample, 0), 4000);
+	SIM_CHECK_EQUAL(check_evt.quality, SENSOR_QUALITY_MAX - SENSOR_QUALITY_RETRY_PENALTY);
+	SIM_CHECK_EQUAL(simSensorGetLog(&p_log), 4);
+	SIM_CHECK_EQUAL(p_log[1].led_drive, CHECK_LEVEL_RED << 8);
+}
+
+/** @Func A Dark Frame Runs One Integration with the LEDs Off, and the Temperature Tag is Invalid without the SoftDevice */
+static void check_sample_ambient(void)
+{
+	uint8_t 													sample[SENSOR_CHANNEL_FULL_DATA_SIZE];
+	sim_sensor_integration_t const *	p_log;
+
+	check_setup(false);
+	simTemperatureSet(SIM_TEMPERATURE_NONE);
+	SIM_CHECK_EQUAL(sensorSampleModeConfig(SENSOR_SAMPLE_MODE_AMBIENT), NRF_SUCCESS);
+	simSensorFrameQueue(12, 14, 9, 30);
+	check_sample_run(sample, sizeof(sample));
+
+	SIM_CHECK_EQUAL(check_word(sample, 0), 12);
+	SIM_CHECK_EQUAL(check_word(sample, 3), 30);
+	SIM_CHECK_EQUAL(check_evt.temperature, SENSOR_TEMPERATURE_INVALID);
+	SIM_CHECK_EQUAL(simSensorGetLog(&p_log), 1);
+	SIM_CHECK_EQUAL(p_log[0].led_drive, 0);
+}
+
+/** @Func The Blocking Sample Reads the Same Data after the Same Integrations */
+static void check_sample_blocking(void)
+{
+	uint8_t 													sample[SENSOR_COLOR_DATA_SIZE];
+	sim_sensor_integration_t const *	p_log;
+
+	check_setup(true);
+	check_frames_queue();
+	SIM_CHECK_EQUAL(sensorSampleColorStart(sample, sizeof(sample), NULL), NRF_ERROR_INVALID_STATE);
+	SIM_CHECK_EQUAL(sensorSampleColor(sample, sizeof(sample)), NRF_SUCCESS);
+
+	SIM_CHECK_EQUAL(check_word(sample, 0), 4000);
+	SIM_CHECK_EQUAL(check_word(sample, 4), 5000);
+	SIM_CHECK_EQUAL(check_word(sample, 8), 6000);
+	SIM_CHECK_EQUAL(sensorGetSampleQuality(), SENSOR_QUALITY_MAX);
+	SIM_CHECK_EQUAL(simSensorGetLog(&p_log), 3);
+	SIM_CHECK_EQUAL(p_log[1].led_drive, CHECK_LEVEL_GREEN << 4);
+	SIM_CHECK_EQUAL(simSensorGetEarlyReads(), 0);
+	SIM_CHECK_EQUAL(simSensorGetDelayCount(), 0);
+	SIM_CHECK(!sensorIsRedOn() && !sensorIsGreenOn() && !sensorIsBlueOn());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	check_sample_rgb();
+	check_sample_oversample();
+	check_sample_retry();
+	check_sample_ambient();
+	check_sample_blocking();
+
+	SIM_CHECK_EQUAL(simErrorCount(), 0);
+	SIM_CHECK_REPORT();
+}
@@ -0,0 +1,527 @@
+/** Library Name : check_storage.c
+	*
+	* @Brief 		Checks of the record storage (app_storage.c, app_storage_health.c, drv_storage.c) on FDS and the flash model of sim_flash.c
+	* @Brief		Every boot of the device is a forked process: it runs the boot sequence of storageInit (initialization.c) on the
+	* @Brief		shared flash pages and passes its checks on in its exit status. A power cut ends a boot before one flash operation,
+	* @Brief		the next boot recovers from the pages left
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim_check.h"
+#include "sim_platform.h"
+#include "app_storage.h"
+#include "app_storage_health.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Exit Status of A Boot (SIM_FLASH_CUT_EXIT if Its Power was Cut) */
+#define CHECK_BOOT_PASSED																		0
+#define CHECK_BOOT_FAILED																		1
+#define CHECK_BOOT_RECORDS_OLD															4
+#define CHECK_BOOT_RECORDS_NEW															5
+
+/** @Macro The Records Changed by the Transaction (A One-word Setting, A Multi-byte Setting and A Packed Color) */
+#define CHECK_TX_WORD_INDEX																	SET_DATA_SYS_MEM_INDEX
+#define CHECK_TX_BYTES_INDEX																(SET_DATA_DEVINFO_START_INDEX + 1)		// Serial number
+#define CHECK_TX_COLOR_INDEX																(COLOR_DATA_TEMP_START_INDEX + 1)
+
+/** @Macro The Records of Another Layout Written by Older Firmware (A Shorter and A Longer Payload) */
+#define CHECK_SCHEMA_SHORT_INDEX														(SET_DATA_DEVINFO_START_INDEX + 1)		// Serial number
+#define CHECK_SCHEMA_SHORT_SIZE															4
+#define CHECK_SCHEMA_LONG_INDEX															(SET_DATA_DEVINFO_START_INDEX + 3)		// Device name
+#define CHECK_SCHEMA_LONG_SIZE															12
+
+/** @Macro Upper Bound of the Flash Operations of A Commit */
+#define CHECK_TX_CUT_MAX																		256
+
+/** @Macro Upper Bound of the Writes Filling the Flash (About 6000 Updates of A One-word Setting Fill the FDS Pages) */
+#define CHECK_FULL_WRITE_MAX																30000
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Exit Status of A Boot whose Checks Pass */
+static int 			check_boot_status 			= CHECK_BOOT_PASSED;
+
+/** @Variable The Flash Operations of the Transaction Run before the Power Cut */
+static int32_t 	check_cut_after 				= SIM_FLASH_CUT_NONE;
+
+/** @Variable The Last Completed Request */
+static uint16_t 				check_request_handle 	= FLASH_REQUEST_HANDLE_INVALID;
+static flash_status_t 	check_request_status 	= FLASH_STATUS_SUCCESS;
+static uint32_t 				check_request_count 	= 0;
+
+/** @Variable The Values Written by the Checks */
+static const uint8_t 	check_tx_old[3][SET_DATA_DEVINFO_SN_SIZE_BYTE] = {{0x11, 0x12, 0x13, 0x14}, {'S', 'N', '-', 'O', 'L', 'D', '-', '1'}, {0x00, 0x00, 0x80, 0x3F}};
+static const uint8_t 	check_tx_new[3][SET_DATA_DEVINFO_SN_SIZE_BYTE] = {{0x21, 0x22, 0x23, 0x24}, {'S', 'N', '-', 'N', 'E', 'W', '-', '2'}, {0x00, 0x00, 0x00, 0x40}};
+static const uint16_t check_tx_index[3] 	= {CHECK_TX_WORD_INDEX, CHECK_TX_BYTES_INDEX, CHECK_TX_COLOR_INDEX};
+static const uint8_t 	check_tx_size[3] 	= {sizeof(union data_set_t), SET_DATA_DEVINFO_SN_SIZE_BYTE, FLASH_COLOR_VALUE_SIZE_BYTE};
+
+/** @Variable The Color Values Written by Older Firmware (One Record per Index) */
+static const uint8_t 	check_legacy_value[COLOR_DATA_TEMP_NUM][4] = {{0x00, 0x00, 0xC8, 0x41}, {0x6F, 0x12, 0x03, 0x3B}};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func FDS Event Handler (The Flags and the Garbage Collection Report of event_handlers.c) */
+static void check_fds_handler(fds_evt_t const * const p_fds_evt)
+{
+	switch(p_fds_evt->id){
+		case FDS_EVT_INIT:
+		if(p_fds_evt->result == FDS_SUCCESS){
+			fdsSetInitFlag(1);
+		}
+		break;
+		case FDS_EVT_WRITE:
+		if(p_fds_evt->result == FDS_SUCCESS){
+			fdsSetWriteFlag(1);
+		}
+		break;
+		case FDS_EVT_UPDATE:
+		if(p_fds_evt->result == FDS_SUCCESS){
+			fdsSetUpdateFlag(1);
+		}
+		break;
+		case FDS_EVT_DEL_RECORD:
+		case FDS_EVT_DEL_FILE:
+		if(p_fds_evt->result == FDS_SUCCESS){
+			fdsSetDelFlag(1);
+		}
+		break;
+		case FDS_EVT_GC:
+		storageHealthOnGC(p_fds_evt->result);
+		if(p_fds_evt->result == FDS_SUCCESS){
+			fdsSetGcFlag(1);
+		}
+		break;
+		default:
+		break;
+	}
+}
+
+/** @Func Completion Handler of the Record Requests */
+static void check_request_handler(const uint16_t handle, const uint16_t index, const flash_status_t status)
+{
+	check_request_handle = handle;
+	check_request_status = status;
+	check_request_count++;
+}
+
+/** @Func Run the Scheduler Events and the Flash Operations until Both are Idle */
+static void check_pump(void)
+{
+	while(simSchedExecute() + simFlashExecute() != 0){
+	}
+}
+
+/** @Func Boot One Device on the Shared Flash Pages (Returns the Exit Status of the Forked Boot) */
+static int check_boot(void (*p_run)(void))
+{
+	int 	status;
+	pid_t pid;
+
+	fflush(stdout);
+	pid = fork();
+	if(pid == 0){
+		p_run();
+		fflush(stdout);
+		_exit((sim_check_failed == 0 && simErrorCount() == 0) ? check_boot_status : CHECK_BOOT_FAILED);
+	}
+	if(pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)){
+		return CHECK_BOOT_FAILED;
+	}
+	return WEXITSTATUS(status);
+}
+
+/** @Func The Boot Sequence of storageInit */
+static void check_storage_init(void)
+{
+	SIM_CHECK_EQUAL(fdsInit(check_fds_handler), FDS_SUCCESS);
+	SIM_CHECK_EQUAL(loadRecordCache(), FLASH_STATUS_SUCCESS);
+	SIM_CHECK_EQUAL(recoverRecordTransaction(), FLASH_STATUS_SUCCESS);
+	SIM_CHECK_EQUAL(syncAllRecords(), FLASH_STATUS_SUCCESS);
+	storageHealthInit();
+}
+
+/** @Func Check One Record Value */
+static bool check_record_is(const uint16_t index, uint8_t const * value, const uint8_t size)
+{
+	uint8_t bytes[FLASH_RECORD_MAX_SIZE_BYTE];
+
+	return getOneRecord(index, bytes) == FLASH_STATUS_SUCCESS && memcmp(bytes, value, size) == 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Boots) */
+
+/** @Func First Boot: Every Record is Created with Its Default Value */
+static void check_run_first_boot(void)
+{
+	check_storage_init();
+	for(uint16_t index = 1; index <= FLASH_RECORD_NUM; index++){
+		if(getDataSection(index) != FLASH_SECTION_OUT_OF_RANGE){
+			SIM_CHECK_EQUAL(getOneRecordStatus(index), FLASH_STATUS_REC_UNCHANGED);
+		}
+	}
+	SIM_CHECK(!isRecordCacheDirty());
+	SIM_CHECK(!fdsFileHasRecords(FLASH_FILEID_SHADOW));
+}
+
+/** @Func Later Boot: Nothing is Written without An Interrupted Transaction or A New Schema */
+static void check_run_quiet_boot(void)
+{
+	uint32_t op_count;
+
+	SIM_CHECK_EQUAL(fdsInit(check_fds_handler), FDS_SUCCESS);
+	SIM_CHECK_EQUAL(loadRecordCache(), FLASH_STATUS_SUCCESS);
+	op_count = simFlashOpCount();
+	SIM_CHECK_EQUAL(recoverRecordTransaction(), FLASH_STATUS_SUCCESS);
+	SIM_CHECK_EQUAL(syncAllRecords(), FLASH_STATUS_SUCCESS);
+	SIM_CHECK_EQUAL(simFlashOpCount(), op_count);
+}
+
+/** @Func RAM Shadow: A Change is Written Back Later, A Request Completes once Its Record is in the Flash */
+static void check_run_write_back(void)
+{
+	uint32_t op_count;
+	uint16_t handle;
+
+	check_storage_init();
+	op_count = simFlashOpCount();
+
+	// The change stays in RAM
+	SIM_CHECK_EQUAL(setOneRecord(check_tx_index[0], check_tx_new[0]), FLASH_STATUS_SUCCESS);
+	SIM_CHECK(check_record_is(check_tx_index[0], check_tx_new[0], check_tx_size[0]));
+	SIM_CHECK_EQUAL(getOneRecordStatus(check_tx_index[0]), FLASH_STATUS_REC_CHANGED);
+	SIM_CHECK(isRecordCacheDirty());
+	SIM_CHECK_EQUAL(simFlashOpCount(), op_count);
+
+	// A request writes it with the other changed records
+	SIM_CHECK_EQUAL(setOneRecordAsync(check_tx_index[2], check_tx_new[2], check_request_handler, &handle), FLASH_STATUS_SUCCESS);
+	SIM_CHECK(isRecordRequestPending(handle));
+	check_pump();
+	SIM_CHECK(!isRecordRequestPending(handle));
+	SIM_CHECK_EQUAL(check_request_handle, handle);
+	SIM_CHECK_EQUAL(check_request_status, FLASH_STATUS_SUCCESS);
+	SIM_CHECK(!isRecordCacheDirty());
+	SIM_CHECK(simFlashOpCount() > op_count);
+}
+
+/** @Func RAM Shadow: The Written Records are Loaded at the Next Boot */
+static void check_run_write_back_reboot(void)
+{
+	check_storage_init();
+	SIM_CHECK(check_record_is(check_tx_index[0], check_tx_new[0], check_tx_size[0]));
+	SIM_CHECK(check_record_is(check_tx_index[2], check_tx_new[2], check_tx_size[2]));
+	SIM_CHECK_EQUAL(getOneRecordStatus(check_tx_index[2]), FLASH_STATUS_REC_CHANGED);
+	SIM_CHECK_EQUAL(getOneRecordStatus(check_tx_index[1]), FLASH_STATUS_REC_UNCHANGED);
+}
+
+/** @Func Transaction: The Old Values are in the Flash */
+static void check_run_tx_setup(void)
+{
+	check_storage_init();
+	for(uint8_t i = 0; i < 3; i++){
+		SIM_CHECK_EQUAL(setOneRecord(check_tx_index[i], check_tx_old[i]), FLASH_STATUS_SUCCESS);
+	}
+	SIM_CHECK_EQUAL(flushRecordCache(), FLASH_STATUS_SUCCESS);
+}
+
+/** @Func Transaction: The New Values are Committed, the Power is Cut after check_cut_after Flash Operations */
+static void check_run_tx_commit(void)
+{
+	check_storage_init();
+	simFlashCutAfter(check_cut_after);
+
+	SIM_CHECK_EQUAL(beginRecordTransaction(), FLASH_STATUS_SUCCESS);
+	for(uint8_t i = 0; i < 3; i++){
+		SIM_CHECK_EQUAL(stageOneRecord(check_tx_index[i], check_tx_new[i]), FLASH_STATUS_SUCCESS);
+		SIM_CHECK(check_record_is(check_tx_index[i], check_tx_old[i], check_tx_size[i]));
+	}
+	SIM_CHECK_EQUAL(commitRecordTransaction(), FLASH_STATUS_SUCCESS);
+	for(uint8_t i = 0; i < 3; i++){
+		SIM_CHECK(check_record_is(check_tx_index[i], check_tx_new[i], check_tx_size[i]));
+	}
+}
+
+/** @Func Transaction: The Boot after the Cut Finds All the Old or All the New Values (The Exit Status Tells Which) */
+static void check_run_tx_verify(void)
+{
+	bool is_old = true;
+	bool is_new = true;
+
+	simFlashCutAfter(check_cut_after);
+	check_storage_init();
+	for(uint8_t i = 0; i < 3; i++){
+		is_old = is_old && check_record_is(check_tx_index[i], check_tx_old[i], check_tx_size[i]);
+		is_new = is_new && check_record_is(check_tx_index[i], check_tx_new[i], check_tx_size[i]);
+	}
+	SIM_CHECK(is_old != is_new);
+	SIM_CHECK(!fdsFileHasRecords(FLASH_FILEID_SHADOW));
+	SIM_CHECK(!isRecordCacheDirty());
+	check_boot_status = is_new ? CHECK_BOOT_RECORDS_NEW : CHECK_BOOT_RECORDS_OLD;
+}
+
+/** @Func Packed Colors: Older Firmware Wrote One Record (Tag + Value) per Index */
+static void check_run_legacy_write(void)
+{
+	uint8_t image[FLASH_COLOR_VALUE_SIZE_BYTE + 1];
+
+	SIM_CHECK_EQUAL(fdsInit(check_fds_handler), FDS_SUCCESS);
+	for(uint8_t i = 0; i < COLOR_DATA_TEMP_NUM; i++){
+		image[0] = (i == 0) ? FLASH_RECTAG_DEFAULT_BYTE : FLASH_RECTAG_CHANGED_BYTE;
+		memcpy(&image[1], check_legacy_value[i], FLASH_COLOR_VALUE_SIZE_BYTE);
+		SIM_CHECK_EQUAL(setByteArray(FLASH_FILEID_COLOR, COLOR_DATA_TEMP_START_INDEX + i, sizeof(image), image), FLASH_STATUS_SUCCESS);
+	}
+}
+
+/** @Func Packed Colors: The Per-index Records are Read without the RAM Shadow, and Nothing is Written */
+static void check_run_legacy_read(void)
+{
+	uint32_t op_count;
+
+	SIM_CHECK_EQUAL(fdsInit(check_fds_handler), FDS_SUCCESS);
+	op_count = simFlashOpCount();
+	for(uint8_t i = 0; i < COLOR_DATA_TEMP_NUM; i++){
+		SIM_CHECK(check_record_is(COLOR_DATA_TEMP_START_INDEX + i, check_legacy_value[i], FLASH_COLOR_VALUE_SIZE_BYTE));
+	}
+	SIM_CHECK_EQUAL(getOneRecordStatus(COLOR_DATA_TEMP_START_INDEX), FLASH_STATUS_REC_UNCHANGED);
+	SIM_CHECK_EQUAL(getOneRecordStatus(COLOR_DATA_TEMP_START_INDEX + 1), FLASH_STATUS_REC_CHANGED);
+	SIM_CHECK_EQUAL(simFlashOpCount(), op_count);
+}
+
+/** @Func Packed Colors: The Load Packs the Per-index Records into the Block Record and Deletes Them */
+static void check_run_legacy_pack(void)
+{
+	uint8_t image[FLASH_COLOR_VALUE_SIZE_BYTE + 1];
+
+	check_storage_init();
+	for(uint8_t i = 0; i < COLOR_DATA_TEMP_NUM; i++){
+		SIM_CHECK(check_record_is(COLOR_DATA_TEMP_START_INDEX + i, check_legacy_value[i], FLASH_COLOR_VALUE_SIZE_BYTE));
+		SIM_CHECK_EQUAL(getByteArray(FLASH_FILEID_COLOR, COLOR_DATA_TEMP_START_INDEX + i, sizeof(image), image), FLASH_STATUS_NOT_FOUND_ERR);
+	}
+	SIM_CHECK_EQUAL(getOneRecordStatus(COLOR_DATA_TEMP_START_INDEX), FLASH_STATUS_REC_UNCHANGED);
+	SIM_CHECK_EQUAL(getOneRecordStatus(COLOR_DATA_TEMP_START_INDEX + 1), FLASH_STATUS_REC_CHANGED);
+	SIM_CHECK_EQUAL(getByteArray(FLASH_FILEID_COLOR, FLASH_COLOR_BLOCK_REC_INDEX(FLASH_COLOR_BLOCK_TEMP), sizeof(image), image), FLASH_STATUS_SUCCESS);
+}
+
+/** @Func Packed Colors: The Block Record is Read at the Next Boot, without the RAM Shadow too */
+static void check_run_legacy_reboot(void)
+{
+	check_run_quiet_boot();
+	for(uint8_t i = 0; i < COLOR_DATA_TEMP_NUM; i++){
+		SIM_CHECK(check_record_is(COLOR_DATA_TEMP_START_INDEX + i, check_legacy_value[i], FLASH_COLOR_VALUE_SIZE_BYTE));
+	}
+}
+
+/** @Func Schema: Older Firmware Wrote A Shorter Serial Number and A Longer Device Name, and Its Schema Record */
+static void check_run_schema_old(void)
+{
+	uint8_t 	image[CHECK_SCHEMA_LONG_SIZE + 1];
+	uint32_t 	schema[FLASH_SCHEMA_REC_WORDS];
+	uint8_t 	*old_sizes = (uint8_t *)&schema[1];
+
+	SIM_CHECK_EQUAL(fdsInit(check_fds_handler), FDS_SUCCESS);
+
+	// The records of the other indexes are missing (A zero size is an index without a size, which is only created)
+	memset(schema, 0, sizeof(schema));
+	schema[0] = FLASH_SCHEMA_VERSION | ((uint32_t)(FLASH_RECORD_NUM - 1) << 8);
+	old_sizes[CHECK_SCHEMA_SHORT_INDEX - 1] = CHECK_SCHEMA_SHORT_SIZE;
+	old_sizes[CHECK_SCHEMA_LONG_INDEX - 1] 	= CHECK_SCHEMA_LONG_SIZE;
+	SIM_CHECK_EQUAL(setWordArray(FLASH_FILEID_EXTENDED, FLASH_SCHEMA_REC_INDEX, FLASH_SCHEMA_REC_WORDS, schema), FLASH_STATUS_SUCCESS);
+
+	image[0] = FLASH_RECTAG_CHANGED_BYTE;
+	memcpy(&image[1], "OLD1", CHECK_SCHEMA_SHORT_SIZE);
+	SIM_CHECK_EQUAL(setByteArray(FLASH_FILEID_SETTINGS, CHECK_SCHEMA_SHORT_INDEX, CHECK_SCHEMA_SHORT_SIZE + 1, image), FLASH_STATUS_SUCCESS);
+	memcpy(&image[1], "LONG-NAME-12", CHECK_SCHEMA_LONG_SIZE);
+	SIM_CHECK_EQUAL(setByteArray(FLASH_FILEID_SETTINGS, CHECK_SCHEMA_LONG_INDEX, CHECK_SCHEMA_LONG_SIZE + 1, image), FLASH_STATUS_SUCCESS);
+}
+
+/** @Func Schema: The Boot Migrates the Changed Sizes (Tags Kept), Creates the Missing Records, then Synchronizes without Any Write */
+static void check_run_schema_sync(void)
+{
+	uint8_t 	serial[SET_DATA_DEVINFO_SN_SIZE_BYTE];
+	uint32_t 	op_count;
+
+	check_storage_init();
+
+	memcpy(serial, "OLD1", CHECK_SCHEMA_SHORT_SIZE);
+	memcpy(&serial[CHECK_SCHEMA_SHORT_SIZE], &default_devinfo_sn[CHECK_SCHEMA_SHORT_SIZE], SET_DATA_DEVINFO_SN_SIZE_BYTE - CHECK_SCHEMA_SHORT_SIZE);
+	SIM_CHECK(check_record_is(CHECK_SCHEMA_SHORT_INDEX, serial, SET_DATA_DEVINFO_SN_SIZE_BYTE));
+	SIM_CHECK_EQUAL(getOneRecordStatus(CHECK_SCHEMA_SHORT_INDEX), FLASH_STATUS_REC_CHANGED);
+	SIM_CHECK(check_record_is(CHECK_SCHEMA_LONG_INDEX, (uint8_t const *)"LONG-NAM", SET_DATA_DEVINFO_NAME_SIZE_BYTE));
+	SIM_CHECK_EQUAL(getOneRecordStatus(CHECK_SCHEMA_LONG_INDEX), FLASH_STATUS_REC_CHANGED);
+	SIM_CHECK(check_record_is(SET_DATA_DEVINFO_START_INDEX, default_devinfo_vmi, SET_DATA_DEVINFO_VMI_SIZE_BYTE));
+	SIM_CHECK_EQUAL(getOneRecordStatus(SET_DATA_DEVINFO_START_INDEX), FLASH_STATUS_REC_UNCHANGED);
+
+	op_count = simFlashOpCount();
+	SIM_CHECK_EQUAL(syncAllRecords(), FLASH_STATUS_SUCCESS);
+	SIM_CHECK_EQUAL(simFlashOpCount(), op_count);
+}
+
+/** @Func Schema: The Migrated Records are in the Flash */
+static void check_run_schema_reboot(void)
+{
+	check_run_quiet_boot();
+	SIM_CHECK(check_record_is(CHECK_SCHEMA_LONG_INDEX, (uint8_t const *)"LONG-NAM", SET_DATA_DEVINFO_NAME_SIZE_BYTE));
+	SIM_CHECK_EQUAL(getOneRecordStatus(CHECK_SCHEMA_SHORT_INDEX), FLASH_STATUS_REC_CHANGED);
+}
+
+/** @Func Full Flash: The Write-back Waits for the Garbage Collection of the Storage Health Module, No Request Fails */
+static void check_run_full_flash(void)
+{
+	storage_health_t 	health;
+	union data_set_t 	value;
+	uint32_t 					failed = 0;
+
+	check_storage_init();
+	storageHealthGetStatus(&health);
+	for(value.word = 0; value.word < CHECK_FULL_WRITE_MAX && health.gc_runs < 2; value.word++){
+		check_request_count = 0;
+		SIM_CHECK_EQUAL(setOneRecordAsync(check_tx_index[0], value.byte, check_request_handler, NULL), FLASH_STATUS_SUCCESS);
+		check_pump();
+		if(check_request_count != 1 || check_request_status != FLASH_STATUS_SUCCESS){
+			failed++;
+		}
+		storageHealthGetStatus(&health);
+	}
+	SIM_CHECK_EQUAL(failed, 0);
+	SIM_CHECK_EQUAL(health.gc_runs, 2);
+	SIM_CHECK_EQUAL(health.gc_failures, 0);
+	SIM_CHECK(!isRecordCacheDirty());
+	value.word--;
+	SIM_CHECK(check_record_is(check_tx_index[0], value.byte, sizeof(value)));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Checks) */
+
+/** @Func The First Boot Creates the Records, the Next Ones Write Nothing */
+static void check_boot_sequence(void)
+{
+	simFlashErase();
+	SIM_CHECK_EQUAL(check_boot(check_run_first_boot), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_quiet_boot), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_quiet_boot), CHECK_BOOT_PASSED);
+}
+
+/** @Func The RAM Shadow and the Non-blocking Requests */
+static void check_write_back(void)
+{
+	simFlashErase();
+	SIM_CHECK_EQUAL(check_boot(check_run_write_back), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_write_back_reboot), CHECK_BOOT_PASSED);
+}
+
+/** @Func A Power Cut at Any Flash Operation of A Commit Leaves All the Old Values (Roll-back) or All the New Ones (Roll-forward) */
+static void check_transaction(void)
+{
+	int 		status;
+	int 		verify;
+	int32_t cut;
+	int32_t commit_cut 		= -1;
+	uint32_t rolled_back 	= 0;
+
+	for(cut = 0; cut < CHECK_TX_CUT_MAX; cut++){
+		simFlashErase();
+		SIM_CHECK_EQUAL(check_boot(check_run_tx_setup), CHECK_BOOT_PASSED);
+		check_cut_after = cut;
+		status = check_boot(check_run_tx_commit);
+		check_cut_after = SIM_FLASH_CUT_NONE;
+		verify = check_boot(check_run_tx_verify);
+
+		// The commit has run to its end: the new values stay
+		if(status == CHECK_BOOT_PASSED){
+			SIM_CHECK_EQUAL(verify, CHECK_BOOT_RECORDS_NEW);
+			break;
+		}
+		SIM_CHECK_EQUAL(status, SIM_FLASH_CUT_EXIT);
+		SIM_CHECK(verify == CHECK_BOOT_RECORDS_OLD || verify == CHECK_BOOT_RECORDS_NEW);
+
+		// Once the marker is in the flash, every later cut rolls forward
+		if(verify == CHECK_BOOT_RECORDS_OLD){
+			SIM_CHECK(commit_cut < 0);
+			rolled_back++;
+		}
+		else if(commit_cut < 0){
+			commit_cut = cut;
+		}
+	}
+	SIM_CHECK(cut < CHECK_TX_CUT_MAX);
+	SIM_CHECK(rolled_back > 0);
+	SIM_CHECK(commit_cut > 0 && commit_cut < cut);
+	printf("%s: a commit of 3 records takes %d flash operations, the commit point is after %d\n", __FILE__, (int)cut, (int)commit_cut);
+
+	// The roll-forward is cut too: it is repeated at the next boot
+	for(int32_t recovery_cut = 0; commit_cut > 0 && recovery_cut < CHECK_TX_CUT_MAX; recovery_cut++){
+		simFlashErase();
+		SIM_CHECK_EQUAL(check_boot(check_run_tx_setup), CHECK_BOOT_PASSED);
+		check_cut_after = commit_cut;
+		SIM_CHECK_EQUAL(check_boot(check_run_tx_commit), SIM_FLASH_CUT_EXIT);
+		check_cut_after = recovery_cut;
+		status = check_boot(check_run_tx_verify);
+		check_cut_after = SIM_FLASH_CUT_NONE;
+		if(status == CHECK_BOOT_RECORDS_NEW){
+			break;
+		}
+		SIM_CHECK_EQUAL(status, SIM_FLASH_CUT_EXIT);
+		SIM_CHECK_EQUAL(check_boot(check_run_tx_verify), CHECK_BOOT_RECORDS_NEW);
+	}
+}
+
+/** @Func The Per-index Color Records of Older Firmware are Read and Packed */
+static void check_legacy_colors(void)
+{
+	simFlashErase();
+	SIM_CHECK_EQUAL(check_boot(check_run_legacy_write), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_legacy_read), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_legacy_pack), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_legacy_reboot), CHECK_BOOT_PASSED);
+}
+
+/** @Func The Records of An Older Layout are Migrated Once */
+static void check_schema_migration(void)
+{
+	simFlashErase();
+	SIM_CHECK_EQUAL(check_boot(check_run_schema_old), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_schema_sync), CHECK_BOOT_PASSED);
+	SIM_CHECK_EQUAL(check_boot(check_run_schema_reboot), CHECK_BOOT_PASSED);
+}
+
+/** @Func The Write-back Goes on after the Garbage Collection of A Full Flash */
+static void check_full_flash(void)
+{
+	simFlashErase();
+	SIM_CHECK_EQUAL(check_boot(check_run_full_flash), CHECK_BOOT_PASSED);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(void)
+{
+	check_boot_sequence();
+	check_write_back();
+	check_transaction();
+	check_legacy_colors();
+	check_schema_migration();
+	check_full_flash();
+
+	SIM_CHECK_EQUAL(simErrorCount(), 0);
+	SIM_CHECK_REPORT();
+}
@@ -0,0 +1,82 @@
+/** Library Name : sim_check.h
+	*
+	* @Brief 		Check macros of the host simulation programs (Each check_*.c program includes this header once)
+	* @Brief		A failed check is printed with its location and the program exits with a non-zero status at the end
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Macro		SIM_CHECK														(Check A Condition)
+	* @Macro		SIM_CHECK_EQUAL											(Check An Integer Value)
+	* @Macro		SIM_CHECK_NEAR											(Check A Value within A Tolerance)
+	* @Macro		SIM_CHECK_REPORT										(Print the Summary and Return the Exit Status from main)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __SIM_CHECK_H__
+#define __SIM_CHECK_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Number of Checks and Failed Checks of the Program */
+static unsigned int sim_check_count 	= 0;
+static unsigned int sim_check_failed 	= 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Check A Condition */
+#define SIM_CHECK(cond)																			\
+	do{																																\
+		sim_check_count++;																							\
+		if(!(cond)){																										\
+			sim_check_failed++;																						\
+			printf("%s:%d: FAILED: %s\n", __FILE__, __LINE__, #cond);		\
+		}																																\
+	}while(0)
+
+/** @Macro Check An Integer Value */
+#define SIM_CHECK_EQUAL(value, expected)											\
+	do{																																\
+		long long sim_v = (long long)(value);														\
+		long long sim_e = (long long)(expected);												\
+		sim_check_count++;																							\
+		if(sim_v != sim_e){																							\
+			sim_check_failed++;																						\
+			printf("%s:%d: FAILED: %s == %lld (expected %lld)\n", __FILE__, __LINE__, #value, sim_v, sim_e);	\
+		}																																\
+	}while(0)
+
+/** @Macro Check A Value within A Tolerance */
+#define SIM_CHECK_NEAR(value, expected, tolerance)						\
+	do{																																\
+		double sim_v = (double)(value);																	\
+		double sim_e = (double)(expected);															\
+		sim_check_count++;																							\
+		if(!(sim_v - sim_e <= (tolerance) && sim_e - sim_v <= (tolerance))){	\
+			sim_check_failed++;																						\
+			printf("%s:%d: FAILED: %s == %.6f (expected %.6f +/- %g)\n", __FILE__, __LINE__, #value, sim_v, sim_e, (double)(tolerance));	\
+		}																																\
+	}while(0)
+
+/** @Macro Print the Summary and Return the Exit Status from main */
+#define SIM_CHECK_REPORT()																		\
+	do{																																\
+		printf("%s: %u checks, %u failed\n", __FILE__, sim_check_count, sim_check_failed);	\
+		return (sim_check_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;		\
+	}while(0)
+
+#endif
@@ -0,0 +1,307 @@
+/** Library Name : sim_flash.c
+	*
+	* @Brief 		Host simulation of the flash pages of FDS (Replaces fstorage, fds.c and the storage modules are run unchanged)
+	* @Brief		The pages are words in shared memory: a store clears bits (NOR flash), an erase sets the words to 0xFFFFFFFF.
+	* @Brief		The operations are queued as fstorage does and run one at a time by sd_app_evt_wait (or simFlashExecute),
+	* @Brief		then reported to the callback of the configuration. A power cut ends the process before an operation;
+	* @Brief		the pages stay in the shared memory, so the next boot of the check is a forked process reading them
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "sim_platform.h"
+#include "nrf_soc.h"
+#include "fstorage.h"
+#include "section_vars.h"
+#include "app_storage.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The fstorage Configurations (Registered by FS_REGISTER_CFG, FDS is the Only One) */
+NRF_SECTION_VARS_CREATE_SECTION(fs_data, fs_config_t);
+
+/** @Variable The Flash Pages (Shared Memory, Mapped before the Boots are Forked) */
+static uint32_t *	sim_flash_words 		= NULL;
+
+/** @Variable The Pages are Assigned to the Configurations */
+static bool 			is_sim_flash_init 	= false;
+
+/** @Variable The Queued Operations (Store: Words, Erase: Pages) */
+static struct{
+	fs_config_t const *	p_config;
+	fs_evt_t						evt;
+	uint32_t *					p_dest;
+	uint32_t const *		p_src;
+	uint16_t						length;
+}sim_flash_queue[FS_QUEUE_SIZE];
+static uint8_t 		sim_flash_head 			= 0;
+static uint8_t 		sim_flash_count 		= 0;
+
+/** @Variable The Number of Operations Run, and the Operations Left before the Power Cut */
+static uint32_t 	sim_flash_op_count 	= 0;
+static int32_t 		sim_flash_cut 			= SIM_FLASH_CUT_NONE;
+
+/** @Variable The Storage Module is Initialized for the Record Controls */
+static bool 			is_sim_record_init 	= false;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Get the Flash Pages (Mapped and Erased at the First Call) */
+static uint32_t * sim_flash_memory(void)
+{
+	if(sim_flash_words == NULL){
+		sim_flash_words = mmap(NULL, SIM_FLASH_WORDS * sizeof(uint32_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if(sim_flash_words == MAP_FAILED){
+			perror("sim_flash_memory");
+			exit(EXIT_FAILURE);
+		}
+		memset(sim_flash_words, 0xFF, SIM_FLASH_WORDS * sizeof(uint32_t));
+	}
+	return sim_flash_words;
+}
+
+/** @Func Check the Configuration and the Range of An Operation */
+static fs_ret_t sim_flash_check(fs_config_t const * const p_config, uint32_t const * const p_dest, const uint32_t length_words)
+{
+	if(!is_sim_flash_init){
+		return FS_ERR_NOT_INITIALIZED;
+	}
+	if(p_config == NULL || p_config->p_start_addr == NULL){
+		return FS_ERR_INVALID_CFG;
+	}
+	if(p_dest == NULL){
+		return FS_ERR_NULL_ARG;
+	}
+	if(length_words == 0){
+		return FS_ERR_INVALID_ARG;
+	}
+	if(p_dest < p_config->p_start_addr || p_dest + length_words > p_config->p_end_addr){
+		return FS_ERR_INVALID_ADDR;
+	}
+	return FS_SUCCESS;
+}
+
+/** @Func Queue One Operation */
+static fs_ret_t sim_flash_enqueue(fs_config_t const * const p_config, const fs_evt_t * p_evt, uint32_t const * const p_dest, uint32_t const * const p_src, const uint16_t length)
+{
+	uint8_t tail;
+
+	if(sim_flash_count >= FS_QUEUE_SIZE){
+		return FS_ERR_QUEUE_FULL;
+	}
+	tail = (sim_flash_head + sim_flash_count) % FS_QUEUE_SIZE;
+	sim_flash_queue[tail].p_config	= p_config;
+	sim_flash_queue[tail].evt 			= *p_evt;
+	sim_flash_queue[tail].p_dest 		= (uint32_t *)p_dest;
+	sim_flash_queue[tail].p_src 		= p_src;
+	sim_flash_queue[tail].length 		= length;
+	sim_flash_count++;
+	return FS_SUCCESS;
+}
+
+/** @Func Run the First Queued Operation (Returns false if None is Queued) */
+static bool sim_flash_run_one(void)
+{
+	fs_config_t const *	p_config;
+	fs_evt_t						evt;
+
+	if(sim_flash_count == 0){
+		return false;
+	}
+
+	// Power Cut: The Operation is Not Run and the Process Ends (The Pages Hold the Operations Run Before)
+	if(sim_flash_cut == 0){
+		fflush(stdout);
+		_exit(SIM_FLASH_CUT_EXIT);
+	}
+	else if(sim_flash_cut > 0){
+		sim_flash_cut--;
+	}
+
+	// The Operation Leaves the Queue before Its Callback, which Usually Queues the Next One
+	p_config = sim_flash_queue[sim_flash_head].p_config;
+	evt 		 = sim_flash_queue[sim_flash_head].evt;
+	if(evt.id == FS_EVT_STORE){
+		for(uint16_t i = 0; i < sim_flash_queue[sim_flash_head].length; i++){
+			sim_flash_queue[sim_flash_head].p_dest[i] &= sim_flash_queue[sim_flash_head].p_src[i];
+		}
+	}
+	else{
+		memset(sim_flash_queue[sim_flash_head].p_dest, 0xFF, sim_flash_queue[sim_flash_head].length * SIM_FLASH_PAGE_WORDS * sizeof(uint32_t));
+	}
+	sim_flash_head = (sim_flash_head + 1) % FS_QUEUE_SIZE;
+	sim_flash_count--;
+	sim_flash_op_count++;
+
+	p_config->callback(&evt, FS_SUCCESS);
+	return true;
+}
+
+/** @Func Initialize the Storage Module for the Record Controls (FDS, without the RAM Shadow) */
+static void sim_record_init(void)
+{
+	if(!is_sim_record_init){
+		is_sim_record_init = true;
+		APP_ERROR_CHECK(fdsInit(NULL));
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Simulation Controls) */
+
+/** @Func Erase All the Flash Pages */
+void simFlashErase(void)
+{
+	memset(sim_flash_memory(), 0xFF, SIM_FLASH_WORDS * sizeof(uint32_t));
+}
+
+/** @Func Run the Queued Flash Operations */
+uint32_t simFlashExecute(void)
+{
+	uint32_t run = 0;
+
+	while(sim_flash_run_one()){
+		run++;
+	}
+	return run;
+}
+
+/** @Func Get the Number of Flash Operations Run */
+uint32_t simFlashOpCount(void)
+{
+	return sim_flash_op_count;
+}
+
+/** @Func Cut the Power before the Flash Operation after the Next Ones */
+void simFlashCutAfter(const int32_t op_count)
+{
+	sim_flash_cut = op_count;
+}
+
+/** @Func Remove All the Records of the Data Files */
+void simRecordClear(void)
+{
+	sim_record_init();
+	APP_ERROR_CHECK(fdsFileDelete(FLASH_FILEID_SETTINGS));
+	APP_ERROR_CHECK(fdsFileDelete(FLASH_FILEID_COLOR));
+	APP_ERROR_CHECK(fdsFileDelete(FLASH_FILEID_EXTENDED));
+	APP_ERROR_CHECK(fdsGC());
+}
+
+/** @Func Write One Record */
+void simRecordSet(const uint16_t index, uint8_t const * bytes_array)
+{
+	flash_status_t flash_ret_code;
+
+	sim_record_init();
+	flash_ret_code = setOneRecord(index, bytes_array);
+
+	// Full Flash: Collect the Garbage at Once (The Storage Health Module is Not Run by the Checks)
+	if(flash_ret_code == FLASH_STATUS_FULL_ERR){
+		APP_ERROR_CHECK(fdsGC());
+		flash_ret_code = setOneRecord(index, bytes_array);
+	}
+	if(flash_ret_code != FLASH_STATUS_SUCCESS){
+		printf("simRecordSet: index %u, status %d\n", (unsigned int)index, (int)flash_ret_code);
+		APP_ERROR_CHECK(NRF_ERROR_INTERNAL);
+	}
+}
+
+/** @Func Read One Record */
+bool simRecordGet(const uint16_t index, uint8_t * bytes_array)
+{
+	sim_record_init();
+	return (getOneRecord(index, bytes_array) == FLASH_STATUS_SUCCESS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Platform Models) */
+
+/** @Func fstorage: Assign the Pages to the Configurations, One after Another */
+fs_ret_t fs_init(void)
+{
+	uint32_t * p_addr = sim_flash_memory();
+
+	for(uint32_t i = 0; i < NRF_SECTION_VARS_COUNT(fs_config_t, fs_data); i++){
+		fs_config_t * p_config = NRF_SECTION_VARS_GET(i, fs_config_t, fs_data);
+
+		if(p_addr + (uint32_t)p_config->num_pages * SIM_FLASH_PAGE_WORDS > sim_flash_words + SIM_FLASH_WORDS){
+			return FS_ERR_INVALID_CFG;
+		}
+		p_config->p_start_addr 	= p_addr;
+		p_addr 								 += (uint32_t)p_config->num_pages * SIM_FLASH_PAGE_WORDS;
+		p_config->p_end_addr 		= p_addr;
+	}
+	is_sim_flash_init = true;
+	return FS_SUCCESS;
+}
+
+/** @Func fstorage: Queue A Store (The Source Words are Read when the Operation is Run) */
+fs_ret_t fs_store(fs_config_t const * const p_config, uint32_t const * const p_dest, uint32_t const * const p_src, uint16_t length_words, void * p_context)
+{
+	fs_evt_t evt;
+	fs_ret_t ret = sim_flash_check(p_config, p_dest, length_words);
+
+	if(ret != FS_SUCCESS){
+		return ret;
+	}
+	if(p_src == NULL){
+		return FS_ERR_NULL_ARG;
+	}
+
+	evt.id 								= FS_EVT_STORE;
+	evt.p_context 				= p_context;
+	evt.store.p_data 			= p_dest;
+	evt.store.length_words 	= length_words;
+	return sim_flash_enqueue(p_config, &evt, p_dest, p_src, length_words);
+}
+
+/** @Func fstorage: Queue An Erase */
+fs_ret_t fs_erase(fs_config_t const * const p_config, uint32_t const * const p_page_addr, uint16_t num_pages, void * p_context)
+{
+	fs_evt_t evt;
+	fs_ret_t ret = sim_flash_check(p_config, p_page_addr, (uint32_t)num_pages * SIM_FLASH_PAGE_WORDS);
+
+	if(ret != FS_SUCCESS){
+		return ret;
+	}
+	if((p_page_addr - p_config->p_start_addr) % SIM_FLASH_PAGE_WORDS != 0){
+		return FS_ERR_UNALIGNED_ADDR;
+	}
+
+	evt.id 								= FS_EVT_ERASE;
+	evt.p_context 				= p_context;
+	evt.erase.first_page 	= (uint16_t)((p_page_addr - sim_flash_words) / SIM_FLASH_PAGE_WORDS);
+	evt.erase.last_page 	= evt.erase.first_page + num_pages - 1;
+	return sim_flash_enqueue(p_config, &evt, p_page_addr, NULL, num_pages);
+}
+
+/** @Func SoftDevice Wait for An Event (The Next Flash Operation is the Only Event, Without One the Wait Would Never End) */
+uint32_t sd_app_evt_wait(void)
+{
+	if(!sim_flash_run_one()){
+		printf("sd_app_evt_wait: no flash operation to wait for\n");
+		fflush(stdout);
+		exit(EXIT_FAILURE);
+	}
+	return NRF_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
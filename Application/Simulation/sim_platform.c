@@ -0,0 +1,252 @@
+/** Library Name : sim_platform.c
+	*
+	* @Brief 		Implementation of the platform models of the host simulation
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <stdio.h>
+#include <string.h>
+#include "sim_platform.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "app_timer.h"
+#include "app_scheduler.h"
+#include "nrf_drv_saadc.h"
+#include "nrf_delay.h"
+#include "nrf_soc.h"
+#include "ble_bas.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Virtual Time in Microseconds */
+static uint64_t sim_time_us 				= 0;
+
+/** @Variable The Die Temperature (0.25 degC Units) */
+static int32_t 	sim_temperature 		= 100;
+
+/** @Variable The Number of Errors Passed to the Error Handler */
+static uint32_t sim_error_count 		= 0;
+
+/** @Variable The Events of the Scheduler Model */
+static struct{
+	app_sched_event_handler_t	handler;
+	uint8_t										data[SIM_SCHED_EVENT_SIZE];
+	uint16_t									size;
+}sim_sched_queue[SIM_SCHED_QUEUE_SIZE];
+static uint8_t sim_sched_head 	= 0;
+static uint8_t sim_sched_count 	= 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Simulation Controls) */
+
+/** @Func Get the Virtual Time in Microseconds */
+uint64_t simTimeGet(void)
+{
+	return sim_time_us;
+}
+
+/** @Func Advance the Virtual Time */
+void simTimeAdvance(const uint64_t time_us)
+{
+	sim_time_us += time_us;
+}
+
+/** @Func Set the Die Temperature Returned by sd_temp_get */
+void simTemperatureSet(const int32_t temperature)
+{
+	sim_temperature = temperature;
+}
+
+/** @Func Run the Events Put into the Scheduler Model */
+uint32_t simSchedExecute(void)
+{
+	uint32_t run = 0;
+
+	// An event handler may put new events, which are run in the same call
+	while(sim_sched_count > 0){
+		uint8_t		data[SIM_SCHED_EVENT_SIZE];
+		uint16_t	size 		= sim_sched_queue[sim_sched_head].size;
+		app_sched_event_handler_t handler = sim_sched_queue[sim_sched_head].handler;
+
+		memcpy(data, sim_sched_queue[sim_sched_head].data, size);
+		sim_sched_head = (sim_sched_head + 1) % SIM_SCHED_QUEUE_SIZE;
+		sim_sched_count--;
+		handler((size != 0) ? data : NULL, size);
+		run++;
+	}
+	return run;
+}
+
+/** @Func Get the Number of Errors Passed to the Error Handler */
+uint32_t simErrorCount(void)
+{
+	return sim_error_count;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Platform Models) */
+
+/** @Func Error Handler (Counts the Error and Goes On, so the Check Reports It) */
+void app_error_handler_bare(ret_code_t error_code)
+{
+	printf("app_error_handler_bare: error 0x%08x\n", (unsigned int)error_code);
+	sim_error_count++;
+}
+
+/** @Func Critical Region (The Simulation Runs in One Context) */
+void app_util_critical_region_enter(uint8_t * p_nested)
+{
+	if(p_nested != NULL){
+		*p_nested = 0;
+	}
+}
+
+void app_util_critical_region_exit(uint8_t nested)
+{
+	(void)nested;
+}
+
+/** @Func Delays Advance the Virtual Time */
+void nrf_delay_us(uint32_t number_of_us)
+{
+	simTimeAdvance(number_of_us);
+}
+
+void nrf_delay_ms(uint32_t number_of_ms)
+{
+	simTimeAdvance((uint64_t)number_of_ms * 1000);
+}
+
+/** @Func App Timer (The RTC1 Counter Follows the Virtual Time, the Timers are Not Run) */
+uint32_t app_timer_create(app_timer_id_t const * p_timer_id, app_timer_mode_t mode, app_timer_timeout_handler_t timeout_handler)
+{
+	(void)p_timer_id;
+	(void)mode;
+	(void)timeout_handler;
+	return NRF_SUCCESS;
+}
+
+uint32_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+	(void)timer_id;
+	(void)timeout_ticks;
+	(void)p_context;
+	return NRF_SUCCESS;
+}
+
+uint32_t app_timer_stop(app_timer_id_t timer_id)
+{
+	(void)timer_id;
+	return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+	return (uint32_t)((sim_time_us * APP_TIMER_CLOCK_FREQ) / 1000000) & 0x00FFFFFF;
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from, uint32_t * p_ticks_diff)
+{
+	*p_ticks_diff = (ticks_to - ticks_from) & 0x00FFFFFF;
+	return NRF_SUCCESS;
+}
+
+/** @Func Scheduler (The Events are Run by simSchedExecute) */
+uint32_t app_sched_event_put(void * p_event_data, uint16_t event_size, app_sched_event_handler_t handler)
+{
+	if(event_size > SIM_SCHED_EVENT_SIZE){
+		return NRF_ERROR_INVALID_LENGTH;
+	}
+	if(sim_sched_count >= SIM_SCHED_QUEUE_SIZE){
+		return NRF_ERROR_NO_MEM;
+	}
+
+	uint8_t tail = (sim_sched_head + sim_sched_count) % SIM_SCHED_QUEUE_SIZE;
+	sim_sched_queue[tail].handler = handler;
+	sim_sched_queue[tail].size 		= (p_event_data != NULL) ? event_size : 0;
+	if(p_event_data != NULL){
+		memcpy(sim_sched_queue[tail].data, p_event_data, event_size);
+	}
+	sim_sched_count++;
+	return NRF_SUCCESS;
+}
+
+/** @Func SoftDevice Die Temperature */
+uint32_t sd_temp_get(int32_t * p_temp)
+{
+	if(sim_temperature == SIM_TEMPERATURE_NONE){
+		return NRF_ERROR_SOFTDEVICE_NOT_ENABLED;
+	}
+	*p_temp = sim_temperature;
+	return NRF_SUCCESS;
+}
+
+/** @Func SAADC Driver (The Conversions are Fed to the Modules by the Checks) */
+ret_code_t nrf_drv_saadc_init(nrf_drv_saadc_config_t const * p_config, nrf_drv_saadc_event_handler_t event_handler)
+{
+	(void)p_config;
+	(void)event_handler;
+	return NRF_SUCCESS;
+}
+
+void nrf_drv_saadc_uninit(void)
+{
+}
+
+ret_code_t nrf_drv_saadc_channel_init(uint8_t channel, nrf_saadc_channel_config_t const * const p_config)
+{
+	(void)channel;
+	(void)p_config;
+	return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_channel_uninit(uint8_t channel)
+{
+	(void)channel;
+	return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_buffer_convert(nrf_saadc_value_t * buffer, uint16_t size)
+{
+	(void)buffer;
+	(void)size;
+	return NRF_SUCCESS;
+}
+
+ret_code_t nrf_drv_saadc_sample(void)
+{
+	return NRF_SUCCESS;
+}
+
+/** @Func Battery Service */
+uint32_t ble_bas_init(ble_bas_t * p_bas, const ble_bas_init_t * p_bas_init)
+{
+	(void)p_bas;
+	(void)p_bas_init;
+	return NRF_SUCCESS;
+}
+
+void ble_bas_on_ble_evt(ble_bas_t * p_bas, ble_evt_t * p_ble_evt)
+{
+	(void)p_bas;
+	(void)p_ble_evt;
+}
+
+uint32_t ble_bas_battery_level_update(ble_bas_t * p_bas, uint8_t battery_level)
+{
+	p_bas->battery_level_last = battery_level;
+	return NRF_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,126 @@
+/** Library Name : sim_platform.h
+	*
+	* @Brief 		Host simulation of the platform services used by the Application modules
+	* @Brief		The SoftDevice, app_timer, app_scheduler, SAADC and Battery Service calls are replaced by
+	* @Brief		RAM models running on a virtual time, so the modules can be built and checked on a Linux host (see Makefile)
+	* @Brief		fstorage is replaced by a RAM model of the flash pages (sim_flash.c), so the records go through FDS and the storage modules
+	* @Brief		The PWM driver of the RGB LEDs is replaced by a model of the double-buffered stream (sim_pwm.c)
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Macro		SIM_FLASH_PAGE_WORDS								(Size of One Flash Page in Words)
+	* @Macro		SIM_FLASH_WORDS											(Size of the Flash Model in Words)
+	* @Macro		SIM_FLASH_CUT_NONE									(The Power is Not Cut)
+	* @Macro		SIM_FLASH_CUT_EXIT									(Exit Status of A Process whose Power is Cut)
+	* @Macro		SIM_SCHED_QUEUE_SIZE								(Number of Events Held by the Scheduler Model)
+	* @Macro		SIM_SCHED_EVENT_SIZE								(Maximum Size of the Event Data)
+	* @Macro		SIM_TEMPERATURE_NONE								(The SoftDevice is Not Enabled, sd_temp_get Fails)
+	*
+	* @Func			simTimeGet													(Get the Virtual Time in Microseconds)
+	* @Func			simTimeAdvance											(Advance the Virtual Time)
+	* @Func			simTemperatureSet										(Set the Die Temperature Returned by sd_temp_get)
+	* @Func			simSchedExecute											(Run the Events Put into the Scheduler Model)
+	* @Func			simErrorCount												(Get the Number of Errors Passed to the Error Handler)
+	*
+	* @Func			simFlashErase												(Erase All the Flash Pages)
+	* @Func			simFlashExecute											(Run the Queued Flash Operations)
+	* @Func			simFlashOpCount											(Get the Number of Flash Operations Run)
+	* @Func			simFlashCutAfter										(Cut the Power before the Flash Operation after the Next Ones)
+	* @Func			simRecordClear											(Remove All the Records of the Data Files)
+	* @Func			simRecordSet												(Write One Record)
+	* @Func			simRecordGet												(Read One Record)
+	*
+	* @Func			simPwmGetTop												(Get the Top Value Passed to pwmConfig)
+	* @Func			simPwmPlayHalf											(Play One Half of the Stream and Refill It)
+	* @Func			simPwmGetHalf												(Get the Steps of One Half of the Stream)
+	* @Func			simPwmIsStopped											(Test Whether the Stream Has Played Its Last Steps)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __SIM_PLATFORM_H__
+#define __SIM_PLATFORM_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf.h"
+#include "nrf_pwm.h"
+#include "sdk_config.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Flash Model (The Pages of FDS, nRF52 Page Size) */
+#define SIM_FLASH_PAGE_WORDS																1024
+#define SIM_FLASH_WORDS																			(FDS_VIRTUAL_PAGES * FDS_VIRTUAL_PAGE_SIZE)
+#define SIM_FLASH_CUT_NONE																	(-1)
+#define SIM_FLASH_CUT_EXIT																	3
+
+/** @Macro Scheduler Model */
+#define SIM_SCHED_QUEUE_SIZE																16
+#define SIM_SCHED_EVENT_SIZE																32
+
+/** @Macro Die Temperature Model */
+#define SIM_TEMPERATURE_NONE																INT32_MIN
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func Get the Virtual Time in Microseconds */
+uint64_t simTimeGet(void);
+
+/** @Func Advance the Virtual Time (in Microseconds) */
+void simTimeAdvance(const uint64_t time_us);
+
+/** @Func Set the Die Temperature Returned by sd_temp_get (0.25 degC Units, SIM_TEMPERATURE_NONE Makes It Fail) */
+void simTemperatureSet(const int32_t temperature);
+
+/** @Func Run the Events Put into the Scheduler Model (Returns the Number of Events Run) */
+uint32_t simSchedExecute(void);
+
+/** @Func Get the Number of Errors Passed to the Error Handler (APP_ERROR_CHECK) */
+uint32_t simErrorCount(void);
+
+/** @Func Erase All the Flash Pages (Called before the Boots of A Check are Forked, so They Share the Pages) */
+void simFlashErase(void);
+
+/** @Func Run the Queued Flash Operations, Including the Ones Queued by Their Callbacks (Returns the Number of Operations Run) */
+uint32_t simFlashExecute(void);
+
+/** @Func Get the Number of Flash Operations Run by This Process */
+uint32_t simFlashOpCount(void);
+
+/** @Func Cut the Power before the Flash Operation after the Next op_count Ones (The Process Exits with SIM_FLASH_CUT_EXIT) */
+void simFlashCutAfter(const int32_t op_count);
+
+/** @Func Remove All the Records of the Data Files (getOneRecord Returns FLASH_STATUS_NOT_FOUND_ERR) */
+void simRecordClear(void);
+
+/** @Func Write One Record with setOneRecord (FDS is Initialized at the First Call, without the RAM Shadow) */
+void simRecordSet(const uint16_t index, uint8_t const * bytes_array);
+
+/** @Func Read One Record with getOneRecord (Returns false if the Record Does Not Exist) */
+bool simRecordGet(const uint16_t index, uint8_t * bytes_array);
+
+/** @Func Get the Top Value Passed to pwmConfig */
+uint16_t simPwmGetTop(void);
+
+/** @Func Play One Half of the Stream and Refill It as the END_SEQ0/END_SEQ1 Events of drv_pwm.c Do */
+void simPwmPlayHalf(const uint8_t half);
+
+/** @Func Get the Steps of One Half of the Stream (Returns the Number of Steps) */
+uint16_t simPwmGetHalf(const uint8_t half, nrf_pwm_values_individual_t const ** pp_values);
+
+/** @Func Test Whether the Stream Has Played Its Last Steps (drv_pwm.c Stops the PWM Then) */
+bool simPwmIsStopped(void);
+
+#endif
@@ -0,0 +1,140 @@
+/** Library Name : sim_pwm.c
+	*
+	* @Brief 		Host simulation of the PWM driver of the RGB LEDs (Replaces drv_pwm.c)
+	* @Brief		The stream keeps the refill rules of drv_pwm.c: both halves are rendered at the start, each played half is refilled,
+	* @Brief		and the PWM stops once both halves have been played after the last steps were rendered
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include "sim_platform.h"
+#include "drv_pwm.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Configuration and the Sequence */
+static uint16_t													sim_pwm_top 	= 0;
+static nrf_pwm_values_individual_t const *	sim_pwm_seq		= NULL;
+static uint16_t													sim_pwm_len		= 0;
+static bool															sim_pwm_running_flag = false;
+
+/** @Variable The Double-buffered Stream */
+static nrf_pwm_values_individual_t *		sim_pwm_half[2];
+static pwm_refill_handler_t							sim_pwm_refill_handler 	= NULL;
+static bool															sim_pwm_is_last_rendered = false;
+static uint8_t													sim_pwm_played_after_last = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Simulation Controls) */
+
+/** @Func Get the Top Value Passed to pwmConfig */
+uint16_t simPwmGetTop(void)
+{
+	return sim_pwm_top;
+}
+
+/** @Func Play One Half of the Stream and Refill It */
+void simPwmPlayHalf(const uint8_t half)
+{
+	if(!sim_pwm_running_flag || sim_pwm_refill_handler == NULL){
+		return;
+	}
+	if(sim_pwm_is_last_rendered){
+		if(++sim_pwm_played_after_last >= 2){
+			sim_pwm_running_flag = false;
+		}
+		return;
+	}
+	sim_pwm_is_last_rendered = !sim_pwm_refill_handler(sim_pwm_half[half & 0x01], sim_pwm_len);
+}
+
+/** @Func Get the Steps of One Half of the Stream */
+uint16_t simPwmGetHalf(const uint8_t half, nrf_pwm_values_individual_t const ** pp_values)
+{
+	*pp_values = sim_pwm_half[half & 0x01];
+	return sim_pwm_len;
+}
+
+/** @Func Test Whether the Stream Has Played Its Last Steps */
+bool simPwmIsStopped(void)
+{
+	return !sim_pwm_running_flag;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (PWM Driver Model) */
+
+/** @Func Set up the PWM Configuration */
+void pwmConfig(const nrf_pwm_clk_t clk, const uint16_t cycle_top, const nrf_pwm_values_individual_t * const seq_data, const uint16_t seq_length, const uint8_t pin_red, const uint8_t pin_green, const uint8_t pin_blue)
+{
+	(void)clk;
+	(void)pin_red;
+	(void)pin_green;
+	(void)pin_blue;
+	sim_pwm_top = cycle_top;
+	pwmUpdateSeq(seq_data, seq_length);
+}
+
+/** @Func Run the Sequence */
+void pwmRun(const pwm_run_mode_t run_mode, const uint16_t loop_times)
+{
+	(void)run_mode;
+	(void)loop_times;
+	sim_pwm_refill_handler 	= NULL;
+	sim_pwm_running_flag 		= true;
+}
+
+/** @Func Update the Data Sequence */
+void pwmUpdateSeq(const nrf_pwm_values_individual_t * const seq_data, const uint16_t seq_length)
+{
+	sim_pwm_seq = seq_data;
+	sim_pwm_len = seq_length;
+}
+
+/** @Func Run a Double-buffered Sequence (Both Halves are Rendered Before the Playback Starts) */
+void pwmRunStream(nrf_pwm_values_individual_t * const seq_data_0, nrf_pwm_values_individual_t * const seq_data_1, const uint16_t seq_length, const pwm_refill_handler_t refill_handler)
+{
+	sim_pwm_half[0] 					= seq_data_0;
+	sim_pwm_half[1] 					= seq_data_1;
+	sim_pwm_len 							= seq_length;
+	sim_pwm_refill_handler 		= refill_handler;
+	sim_pwm_is_last_rendered 	= false;
+	sim_pwm_played_after_last = 0;
+	for(uint8_t half = 0; half < 2; half++){
+		if(!sim_pwm_is_last_rendered){
+			sim_pwm_is_last_rendered = !refill_handler(sim_pwm_half[half], seq_length);
+		}
+		else{// Hold the last step
+			for(uint16_t i = 0; i < seq_length; i++){
+				sim_pwm_half[half][i] = seq_data_0[seq_length - 1];
+			}
+		}
+	}
+	sim_pwm_running_flag = true;
+}
+
+/** @Func Stop the Sequence */
+void pwmStop(const pwm_stop_mode_t mode, const bool led_active_state)
+{
+	(void)mode;
+	(void)led_active_state;
+	sim_pwm_running_flag = false;
+}
+
+/** @Func Get PWM Status */
+bool pwmIsRunning(void)
+{
+	return sim_pwm_running_flag;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,339 @@
+/** Library Name : sim_sensor.c
+	*
+	* @Brief 		Implementation of the color sensor model and of the transaction and delay seams of app_sensor.c
+	* @Brief		(sensorTransactionPerform, sensorTransactionSchedule, sensor_delay_ms and sensor_delay_stop under SENSOR_HOST_SIMULATION)
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+#include <string.h>
+#include "sim_sensor.h"
+#include "sim_platform.h"
+#include "app_sensor.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro The TWI Bus (400 kHz, Nine Clocks per Byte Including the Acknowledge) */
+#define SIM_SENSOR_TWI_FREQ_HZ															400000
+#define SIM_SENSOR_TWI_BYTE_CLOCKS													9
+
+/** @Macro The RTC2 Tick of app_sensor.c (Prescaler 32) */
+#define SIM_SENSOR_RTC_PRESCALER														32
+
+/** @Macro The Scheduled Transaction Queue */
+#define SIM_SENSOR_QUEUE_SIZE																8
+
+/** @Macro The Number of Steps after which simSensorRun Gives Up (A State Machine That Never Idles) */
+#define SIM_SENSOR_RUN_MAX_STEPS														100000
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Variable Definitions */
+
+/** @Variable The Register Map and the Register Pointer */
+static uint8_t 	sim_sensor_regs[SIM_SENSOR_REG_NUM];
+static uint8_t 	sim_sensor_pointer = 0;
+
+/** @Variable The Integration in Progress */
+static bool			is_sim_sensor_integrating = false;
+static uint64_t	sim_sensor_integration_end_us;
+
+/** @Variable The Scripted Frames (Red, Green, Blue and Infrared Counts) */
+static uint16_t sim_sensor_frames[SIM_SENSOR_FRAME_NUM][4];
+static uint8_t	sim_sensor_frame_head 	= 0;
+static uint8_t	sim_sensor_frame_count 	= 0;
+static uint16_t	sim_sensor_frame_last[4];
+
+/** @Variable The Integration Log and the Counters */
+static sim_sensor_integration_t	sim_sensor_log[SIM_SENSOR_LOG_NUM];
+static uint32_t									sim_sensor_log_count 		= 0;
+static uint32_t									sim_sensor_early_reads 	= 0;
+static uint32_t									sim_sensor_delay_count 	= 0;
+
+/** @Variable The Scheduled Transactions */
+static app_twi_transaction_t const * sim_sensor_queue[SIM_SENSOR_QUEUE_SIZE];
+static uint8_t	sim_sensor_queue_head 	= 0;
+static uint8_t	sim_sensor_queue_count 	= 0;
+
+/** @Variable The RTC2 Compare Event */
+static nrf_drv_rtc_handler_t	sim_sensor_rtc_handler 		= NULL;
+static bool										is_sim_sensor_delay_pending = false;
+static uint64_t								sim_sensor_delay_end_us;
+
+/** @Variable The Length of One Integration Time Unit (in microsecond) Indexed by the Integration Time Setting */
+static const uint32_t sim_sensor_int_time_unit_us[4] = {32, 1000, 16000, 131000};
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Internal Functions) */
+
+/** @Func Latch the Next Frame into the Data Registers once the Integration is Finished */
+static void sim_sensor_latch(void)
+{
+	if(!is_sim_sensor_integrating || simTimeGet() < sim_sensor_integration_end_us){
+		return;
+	}
+	is_sim_sensor_integrating = false;
+
+	if(sim_sensor_frame_count > 0){
+		memcpy(sim_sensor_frame_last, sim_sensor_frames[sim_sensor_frame_head], sizeof(sim_sensor_frame_last));
+		sim_sensor_frame_head = (sim_sensor_frame_head + 1) % SIM_SENSOR_FRAME_NUM;
+		sim_sensor_frame_count--;
+	}
+	for(uint8_t word = 0; word < 4; word++){
+		sim_sensor_regs[SENSOR_REG_RED_DATA_HIGH_BYTE + 2 * word] 		= (sim_sensor_frame_last[word] >> 8) & 0xff;
+		sim_sensor_regs[SENSOR_REG_RED_DATA_HIGH_BYTE + 2 * word + 1] = sim_sensor_frame_last[word] & 0xff;
+	}
+}
+
+/** @Func Write the Control Register (Reset, Sleep and the Sampling Command) */
+static void sim_sensor_control_write(const uint8_t value)
+{
+	const uint8_t halt 			= SENSOR_CTRL_RESET_RESET|SENSOR_CTRL_SLEEP_SLEEP|SENSOR_CTRL_REG_RESET_03_TO_0A;
+	uint8_t 			previous 	= sim_sensor_regs[SENSOR_REG_CONTROL];
+
+	sim_sensor_regs[SENSOR_REG_CONTROL] = value;
+
+	// A finished integration is latched before the sensor is halted, an unfinished one is lost
+	if(value & halt){
+		sim_sensor_latch();
+		is_sim_sensor_integrating = false;
+		if(value & SENSOR_CTRL_REG_RESET_03_TO_0A){
+			memset(&sim_sensor_regs[SENSOR_REG_RED_DATA_HIGH_BYTE], 0, SENSOR_REG_INFRARED_DATA_LOW_BYTE - SENSOR_REG_RED_DATA_HIGH_BYTE + 1);
+		}
+		return;
+	}
+
+	// The release from the reset or the sleep starts the four channels one after another
+	if(previous & halt){
+		uint32_t units = (value & SENSOR_CTRL_INT_MODE_MANUAL_SETTING) \
+									 ? ((sim_sensor_regs[SENSOR_REG_MANUAL_TIMING_HIGH_BYTE] << 8) | sim_sensor_regs[SENSOR_REG_MANUAL_TIMING_LOW_BYTE]) : 1;
+
+		is_sim_sensor_integrating 		= true;
+		sim_sensor_integration_end_us = simTimeGet() + (uint64_t)sim_sensor_int_time_unit_us[value & 0x03] * units * 4;
+
+		if(sim_sensor_log_count < SIM_SENSOR_LOG_NUM){
+			sim_sensor_integration_t * p_log = &sim_sensor_log[sim_sensor_log_count];
+			bool is_led_on = (sim_sensor_regs[SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1] & (SENSOR_LED_RESET_RESET|SENSOR_LED_SLEEP_SLEEP)) == 0;
+			p_log->start_us 	= simTimeGet();
+			p_log->end_us 		= sim_sensor_integration_end_us;
+			p_log->led_drive 	= is_led_on ? (uint16_t)(((sim_sensor_regs[SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1] & 0x0f) << 8) \
+																							| sim_sensor_regs[SENSOR_REG_COLOR_LED_DRIVE_CONTROL_2]) : 0;
+		}
+		sim_sensor_log_count++;
+	}
+}
+
+/** @Func Run the Transfers of One Transaction on the Model */
+static ret_code_t sim_sensor_transfers(app_twi_transfer_t const * p_transfers, const uint8_t number_of_transfers)
+{
+	for(uint8_t i = 0; i < number_of_transfers; i++){
+		app_twi_transfer_t const * p_transfer = &p_transfers[i];
+
+		if(APP_TWI_OP_ADDRESS(p_transfer->operation) != SENSOR_ADDRESS){
+			return NRF_ERROR_DRV_TWI_ERR_ANACK;
+		}
+
+		// The address byte and the data bytes on the bus
+		simTimeAdvance(((uint64_t)(p_transfer->length + 1) * SIM_SENSOR_TWI_BYTE_CLOCKS * 1000000 + SIM_SENSOR_TWI_FREQ_HZ - 1) / SIM_SENSOR_TWI_FREQ_HZ);
+
+		if(APP_TWI_IS_READ_OP(p_transfer->operation)){
+			bool is_early = false;
+			sim_sensor_latch();
+			for(uint8_t n = 0; n < p_transfer->length; n++){
+				uint8_t reg = sim_sensor_pointer++;
+				if(reg >= SENSOR_REG_RED_DATA_HIGH_BYTE && reg <= SENSOR_REG_INFRARED_DATA_LOW_BYTE && is_sim_sensor_integrating){
+					is_early = true;
+				}
+				p_transfer->p_data[n] = (reg < SIM_SENSOR_REG_NUM) ? sim_sensor_regs[reg] : 0;
+			}
+			sim_sensor_early_reads += is_early ? 1 : 0;
+		}
+		else if(p_transfer->length > 0){
+			sim_sensor_pointer = p_transfer->p_data[0];
+			for(uint8_t n = 1; n < p_transfer->length; n++){
+				uint8_t reg = sim_sensor_pointer++;
+				if(reg == SENSOR_REG_CONTROL){
+					sim_sensor_control_write(p_transfer->p_data[n]);
+				}
+				else if(reg < SIM_SENSOR_REG_NUM){
+					sim_sensor_regs[reg] = p_transfer->p_data[n];
+				}
+			}
+		}
+	}
+	return NRF_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Simulation Controls) */
+
+/** @Func Clear the Registers, the Frames, the Log and the Transaction Queue */
+void simSensorReset(void)
+{
+	memset(sim_sensor_regs, 0, sizeof(sim_sensor_regs));
+	sim_sensor_regs[SENSOR_REG_CONTROL] 								= SENSOR_CTRL_RESET_RESET|SENSOR_CTRL_SLEEP_SLEEP;
+	sim_sensor_regs[SENSOR_REG_COLOR_LED_DRIVE_CONTROL_1] 	= SENSOR_LED_RESET_RESET|SENSOR_LED_SLEEP_SLEEP;
+	memset(sim_sensor_frame_last, 0, sizeof(sim_sensor_frame_last));
+	sim_sensor_pointer 						= 0;
+	is_sim_sensor_integrating 		= false;
+	sim_sensor_frame_head 				= 0;
+	sim_sensor_frame_count 				= 0;
+	sim_sensor_log_count 					= 0;
+	sim_sensor_early_reads 				= 0;
+	sim_sensor_delay_count 				= 0;
+	sim_sensor_queue_head 				= 0;
+	sim_sensor_queue_count 				= 0;
+	is_sim_sensor_delay_pending 	= false;
+}
+
+/** @Func Queue One Frame of Counts for the Next Integration */
+void simSensorFrameQueue(const uint16_t red, const uint16_t green, const uint16_t blue, const uint16_t infrared)
+{
+	if(sim_sensor_frame_count < SIM_SENSOR_FRAME_NUM){
+		uint16_t * p_frame = sim_sensor_frames[(sim_sensor_frame_head + sim_sensor_frame_count) % SIM_SENSOR_FRAME_NUM];
+		p_frame[0] = red;
+		p_frame[1] = green;
+		p_frame[2] = blue;
+		p_frame[3] = infrared;
+		sim_sensor_frame_count++;
+	}
+}
+
+/** @Func Run the Scheduled Transactions and the RTC2 Events until the Bus is Idle */
+uint32_t simSensorRun(void)
+{
+	uint32_t steps = 0;
+
+	while(steps < SIM_SENSOR_RUN_MAX_STEPS){
+		if(sim_sensor_queue_count > 0){
+			app_twi_transaction_t const * p_transaction = sim_sensor_queue[sim_sensor_queue_head];
+			sim_sensor_queue_head = (sim_sensor_queue_head + 1) % SIM_SENSOR_QUEUE_SIZE;
+			sim_sensor_queue_count--;
+
+			ret_code_t result = sim_sensor_transfers(p_transaction->p_transfers, p_transaction->number_of_transfers);
+			if(p_transaction->callback != NULL){
+				p_transaction->callback(result, p_transaction->p_user_data);
+			}
+		}
+		else if(is_sim_sensor_delay_pending && sim_sensor_rtc_handler != NULL){
+			if(simTimeGet() < sim_sensor_delay_end_us){
+				simTimeAdvance(sim_sensor_delay_end_us - simTimeGet());
+			}
+			is_sim_sensor_delay_pending = false;
+			sim_sensor_rtc_handler(NRF_DRV_RTC_INT_COMPARE0);
+		}
+		else{
+			break;
+		}
+		steps++;
+	}
+	return steps;
+}
+
+/** @Func Read One Register of the Model */
+uint8_t simSensorRegGet(const uint8_t reg)
+{
+	return (reg < SIM_SENSOR_REG_NUM) ? sim_sensor_regs[reg] : 0;
+}
+
+/** @Func Get the Integration Log */
+uint32_t simSensorGetLog(sim_sensor_integration_t const ** pp_log)
+{
+	*pp_log = sim_sensor_log;
+	return sim_sensor_log_count;
+}
+
+/** @Func Get the Number of Data Reads before the End of the Integration */
+uint32_t simSensorGetEarlyReads(void)
+{
+	return sim_sensor_early_reads;
+}
+
+/** @Func Get the Number of RTC2 Delays Started */
+uint32_t simSensorGetDelayCount(void)
+{
+	return sim_sensor_delay_count;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Implementations (Seams of app_sensor.c and the TWI and RTC Drivers) */
+
+/** @Func Perform the Sensor Transaction (Blocking Mode) */
+uint8_t sensorTransactionPerform(sensor_transaction_t * p_trans)
+{
+	return (uint8_t)sim_sensor_transfers(p_trans->transfers, p_trans->number_of_transfers);
+}
+
+/** @Func Schedule the Sensor Transaction (Run by simSensorRun) */
+uint8_t sensorTransactionSchedule(sensor_transaction_t * p_trans, app_twi_callback_t callback, void * p_user_data)
+{
+	if(sim_sensor_queue_count >= SIM_SENSOR_QUEUE_SIZE){
+		return NRF_ERROR_BUSY;
+	}
+
+	p_trans->transaction.callback							= callback;
+	p_trans->transaction.p_user_data					= p_user_data;
+	p_trans->transaction.p_transfers					= p_trans->transfers;
+	p_trans->transaction.number_of_transfers	= p_trans->number_of_transfers;
+	sim_sensor_queue[(sim_sensor_queue_head + sim_sensor_queue_count) % SIM_SENSOR_QUEUE_SIZE] = &p_trans->transaction;
+	sim_sensor_queue_count++;
+	return NRF_SUCCESS;
+}
+
+/** @Func Start the RTC2 Delay (The Compare Event is Raised by simSensorRun) */
+void sensor_delay_ms(uint32_t delay_time_ms)
+{
+	uint64_t ticks_us = ((uint64_t)delay_time_ms * (SIM_SENSOR_RTC_PRESCALER + 1) * 1000000 + 32767) / 32768;
+
+	if(is_sim_sensor_delay_pending){
+		APP_ERROR_CHECK(NRF_ERROR_BUSY);
+	}
+	sim_sensor_delay_end_us 		= simTimeGet() + ticks_us;
+	is_sim_sensor_delay_pending = true;
+	sim_sensor_delay_count++;
+}
+
+/** @Func Stop the RTC2 Delay */
+void sensor_delay_stop(void)
+{
+	is_sim_sensor_delay_pending = false;
+}
+
+/** @Func TWI Transaction Manager (Only the Blocking Transfers of sensorWriteByteArray and sensorReadByteArray Come Here) */
+ret_code_t app_twi_init(app_twi_t * p_app_twi, nrf_drv_twi_config_t const * p_twi_config, uint8_t queue_size, app_twi_transaction_t const * * p_queue_buffer)
+{
+	(void)p_app_twi;
+	(void)p_twi_config;
+	(void)queue_size;
+	(void)p_queue_buffer;
+	return NRF_SUCCESS;
+}
+
+ret_code_t app_twi_perform(app_twi_t * p_app_twi, app_twi_transfer_t const * p_transfers, uint8_t number_of_transfers, void (* user_function)(void))
+{
+	(void)p_app_twi;
+	(void)user_function;
+	return sim_sensor_transfers(p_transfers, number_of_transfers);
+}
+
+/** @Func RTC Driver (Records the Compare Event Handler of app_sensor.c) */
+ret_code_t nrf_drv_rtc_init(nrf_drv_rtc_t const * const p_instance, nrf_drv_rtc_config_t const * p_config, nrf_drv_rtc_handler_t handler)
+{
+	(void)p_instance;
+	(void)p_config;
+	sim_sensor_rtc_handler = handler;
+	return NRF_SUCCESS;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
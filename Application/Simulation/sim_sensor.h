@@ -0,0 +1,91 @@
+/** Library Name : sim_sensor.h
+	*
+	* @Brief 		Host simulation of the P1234701CT color sensor behind the TWI transactions of app_sensor.c
+	* @Brief		The model keeps the register map, starts the integration of the four channels on the sampling command
+	* @Brief		(integration time unit x manual timing x 4) and latches the next scripted frame into the data registers at its end.
+	* @Brief		A data read before the end of the integration returns the cleared registers (zeros) and is counted as an early read.
+	* @Brief		The TWI transfers take their time on the 400 kHz bus, and the RTC2 delay counts in 1/993 s ticks as on the target.
+	*
+	* @Auther 	Feng Yuan
+	* @Time 		18/09/2017
+	* @Version	1.0
+	*
+	* @Macro		SIM_SENSOR_REG_NUM									(Number of Registers of the Model)
+	* @Macro		SIM_SENSOR_FRAME_NUM								(Number of Scripted Frames Held by the Model)
+	* @Macro		SIM_SENSOR_LOG_NUM									(Number of Integrations Kept in the Log)
+	*
+	* @Type			sim_sensor_integration_t						(Data Type of One Integration in the Log)
+	*
+	* @Func			simSensorReset											(Clear the Registers, the Frames, the Log and the Transaction Queue)
+	* @Func			simSensorFrameQueue									(Queue One Frame of Counts for the Next Integration)
+	* @Func			simSensorRun												(Run the Scheduled Transactions and the RTC2 Events until the Bus is Idle)
+	* @Func			simSensorRegGet											(Read One Register of the Model)
+	* @Func			simSensorGetLog											(Get the Integration Log)
+	* @Func			simSensorGetEarlyReads							(Get the Number of Data Reads before the End of the Integration)
+	* @Func			simSensorGetDelayCount							(Get the Number of RTC2 Delays Started)
+	*
+*/
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __SIM_SENSOR_H__
+#define __SIM_SENSOR_H__
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* System Modules */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Macro Definitions */
+
+/** @Macro Model Dimensions */
+#define SIM_SENSOR_REG_NUM																	0x11
+#define SIM_SENSOR_FRAME_NUM																32
+#define SIM_SENSOR_LOG_NUM																	32
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Type Declarations */
+
+/** @Type 	Data Type of One Integration in the Log
+	*
+	* @Brief 	start_us and end_us 	: the virtual time of the sampling command and of the end of the four channels
+	* @Brief 	led_drive 						: the LED drive registers (0x0E and 0x0F) at the sampling command (0 when the LEDs are off)
+	*
+*/
+typedef struct{
+	uint64_t			start_us;
+	uint64_t			end_us;
+	uint16_t			led_drive;
+}sim_sensor_integration_t;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/* Function Declarations */
+
+/** @Func Clear the Registers, the Frames, the Log and the Transaction Queue */
+void simSensorReset(void);
+
+/** @Func Queue One Frame of Counts for the Next Integration (The Last Frame is Repeated when the Queue is Empty) */
+void simSensorFrameQueue(const uint16_t red, const uint16_t green, const uint16_t blue, const uint16_t infrared);
+
+/** @Func Run the Scheduled Transactions and the RTC2 Events until the Bus is Idle (Returns the Number of Steps Run) */
+uint32_t simSensorRun(void);
+
+/** @Func Read One Register of the Model */
+uint8_t simSensorRegGet(const uint8_t reg);
+
+/** @Func Get the Integration Log (Returns the Number of Integrations Since the Reset) */
+uint32_t simSensorGetLog(sim_sensor_integration_t const ** pp_log);
+
+/** @Func Get the Number of Data Reads before the End of the Integration */
+uint32_t simSensorGetEarlyReads(void);
+
+/** @Func Get the Number of RTC2 Delays Started */
+uint32_t simSensorGetDelayCount(void);
+
+#endif
@@ -1194,6 +1194,8 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
 
     // This must persist across calls.
     static fds_record_desc_t desc = {0};
+    // The page of the copy to be deleted by an update. This must persist across calls.
+    static uint16_t          desc_page = 0;
 
     if (prev_ret != FS_SUCCESS)
     {
@@ -1222,6 +1224,7 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
             {
                 return FDS_ERR_NOT_FOUND;
             }
+            desc_page = page;
             // Setting the step is redundant since we are falling through.
         }
         // Fallthrough to FDS_OP_WRITE_HEADER_BEGIN.
@@ -1244,6 +1247,9 @@ static ret_code_t write_execute(uint32_t prev_ret, fds_op_t * const p_op)
 
         case FDS_OP_WRITE_FLAG_DIRTY:
             ret = record_header_flag_dirty((uint32_t*)desc.p_record);
+            // The page of the old copy can now be garbage collected, as after fds_record_delete().
+            // (Not done by SDK 12.2.0: the space freed by updates was only reclaimed after a reboot.)
+            m_pages[desc_page].can_gc = true;
             p_op->write.step = FDS_OP_WRITE_DONE;
             break;
 